@@ -14,13 +14,15 @@
 #include <jansson.h>
 #include <yoyoengine/yoyoengine.h>
 
+#include "editor_spatial.h"
+
 // get the path to a resource from the editor install dir
 char * editor_path(const char *subpath);
 
 /*
     Macros for marking dirty and saving status
 */
-#define editor_unsaved() unsaved = true 
+#define editor_unsaved() do { unsaved = true; editor_spatial_invalidate(); } while(0)
 #define editor_saved() unsaved = saving = false;
 #define editor_saving() saving = true
 
@@ -0,0 +1,77 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#ifndef EDITOR_SPATIAL_H
+#define EDITOR_SPATIAL_H
+
+/*
+    The purpose of this header is to answer "what is under the cursor"
+    and "what is inside this rectangle" for editor picking without
+    walking every entity in the scene.
+
+    Entities are bucketed into a uniform grid by their picking bounds
+    (see editor_spatial_bounds). The grid is rebuilt lazily on the next
+    query after it is invalidated, which happens whenever the editor
+    marks the scene unsaved and whenever a scene loads. Candidates are
+    always re-tested against their live bounds, so a query only costs
+    the entities in the cells it touches.
+*/
+
+#include <stdbool.h>
+
+#include <yoyoengine/yoyoengine.h>
+
+// world units per grid cell
+#define EDITOR_SPATIAL_CELL 256.0f
+
+// entities covering more cells than this are tested by every query instead
+#define EDITOR_SPATIAL_MAX_CELLS 1024
+
+/**
+ * @brief Gets the bounds an entity is picked and outlined by. In order of precedence:
+ * the rect its renderer actually draws, its collider, its audiosource range, its camera
+ * viewport, or a 10x10 box around its transform.
+ *
+ * @param ent The entity
+ * @param out Filled in with the bounds in world coordinates
+ * @return true if the entity has anything to pick it by, false otherwise
+ */
+bool editor_spatial_bounds(struct ye_entity * ent, struct ye_rectf * out);
+
+/**
+ * @brief Marks the index stale, it will be rebuilt before the next query
+ */
+void editor_spatial_invalidate();
+
+/**
+ * @brief Finds the topmost entity under a world position
+ *
+ * Rendered entities are ranked by z and then by draw order. Entities
+ * without a renderer are drawn as outlines over the scene, so they rank
+ * above every rendered entity, smallest first.
+ *
+ * @param x The world x position
+ * @param y The world y position
+ * @return struct ye_entity* The topmost entity, or NULL if nothing is there
+ */
+struct ye_entity * editor_spatial_pick(float x, float y);
+
+/**
+ * @brief Calls visit for every entity whose bounds lie entirely inside a world rect
+ *
+ * @param zone The world rect (must have a positive w and h)
+ * @param visit Called once per entity inside
+ * @param data Passed to visit
+ */
+void editor_spatial_within(struct ye_rectf zone, void (*visit)(struct ye_entity * ent, void * data), void * data);
+
+/**
+ * @brief Frees the index
+ */
+void editor_spatial_shutdown();
+
+#endif
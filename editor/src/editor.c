@@ -112,6 +112,12 @@ void editor_load_scene(char * path){
     editor_re_attach_ecs();
 }
 
+// every entity the picking index knew about is gone after a scene load
+static void editor_scene_loaded(char *scene_name){
+    (void)scene_name;
+    editor_spatial_invalidate();
+}
+
 void editor_re_attach_ecs(){
     entity_list_head = ye_get_entity_list_head();
     editor_camera = ye_get_entity_by_name("editor_camera");
@@ -228,8 +234,12 @@ void editor_editing_loop() {
     else
         ye_logf(error, "No project path provided. Please provide a path to the project folder as the first argument.");
 
+    // watch the project resources so changed assets reload in place instead of through ye_reload_scene
+    ye_init_hotreload(ye_path_resources(""));
+
     // let the engine know we also want to custom handle inputs
     ye_register_event_cb(YE_EVENT_HANDLE_INPUT, editor_handle_input, YE_EVENT_FLAG_PERSISTENT);
+    ye_register_event_cb(YE_EVENT_SCENE_LOAD, editor_scene_loaded, YE_EVENT_FLAG_PERSISTENT);
 
     editor_camera = get_ent_by_name_silent("editor_camera");
     if(!editor_camera){ // we hit this because purge ecs recreates editor ents for us
@@ -325,8 +335,10 @@ void editor_editing_loop() {
     }
 
     // if we have left that loop, cleanup the editor editing state
+    ye_shutdown_hotreload();
     editor_deselect_all();
     ye_purge_ecs();
+    editor_spatial_shutdown();
     remove_ui_component("heiarchy");
     remove_ui_component("entity");
     remove_ui_component("options");
@@ -338,6 +350,7 @@ void editor_editing_loop() {
     YE_STATE.engine.target_camera = NULL;
 
     ye_unregister_event_cb(editor_handle_input);
+    ye_unregister_event_cb(editor_scene_loaded);
 }
 
 /*
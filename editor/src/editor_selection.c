@@ -15,6 +15,7 @@
 #include "editor_input.h"
 #include "editor_ui.h"
 #include "editor_selection.h"
+#include "editor_spatial.h"
 
 bool is_dragging = false;
 SDL_Point drag_start;
@@ -61,8 +62,13 @@ void add_selection(struct ye_entity * ent){
     num_editor_selections++;
 }
 
+static void _select_visit(struct ye_entity * ent, void * data){
+    (void)data;
+    add_selection(ent);
+}
+
 /*
-    Only works with entities having transform components
+    Selects every entity whose picking bounds lie inside the zone
 */
 void select_within(SDL_Rect zone){
 
@@ -80,17 +86,7 @@ void select_within(SDL_Rect zone){
     if(zone.w < 0){ zone.x += zone.w; zone.w = abs(zone.w); }
     if(zone.h < 0){ zone.y += zone.h; zone.h = abs(zone.h); }
 
-    struct ye_entity_node * itr = transform_list_head;
-    while(itr != NULL){
-        struct ye_entity * ent = itr->entity;
-        struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_TRANSFORM);
-        if(pos.x > zone.x && pos.y > zone.y &&
-            pos.x + pos.w < zone.x + zone.w &&
-            pos.y + pos.h < zone.y + zone.h){
-            add_selection(ent);
-        }
-        itr = itr->next;
-    }
+    editor_spatial_within(ye_convert_rect_rectf(zone), _select_visit, NULL);
 }
 
 void editor_selection_handler(SDL_Event event){
@@ -130,47 +126,16 @@ void editor_selection_handler(SDL_Event event){
                 }
                 
                 /*
-                    Detect the item clicked on and add it to the selected list
-
-                    We check for:
-                    - clicked within renderer comp bounds
-                    - clicked within collider bounds
-                    - clicked within audiosource bounds
-                    - clicked within camera viewport
-                    // (not now) - clicked within 10px of transform position
+                    Select the topmost item clicked on, by the bounds it is drawn with:
+                    - renderer comp bounds (as painted)
+                    - collider bounds
+                    - audiosource bounds
+                    - camera viewport
+                    - within 5px of transform position
                 */
-                struct ye_entity_node *itr = entity_list_head;
-                while(itr != NULL){
-                    struct ye_entity * ent = itr->entity;
-                    struct ye_rectf pos;
-                    if(ye_component_exists(ent, YE_COMPONENT_RENDERER)){
-                        pos = ye_get_position(ent, YE_COMPONENT_RENDERER);
-                    }
-                    else if(ye_component_exists(ent, YE_COMPONENT_COLLIDER)){
-                        pos = ye_get_position(ent, YE_COMPONENT_COLLIDER);
-                    }
-                    else if(ye_component_exists(ent, YE_COMPONENT_AUDIOSOURCE)){
-                        pos = ye_get_position(ent, YE_COMPONENT_AUDIOSOURCE);
-                    }
-                    else if(ye_component_exists(ent, YE_COMPONENT_CAMERA)){
-                        pos = ye_get_position(ent, YE_COMPONENT_CAMERA);
-                    }
-                    else if(ye_component_exists(ent, YE_COMPONENT_TRANSFORM)){
-                        pos = ye_get_position(ent, YE_COMPONENT_TRANSFORM);
-                    }
-                    else{
-                        itr = itr->next;
-                        continue;
-                    }
-
-                    if(mx > pos.x && my > pos.y &&
-                        mx < pos.x + pos.w && my < pos.y + pos.h){
-                        add_selection(ent);
-                        break;
-                    }
-
-                    itr = itr->next;
-                }
+                struct ye_entity * picked = editor_spatial_pick(mx, my);
+                if(picked != NULL)
+                    add_selection(picked);
             }
             break;
         case SDL_MOUSEBUTTONUP:
@@ -226,26 +191,9 @@ void editor_render_selection_rects(){
 
         SDL_Color select_color = (SDL_Color){255, 0, 255, 255};
 
-        if(ye_component_exists(ent, YE_COMPONENT_RENDERER)){
-            struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_RENDERER);
+        struct ye_rectf pos;
+        if(editor_spatial_bounds(ent, &pos))
             ye_debug_render_rect(pos.x, pos.y, pos.w, pos.h, select_color, 8);
-        }
-        else if(ye_component_exists(ent, YE_COMPONENT_COLLIDER)){
-            struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_COLLIDER);
-            ye_debug_render_rect(pos.x, pos.y, pos.w, pos.h, select_color, 8);
-        }
-        else if(ye_component_exists(ent, YE_COMPONENT_AUDIOSOURCE)){
-            struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_AUDIOSOURCE);
-            ye_debug_render_rect(pos.x, pos.y, pos.w, pos.h, select_color, 8);
-        }
-        else if(ye_component_exists(ent, YE_COMPONENT_CAMERA)){
-            struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_CAMERA);
-            ye_debug_render_rect(pos.x, pos.y, pos.w, pos.h, select_color, 8);
-        }
-        else if(ye_component_exists(ent, YE_COMPONENT_TRANSFORM)){
-            struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_TRANSFORM);
-            ye_debug_render_rect(pos.x - 5, pos.y - 5, 10, 10, select_color, 8);
-        }
 
         itr = itr->next;
     }
@@ -234,6 +234,10 @@ void serialize_entity_collider(struct ye_entity *entity, json_t *entity_json){
     // set the relativity
     json_object_set_new(collider, "relative", json_boolean(entity->collider->relative));
 
+    // set the body type
+    json_object_set_new(collider, "body", json_integer(entity->collider->body));
+    json_object_set_new(collider, "layer", json_integer(entity->collider->layer));
+
     // add the collider object to the entity json
     json_object_set_new(entity_json, "collider", collider);
 }
@@ -251,7 +255,7 @@ void serialize_entity_tag(struct ye_entity *entity, json_t *entity_json){
     // for each tag in the entity, add it to the tags array
     for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
         // if the tag is empty, dont add it
-        if(entity->tag->tags[i][0] == '\0'){
+        if(entity->tag->tags[i] == NULL){
             continue;
         }
 
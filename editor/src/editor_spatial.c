@@ -0,0 +1,289 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <uthash/uthash.h>
+
+#include <yoyoengine/utils.h>
+#include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/renderer.h>
+
+#include "editor.h"
+#include "editor_spatial.h"
+
+struct editor_spatial_body {
+    struct ye_entity * ent;
+    int z;                  // renderer z, INT_MAX for entities without a renderer
+    int order;              // position in the renderer list, later draws on top
+    float area;             // breaks ties between entities without a renderer
+    unsigned int stamp;     // last query that visited this body, to dedupe across cells
+};
+
+struct editor_spatial_cell {
+    int64_t key;
+    int * bodies;
+    int count;
+    int capacity;
+    UT_hash_handle hh;
+};
+
+static struct editor_spatial_body * bodies = NULL;
+static int body_count = 0;
+static int body_capacity = 0;
+
+static struct editor_spatial_cell * grid = NULL;
+static int * oversized = NULL;
+static int oversized_count = 0;
+static int oversized_capacity = 0;
+
+static bool dirty = true;
+static unsigned int query_stamp = 0;
+
+static inline int64_t _cell_key(int cx, int cy){
+    return (int64_t)(((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy);
+}
+
+static inline int _cell_of(float v){
+    return (int)floorf(v / EDITOR_SPATIAL_CELL);
+}
+
+static void _push_int(int ** array, int * count, int * capacity, int value){
+    if(*count == *capacity){
+        *capacity = *capacity > 0 ? *capacity * 2 : 16;
+        *array = realloc(*array, sizeof(int) * *capacity);
+    }
+    (*array)[(*count)++] = value;
+}
+
+static void _clear(){
+    struct editor_spatial_cell * cell, * tmp;
+    HASH_ITER(hh, grid, cell, tmp){
+        HASH_DEL(grid, cell);
+        free(cell->bodies);
+        free(cell);
+    }
+    body_count = 0;
+    oversized_count = 0;
+}
+
+/*
+    The rect the renderer system draws, computed the same way it does
+    so it is correct before the entity has been painted once.
+*/
+static struct ye_rectf _rendered_rect(struct ye_entity * ent){
+    struct ye_component_renderer * rend = ent->renderer;
+    struct ye_rectf bounds = ye_get_position(ent, YE_COMPONENT_RENDERER);
+
+    struct ye_rectf texture_rect;
+    if(rend->type == YE_RENDERER_TYPE_ANIMATION)
+        texture_rect = (struct ye_rectf){0, 0, rend->renderer_impl.animation->frame_width, rend->renderer_impl.animation->frame_height};
+    else if(rend->texture != NULL)
+        texture_rect = ye_convert_rect_rectf(ye_get_real_texture_size_rect(rend->texture));
+    else
+        return bounds;
+
+    // auto fit writes the center back, keep the renderer's untouched
+    SDL_Point center = rend->center;
+    ye_auto_fit_bounds(&bounds, &texture_rect, rend->alignment, &center, !rend->preserve_original_size);
+    return texture_rect;
+}
+
+bool editor_spatial_bounds(struct ye_entity * ent, struct ye_rectf * out){
+    if(ent->renderer != NULL){
+        *out = _rendered_rect(ent);
+    }
+    else if(ent->collider != NULL){
+        *out = ye_get_position(ent, YE_COMPONENT_COLLIDER);
+    }
+    else if(ent->audiosource != NULL){
+        *out = ye_get_position(ent, YE_COMPONENT_AUDIOSOURCE);
+    }
+    else if(ent->camera != NULL){
+        *out = ye_get_position(ent, YE_COMPONENT_CAMERA);
+    }
+    else if(ent->transform != NULL){
+        struct ye_rectf pos = ye_get_position(ent, YE_COMPONENT_TRANSFORM);
+        *out = (struct ye_rectf){pos.x - 5, pos.y - 5, 10, 10};
+    }
+    else{
+        return false;
+    }
+    return true;
+}
+
+void editor_spatial_invalidate(){
+    dirty = true;
+}
+
+static void _add_body(struct ye_entity * ent, int z, int order){
+    // editor entities are never selectable
+    if(ent == editor_camera || ent == origin)
+        return;
+
+    struct ye_rectf rect;
+    if(!editor_spatial_bounds(ent, &rect))
+        return;
+
+    if(body_count == body_capacity){
+        body_capacity = body_capacity > 0 ? body_capacity * 2 : 256;
+        bodies = realloc(bodies, sizeof(struct editor_spatial_body) * body_capacity);
+    }
+    int index = body_count++;
+    bodies[index] = (struct editor_spatial_body){ent, z, order, fabsf(rect.w * rect.h), 0};
+
+    int x0 = _cell_of(rect.x), x1 = _cell_of(rect.x + rect.w);
+    int y0 = _cell_of(rect.y), y1 = _cell_of(rect.y + rect.h);
+    if((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > EDITOR_SPATIAL_MAX_CELLS){
+        _push_int(&oversized, &oversized_count, &oversized_capacity, index);
+        return;
+    }
+
+    for(int cx = x0; cx <= x1; cx++){
+        for(int cy = y0; cy <= y1; cy++){
+            int64_t key = _cell_key(cx, cy);
+            struct editor_spatial_cell * cell = NULL;
+            HASH_FIND(hh, grid, &key, sizeof(int64_t), cell);
+            if(cell == NULL){
+                cell = calloc(1, sizeof(struct editor_spatial_cell));
+                cell->key = key;
+                HASH_ADD(hh, grid, key, sizeof(int64_t), cell);
+            }
+            _push_int(&cell->bodies, &cell->count, &cell->capacity, index);
+        }
+    }
+}
+
+static void _build(){
+    _clear();
+
+    // rendered entities first, in the order they are painted
+    int order = 0;
+    for(struct ye_entity_node * itr = renderer_list_head; itr != NULL; itr = itr->next)
+        _add_body(itr->entity, itr->entity->renderer->z, order++);
+
+    for(struct ye_entity_node * itr = ye_get_entity_list_head(); itr != NULL; itr = itr->next){
+        if(itr->entity->renderer == NULL)
+            _add_body(itr->entity, INT_MAX, 0);
+    }
+
+    dirty = false;
+}
+
+// calls visit for every body in the cells overlapping area, once each
+static void _gather(struct ye_rectf area, void (*visit)(struct editor_spatial_body * body, void * data), void * data){
+    if(dirty)
+        _build();
+
+    query_stamp++;
+
+    int x0 = _cell_of(area.x), x1 = _cell_of(area.x + area.w);
+    int y0 = _cell_of(area.y), y1 = _cell_of(area.y + area.h);
+
+    // a marquee dragged while zoomed far out can span more cells than there are entities
+    if((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > body_count){
+        for(int i = 0; i < body_count; i++)
+            visit(&bodies[i], data);
+        return;
+    }
+
+    for(int i = 0; i < oversized_count; i++)
+        visit(&bodies[oversized[i]], data);
+
+    for(int cx = x0; cx <= x1; cx++){
+        for(int cy = y0; cy <= y1; cy++){
+            int64_t key = _cell_key(cx, cy);
+            struct editor_spatial_cell * cell = NULL;
+            HASH_FIND(hh, grid, &key, sizeof(int64_t), cell);
+            if(cell == NULL)
+                continue;
+            for(int i = 0; i < cell->count; i++){
+                struct editor_spatial_body * body = &bodies[cell->bodies[i]];
+                if(body->stamp == query_stamp)
+                    continue;
+                body->stamp = query_stamp;
+                visit(body, data);
+            }
+        }
+    }
+}
+
+/*
+    Picking
+*/
+
+struct _pick_query {
+    float x, y;
+    struct editor_spatial_body * best;
+};
+
+static bool _above(struct editor_spatial_body * a, struct editor_spatial_body * b){
+    if(a->z != b->z) return a->z > b->z;
+    if(a->order != b->order) return a->order > b->order;
+    return a->area < b->area;
+}
+
+static void _pick_visit(struct editor_spatial_body * body, void * data){
+    struct _pick_query * query = data;
+
+    struct ye_rectf pos;
+    if(!editor_spatial_bounds(body->ent, &pos))
+        return;
+    if(query->x < pos.x || query->y < pos.y || query->x >= pos.x + pos.w || query->y >= pos.y + pos.h)
+        return;
+
+    if(query->best == NULL || _above(body, query->best))
+        query->best = body;
+}
+
+struct ye_entity * editor_spatial_pick(float x, float y){
+    struct _pick_query query = {x, y, NULL};
+    _gather((struct ye_rectf){x, y, 0, 0}, _pick_visit, &query);
+    return query.best != NULL ? query.best->ent : NULL;
+}
+
+/*
+    Marquee
+*/
+
+struct _within_query {
+    struct ye_rectf zone;
+    void (*visit)(struct ye_entity * ent, void * data);
+    void * data;
+};
+
+static void _within_visit(struct editor_spatial_body * body, void * data){
+    struct _within_query * query = data;
+
+    struct ye_rectf pos;
+    if(!editor_spatial_bounds(body->ent, &pos))
+        return;
+    if(pos.x >= query->zone.x && pos.y >= query->zone.y &&
+        pos.x + pos.w <= query->zone.x + query->zone.w &&
+        pos.y + pos.h <= query->zone.y + query->zone.h){
+        query->visit(body->ent, query->data);
+    }
+}
+
+void editor_spatial_within(struct ye_rectf zone, void (*visit)(struct ye_entity * ent, void * data), void * data){
+    struct _within_query query = {zone, visit, data};
+    _gather(zone, _within_visit, &query);
+}
+
+void editor_spatial_shutdown(){
+    _clear();
+    free(bodies);
+    free(oversized);
+    bodies = NULL;
+    oversized = NULL;
+    body_capacity = oversized_capacity = 0;
+    dirty = true;
+}
@@ -231,8 +231,8 @@ void _paint_renderer(struct nk_context *ctx, struct ye_entity *ent){
 
                         // If the text has been changed, replace the old text with the new one
                         if (strcmp(temp_src_buffer, ent->renderer->renderer_impl.image->src) != 0) {
-                            free(ent->renderer->renderer_impl.image->src);
-                            ent->renderer->renderer_impl.image->src = strdup(temp_src_buffer);
+                            ye_intern_release(ent->renderer->renderer_impl.image->src);
+                            ent->renderer->renderer_impl.image->src = ye_intern(temp_src_buffer);
                             // recomputes the image texture
                             ye_update_renderer_component(ent);
                             editor_unsaved();
@@ -244,8 +244,9 @@ void _paint_renderer(struct nk_context *ctx, struct ye_entity *ent){
                         if(nk_button_image_label(ctx, editor_icons.folder, "Browse", NK_TEXT_CENTERED)){
                             char *new_src = editor_file_dialog_select_resource("*.png *.jpg *.jpeg");
                             if(new_src != NULL){
-                                free(ent->renderer->renderer_impl.image->src);
-                                ent->renderer->renderer_impl.image->src = new_src;
+                                ye_intern_release(ent->renderer->renderer_impl.image->src);
+                                ent->renderer->renderer_impl.image->src = ye_intern(new_src);
+                                free(new_src);
                                 // recomputes the image texture
                                 ye_update_renderer_component(ent);
                                 editor_unsaved();
@@ -311,8 +312,8 @@ void _paint_renderer(struct nk_context *ctx, struct ye_entity *ent){
 
                         // If the text has been changed, replace the old text with the new one
                         if (strcmp(temp_buffer_color, ent->renderer->renderer_impl.text->color_name) != 0) {
-                            free(ent->renderer->renderer_impl.text->color_name);
-                            ent->renderer->renderer_impl.text->color_name = strdup(temp_buffer_color);
+                            ye_intern_release(ent->renderer->renderer_impl.text->color_name);
+                            ent->renderer->renderer_impl.text->color_name = ye_intern(temp_buffer_color);
                             // recomputes the text texture
                             ye_update_renderer_component(ent);
                             editor_unsaved();
@@ -332,8 +333,8 @@ void _paint_renderer(struct nk_context *ctx, struct ye_entity *ent){
 
                         // If the text has been changed, replace the old text with the new one
                         if (strcmp(temp_buffer_font, ent->renderer->renderer_impl.text->font_name) != 0) {
-                            free(ent->renderer->renderer_impl.text->font_name);
-                            ent->renderer->renderer_impl.text->font_name = strdup(temp_buffer_font);
+                            ye_intern_release(ent->renderer->renderer_impl.text->font_name);
+                            ent->renderer->renderer_impl.text->font_name = ye_intern(temp_buffer_font);
                             // recomputes the text texture
                             ye_update_renderer_component(ent);
                             editor_unsaved();
@@ -591,6 +592,28 @@ void _paint_collider(struct nk_context *ctx, struct ye_entity *ent){
             nk_layout_row_dynamic(ctx, 25, 1);
             nk_checkbox_label(ctx, "Is Trigger", (nk_bool*)&ent->collider->is_trigger);
             nk_layout_row_dynamic(ctx, 25, 2);
+            nk_label(ctx, "Body:", NK_TEXT_LEFT);
+            static const char *body_items[] = {"auto", "static", "kinematic", "dynamic"};
+            int body = nk_combo(ctx, body_items, 4, ent->collider->body, 25, nk_vec2(200,200));
+            if(body != (int)ent->collider->body){
+                ye_collider_set_body(ent, (enum ye_collider_body)body);
+                editor_unsaved();
+            }
+            nk_layout_row_dynamic(ctx, 25, 2);
+            nk_label(ctx, "Layer:", NK_TEXT_LEFT);
+            static char layer_labels[YE_PHYSICS_MAX_LAYERS][YE_PHYSICS_MAX_LAYER_NAME + 8];
+            static const char *layer_items[YE_PHYSICS_MAX_LAYERS];
+            for(int i = 0; i < YE_PHYSICS_MAX_LAYERS; i++){
+                const char *name = ye_physics_layer_name(i);
+                snprintf(layer_labels[i], sizeof(layer_labels[i]), "%d %s", i, name != NULL ? name : "");
+                layer_items[i] = layer_labels[i];
+            }
+            int layer = nk_combo(ctx, layer_items, YE_PHYSICS_MAX_LAYERS, ent->collider->layer, 25, nk_vec2(200,200));
+            if(layer != ent->collider->layer){
+                ent->collider->layer = layer;
+                editor_unsaved();
+            }
+            nk_layout_row_dynamic(ctx, 25, 2);
             nk_property_float(ctx, "#x", -1000000, &ent->collider->rect.x, 1000000, 1, 5);
             nk_property_float(ctx, "#y", -1000000, &ent->collider->rect.y, 1000000, 1, 5);
             nk_property_float(ctx, "#w", 0, &ent->collider->rect.w, 1000000, 1, 5);
@@ -665,10 +688,18 @@ void _paint_tag(struct nk_context *ctx, struct ye_entity *ent){
             // tag components can hold 10 buffers (TODO: sync this somehow with the #define in engine) so we want to just show them all as editable text boxes
             nk_layout_row_dynamic(ctx, 25, 1);
             nk_label(ctx, "Tag Buffers:", NK_TEXT_LEFT);
-            for(int i = 0; i < 10;){
-                nk_layout_row_dynamic(ctx, 25, 2);
-                nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, ent->tag->tags[i], 20, nk_filter_default); i++;
-                nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, ent->tag->tags[i], 20, nk_filter_default); i++;
+            // tags are interned, so edit a copy and swap the slot when it changes
+            nk_layout_row_dynamic(ctx, 25, 2);
+            for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
+                char buffer[YE_TAG_MAX_LENGTH];
+                const char *old = ent->tag->tags[i];
+                snprintf(buffer, sizeof(buffer), "%s", old != NULL ? old : "");
+                nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, buffer, sizeof(buffer), nk_filter_default);
+                if(strcmp(buffer, old != NULL ? old : "") != 0){
+                    ent->tag->tags[i] = buffer[0] != '\0' ? ye_intern(buffer) : NULL;
+                    ye_intern_release(old);
+                    editor_unsaved();
+                }
             }
 
             nk_layout_row_dynamic(ctx, 25, 1);
@@ -1171,6 +1202,9 @@ void ye_editor_paint_inspector(struct nk_context *ctx){
                     editor_selection_last_group_x = editor_selection_group_x;
                     editor_selection_last_group_y = editor_selection_group_y;
 
+                    // the moved entities are in new cells now
+                    editor_spatial_invalidate();
+
                 }
 
                 nk_layout_row_dynamic(ctx, 25, 1);
@@ -1187,8 +1221,14 @@ void ye_editor_paint_inspector(struct nk_context *ctx){
             else if (num_editor_selections == 1) { // do not handle 0 selections because this panel is unrendered
                 nk_layout_row_dynamic(ctx, 25, 2);
                 nk_label(ctx, "Name:", NK_TEXT_LEFT);
-                // TODO: bugfix name editing, setting to zero len is unhappy, also should be 99 for str term?
-                nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, ent->name, 100, nk_filter_default);
+                // names are interned, so edit a copy and rename when it changes
+                char name_buffer[100];
+                snprintf(name_buffer, sizeof(name_buffer), "%s", ent->name);
+                nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, name_buffer, sizeof(name_buffer), nk_filter_default);
+                if(strcmp(name_buffer, ent->name) != 0){
+                    ye_rename_entity(ent, name_buffer);
+                    editor_unsaved();
+                }
 
                 nk_layout_row_dynamic(ctx, 25, 1);
                 nk_checkbox_label(ctx, "Active", (nk_bool*)&ent->active);
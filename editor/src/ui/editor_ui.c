@@ -91,6 +91,9 @@ void ye_editor_paint_hiearchy(struct nk_context *ctx){
                             // loop over all tags and check for matches
                             bool tag_matches = false;
                             for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
+                                if(current->entity->tag->tags[i] == NULL){
+                                    continue;
+                                }
                                 ret = strstr(current->entity->tag->tags[i], search_text);
                                 if(ret != NULL){
                                     // printf("matched tag: %s\n",current->entity->tag->tags[i]);
@@ -50,7 +50,40 @@ Mix_Chunk *ye_audio(const char *handle);
 void ye_init_audio();
 void ye_shutdown_audio();
 
+/**
+ * @brief Opens the audio device on a worker thread, used at startup so it overlaps the rest of init
+ */
+void ye_init_audio_async();
+
+/**
+ * @brief Waits until the device from ye_init_audio_async is open, returns right away after that
+ * 
+ * @note Every playback function calls this itself
+ */
+void ye_audio_wait_ready();
+
+/**
+ * @brief Stops all playback and frees every cached chunk and the music, keeping the device open
+ */
+void ye_reset_audio();
+
+/**
+ * @brief Plays a sound on the sfx bus
+ * 
+ * @param handle The resource handle
+ * @param loops How many extra times to play it, -1 for forever
+ * @param volume_scale The volume (0-1), the engine volume is applied on top by the master bus
+ * @return int The mixer voice playing it, or -2 on failure
+ */
 int ye_play_sound(const char *handle, int loops, float volume_scale);
+
+/**
+ * @brief Plays a sound on a mixer bus (see mixer.h)
+ * 
+ * @return int The mixer voice playing it, or -2 on failure
+ */
+int ye_play_sound_on_bus(const char *handle, int loops, float volume_scale, int bus);
+
 void ye_play_music(const char *handle, int loops, float volume_scale);
 
 /**
@@ -53,6 +53,8 @@
 #ifndef YE_CACHE_H
 #define YE_CACHE_H
 
+#include <stdint.h>
+
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <jansson.h>
@@ -105,6 +107,19 @@ void ye_clear_color_cache();
  */
 void ye_init_cache();
 
+/**
+ * @brief Counts of lookups through ye_image, ye_font and ye_color since startup.
+ */
+struct ye_cache_stats {
+    uint64_t hits;      /**< Found already cached. */
+    uint64_t misses;    /**< Loaded (textures) or replaced by the engine default (fonts, colors). */
+};
+
+/**
+ * @brief Returns the lookup counts of the caches.
+ */
+struct ye_cache_stats ye_cache_stats();
+
 /**
  * @brief Shuts down the cache.
  * 
@@ -117,7 +132,7 @@ void ye_shutdown_cache();
  */
 struct ye_texture_node {
     SDL_Texture *texture; /**< The cached texture. */
-    char *path; /**< The path to the texture. */
+    const char *path; /**< The path to the texture (interned, and the hash key). */
     UT_hash_handle hh; /**< The hash handle. */
 };
 
@@ -126,7 +141,8 @@ struct ye_texture_node {
  */
 struct ye_font_node {
     TTF_Font *font;     /**< The cached font. */
-    char *name;         /**< The name of the font. */
+    const char *name;   /**< The name of the font (interned, and the hash key). */
+    const char *path;   /**< The resource handle the font was loaded from (interned, NULL if cached manually). */
     int size;           /**< The current size of the font. */
     UT_hash_handle hh;  /**< The hash handle. */
 };
@@ -136,7 +152,7 @@ struct ye_font_node {
  */
 struct ye_color_node {
     SDL_Color color; /**< The cached color. */
-    char *name; /**< The name of the color. */
+    const char *name; /**< The name of the color (interned, and the hash key). */
     UT_hash_handle hh; /**< The hash handle. */
 };
 
@@ -243,6 +259,27 @@ void ye_destroy_font(const char *name);
  */
 void ye_destroy_color(const char *name);
 
+/**
+ * @brief Reloads a cached texture from its loose file in place.
+ * 
+ * The new texture replaces the old one in the cache, and any renderer still pointing
+ * at the old texture is patched to the new one before the old texture is destroyed.
+ * 
+ * @param path The path (resource handle) the texture was cached under.
+ * @return int The number of renderers patched, or -1 if the texture was not cached or failed to load.
+ */
+int ye_reload_texture(const char *path);
+
+/**
+ * @brief Reloads every cached font that was loaded from the given loose file in place.
+ * 
+ * Text renderers using a reloaded font have their text textures regenerated.
+ * 
+ * @param path The path (resource handle) of the font file.
+ * @return int The number of renderers patched, or -1 if no cached font uses this file.
+ */
+int ye_reload_font_file(const char *path);
+
 /** @} */ // end of CacheLowLevel
 
 #endif
\ No newline at end of file
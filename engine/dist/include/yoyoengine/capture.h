@@ -0,0 +1,136 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file capture.h
+ * @brief Records every draw of one frame to a file, and replays it headless.
+ *
+ * A capture is armed with ye_capture_frame (or F12 in debug mode). During the next rendered
+ * frame the scene renderer, the debug renderer and the ui record what they submit: the texture
+ * (by resource handle), src and dst rects, rotation, flip, alpha, z, the entity and how long the
+ * submission took on the cpu. The frame is written as json when it is presented.
+ *
+ * ye_capture_replay draws a capture again into a software surface, one op at a time, reloading
+ * the textures by handle, and reports draw calls, texture switches and overdraw. The "capture"
+ * debug overlay captures, replays and steps through the last capture.
+ *
+ * Textures without a handle (text, manually cached ones) and debug or ui shapes replay as
+ * solid rects. Overdraw is counted over each dst rect, ignoring rotation.
+ */
+
+#ifndef YE_CAPTURE_H
+#define YE_CAPTURE_H
+
+#include <stdbool.h>
+
+#include <SDL.h>
+
+#define YE_CAPTURE_VERSION 1
+
+/**
+ * @brief Which part of the frame submitted a draw.
+ */
+enum ye_capture_source {
+    YE_CAPTURE_SCENE,   // renderer components (ye_system_renderer)
+    YE_CAPTURE_DEBUG,   // the debug renderer and editor overlays drawn into the scene
+    YE_CAPTURE_UI,      // nuklear, in window coordinates
+
+    YE_CAPTURE_SOURCE_COUNT
+};
+
+/**
+ * @brief One draw.
+ */
+struct ye_capture_op {
+    enum ye_capture_source source;
+    char texture[128];      // resource handle of the texture, empty for shapes and text
+    char label[64];         // entity name, or the kind of shape or ui command
+
+    SDL_Rect src;           // w of 0 for the whole texture
+    SDL_Rect dst;           // render target coordinates (window coordinates for ui)
+    float rotation;         // degrees
+    int flip;               // SDL_RendererFlip
+    int alpha;
+    int z;
+    int entity;             // entity id, -1 if not drawn for an entity
+    SDL_Color color;        // draw color of shapes
+
+    float cost_ms;          // cpu time spent submitting it (ui commands share the time of the ui submit)
+};
+
+/**
+ * @brief What a replay found.
+ */
+struct ye_capture_report {
+    int draw_calls;
+    int draw_calls_by_source[YE_CAPTURE_SOURCE_COUNT];
+    int texture_switches;       // draws using a different texture than the draw before, each breaks SDL's batch
+    int missing_textures;       // handles that could not be loaded, replayed as solid rects
+    float cost_ms;              // sum of the cpu cost of every draw
+    int most_expensive;         // index of the costliest draw, -1 if there were none
+
+    int width, height;          // the render target the scene was drawn at
+    float covered;              // fraction of the target drawn at least once
+    float average_overdraw;     // draws per covered pixel
+    int max_overdraw;           // draws on the most drawn pixel
+};
+
+/**
+ * @brief Captures the next rendered frame.
+ *
+ * @param path Where to write it, NULL for capture_<ticks>.json next to the executable
+ */
+void ye_capture_frame(const char *path);
+
+/**
+ * @brief Whether the frame being rendered is being captured.
+ */
+bool ye_capture_recording();
+
+/**
+ * @brief Records a draw into the capture. Does nothing unless recording.
+ */
+void ye_capture_record(const struct ye_capture_op *op);
+
+/**
+ * @brief Splits a cost evenly across the last count recorded draws, for draws that are submitted as one batch.
+ */
+void ye_capture_share_cost(int count, float cost_ms);
+
+/**
+ * @brief Starts recording if a capture is armed. Called by ye_render_all before anything is drawn.
+ */
+void ye_capture_begin_frame();
+
+/**
+ * @brief Writes the capture if one was recording. Called by ye_render_all after the ui is drawn.
+ */
+void ye_capture_end_frame();
+
+/**
+ * @brief Replays a capture into a software surface.
+ *
+ * @param path The capture file
+ * @param report Filled in with what the replay found
+ * @param step Called after every draw with the surface as it is so far, may be NULL
+ * @param data Passed to step
+ * @return true The capture was read and replayed.
+ */
+bool ye_capture_replay(const char *path, struct ye_capture_report *report,
+                       void (*step)(int index, const struct ye_capture_op *op, SDL_Surface *target, void *data), void *data);
+
+/**
+ * @brief Debug overlay to capture a frame, replay it and step through its draws.
+ */
+void ye_capture_overlay(struct nk_context *ctx);
+
+/**
+ * @brief Drops an armed capture and frees the last capture the overlay replayed.
+ */
+void ye_shutdown_capture();
+
+#endif
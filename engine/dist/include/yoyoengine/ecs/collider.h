@@ -23,11 +23,21 @@
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/utils.h>
 
+/**
+ * @brief How a collider moves, which decides how the physics system stores and tests it.
+ */
+enum ye_collider_body {
+    YE_COLLIDER_BODY_AUTO,          /**< Dynamic if the entity has a physics component, static otherwise. */
+    YE_COLLIDER_BODY_STATIC,        /**< Rarely moves. Held in the broadphase grid, which is rebuilt whenever one is moved. */
+    YE_COLLIDER_BODY_KINEMATIC,     /**< Moved by scripts, its position is re-read every physics step. Set this on colliders without physics that move often. */
+    YE_COLLIDER_BODY_DYNAMIC,       /**< Moved by its physics component, can sleep while resting. */
+};
+
 /**
  * @brief A structure representing a collider component.
  *
  * This structure might need to be broken out into two different colliders, trigger and static to enable
- * multiple colliders on a single entity. Also, consider giving this a z or a layer, colliders do not care about the layer right now.
+ * multiple colliders on a single entity.
  */
 struct ye_component_collider {
     bool active;            /**< Controls whether system will act upon this component. */
@@ -38,6 +48,12 @@ struct ye_component_collider {
 
     bool is_trigger;        /**< Specifies whether this collider is a trigger. If false, it is a static collider. */
 
+    enum ye_collider_body body; /**< How this collider moves. Change it with ye_collider_set_body. */
+
+    int layer;              /**< The collision layer (0 to YE_PHYSICS_MAX_LAYERS - 1), see ye_physics_set_layers_interact. */
+
+    int _step_slot;         /**< Internal: index into the physics step's collider cache. */
+
     /*
         Meta tracking trigger states
     */
@@ -60,6 +76,24 @@ void ye_add_static_collider_component(struct ye_entity *entity, struct ye_rectf
  */
 void ye_add_trigger_collider_component(struct ye_entity *entity, struct ye_rectf rect);
 
+/**
+ * @brief Sets how an entity's collider moves.
+ *
+ * @param entity The entity whose collider to change.
+ * @param body The body type.
+ *
+ * @note Moving a static collider from C without going through ye_component_modified requires ye_physics_invalidate_static to take effect.
+ */
+void ye_collider_set_body(struct ye_entity *entity, enum ye_collider_body body);
+
+/**
+ * @brief Returns how an entity's collider moves, resolving YE_COLLIDER_BODY_AUTO.
+ *
+ * @param entity The entity, which must have a collider.
+ * @return enum ye_collider_body Never YE_COLLIDER_BODY_AUTO.
+ */
+enum ye_collider_body ye_collider_body(struct ye_entity *entity);
+
 /**
  * @brief Removes an entity's collider component.
  *
@@ -14,6 +14,7 @@
 #define YE_ECS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /*
     =============================================================
@@ -86,7 +87,7 @@ struct ye_entity {
     bool active;        // controls whether system will act upon this entity and its components
 
     int id;             // unique id for this entity
-    char *name;         // name that can also be used to access the entity
+    const char *name;   // name that can also be used to access the entity (interned, rename with ye_rename_entity)
 
     struct ye_component_transform *transform;       // transform component
     struct ye_component_renderer *renderer;         // renderer component
@@ -97,6 +98,12 @@ struct ye_entity {
     struct ye_component_collider *collider;         // collider component
     struct ye_component_tag *tag;                   // tag component
     struct ye_component_audiosource *audiosource;   // audiosource component
+
+    uint32_t components;    // YE_COMPONENT_BIT set of the components above it has, kept by the ECS
+    uint32_t modified;      // YE_COMPONENT_BIT set of components with a modification waiting to be observed (see observer.h)
+    int _slot;              // internal: dense index, reused once the entity is destroyed, that queries are keyed on
+
+    int tween_count;    // tweens targeting this entity (see tween.h)
 };
 
 /**
@@ -134,7 +141,7 @@ struct ye_entity * ye_create_entity_named(const char *name);
  * @param entity The entity to rename
  * @param name The new name
  */
-void ye_rename_entity(struct ye_entity *entity, char *name);
+void ye_rename_entity(struct ye_entity *entity, const char *name);
 
 /**
  * @brief !!!DO NOT USE THIS RIGHT NOW. IT IS COMPLETELY BROKEN!!! Duplicate an entity by pointer. Will rename the entity to "entity_name (copy)"
@@ -175,6 +182,122 @@ struct ye_entity * ye_get_entity_by_tag(const char *tag);
  */
 struct ye_entity *ye_get_entity_by_id(int id);
 
+/**
+ * @brief Checks whether an entity is still alive, without reading through the pointer if it is not.
+ *
+ * For holding on to an entity across code that might destroy it, like script callbacks.
+ * Read its _slot and id before running that code, then pass them in with the pointer.
+ *
+ * @param entity The entity pointer, possibly dangling
+ * @param slot Its _slot from before
+ * @param id Its id from before
+ * @return true if the pointer still refers to that same entity
+ */
+bool ye_entity_alive(struct ye_entity *entity, int slot, int id);
+
+/*
+    =============================================================
+                        COMPONENT QUERIES
+    =============================================================
+*/
+
+/**
+ * @brief A cached set of every entity that has all of some components and none of others.
+ *
+ * Queries are kept up to date as components are added and removed, so iterating one only
+ * touches the entities that match. The same query is shared by everyone asking for the same
+ * components, and lives until the engine shuts down (it is emptied, not freed, with the scene).
+ *
+ * Iterate it between ye_ecs_query_lock and ye_ecs_query_unlock. While it is locked, entities
+ * that stop matching leave a NULL behind instead of reordering it, and entities that start
+ * matching are appended (and visited by a loop that rereads count):
+ * @code
+ * ye_ecs_query_lock(query);
+ * for(int i = 0; i < query->count; i++){
+ *     struct ye_entity *entity = query->entities[i];
+ *     if(entity == NULL) continue;
+ *     ...
+ * }
+ * ye_ecs_query_unlock(query);
+ * @endcode
+ * Outside of a lock the order of entities is not stable.
+ */
+struct ye_ecs_query {
+    uint32_t required;              // YE_COMPONENT_BIT set an entity must have
+    uint32_t excluded;              // YE_COMPONENT_BIT set an entity must not have
+
+    struct ye_entity **entities;    // the matching entities, NULL where one left during a lock
+    int count;
+
+    // internal
+    int capacity;
+    int *slots;                     // entity _slot -> index in entities + 1, 0 if absent
+    int slot_capacity;
+    int locks;
+    bool holes;
+};
+
+/**
+ * @brief The most distinct queries that can exist at once.
+ */
+#define YE_ECS_MAX_QUERIES 64
+
+/**
+ * @brief Gets the query for a combination of components, creating it if it does not exist yet.
+ *
+ * @param required YE_COMPONENT_BIT set an entity must have (at least one)
+ * @param excluded YE_COMPONENT_BIT set an entity must not have
+ * @return struct ye_ecs_query* The query, or NULL if required is empty or there are too many queries.
+ */
+struct ye_ecs_query * ye_ecs_query(uint32_t required, uint32_t excluded);
+
+/**
+ * @brief Gets a query from component names, ex: "physics+transform+collider", or "transform+!button" to exclude.
+ *
+ * Names are transform, renderer, physics, collider, lua_script, audiosource, camera, tag and button.
+ *
+ * @param spec The components, joined by +
+ * @return struct ye_ecs_query* The query, or NULL if spec names an unknown component (see ye_ecs_query).
+ */
+struct ye_ecs_query * ye_ecs_query_parse(const char *spec);
+
+/**
+ * @brief Starts iterating a query, see struct ye_ecs_query. Locks nest.
+ */
+void ye_ecs_query_lock(struct ye_ecs_query *query);
+
+/**
+ * @brief Stops iterating a query, dropping the NULLs left by entities that stopped matching.
+ */
+void ye_ecs_query_unlock(struct ye_ecs_query *query);
+
+/**
+ * @brief Gets the name of a component type as used by ye_ecs_query_parse, ex: "audiosource".
+ */
+const char * ye_component_name(int type);
+
+/**
+ * @brief Gets a component type from its name (see ye_component_name).
+ *
+ * @return int The enum ye_component_type, or -1 if no component has that name.
+ */
+int ye_component_from_name(const char *name);
+
+/**
+ * @brief Records that a component was added to an entity. Called by every ye_add_*_component.
+ */
+void ye_entity_component_added(struct ye_entity *entity, int type);
+
+/**
+ * @brief Records that a component was removed from an entity. Called by every ye_remove_*_component.
+ */
+void ye_entity_component_removed(struct ye_entity *entity, int type);
+
+/**
+ * @brief Frees every query. Called when the engine shuts down.
+ */
+void ye_shutdown_ecs_queries();
+
 /**
  * @brief Initialize the ECS
  */
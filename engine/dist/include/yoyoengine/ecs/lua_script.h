@@ -20,6 +20,8 @@
 #include <lualib.h>
 #include <lauxlib.h>
 
+#include <yoyoengine/lua_memory.h>
+
 /*
     Types of lua globals we can pass through editor
 
@@ -59,6 +61,7 @@ struct ye_component_lua_script {
     char *script_handle;            // the path to the script
 
     lua_State *state;               // the lua state for this script
+    struct ye_lua_memory memory;    // allocation accounting and limit for the state
 
     /*
         List of globals we pass to script.
@@ -80,6 +83,8 @@ struct ye_component_lua_script {
     bool has_on_update;
     bool has_on_collision;
     bool has_on_trigger_enter;
+    bool has_on_trigger_exit;
+    bool has_on_collision_exit;
     // ... etc
 };
 
@@ -107,6 +112,30 @@ void ye_lua_script_remove_global(struct ye_entity *ent, const char *name);
  */
 bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, struct ye_lua_script_global *globals);
 
+/**
+ * @brief Re-runs the (changed) script file of a lua script component inside its existing state.
+ * 
+ * Functions are redefined and top level code runs again, but the state itself, its runtime
+ * and anything referencing it survive. Signatures and UI globals are re-applied afterwards.
+ * The script is read from the loose resources folder, not resources.yep.
+ * Does nothing in editor mode, where script states are never run.
+ * 
+ * @param entity The entity whose script should be reloaded.
+ * @return true if the script was reloaded successfully.
+ */
+bool ye_reload_lua_script_component(struct ye_entity *entity);
+
+/**
+ * @brief Change how many bytes a script's state may allocate.
+ * 
+ * Lowering the limit below what the script already uses does not free anything,
+ * it only causes further growth to fail with a lua memory error.
+ * 
+ * @param entity The entity whose script should be limited.
+ * @param limit The limit in bytes, 0 for unlimited.
+ */
+void ye_lua_script_set_memory_limit(struct ye_entity *entity, size_t limit);
+
 /**
  * @brief Remove a lua script component from an entity
  * 
@@ -120,13 +149,23 @@ void ye_remove_lua_script_component(struct ye_entity *entity);
 void ye_system_lua_scripting();
 
 /**
- * @brief Send onCollision to all scripts that observe it
+ * @brief Send onCollision to the scripts on the two colliding entities
  */
 void ye_lua_signal_collisions(struct ye_entity *entity1, struct ye_entity *entity2);
 
 /**
- * @brief Send onTriggerEnter to all scripts that observe it
+ * @brief Send onCollisionExit to the scripts on the two entities that stopped touching
+ */
+void ye_lua_signal_collision_exit(struct ye_entity *entity1, struct ye_entity *entity2);
+
+/**
+ * @brief Send onTriggerEnter to the scripts on the entity and the trigger it entered
  */
 void ye_lua_signal_trigger_enter(struct ye_entity *entity1, struct ye_entity *entity2);
 
+/**
+ * @brief Send onTriggerExit to the scripts on the entity and the trigger it left
+ */
+void ye_lua_signal_trigger_exit(struct ye_entity *entity1, struct ye_entity *entity2);
+
 #endif
\ No newline at end of file
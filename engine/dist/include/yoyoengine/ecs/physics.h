@@ -20,7 +20,31 @@
     #define YE_PHYSICS_SUBSTEPS 10
 #endif
 
+/*
+    How many frames a dynamic body has to rest before it is put to sleep
+*/
+#ifndef YE_PHYSICS_SLEEP_FRAMES
+    #define YE_PHYSICS_SLEEP_FRAMES 30
+#endif
+
+/*
+    Side length in pixels of a cell in the static collider broadphase grid
+*/
+#ifndef YE_PHYSICS_GRID_CELL
+    #define YE_PHYSICS_GRID_CELL 256
+#endif
+
+/*
+    Collision layers, a collider sits on one of these (its collider->layer)
+*/
+#define YE_PHYSICS_MAX_LAYERS 32
+#define YE_PHYSICS_MAX_LAYER_NAME 32
+#define YE_PHYSICS_LAYER_BIT(layer) (1u << (layer))
+#define YE_PHYSICS_LAYERS_ALL 0xFFFFFFFFu
+
 #include <stdbool.h>
+#include <stdint.h>
+#include <yoyoengine/utils.h>
 #include <yoyoengine/ecs/ecs.h>
 
 /**
@@ -33,6 +57,9 @@ struct ye_component_physics {
 
     struct ye_vec2f velocity;           /**< Velocity of entity */
     float rotational_velocity;          /**< Rotational velocity of entity */
+
+    bool sleeping;                      /**< Set after resting for YE_PHYSICS_SLEEP_FRAMES. Sleeping bodies are skipped until woken or given velocity, see ye_physics_wake */
+    int rest_frames;                    /**< How many frames in a row the body has not moved */
 };
 
 /**
@@ -58,4 +85,152 @@ void ye_remove_physics_component(struct ye_entity *entity);
  */
 void ye_system_physics();
 
+/**
+ * @brief Wakes a sleeping body.
+ *
+ * Bodies wake by themselves when something runs into them, when they are given velocity (even written
+ * directly), or when ye_component_modified reports their transform or physics changed (the lua bindings
+ * and tweens do). C code that moves a sleeping body some other way calls this.
+ *
+ * @param entity The entity, which must have a physics component.
+ */
+void ye_physics_wake(struct ye_entity *entity);
+
+/**
+ * @brief Rebuilds the broadphase grid of static colliders from the current scene.
+ *
+ * Runs at the end of every scene load, and lazily before the next physics step after static colliders change.
+ */
+void ye_physics_build_broadphase();
+
+/**
+ * @brief Marks the static broadphase as stale, so it is rebuilt before the next physics step.
+ *
+ * Call this after moving or resizing a static collider by hand.
+ */
+void ye_physics_invalidate_static();
+
+/**
+ * @brief Drops every contact involving an entity, without firing exit events.
+ *
+ * Called when its collider is removed, so the cache never holds a dangling entity.
+ */
+void ye_physics_forget_contacts(struct ye_entity *entity);
+
+/**
+ * @brief Puts every layer back to interacting with every other, and clears their names (layer 0 is "default").
+ *
+ * Called on every scene load, before the scene's "physics" settings are applied.
+ */
+void ye_physics_reset_layers();
+
+/**
+ * @brief Names a layer, so scenes and scripts can refer to it by name.
+ */
+void ye_physics_set_layer_name(int layer, const char *name);
+
+/**
+ * @brief Gets the name of a layer, an empty string if it is unnamed or NULL if out of range.
+ */
+const char * ye_physics_layer_name(int layer);
+
+/**
+ * @brief Looks up a layer by name.
+ *
+ * @return The layer, or -1 if no layer has that name.
+ */
+int ye_physics_layer_index(const char *name);
+
+/**
+ * @brief Sets whether colliders on two layers collide (and trigger) with each other. Always symmetric.
+ */
+void ye_physics_set_layers_interact(int a, int b, bool interact);
+
+/**
+ * @brief Returns true if colliders on two layers collide with each other.
+ */
+bool ye_physics_layers_interact(int a, int b);
+
+/**
+ * @brief Gets the set of layers (YE_PHYSICS_LAYER_BIT) a layer interacts with.
+ */
+uint32_t ye_physics_layer_mask(int layer);
+
+/**
+ * @brief Narrows down what a query can return. Zero initialize it to accept every collider.
+ */
+struct ye_physics_filter {
+    const char *tag;            /**< Only return entities with this tag, NULL for any */
+    struct ye_entity *ignore;   /**< Never return this entity (usually the one asking) */
+    bool skip_triggers;         /**< Do not return trigger colliders */
+    uint32_t layers;            /**< Only return colliders on these layers (YE_PHYSICS_LAYER_BIT), 0 for any. Pass ye_physics_layer_mask(layer) to query as a collider on that layer would see the world */
+};
+
+/**
+ * @brief A single result of a raycast or sweep.
+ */
+struct ye_physics_hit {
+    struct ye_entity *entity;   /**< The collider that was hit */
+    struct ye_vec2f point;      /**< Where the ray (or the swept box's top left) was on contact */
+    struct ye_vec2f normal;     /**< Normal of the face that was hit, zero if the cast started inside it */
+    float distance;             /**< How far along the cast the contact was */
+};
+
+/**
+ * @brief Casts a ray against every collider.
+ *
+ * @param origin Where the ray starts, in world space
+ * @param direction The direction of the ray, does not need to be normalized
+ * @param max_distance How far the ray reaches
+ * @param filter Which colliders can be hit, may be NULL
+ * @param hits Filled with the nearest hits, sorted by distance
+ * @param max_hits The length of hits, 1 to only get the nearest
+ * @return The number of hits written
+ */
+int ye_physics_raycast(struct ye_vec2f origin, struct ye_vec2f direction, float max_distance,
+                        const struct ye_physics_filter *filter, struct ye_physics_hit *hits, int max_hits);
+
+/**
+ * @brief Moves a box along a direction and reports what it would run into.
+ *
+ * @param box The box at its starting position, in world space
+ * @param direction The direction to move it, does not need to be normalized
+ * @param max_distance How far to move it
+ * @param filter Which colliders can be hit, may be NULL
+ * @param hits Filled with the nearest hits, sorted by distance
+ * @param max_hits The length of hits
+ * @return The number of hits written
+ */
+int ye_physics_sweep(struct ye_rectf box, struct ye_vec2f direction, float max_distance,
+                        const struct ye_physics_filter *filter, struct ye_physics_hit *hits, int max_hits);
+
+/**
+ * @brief Finds the colliders overlapping a rect.
+ *
+ * @param area The rect to test, in world space
+ * @param filter Which colliders can be returned, may be NULL
+ * @param results Filled with the overlapping entities, in no particular order
+ * @param max_results The length of results, the query stops once it is full
+ * @return The number of entities written
+ */
+int ye_physics_overlap_rect(struct ye_rectf area, const struct ye_physics_filter *filter,
+                            struct ye_entity **results, int max_results);
+
+/**
+ * @brief Finds the colliders containing a point.
+ *
+ * @param point The point to test, in world space
+ * @param filter Which colliders can be returned, may be NULL
+ * @param results Filled with the entities containing the point, in no particular order
+ * @param max_results The length of results, the query stops once it is full
+ * @return The number of entities written
+ */
+int ye_physics_overlap_point(struct ye_vec2f point, const struct ye_physics_filter *filter,
+                            struct ye_entity **results, int max_results);
+
+/**
+ * @brief Frees the broadphase and the contact cache.
+ */
+void ye_shutdown_physics();
+
 #endif
\ No newline at end of file
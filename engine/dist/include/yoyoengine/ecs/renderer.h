@@ -75,7 +75,7 @@ struct ye_component_renderer {
  * @brief A structure to represent an image renderer.
  */
 struct ye_component_renderer_image {
-    char *src;  ///< path to image
+    const char *src;  ///< path to image (interned)
 };
 
 /**
@@ -83,9 +83,9 @@ struct ye_component_renderer_image {
  */
 struct ye_component_renderer_text {
     char *text;         ///< text to render
-    char *font_name;    ///< name of font to use
-    int font_size;      ///< size of font to use
-    char *color_name;   ///< name of the color to use
+    const char *font_name;  ///< name of font to use (interned)
+    int font_size;          ///< size of font to use
+    const char *color_name; ///< name of the color to use (interned)
     TTF_Font *font;     ///< font to use
     SDL_Color *color;   ///< color of text
     int wrap_width;     ///< if >0 then wrap text to this width (in pixels
@@ -97,10 +97,10 @@ struct ye_component_renderer_text {
 struct ye_component_renderer_text_outlined {
     char *text;                 ///< text to render
     int outline_size;           ///< size of text outline
-    char *font_name;            ///< name of font to use
-    int font_size;              ///< size of font to use
-    char *color_name;           ///< name of the color to use
-    char *outline_color_name;   ///< name of the color to use for the outline
+    const char *font_name;          ///< name of font to use (interned)
+    int font_size;                  ///< size of font to use
+    const char *color_name;         ///< name of the color to use (interned)
+    const char *outline_color_name; ///< name of the color to use for the outline (interned)
     TTF_Font *font;             ///< font to use
     SDL_Color *color;           ///< color of text
     SDL_Color *outline_color;   ///< color of text outline
@@ -201,6 +201,17 @@ void ye_add_text_outlined_renderer_component(struct ye_entity *entity, int z, co
  */
 void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const char *meta_file);
 
+/**
+ * @brief Re-reads the meta file of an animation renderer and patches its frame data in place.
+ * 
+ * Unlike @ref ye_update_renderer_component this keeps the rest of the renderer (rect, alignment, z, etc)
+ * untouched, which is what we want when an animation meta file changes on disk.
+ * 
+ * @param entity The entity whose animation renderer should be refreshed.
+ * @return true if the meta file was read and applied, false otherwise.
+ */
+bool ye_reload_animation_renderer_meta(struct ye_entity *entity);
+
 /**
  * @brief Adds a tilemap tile renderer component to an entity.
  * 
@@ -217,6 +228,13 @@ void ye_add_tilemap_renderer_component(struct ye_entity *entity, int z, const ch
  */
 void ye_remove_renderer_component(struct ye_entity *entity);
 
+/**
+ * @brief Advances the frame of every active, unpaused animation renderer.
+ *
+ * Only touches animation renderers, so the scheduler runs it off the main thread.
+ */
+void ye_system_animation();
+
 /**
  * @brief Handles the rendering system.
  * @param renderer The SDL renderer to use.
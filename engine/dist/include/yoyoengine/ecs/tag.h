@@ -17,7 +17,7 @@
 #include <yoyoengine/ecs/ecs.h>
 
 #define YE_TAG_MAX_NUMBER 10
-#define YE_TAG_MAX_LENGTH 20
+#define YE_TAG_MAX_LENGTH 20 // longest tag the editor will let you type
 
 /**
  * @brief The tag component
@@ -25,7 +25,7 @@
 struct ye_component_tag {
     bool active;    // controls whether system will act upon this component
 
-    char tags[YE_TAG_MAX_NUMBER][YE_TAG_MAX_LENGTH]; // array of tags
+    const char *tags[YE_TAG_MAX_NUMBER]; // interned tags (see intern.h), NULL slots are empty
 };
 
 /**
@@ -69,6 +69,16 @@ void ye_remove_tag_component(struct ye_entity *entity);
  */
 bool ye_entity_has_tag(struct ye_entity *entity, const char *tag);
 
+/**
+ * @brief Returns true if an entity has a tag, comparing by pointer
+ * 
+ * @param entity The entity to check
+ * @param tag An interned tag (from ye_intern or ye_intern_find), NULL never matches
+ * @return true 
+ * @return false 
+ */
+bool ye_entity_has_interned_tag(struct ye_entity *entity, const char *tag);
+
 /**
  * @brief Iterates over every tagged entity, passing each one that matches a tag to a specified callback
  * 
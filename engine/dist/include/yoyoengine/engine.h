@@ -126,6 +126,34 @@ struct ye_engine_config {
     */
     bool skipintro;
 
+    /*
+        The default limit (in KB) on how much memory each lua script may allocate, 0 for unlimited.
+    */
+    int lua_memory_limit_kb;
+
+    /*
+        How many job worker threads to start, -1 for one less than the number of cores.
+    */
+    int job_workers;
+
+    /*
+        The shortest time (in ms) the splash screen stays up, it otherwise ends as soon as the entry scene is ready.
+    */
+    int splash_min_ms;
+
+    /*
+        Outside the editor, watch the loose game resources folder and re-run changed lua scripts (for dev builds).
+    */
+    bool hot_reload_scripts;
+
+    /*
+        Where metrics are exported (see metrics.h): "none", "textfile", "statsd" or "unix".
+        The target is the file, host:port or socket path (empty for the default), written every interval.
+    */
+    char *metrics_sink;
+    char *metrics_target;
+    int metrics_interval_ms;
+
     /*
         Allocated strings for resource accessing paths.
     */
@@ -207,6 +235,7 @@ struct ye_runtime_data {
     */
     int entity_count;           // scene entities
     int painted_entity_count;   // scene entities actually painted
+    int draw_call_count;        // textures the renderer copied for the last frame (overlays and ui not included)
     int fps;                    // our current fps (updated every frame)
     
     int paint_time;             // time in ms it took to paint the last frame
@@ -224,6 +253,9 @@ struct ye_runtime_data {
     int error_count;            // tracks the number of error level logs that have occurred
     int warning_count;          // same but for warnings
 
+    float init_ms;              // how long ye_init_engine took
+    float first_frame_ms;       // from ye_init_engine starting to the first frame of the entry scene being done, 0 until then
+
     /*
         Meta on opened controllers
     */
@@ -28,9 +28,12 @@ enum ye_event_type {
     YE_EVENT_SCENE_LOAD,        // scene_load_cb
     YE_EVENT_COLLISION,         // collision_cb
     YE_EVENT_TRIGGER_ENTER,     // collision_cb
+    YE_EVENT_COLLISION_EXIT,    // collision_cb
+    YE_EVENT_TRIGGER_EXIT,      // collision_cb
     YE_EVENT_PRE_SHUTDOWN,      // empty_cb
     YE_EVENT_POST_SHUTDOWN,     // empty_cb
     YE_EVENT_ADDITIONAL_RENDER, // empty_cb
+    YE_EVENT_TWEEN_COMPLETE,    // tween_cb
 
     YE_EVENT_CUSTOM,    // void * data, user defined event
 };
@@ -45,6 +48,7 @@ struct _ye_event {
         void (*input_cb)(SDL_Event event);
         void (*lua_cb)(lua_State *L);
         void (*collision_cb)(struct ye_entity *one, struct ye_entity *two);
+        void (*tween_cb)(unsigned int id, struct ye_entity *entity);
         void (*custom_cb)(void *data);
     };
     
@@ -59,6 +63,10 @@ union ye_event_args {
         struct ye_entity *one;
         struct ye_entity *two;
     } collision;
+    struct {
+        unsigned int id;
+        struct ye_entity *entity;
+    } tween;
     void *custom_data;
 };
 
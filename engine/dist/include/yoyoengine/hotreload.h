@@ -0,0 +1,68 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file hotreload.h
+ * @brief Watches loose resource files and reloads changed assets in place.
+ *
+ * When the engine runs off of loose files (editor mode), a changed texture, font, animation
+ * meta or script used to require @ref ye_reload_scene, which tears down the whole ECS and every cache.
+ * The hot reloader instead maps a changed resource handle to whatever references it:
+ * - cached textures are swapped and every renderer holding the old texture is patched
+ * - cached fonts loaded from the file are reopened and dependant text is re-rendered
+ * - animation renderers using the file as their meta have their frame data re-read
+ * - lua script components using the file re-run it inside their existing state
+ *
+ * The editor watches its project. Scripts only run outside the editor, so to iterate on them a
+ * dev build can set "hot_reload_scripts" in settings.yoyo, which watches the loose game resources folder
+ * and re-runs changed scripts in place.
+ *
+ * Watching is implemented with inotify and is only available on linux. @ref ye_hotreload_asset
+ * can be called manually on any platform.
+ */
+
+#ifndef YE_HOTRELOAD_H
+#define YE_HOTRELOAD_H
+
+#include <stdbool.h>
+
+/**
+ * @brief The maximum number of directories the hot reloader will watch.
+ */
+#define YE_HOTRELOAD_MAX_WATCHES 256
+
+/**
+ * @brief Starts watching a resources directory (recursively) for changes.
+ *
+ * Calling this again will stop watching the previous directory first.
+ *
+ * @param resources_path The absolute path to the resources folder to watch.
+ * @return true if the watcher was started, false otherwise.
+ */
+bool ye_init_hotreload(const char *resources_path);
+
+/**
+ * @brief Stops watching for changes and frees the watcher.
+ */
+void ye_shutdown_hotreload();
+
+/**
+ * @brief Drains pending file change events and reloads any affected assets.
+ *
+ * Called once per frame by @ref ye_process_frame, does nothing if the watcher is not running.
+ */
+void ye_hotreload_poll();
+
+/**
+ * @brief Reloads everything in the engine that references a resource handle.
+ *
+ * @param handle The path of the resource relative to the resources folder.
+ * @return int The number of references that were patched, or -1 if nothing referenced the handle.
+ */
+int ye_hotreload_asset(const char *handle);
+
+#endif
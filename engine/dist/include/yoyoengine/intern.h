@@ -0,0 +1,73 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file intern.h
+ * @brief Shared storage for the strings the engine compares over and over.
+ *
+ * Interning a string returns a pointer to the one stored copy of it. Every caller interning the
+ * same text gets the same pointer back, so two interned strings are equal exactly when their
+ * pointers are, and the text itself is only stored once no matter how many places hold it.
+ *
+ * Entity names, tags, renderer asset handles and the keys of the texture, font and color caches
+ * are all interned. Code that stores one of those fields must put an interned pointer there
+ * (ye_intern), and give it back (ye_intern_release) when it replaces or drops it.
+ *
+ * Interned strings are refcounted, the storage goes away when the last reference is released.
+ * They are read only, never write through one.
+ */
+
+#ifndef YE_INTERN_H
+#define YE_INTERN_H
+
+#include <stddef.h>
+
+/**
+ * @brief Interns a string, taking a reference to it.
+ *
+ * @param str The string, may be NULL
+ * @return const char* The stored copy (NULL for NULL), valid until the reference is released.
+ */
+const char * ye_intern(const char *str);
+
+/**
+ * @brief Takes another reference to an already interned string.
+ *
+ * @param interned A pointer returned from ye_intern, may be NULL
+ * @return const char* interned, for convenience.
+ */
+const char * ye_intern_retain(const char *interned);
+
+/**
+ * @brief Releases a reference, freeing the string when it was the last one.
+ *
+ * @param interned A pointer returned from ye_intern, may be NULL
+ */
+void ye_intern_release(const char *interned);
+
+/**
+ * @brief Looks a string up without interning it.
+ *
+ * Use this for lookups: anything keyed on an interned pointer cannot contain a string that was
+ * never interned, so a NULL return is already a miss.
+ *
+ * @param str The string
+ * @return const char* The interned copy, or NULL if nothing holds this string.
+ */
+const char * ye_intern_find(const char *str);
+
+/**
+ * @brief Returns how many distinct strings are interned.
+ */
+size_t ye_intern_count();
+
+/**
+ * @brief Frees every interned string, logging any that still had references.
+ */
+void ye_shutdown_intern();
+
+#endif
@@ -0,0 +1,80 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file jobs.h
+ * @brief A small pool of worker threads for running engine work off the main thread.
+ *
+ * Jobs are plain function pointers. Submitting a job bumps a counter, and the counter drops
+ * back when the job finishes, so callers can fan out any number of jobs and wait on them together.
+ *
+ * Jobs must not touch anything that is main thread only: the SDL renderer, lua states,
+ * nuklear or the event system.
+ *
+ * The worker count comes from `job_workers` in settings.yoyo (-1, the default, picks one less
+ * than the number of cores). With no workers (or on emscripten) jobs run inline when submitted.
+ */
+
+#ifndef YE_JOBS_H
+#define YE_JOBS_H
+
+#include <stdbool.h>
+
+#include <SDL.h>
+
+/**
+ * @brief Tracks how many submitted jobs have not finished yet.
+ * Zero initialize it before use.
+ */
+struct ye_job_counter {
+    SDL_atomic_t pending;
+};
+
+/**
+ * @brief The signature of a job.
+ */
+typedef void (*ye_job_fn)(void *data);
+
+/**
+ * @brief Spawns the worker threads.
+ *
+ * @param workers How many workers to spawn, -1 to pick from the core count.
+ */
+void ye_init_jobs(int workers);
+
+/**
+ * @brief Queues a job to run on a worker.
+ *
+ * @param fn The job.
+ * @param data Passed to the job.
+ * @param counter Incremented now and decremented when the job finishes, may be NULL.
+ */
+void ye_job_submit(ye_job_fn fn, void *data, struct ye_job_counter *counter);
+
+/**
+ * @brief Returns true if every job submitted against the counter has finished.
+ */
+bool ye_job_done(struct ye_job_counter *counter);
+
+/**
+ * @brief Blocks until every job submitted against the counter has finished.
+ * The calling thread helps run queued jobs submitted against the same counter while it waits,
+ * any other queued work is left to the workers.
+ */
+void ye_job_wait(struct ye_job_counter *counter);
+
+/**
+ * @brief Returns how many worker threads are running.
+ */
+int ye_job_worker_count();
+
+/**
+ * @brief Finishes any queued jobs and joins the workers.
+ */
+void ye_shutdown_jobs();
+
+#endif
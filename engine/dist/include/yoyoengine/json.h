@@ -28,6 +28,8 @@
 
 #include <jansson.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief Reads a JSON file and returns its content.
@@ -196,4 +198,67 @@ bool ye_json_arr_object(json_t* json, int index, json_t **out);
  */
 bool ye_json_arr_array(json_t* json, int index, json_t **out);
 
-#endif
\ No newline at end of file
+/*
+    Transient documents
+
+    Scenes, styles and animation meta are parsed, read once and thrown away. While an arena is
+    active (between ye_json_arena_begin and ye_json_arena_end), documents loaded with
+    ye_json_load_transient allocate their nodes from a bump arena instead of one heap block per
+    value, and the whole arena is dropped in one shot by the outermost ye_json_arena_end.
+
+    Arena documents are read only. Release them with ye_json_release (which skips the walk
+    json_decref would do) and do not keep any references into them past ye_json_arena_end.
+    Anything else parsed while the arena is active (by scripts, tricks or other threads) still uses the heap.
+*/
+
+/**
+ * @brief Opens an arena scope. Scopes nest, only the outermost end frees the arena.
+ */
+void ye_json_arena_begin();
+
+/**
+ * @brief Closes an arena scope, freeing every transient document loaded since the outermost begin.
+ */
+void ye_json_arena_end();
+
+/**
+ * @brief Frees the chunk the arena keeps around between scopes. Called on shutdown.
+ */
+void ye_shutdown_json_arena();
+
+/**
+ * @brief Loads a json resource (loose from resources/ in editor mode, packed otherwise) into the active arena.
+ * @param handle The resource handle, ex: "scenes/entry.yoyo"
+ * @return The document, or NULL on failure. Falls back to the heap when no arena is active.
+ * @note Release the document with ye_json_release.
+ */
+json_t* ye_json_load_transient(const char* handle);
+
+/**
+ * @brief Releases a document. Arena documents are left for ye_json_arena_end, anything else is json_decref'd.
+ * @param json The json_t object, may be NULL.
+ */
+void ye_json_release(json_t* json);
+
+/**
+ * @brief A key whose length and hash are computed once, for matching keys in hot loops.
+ * Declare them with YE_JSON_KEY, the hash is filled in on first use.
+ */
+struct ye_json_key {
+    const char *name;
+    size_t length;
+    uint32_t hash;
+};
+
+#define YE_JSON_KEY(str) { str, sizeof(str) - 1, 0 }
+
+/**
+ * @brief Finds which of a table of interned keys a key string is.
+ * @param keys The table of interned keys.
+ * @param count The number of keys in the table.
+ * @param key The key to look up.
+ * @return The index of the key in the table, or -1 if it is not in the table.
+ */
+int ye_json_key_index(struct ye_json_key *keys, int count, const char* key);
+
+#endif
@@ -13,6 +13,11 @@
 // #include <lua/lauxlib.h>
 #include <yoyoengine/ecs/lua_script.h>
 
+// LuaJIT implements the 5.1 api, give it the 5.2+ names the bindings use
+#if defined(YE_LUAJIT) && !defined(lua_rawlen)
+#define lua_rawlen lua_objlen
+#endif
+
 /**
  * @brief Takes in a lua state and registers the engine API with it.
  * 
@@ -70,7 +75,9 @@ void ye_lua_lua_script_register(lua_State *L);
 */
 
 void ye_run_lua_on_collision(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2);
+void ye_run_lua_on_collision_exit(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2);
 void ye_run_lua_on_trigger_enter(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2);
+void ye_run_lua_on_trigger_exit(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2);
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -90,6 +97,21 @@ int ye_read_cross_state_value(lua_State* L);
 
 int ye_lua_remove_component(lua_State* L);
 
+/**
+ * @brief Pushes the Entity table for a C entity, reusing the one this state already has if there is one.
+ *
+ * @param L The lua state (or one of its coroutines)
+ * @param entity The entity, NULL pushes nil
+ */
+void ye_lua_push_entity(lua_State *L, struct ye_entity *entity);
+
+/**
+ * @brief Drops the Entity table of an entity from every script state. Called when it is destroyed.
+ *
+ * @param entity The entity being destroyed
+ */
+void ye_lua_forget_entity(struct ye_entity *entity);
+
 //////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -100,6 +122,88 @@ int ye_lua_audio_register(lua_State *L);
 int ye_lua_scene_register(lua_State *L);
 int ye_lua_timer_register(lua_State *L);
 int ye_lua_input_register(lua_State *L);
+int ye_lua_coroutine_register(lua_State *L);
+int ye_lua_query_register(lua_State *L);
+int ye_lua_navigation_register(lua_State *L);
+int ye_lua_tween_register(lua_State *L);
+int ye_lua_observer_register(lua_State *L);
+
+//////////////////////////////////////////////////////////////////////////////
+
+/*
+    Coroutines (lua_subsystem_coroutine.c)
+*/
+
+/**
+ * @brief Resumes every lua coroutine whose wait has elapsed. Called once per frame by the scripting system.
+ */
+void ye_update_lua_coroutines();
+
+/**
+ * @brief Wakes every lua coroutine (across all scripts) waiting on a named event with waitUntil.
+ *
+ * @param event The name of the event.
+ */
+void ye_lua_coroutine_signal(const char *event);
+
+/**
+ * @brief Drops every coroutine belonging to a state. Must be called before the state is closed.
+ *
+ * @param L The main state of the script.
+ */
+void ye_lua_coroutines_purge_state(lua_State *L);
+
+/**
+ * @brief Resolves the main state of a script from any of its coroutine threads.
+ *
+ * @param L The running state.
+ * @return The main state, or L itself if it is one.
+ */
+lua_State * ye_lua_main_state(lua_State *L);
+
+/**
+ * @brief Frees the coroutine scheduler.
+ */
+void ye_shutdown_lua_coroutines();
+
+//////////////////////////////////////////////////////////////////////////////
+
+/*
+    Navigation (lua_subsystem_navigation.c)
+*/
+
+/**
+ * @brief Cancels every path request made from a state. Must be called before the state is closed.
+ *
+ * @param L The main state of the script.
+ */
+void ye_lua_navigation_purge_state(lua_State *L);
+
+//////////////////////////////////////////////////////////////////////////////
+
+/*
+    Tweens (lua_subsystem_tween.c)
+*/
+
+/**
+ * @brief Cancels every tween with an onComplete callback made from a state. Must be called before the state is closed.
+ *
+ * @param L The main state of the script.
+ */
+void ye_lua_tween_purge_state(lua_State *L);
+
+//////////////////////////////////////////////////////////////////////////////
+
+/*
+    Observers (lua_subsystem_observer.c)
+*/
+
+/**
+ * @brief Stops every observer made from a state. Must be called before the state is closed.
+ *
+ * @param L The main state of the script.
+ */
+void ye_lua_observer_purge_state(lua_State *L);
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,103 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file lua_memory.h
+ * @brief Pooled allocator and memory accounting for lua script states.
+ *
+ * Every script state allocates through a custom lua_Alloc. Small blocks (which is nearly
+ * everything lua allocates) come out of size class free lists carved from shared 64KB slabs,
+ * so hundreds of script heaps don't fragment the process heap. Larger blocks fall back to realloc.
+ *
+ * Each state tracks the bytes it has allocated, and can be given a limit. An allocation that
+ * would push a state over its limit fails, which lua turns into a "not enough memory" error
+ * inside the script instead of growing.
+ *
+ * The default limit comes from `lua_memory_limit_kb` in settings.yoyo (0 means unlimited).
+ *
+ * @note LuaJIT (YOYO_ENGINE_LUAJIT) does not support custom allocators on 64 bit, so there
+ * states use the default allocator and only report the usage of their garbage collector.
+ */
+
+#ifndef YE_LUA_MEMORY_H
+#define YE_LUA_MEMORY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <lua.h>
+
+/**
+ * @brief The largest block size that is served from the pools, anything bigger uses realloc.
+ */
+#define YE_LUA_POOL_MAX_BLOCK 512
+
+/**
+ * @brief The size of each slab the pools carve blocks from.
+ */
+#define YE_LUA_POOL_SLAB_SIZE (64 * 1024)
+
+/**
+ * @brief Memory accounting for a single lua state.
+ */
+struct ye_lua_memory {
+    size_t used;        // bytes currently allocated by the state
+    size_t peak;        // the most bytes the state has had allocated at once
+    size_t limit;       // the most bytes the state may allocate, 0 for unlimited
+    size_t blocks;      // number of live allocations
+    size_t refused;     // allocations refused because they would exceed the limit
+
+    size_t allocations; // blocks allocated or grown since the state was created
+    size_t allocated;   // bytes those asked for
+};
+
+/**
+ * @brief Creates a new lua state that allocates from the pools and reports into memory.
+ *
+ * @param memory The accounting struct for the state. Must outlive the state.
+ * @param limit The byte limit for the state, 0 for unlimited.
+ * @return lua_State* The new state, or NULL on failure.
+ */
+lua_State * ye_lua_new_state(struct ye_lua_memory *memory, size_t limit);
+
+/**
+ * @brief Returns the number of bytes a script state is using.
+ *
+ * Uses the allocator accounting when available, otherwise asks the garbage collector.
+ */
+size_t ye_lua_memory_used(lua_State *L, struct ye_lua_memory *memory);
+
+/**
+ * @brief Lua binding, returns the bytes the calling script's state is using, and how many
+ * allocations and bytes it has asked for since it was created (nil for both on LuaJIT).
+ *
+ * Benchmarks read it before and after running something to count what it allocates.
+ */
+int ye_lua_memory_stats(lua_State *L);
+
+/**
+ * @brief Lua binding, returns the live bytes, live allocations and peak bytes of the engine
+ * memory tag named by its argument (see ye_memory_tag_name), nil for an unknown tag.
+ */
+int ye_lua_engine_memory_stats(lua_State *L);
+
+/**
+ * @brief Returns the total bytes reserved for the pools, and how many of those are sitting unused.
+ */
+void ye_lua_memory_pool_stats(size_t *reserved, size_t *unused);
+
+/**
+ * @brief Debug overlay listing the memory of every script.
+ */
+void ye_lua_memory_overlay(struct nk_context *ctx);
+
+/**
+ * @brief Frees every pool slab. All lua states must have been closed beforehand.
+ */
+void ye_shutdown_lua_memory();
+
+#endif
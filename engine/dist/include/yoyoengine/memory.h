@@ -0,0 +1,157 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file memory.h
+ * @brief Tagged allocation tracking.
+ *
+ * Engine subsystems allocate through ye_malloc and friends, passing a tag for the subsystem the
+ * memory belongs to. Each tag tracks its live bytes, peak bytes and how many allocations it made
+ * in the last frame, which the "memory" debug overlay shows and ye_memory_report dumps as json.
+ *
+ * Builds with YE_MEMORY_CALLSITES defined (debug builds, see YOYO_ENGINE_BUILD_RELEASE) also
+ * attribute every allocation to the file and line that made it, so a leak or a hot spot of
+ * per frame churn can be traced to its source.
+ *
+ * Memory from ye_malloc must be freed with ye_free (and the other way around), it carries a
+ * small header the plain allocator does not know about. Anything handed to code outside the
+ * engine that will free() it must come from plain malloc.
+ *
+ * Textures live on the GPU, so they are not tracked as live memory. Creating one is counted
+ * with ye_memory_note, which shows up as per frame churn under YE_MEM_TEXTURE. Memory another
+ * library allocates and the engine keeps (mixer samples) is counted with ye_memory_adopt and
+ * ye_memory_release instead.
+ */
+
+#ifndef YE_MEMORY_H
+#define YE_MEMORY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <jansson.h>
+
+/**
+ * @brief The subsystem an allocation belongs to.
+ */
+enum ye_memory_tag {
+    YE_MEM_GENERAL,
+    YE_MEM_ECS,         // entities, names and components
+    YE_MEM_CACHE,       // texture, font and color cache nodes
+    YE_MEM_LUA,         // script state pools
+    YE_MEM_AUDIO,       // mixer cache
+    YE_MEM_YEP,         // pack file headers
+    YE_MEM_UI,
+    YE_MEM_SCENE,       // scene paths and names
+    YE_MEM_JSON,        // json arena chunks
+    YE_MEM_PHYSICS,     // broadphase and contact cache
+    YE_MEM_TEXTURE,     // only counted when created, see ye_memory_note
+    YE_MEM_STRINGS,     // interned strings
+
+    YE_MEM_TAG_COUNT
+};
+
+/**
+ * @brief The accounting for one tag.
+ */
+struct ye_memory_stats {
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t live_allocs;
+    size_t total_allocs;    // since startup
+
+    size_t frame_allocs;    // during the last full frame
+    size_t frame_bytes;
+};
+
+void * _ye_malloc(enum ye_memory_tag tag, size_t size, const char *file, int line);
+void * _ye_calloc(enum ye_memory_tag tag, size_t count, size_t size, const char *file, int line);
+void * _ye_realloc(enum ye_memory_tag tag, void *ptr, size_t size, const char *file, int line);
+char * _ye_strdup(enum ye_memory_tag tag, const char *str, const char *file, int line);
+
+/**
+ * @brief malloc, accounted to tag.
+ */
+#define ye_malloc(tag, size) _ye_malloc((tag), (size), __FILE__, __LINE__)
+
+/**
+ * @brief calloc, accounted to tag.
+ */
+#define ye_calloc(tag, count, size) _ye_calloc((tag), (count), (size), __FILE__, __LINE__)
+
+/**
+ * @brief realloc, accounted to tag. ptr may be NULL.
+ */
+#define ye_realloc(tag, ptr, size) _ye_realloc((tag), (ptr), (size), __FILE__, __LINE__)
+
+/**
+ * @brief strdup, accounted to tag.
+ */
+#define ye_strdup(tag, str) _ye_strdup((tag), (str), __FILE__, __LINE__)
+
+/**
+ * @brief Frees memory from ye_malloc, ye_calloc, ye_realloc or ye_strdup. NULL is ignored.
+ */
+void ye_free(void *ptr);
+
+/**
+ * @brief Counts an allocation made outside the tracker (a texture, for example) towards a tag's per frame numbers.
+ *
+ * @param tag The tag
+ * @param bytes Roughly how big it is
+ */
+void ye_memory_note(enum ye_memory_tag tag, size_t bytes);
+
+/**
+ * @brief Counts memory allocated outside the tracker as live under a tag, until ye_memory_release is called for it.
+ *
+ * @param tag The tag
+ * @param bytes How big it is
+ */
+void ye_memory_adopt(enum ye_memory_tag tag, size_t bytes);
+
+/**
+ * @brief Stops counting memory passed to ye_memory_adopt, once it has been freed.
+ *
+ * @param tag The tag it was adopted under
+ * @param bytes The same size it was adopted with
+ */
+void ye_memory_release(enum ye_memory_tag tag, size_t bytes);
+
+/**
+ * @brief Closes the per frame counters. Called once at the end of every frame.
+ */
+void ye_memory_end_frame();
+
+/**
+ * @brief Gets the accounting for a tag.
+ */
+struct ye_memory_stats ye_memory_stats(enum ye_memory_tag tag);
+
+/**
+ * @brief Gets the display name of a tag.
+ */
+const char * ye_memory_tag_name(enum ye_memory_tag tag);
+
+/**
+ * @brief Builds a json report of every tag (and every callsite, if they are tracked).
+ *
+ * @return json_t* A new reference, the caller must json_decref it.
+ */
+json_t * ye_memory_report();
+
+/**
+ * @brief Debug overlay listing every tag, and the busiest callsites if they are tracked.
+ */
+void ye_memory_overlay(struct nk_context *ctx);
+
+/**
+ * @brief Logs whatever is still allocated, writing memory_report.json in debug mode.
+ */
+void ye_shutdown_memory();
+
+#endif
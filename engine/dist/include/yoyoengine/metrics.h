@@ -0,0 +1,104 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file metrics.h
+ * @brief Counters, gauges and histograms, exported to a local sink for charting long runs.
+ *
+ * Every frame the engine records its own numbers (frame time, per system time, draw calls, cache
+ * lookups, lua pool memory, tagged memory, playing voices), and every metrics_interval_ms it writes
+ * all of them to the sink picked in settings.yoyo:
+ *
+ * - "textfile": a Prometheus text exposition file (metrics_target, default metrics.prom next to
+ *   the executable), replaced atomically, for node_exporter's textfile collector
+ * - "statsd": statsd lines over UDP (metrics_target, default 127.0.0.1:8125)
+ * - "unix": statsd lines to a unix datagram socket (metrics_target, default yoyo_metrics.sock
+ *   next to the executable), not available on windows
+ * - "none" (default): nothing is recorded
+ *
+ * Games and tricks can add their own metrics. Look one up once with ye_metric and keep the id,
+ * recording through it is a store. Everything here is main thread only.
+ *
+ * statsd has no histograms, so each one is sent as the average and max over the interval plus a
+ * count. Labels become the last part of the statsd name (yoyo.system_time_ms.physics.avg).
+ */
+
+#ifndef YE_METRICS_H
+#define YE_METRICS_H
+
+#include <stdbool.h>
+
+#ifndef YE_METRICS_MAX
+    #define YE_METRICS_MAX 128
+#endif
+
+enum ye_metric_type {
+    YE_METRIC_COUNTER,      // only goes up
+    YE_METRIC_GAUGE,        // the current value of something
+    YE_METRIC_HISTOGRAM,    // a distribution of samples, bucketed in milliseconds
+};
+
+/**
+ * @brief Starts exporting to the sink configured in settings.yoyo, does nothing for "none".
+ */
+void ye_init_metrics();
+
+/**
+ * @brief Whether a sink is open, and metrics are being recorded.
+ */
+bool ye_metrics_enabled();
+
+/**
+ * @brief Finds or registers a metric.
+ *
+ * @param name The name, lowercase with underscores (it gets a yoyo prefix when exported)
+ * @param help A description for the Prometheus HELP line
+ * @param type What kind of metric it is, must match an earlier registration of the same name
+ * @return int The metric, or -1 if the registry is full, the type does not match or metrics are off.
+ */
+int ye_metric(const char *name, const char *help, enum ye_metric_type type);
+
+/**
+ * @brief Finds or registers one series of a labeled metric, ex: ("system_time_ms", ..., "system", "physics").
+ *
+ * @return int The metric, or -1 (see ye_metric).
+ */
+int ye_metric_labeled(const char *name, const char *help, enum ye_metric_type type, const char *label, const char *value);
+
+/**
+ * @brief Adds to a counter (or a gauge). Invalid metrics (-1) are ignored, as they are for the functions below.
+ */
+void ye_metric_add(int metric, double value);
+
+/**
+ * @brief Sets a gauge, or a counter that is tracked somewhere else as a running total.
+ */
+void ye_metric_set(int metric, double value);
+
+/**
+ * @brief Records a sample in a histogram.
+ */
+void ye_metric_observe(int metric, double value);
+
+/**
+ * @brief Records the engine's numbers for the frame, and writes to the sink when the interval is up.
+ *
+ * Called at the end of every frame.
+ */
+void ye_metrics_frame();
+
+/**
+ * @brief Writes every metric to the sink now.
+ */
+void ye_metrics_flush();
+
+/**
+ * @brief Writes a last time and closes the sink.
+ */
+void ye_shutdown_metrics();
+
+#endif
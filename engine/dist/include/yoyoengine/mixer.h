@@ -0,0 +1,157 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file mixer.h
+ * @brief The engine's software mixer, which plays sound effects through a graph of buses.
+ *
+ * SDL_mixer still opens the device, decodes chunks and streams music, but sound effects no longer
+ * go through its channels. They play on engine voices, which are mixed (with SSE2 or NEON where
+ * available) into buses by a postmix callback running on the audio thread.
+ *
+ * Buses form a tree under YE_BUS_MASTER. Every bus has a gain and an optional low pass filter,
+ * and mixes into its parent. Music from SDL_mixer enters the graph on YE_BUS_MUSIC.
+ *
+ * Everything here is called from the main thread. Starting a voice, changing a gain or a filter
+ * only stores to atomics the audio thread picks up on its next block, nothing waits on it.
+ * Only halting everything (ye_mixer_halt) and offline rendering synchronize with the mix.
+ */
+
+#ifndef YE_MIXER_H
+#define YE_MIXER_H
+
+#include <stdbool.h>
+
+#include <SDL_mixer.h>
+
+#ifndef YE_MIXER_MAX_VOICES
+    #define YE_MIXER_MAX_VOICES 64
+#endif
+
+#ifndef YE_MIXER_MAX_BUSES
+    #define YE_MIXER_MAX_BUSES 16
+#endif
+
+/**
+ * @brief The buses that always exist. Custom buses get ids after these.
+ */
+enum ye_mixer_bus {
+    YE_BUS_MASTER,
+    YE_BUS_MUSIC,   // everything SDL_mixer plays itself
+    YE_BUS_SFX,     // ye_play_sound and audiosources
+    YE_BUS_UI,
+
+    YE_BUS_BUILTIN_COUNT
+};
+
+/**
+ * @brief Starts the mixer on the device SDL_mixer opened. Called from ye_init_audio.
+ *
+ * @return true The device is stereo S16 or F32 and voices can play.
+ */
+bool ye_init_mixer();
+
+/**
+ * @brief Stops every voice and detaches the mixer from SDL_mixer.
+ */
+void ye_shutdown_mixer();
+
+/**
+ * @brief Starts playing a chunk. The chunk must outlive the voice (see ye_mixer_halt).
+ *
+ * @param chunk The chunk, in the device format
+ * @param bus The bus to play on
+ * @param loops How many extra times to play it, -1 for forever
+ * @param gain The starting gain of both sides
+ * @return int The voice, or -1 if every voice is busy.
+ */
+int ye_mixer_play(Mix_Chunk *chunk, int bus, int loops, float gain);
+
+/**
+ * @brief Stops a voice. Stale or invalid voices are ignored.
+ */
+void ye_mixer_stop(int voice);
+
+/**
+ * @brief Sets the gain of each side of a voice, it ramps there over the next block.
+ */
+void ye_mixer_set_voice_gain(int voice, float left, float right);
+
+/**
+ * @brief Whether a voice is still playing (or about to).
+ */
+bool ye_mixer_voice_playing(int voice);
+
+/**
+ * @brief How many voices are playing (or about to).
+ */
+int ye_mixer_active_voices();
+
+/**
+ * @brief Registers the function told about voices that finished on their own, called from ye_mixer_update.
+ */
+void ye_mixer_voice_finished(void (*callback)(int voice));
+
+/**
+ * @brief Recycles finished voices and runs the finished callback for each. Called once a frame.
+ */
+void ye_mixer_update();
+
+/**
+ * @brief Creates a bus.
+ *
+ * @param name The name, for looking it up
+ * @param parent The bus it mixes into
+ * @return int The bus, or -1 if there is no room or the parent does not exist.
+ */
+int ye_mixer_create_bus(const char *name, int parent);
+
+/**
+ * @brief Finds a bus by name.
+ *
+ * @return int The bus, or -1.
+ */
+int ye_mixer_find_bus(const char *name);
+
+/**
+ * @brief Sets the gain of a bus (1 is unchanged).
+ */
+void ye_mixer_set_bus_gain(int bus, float gain);
+
+/**
+ * @brief Gets the gain of a bus.
+ */
+float ye_mixer_get_bus_gain(int bus);
+
+/**
+ * @brief Sets the cutoff of a bus's low pass filter in Hz, 0 turns it off.
+ */
+void ye_mixer_set_bus_lowpass(int bus, float cutoff);
+
+/**
+ * @brief Stops every voice and waits until the audio thread is done with them.
+ *
+ * Call this before freeing chunks that may be playing. Finished callbacks are not run.
+ */
+void ye_mixer_halt();
+
+/**
+ * @brief Renders the mixer offline into a wav file.
+ *
+ * The voices and buses are advanced by exactly the rendered length, while the device keeps
+ * running (the dummy driver works) but plays only SDL_mixer's own output. Music is not part
+ * of the render. This is how the mixer is checked headless:
+ *
+ *     SDL_AUDIODRIVER=dummy, ye_play_sound(...), ye_mixer_render_wav("out.wav", 2.0f)
+ *
+ * @param path Where to write the wav
+ * @param seconds How much to render
+ * @return true The file was written.
+ */
+bool ye_mixer_render_wav(const char *path, float seconds);
+
+#endif
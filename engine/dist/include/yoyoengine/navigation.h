@@ -0,0 +1,165 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file navigation.h
+ * @brief Grid pathfinding, run on the job workers.
+ *
+ * The navigation grid covers a rect of the world with square cells that are either free or blocked.
+ * It can be built from the static colliders in the scene (the "navigation" settings of a scene do this
+ * on load), or filled in by hand (from tilemap data, for example).
+ *
+ * Paths are found with A* over the 8 neighbours of a cell (diagonals may not cut corners), and are
+ * shortened afterwards by skipping every waypoint the path can see past. Free cells are labelled
+ * with the connected region they belong to whenever the grid changes, so a request for an
+ * unreachable goal is answered immediately instead of searching the whole grid.
+ *
+ * Requests made with ye_nav_request_path are searched on the job workers (see jobs.h) and
+ * delivered to their callbacks on the main thread, at the start of a later frame. Searches read an
+ * immutable snapshot of the grid, so it is safe to edit the grid while they are running; edits are
+ * published to new requests once per frame (or on the next request).
+ *
+ * Recently found paths are cached by start and goal cell. Any change to the grid empties the cache.
+ */
+
+#ifndef YE_NAVIGATION_H
+#define YE_NAVIGATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <yoyoengine/utils.h>
+#include <yoyoengine/ecs/ecs.h>
+
+/**
+ * @brief How many found paths are kept around for repeat requests.
+ */
+#ifndef YE_NAV_CACHE_SIZE
+    #define YE_NAV_CACHE_SIZE 128
+#endif
+
+/**
+ * @brief The most cells a navigation grid can have.
+ */
+#define YE_NAV_MAX_CELLS (2048 * 2048)
+
+/**
+ * @brief A found path, handed to request callbacks.
+ */
+struct ye_nav_path {
+    bool found;                         /**< false if the goal is unreachable (or outside the grid) */
+    const struct ye_vec2f *points;      /**< Waypoints in world space, from the start to the goal. Only valid during the callback */
+    int count;                          /**< Number of points */
+};
+
+/**
+ * @brief Called on the main thread once a requested path has been searched.
+ *
+ * @param request The handle ye_nav_request_path returned
+ * @param path The result
+ * @param data The pointer passed to ye_nav_request_path
+ */
+typedef void (*ye_nav_callback)(unsigned int request, const struct ye_nav_path *path, void *data);
+
+/**
+ * @brief Sets up the navigation subsystem, with no grid.
+ */
+void ye_init_navigation();
+
+/**
+ * @brief Replaces the grid with an empty (all free) one.
+ *
+ * @param bounds The area of the world it covers
+ * @param cell_size The side length of a cell, in pixels
+ * @return false if the grid would be empty or larger than YE_NAV_MAX_CELLS
+ */
+bool ye_nav_build(struct ye_rectf bounds, float cell_size);
+
+/**
+ * @brief Blocks every cell overlapped by an active, non trigger, static collider.
+ *
+ * @param layers Only colliders on these layers (YE_PHYSICS_LAYER_BIT), 0 for any
+ */
+void ye_nav_block_colliders(uint32_t layers);
+
+/**
+ * @brief Blocks or frees a single cell.
+ *
+ * @param x The cell column
+ * @param y The cell row
+ * @param blocked Whether the cell can not be walked through
+ */
+void ye_nav_set_cell(int x, int y, bool blocked);
+
+/**
+ * @brief Blocks or frees the cell under a point in world space.
+ */
+void ye_nav_set_blocked(struct ye_vec2f point, bool blocked);
+
+/**
+ * @brief Copies a whole row major map of cells in, for example from tilemap data.
+ *
+ * @param cells width * height values, non zero meaning blocked
+ * @param width Must match the grid
+ * @param height Must match the grid
+ * @return false if there is no grid or the size does not match
+ */
+bool ye_nav_set_cells(const uint8_t *cells, int width, int height);
+
+/**
+ * @brief Returns true if the cell under a point is blocked (or the point is outside the grid).
+ */
+bool ye_nav_is_blocked(struct ye_vec2f point);
+
+/**
+ * @brief Removes the grid. Requests fail until a new one is built.
+ */
+void ye_nav_clear();
+
+/**
+ * @brief Finds a path right away, on the calling (main) thread.
+ *
+ * @param start Where the path starts, in world space
+ * @param goal Where the path ends, in world space
+ * @param points Filled with the waypoints, may be NULL to only ask for the length
+ * @param max_points The length of points
+ * @return The number of waypoints in the whole path (which may be more than max_points), 0 if there is no path
+ */
+int ye_nav_find_path(struct ye_vec2f start, struct ye_vec2f goal, struct ye_vec2f *points, int max_points);
+
+/**
+ * @brief Queues a path to be found on the job workers.
+ *
+ * The callback is always called exactly once (on a later frame, on the main thread) unless the
+ * request is cancelled first.
+ *
+ * @param start Where the path starts, in world space
+ * @param goal Where the path ends, in world space
+ * @param callback Receives the path
+ * @param data Passed to the callback
+ * @return A handle for ye_nav_cancel, never 0
+ */
+unsigned int ye_nav_request_path(struct ye_vec2f start, struct ye_vec2f goal, ye_nav_callback callback, void *data);
+
+/**
+ * @brief Cancels a request, its callback will not be called.
+ *
+ * @param request The handle ye_nav_request_path returned
+ */
+void ye_nav_cancel(unsigned int request);
+
+/**
+ * @brief Publishes grid edits and delivers finished requests. Runs once per frame as the "navigation" system.
+ */
+void ye_system_navigation();
+
+/**
+ * @brief Waits for any running searches and frees everything.
+ */
+void ye_shutdown_navigation();
+
+#endif
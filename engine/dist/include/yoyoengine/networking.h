@@ -10,8 +10,14 @@
 
 #include <SDL_net.h>
 
+/**
+ * @brief Starts SDL_net. The engine does not do this at startup, call it before using SDL_net, extra calls do nothing.
+ */
 void ye_init_networking();
 
+/**
+ * @brief Stops SDL_net if it was started, called by the engine at shutdown.
+ */
 void ye_shutdown_networking();
 
 #endif // YE_NETWORKING_H
\ No newline at end of file
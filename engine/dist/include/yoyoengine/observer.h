@@ -0,0 +1,115 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file observer.h
+ * @brief Callbacks for components being added, removed or modified, and for button state changes.
+ *
+ * Instead of checking every frame whether something happened (ye_button_clicked in an update,
+ * comparing positions), register an observer and get called when it does.
+ *
+ * Changes are not delivered as they happen. They are recorded into one buffer per component
+ * type during the frame and dispatched together by the "observers" system, which runs after
+ * scripts and tweens and before rendering. Within a component type changes arrive in the order
+ * they happened, types are dispatched in enum ye_component_type order. Changes made by an
+ * observer are delivered on the next frame. Nothing is recorded for a component type nobody
+ * observes, so unobserved changes cost one mask test.
+ *
+ * Modifications are reported by whatever writes the component through the engine: the lua
+ * component bindings, physics moving a transform and tweens. A component modified several
+ * times in one frame is reported once. Code that writes component fields directly (C, or lua
+ * through FFI component views) calls ye_component_modified itself if anyone should hear about it.
+ */
+
+#ifndef YE_OBSERVER_H
+#define YE_OBSERVER_H
+
+#include <stdbool.h>
+
+#include <yoyoengine/utils.h>
+#include <yoyoengine/ecs/ecs.h>
+
+/**
+ * @brief What happened, or'd together to observe several at once.
+ */
+enum ye_observe_kind {
+    YE_OBSERVE_ADDED            = 1 << 0,
+    YE_OBSERVE_REMOVED          = 1 << 1,   ///< also sent for each component of a destroyed entity
+    YE_OBSERVE_MODIFIED         = 1 << 2,
+    YE_OBSERVE_BUTTON_HOVER     = 1 << 3,   ///< the mouse moved onto a button
+    YE_OBSERVE_BUTTON_UNHOVER   = 1 << 4,   ///< the mouse left a button
+    YE_OBSERVE_BUTTON_PRESS     = 1 << 5,   ///< the mouse went down on a button
+    YE_OBSERVE_BUTTON_RELEASE   = 1 << 6,   ///< the button stopped being pressed, by release or by the mouse leaving
+    YE_OBSERVE_BUTTON_CLICK     = 1 << 7,   ///< the mouse went down and up on a button
+};
+
+#define YE_OBSERVE_KIND_COUNT 8
+
+/**
+ * @brief One recorded change, as handed to an observer.
+ */
+struct ye_change {
+    struct ye_entity *entity;   ///< NULL if the entity was destroyed before the change was dispatched
+    int entity_id;
+    int component;              ///< enum ye_component_type
+    enum ye_observe_kind kind;
+};
+
+/**
+ * @brief Starts observing changes to a component type.
+ *
+ * Changes to entities destroyed before the dispatch are only delivered if they are removals.
+ * An observer watching a single entity is dropped when that entity is destroyed.
+ *
+ * @param component The component type (enum ye_component_type), button kinds need YE_COMPONENT_BUTTON.
+ * @param kinds The enum ye_observe_kind values to be called for.
+ * @param entity Only report changes to this entity, NULL for every entity.
+ * @param callback Called once per change.
+ * @param data Passed to the callback.
+ * @return unsigned int A handle for ye_unobserve, 0 if the observer could not be registered.
+ */
+unsigned int ye_observe(int component, int kinds, struct ye_entity *entity, void (*callback)(const struct ye_change *change, void *data), void *data);
+
+/**
+ * @brief Stops an observer. Safe to call from inside its own callback.
+ *
+ * @param observer The handle ye_observe returned.
+ * @return true if it was observing.
+ */
+bool ye_unobserve(unsigned int observer);
+
+/**
+ * @brief Reports that a component of an entity was modified.
+ *
+ * Moving a static collider (its transform or its collider) also marks the physics broadphase for a rebuild.
+ *
+ * @param entity The entity.
+ * @param component The component type (enum ye_component_type).
+ */
+void ye_component_modified(struct ye_entity *entity, int component);
+
+/**
+ * @brief Records a change for the next dispatch. Called by the ECS and the button system.
+ */
+void ye_observer_record(struct ye_entity *entity, int component, enum ye_observe_kind kind);
+
+/**
+ * @brief Detaches pending changes and observers from an entity being destroyed. Called by ye_destroy_entity.
+ */
+void ye_observer_forget_entity(struct ye_entity *entity);
+
+/**
+ * @brief Delivers every change recorded since the last dispatch. Run once per frame by the scheduler.
+ */
+void ye_system_observers();
+
+/**
+ * @brief Drops every observer and pending change.
+ */
+void ye_shutdown_observers();
+
+#endif
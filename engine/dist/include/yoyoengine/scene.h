@@ -28,6 +28,20 @@ void ye_init_scene_manager();
  */
 void ye_load_scene(const char *scene_name);
 
+/**
+ * @brief Starts parsing a scene on a worker thread, the next ye_load_scene of the same path uses the result.
+ * 
+ * The engine preloads the entry scene while it starts up. Only one scene is preloaded at a time.
+ * 
+ * @param scene_path The scene to parse
+ */
+void ye_preload_scene(const char *scene_path);
+
+/**
+ * @brief Whether the preloaded scene is parsed (true when nothing is preloading), loading it will not wait
+ */
+bool ye_scene_preload_ready();
+
 /**
  * @brief Reloads the current scene from disk
  */
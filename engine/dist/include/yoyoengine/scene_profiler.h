@@ -0,0 +1,130 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file scene_profiler.h
+ * @brief Breaks down where the time in @ref ye_load_scene goes.
+ *
+ * While a scene is loading, the engine records:
+ * - the time spent in each phase of the load (audio reinit, ecs purge, parsing, styles, pre caching, construction)
+ * - the time spent constructing each component type, and how many were constructed
+ * - for each asset touched, the time spent reading it out of its pack, decompressing it,
+ *   decoding it and uploading it to the GPU, along with the bytes read
+ *
+ * The last report can be viewed in the "scene_load" debug overlay, fetched as json with
+ * @ref ye_scene_profiler_report, and is written to `scene_load_profile.json` next to the
+ * executable when the engine is in debug mode.
+ *
+ * Outside of a scene load every recording function is a no-op.
+ */
+
+#ifndef YE_SCENE_PROFILER_H
+#define YE_SCENE_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <jansson.h>
+
+/**
+ * @brief The phases of a scene load, in the order they happen.
+ */
+enum ye_scene_load_phase {
+    YE_SCENE_LOAD_PHASE_AUDIO,      // audio subsystem shutdown and reinit
+    YE_SCENE_LOAD_PHASE_PURGE_ECS,  // destroying the previous scene
+    YE_SCENE_LOAD_PHASE_PARSE,      // reading and parsing the scene file
+    YE_SCENE_LOAD_PHASE_STYLES,     // pre caching styles files
+    YE_SCENE_LOAD_PHASE_PRE_CACHE,  // pre caching the scenes assets
+    YE_SCENE_LOAD_PHASE_CONSTRUCT,  // constructing entities and components
+    YE_SCENE_LOAD_PHASE_FINALIZE,   // default camera, music and load callbacks
+    YE_SCENE_LOAD_PHASE_COUNT
+};
+
+/**
+ * @brief The stages an individual asset goes through while being loaded.
+ */
+enum ye_asset_load_stage {
+    YE_ASSET_LOAD_READ,         // seeking and reading the raw bytes
+    YE_ASSET_LOAD_DECOMPRESS,   // inflating compressed pack data
+    YE_ASSET_LOAD_DECODE,       // turning bytes into a surface, chunk, font or json
+    YE_ASSET_LOAD_UPLOAD,       // creating a GPU texture from a surface
+    YE_ASSET_LOAD_STAGE_COUNT
+};
+
+/**
+ * @brief Returns whether a scene load is currently being profiled on the calling thread.
+ *
+ * Only the thread running the load records anything, calls from worker threads are ignored.
+ */
+bool ye_scene_profiler_active();
+
+/**
+ * @brief Returns a timestamp to pass into the recording functions.
+ *
+ * @return uint64_t The current performance counter, or 0 if no load is being profiled.
+ */
+uint64_t ye_scene_profiler_now();
+
+/**
+ * @brief Starts profiling a scene load, discarding the previous report.
+ *
+ * @param scene_path The handle of the scene being loaded.
+ */
+void ye_scene_profiler_begin(const char *scene_path);
+
+/**
+ * @brief Finishes profiling the current scene load.
+ *
+ * Logs a short summary, and in debug mode writes the full report to `scene_load_profile.json`.
+ */
+void ye_scene_profiler_end();
+
+/**
+ * @brief Records time spent in a load phase.
+ *
+ * @param phase The phase the time belongs to.
+ * @param start The timestamp (from @ref ye_scene_profiler_now) the phase started at.
+ */
+void ye_scene_profiler_phase(enum ye_scene_load_phase phase, uint64_t start);
+
+/**
+ * @brief Records the construction of a single component.
+ *
+ * @param type The name of the component type, ex: "renderer".
+ * @param start The timestamp the construction started at.
+ */
+void ye_scene_profiler_component(const char *type, uint64_t start);
+
+/**
+ * @brief Records time spent on one stage of loading an asset.
+ *
+ * @param handle The handle of the asset.
+ * @param stage The stage the time belongs to.
+ * @param start The timestamp the stage started at.
+ * @param bytes The number of bytes read from disk during this stage (0 if none).
+ */
+void ye_scene_profiler_asset(const char *handle, enum ye_asset_load_stage stage, uint64_t start, size_t bytes);
+
+/**
+ * @brief Builds a json report of the last profiled scene load.
+ *
+ * @return json_t* A new json object the caller owns, or NULL if no scene has been profiled.
+ */
+json_t * ye_scene_profiler_report();
+
+/**
+ * @brief Debug overlay showing the last profiled scene load.
+ */
+void ye_scene_profiler_overlay(struct nk_context *ctx);
+
+/**
+ * @brief Frees the last report.
+ */
+void ye_shutdown_scene_profiler();
+
+#endif
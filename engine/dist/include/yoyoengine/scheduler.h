@@ -0,0 +1,128 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file scheduler.h
+ * @brief Registry of the systems that run every frame, and the scheduler that orders them.
+ *
+ * Each system declares which components it reads and writes, plus optional names of systems
+ * it must run before or after. The first frame after the registry changes, the scheduler builds
+ * a dependency graph:
+ * - explicit before/after constraints become edges
+ * - two systems that touch the same component, where at least one writes it, are ordered by registration
+ *
+ * The graph is split into stages. Systems in the same stage never conflict, so the ones not
+ * flagged YE_SYSTEM_MAIN_THREAD are handed to the job system (see jobs.h) and run alongside the
+ * main thread ones.
+ *
+ * Tricks can register their own systems from yoyo_trick_init, in addition to on_update.
+ */
+
+#ifndef YE_SCHEDULER_H
+#define YE_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <yoyoengine/utils.h>
+
+/**
+ * @brief Reads or writes every component. Use this for anything that calls out into user code.
+ */
+#define YE_COMPONENT_BITS_ALL 0xFFFFFFFFu
+
+/**
+ * @brief The most before/after constraints a system can declare.
+ */
+#define YE_SYSTEM_MAX_CONSTRAINTS 4
+
+/**
+ * @brief The most systems that can be registered at once.
+ */
+#define YE_SYSTEM_MAX 64
+
+enum ye_system_flags {
+    YE_SYSTEM_MAIN_THREAD   = 1 << 0,   // touches SDL rendering, lua, nuklear or events
+    YE_SYSTEM_EDITOR        = 1 << 1,   // also runs while in the editor (runtime only by default)
+};
+
+/**
+ * @brief Describes a system to the scheduler.
+ */
+struct ye_system_desc {
+    const char *name;                                   // unique, copied on registration
+    void (*run)(void *data);
+    void *data;                                         // passed to run
+
+    uint32_t reads;                                     // YE_COMPONENT_BIT set of components read
+    uint32_t writes;                                    // YE_COMPONENT_BIT set of components written
+
+    const char *after[YE_SYSTEM_MAX_CONSTRAINTS];       // systems that must finish before this one
+    const char *before[YE_SYSTEM_MAX_CONSTRAINTS];      // systems that must wait for this one
+
+    int flags;                                          // enum ye_system_flags
+};
+
+/**
+ * @brief Timing of a system, in milliseconds.
+ */
+struct ye_system_timing {
+    float last;
+    float average;      // exponential moving average
+    float peak;         // since the graph was last rebuilt
+};
+
+/**
+ * @brief Sets up the registry and registers the engine systems.
+ */
+void ye_init_scheduler();
+
+/**
+ * @brief Registers a system, replacing any existing system with the same name.
+ *
+ * @param desc The system description.
+ * @return true on success, false if the registry is full or the description is invalid.
+ */
+bool ye_register_system(struct ye_system_desc desc);
+
+/**
+ * @brief Removes a system.
+ *
+ * @param name The name it was registered with.
+ * @return true if it was found.
+ */
+bool ye_unregister_system(const char *name);
+
+/**
+ * @brief Runs every registered system for this frame, in dependency order.
+ */
+void ye_run_systems();
+
+/**
+ * @brief Gets the timing of a system.
+ *
+ * @param name The system name.
+ * @return The timing, or NULL if there is no such system.
+ */
+const struct ye_system_timing * ye_system_timing(const char *name);
+
+/**
+ * @brief Calls fn with the name and timing of every system that runs in the current mode.
+ */
+void ye_each_system_timing(void (*fn)(const char *name, const struct ye_system_timing *timing, void *data), void *data);
+
+/**
+ * @brief Debug overlay listing the stages and per system timings.
+ */
+void ye_scheduler_overlay(struct nk_context *ctx);
+
+/**
+ * @brief Frees the registry.
+ */
+void ye_shutdown_scheduler();
+
+#endif
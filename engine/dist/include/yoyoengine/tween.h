@@ -0,0 +1,179 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+/**
+ * @file tween.h
+ * @brief Interpolates component properties over time.
+ *
+ * Tweens are kept in one packed array and all advanced in a single pass per frame (the "tween"
+ * system, which runs after scripts and before rendering), so thousands of them cost next to
+ * nothing. Once a tween is started nothing needs to touch it again until it finishes.
+ *
+ * A tween that finishes fires YE_EVENT_TWEEN_COMPLETE and its own callback, if it has one.
+ * Looping tweens never finish on their own. Destroying the target entity (or removing the
+ * component a tween animates) drops its tweens.
+ */
+
+#ifndef YE_TWEEN_H
+#define YE_TWEEN_H
+
+#include <stdbool.h>
+
+#include <yoyoengine/ecs/ecs.h>
+
+/**
+ * @brief The properties a tween can animate.
+ */
+enum ye_tween_property {
+    YE_TWEEN_TRANSFORM_X,
+    YE_TWEEN_TRANSFORM_Y,
+    YE_TWEEN_RENDERER_ALPHA,        ///< 0-255
+    YE_TWEEN_RENDERER_ROTATION,     ///< degrees
+    YE_TWEEN_RENDERER_WIDTH,
+    YE_TWEEN_RENDERER_HEIGHT,
+    YE_TWEEN_CAMERA_WIDTH,          ///< the view field, so tweening it zooms
+    YE_TWEEN_CAMERA_HEIGHT,
+
+    YE_TWEEN_PROPERTY_COUNT
+};
+
+/**
+ * @brief Easing curves, see https://easings.net for what they look like.
+ */
+enum ye_tween_easing {
+    YE_EASE_LINEAR,
+    YE_EASE_IN_QUAD,
+    YE_EASE_OUT_QUAD,
+    YE_EASE_IN_OUT_QUAD,
+    YE_EASE_IN_CUBIC,
+    YE_EASE_OUT_CUBIC,
+    YE_EASE_IN_OUT_CUBIC,
+    YE_EASE_IN_SINE,
+    YE_EASE_OUT_SINE,
+    YE_EASE_IN_OUT_SINE,
+    YE_EASE_IN_EXPO,
+    YE_EASE_OUT_EXPO,
+    YE_EASE_IN_BACK,
+    YE_EASE_OUT_BACK,
+    YE_EASE_OUT_ELASTIC,
+    YE_EASE_OUT_BOUNCE,
+
+    YE_EASE_COUNT
+};
+
+/**
+ * @brief What a tween does when it reaches the end.
+ */
+enum ye_tween_loop {
+    YE_TWEEN_ONCE,          ///< stops and finishes
+    YE_TWEEN_RESTART,       ///< jumps back to the start
+    YE_TWEEN_PINGPONG,      ///< plays backwards, then forwards again
+};
+
+/**
+ * @brief Called when a tween ends.
+ *
+ * @param tween The handle ye_tween_start returned
+ * @param entity The entity it animated, NULL if it was dropped because the entity was destroyed
+ * @param finished true if it reached the end, false if it was dropped because its target went away
+ * @param data The pointer in the tween description
+ */
+typedef void (*ye_tween_callback)(unsigned int tween, struct ye_entity *entity, bool finished, void *data);
+
+/**
+ * @brief Describes a tween to start.
+ */
+struct ye_tween_desc {
+    struct ye_entity *entity;
+    enum ye_tween_property property;
+
+    float from;                     ///< ignored if from_current is set
+    float to;
+    bool from_current;              ///< start from whatever the value is once the delay is over
+
+    float duration;                 ///< seconds
+    float delay;                    ///< seconds before it starts moving
+    enum ye_tween_easing easing;
+    enum ye_tween_loop loop;
+
+    ye_tween_callback on_complete;  ///< optional, called exactly once unless the tween is cancelled
+    void *data;                     ///< passed to on_complete
+};
+
+/**
+ * @brief Starts a tween.
+ *
+ * @param desc The description, copied.
+ * @return A handle for ye_tween_cancel, or 0 if the entity lacks the component the property belongs to.
+ */
+unsigned int ye_tween_start(struct ye_tween_desc desc);
+
+/**
+ * @brief Stops a tween where it is, without calling its callback.
+ *
+ * Also works on a tween that ended this frame but whose callback has not run yet, the callback is dropped.
+ *
+ * @param tween The handle ye_tween_start returned
+ * @return true if it was still running, or its callback was still pending
+ */
+bool ye_tween_cancel(unsigned int tween);
+
+/**
+ * @brief Stops every tween on an entity, without calling their callbacks.
+ *
+ * Callbacks of its tweens that ended this frame and have not run yet are dropped as well.
+ *
+ * @param entity The target
+ * @param property Only tweens of this property, or YE_TWEEN_PROPERTY_COUNT for all of them
+ * @return How many were stopped
+ */
+int ye_tween_cancel_entity(struct ye_entity *entity, enum ye_tween_property property);
+
+/**
+ * @brief Drops the tweens on an entity that is being destroyed. Their callbacks get finished = false.
+ */
+void ye_tween_forget(struct ye_entity *entity);
+
+/**
+ * @brief Looks up an easing by name ("linear", "outQuad", "inOutSine", ...).
+ *
+ * @return The easing, or YE_EASE_COUNT if there is none by that name
+ */
+enum ye_tween_easing ye_tween_easing_from_name(const char *name);
+
+/**
+ * @brief Looks up a property by name ("x", "y", "alpha", "rotation", "width", "height", "cameraWidth", "cameraHeight").
+ *
+ * @return The property, or YE_TWEEN_PROPERTY_COUNT if there is none by that name
+ */
+enum ye_tween_property ye_tween_property_from_name(const char *name);
+
+/**
+ * @brief Evaluates an easing curve.
+ *
+ * @param easing The curve
+ * @param t Progress, from 0 to 1
+ * @return The eased progress (which can overshoot 0-1 for back and elastic curves)
+ */
+float ye_ease(enum ye_tween_easing easing, float t);
+
+/**
+ * @brief How many tweens are running.
+ */
+int ye_tween_count();
+
+/**
+ * @brief Advances every tween. Runs once per frame as the "tween" system.
+ */
+void ye_system_tween();
+
+/**
+ * @brief Drops every tween, calling callbacks with finished = false.
+ */
+void ye_shutdown_tween();
+
+#endif
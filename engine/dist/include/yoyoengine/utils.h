@@ -98,6 +98,16 @@ enum ye_component_type {
     YE_COMPONENT_BUTTON
 };
 
+/**
+ * @brief The number of component types.
+ */
+#define YE_COMPONENT_TYPE_COUNT 9
+
+/**
+ * @brief The bit for a component type in a component set (entity signatures, queries, system read/write sets).
+ */
+#define YE_COMPONENT_BIT(type) (1u << (type))
+
 /**
  * @brief Returns the angle between two points.
  * 
@@ -40,6 +40,10 @@
     // 1 byte - data type
     // repeat for entry count
     // data begins
+
+    PCM entries (YEP_DATATYPE_PCM) hold a struct yep_pcm_header followed by the samples,
+    already decoded into the format the mixer was opened with when the pack was built.
+    They are never compressed, so loading one is a read and a copy.
 */
 
 #define YEP_CURRENT_FORMAT_VERSION 1
@@ -62,9 +66,28 @@ enum YEP_COMPRESSION {
 };
 
 /*
-    In regards to file handling, lets just keep the most recent file we have opened open,
-    that way we can just close whatever we have open at the end, and if we need to swap files during
-    runtime we can just detect this and close it.
+    Audio files that decode to at most this many bytes are packed as PCM, anything longer
+    stays as the original (compressed) file and is decoded when it loads. The default is about
+    six seconds of 16 bit stereo at 44.1kHz.
+*/
+#ifndef YEP_PCM_MAX_BYTES
+    #define YEP_PCM_MAX_BYTES (1024 * 1024)
+#endif
+
+/*
+    Leads the samples of a PCM entry, describing the format they were decoded into
+*/
+struct yep_pcm_header {
+    uint32_t frequency;
+    uint16_t format;    // SDL_AudioFormat
+    uint8_t channels;
+    uint8_t reserved;
+};
+
+/*
+    In regards to file handling, every file we have read from stays open until shutdown, so swapping
+    between the engine and game packs costs nothing. Reads lock the file they read from, so packs can be
+    read from any thread.
 */
 
 /**
@@ -101,8 +124,8 @@ bool yep_force_pack_directory(char *directory_path, char *output_name);
 #endif
 
 // extract data will call private functions
-// _yep_open_file(char *file); which will open the file into the yep global file pointer
-// _yep_close_file(); which will close the file on shutdown
+// _yep_open_file(char *file); which will open the file (each pack stays open, with its own lock)
+// _yep_close_files(); which will close the files on shutdown
 
 /**
  * @brief Initializes the yep subsystem
@@ -143,6 +166,7 @@ struct yep_pack_list {
 struct yep_data_info {
     void *data;
     size_t size;
+    uint8_t data_type;  // enum YEP_DATATYPE
 };
 
 /**
@@ -171,6 +195,8 @@ json_t * yep_resource_json(const char *handle);
  * @param handle The key storing the audio file in the file
  * @return Mix_Chunk* The loaded audio file (NULL if not found)
  * 
+ * Short sounds are packed as PCM and handed to the mixer without decoding them.
+ * 
  * !!! YOU MUST FREE THE CHUNK YOURSELF WHEN YOU ARE DONE WITH IT !!!
  */
 Mix_Chunk * yep_resource_audio(const char *handle);
@@ -201,6 +227,8 @@ TTF_Font * yep_resource_font(const char *handle);
  * @param handle The key storing the misc file in the file
  * @return struct yep_data_info The loaded misc file (NULL if not found)
  * 
+ * The data is whatever was packed, check data_type: short audio files come back as PCM, not the original file.
+ * 
  * !!! YOU MUST FREE THE DATA YOURSELF WHEN YOU ARE DONE WITH IT !!!
  */
 struct yep_data_info yep_resource_misc(const char *handle);
@@ -52,7 +52,20 @@
 #include "audio.h"
 #include "logging.h"        // logging
 #include "lua_api.h"        // scripting api
+#include "lua_memory.h"     // pooled lua allocator
 #include "scene.h"          // scene manager
 #include "tricks.h"         // plugin system
+#include "hotreload.h"      // loose resource hot reloading
+#include "scene_profiler.h" // scene load timing breakdown
+#include "jobs.h"           // worker thread pool
+#include "scheduler.h"      // per frame system ordering
+#include "navigation.h"     // grid pathfinding
+#include "tween.h"          // property interpolation
+#include "memory.h"         // tagged allocation tracking
+#include "intern.h"         // shared string storage
+#include "mixer.h"          // software mixer and buses
+#include "metrics.h"        // metrics export
+#include "capture.h"        // frame capture and replay
+#include "observer.h"       // component change observers
 
 #endif // YE_ENGINE_MAIN_H
\ No newline at end of file
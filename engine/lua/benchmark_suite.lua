@@ -0,0 +1,424 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+--- Companion to test_suite.lua: times the parts of the yoyoengine LUA API scripts lean on
+--- every frame, so changes to the binding layer can be compared against a baseline.
+---
+--- Attach this script to an entity in an otherwise empty scene, and copy benchmark_target.lua
+--- into the game's resources (see benchmarkTargetScript). It writes a JSON report and quits
+--- when it is done. To run it without a window or audio device:
+---
+---     SDL_VIDEODRIVER=dummy SDL_AUDIODRIVER=dummy ./yourgame
+---
+--- Then compare two reports with tools/compare_lua_benchmarks.py.
+---
+--- Every microbenchmark is run a few times after a warmup, with a full collection before each
+--- run. ns_per_op is the fastest run, ns_per_op_median the median. allocations_per_op and
+--- bytes_per_op come from this script's lua state, so work done in another state (cross state
+--- calls) or in C is not counted. On LuaJIT only bytes are known and allocations_per_op is left
+--- out. Leave lua_memory_limit_kb unset, the collector is stopped while a benchmark runs.
+
+-- settings, all of them can be set as globals on the script component
+benchmarkOutput = "lua_benchmark.json"                  -- where the report is written
+benchmarkTargetScript = "scripts/benchmark_target.lua"  -- resource handle of benchmark_target.lua
+benchmarkImage = "benchmark.png"                        -- image for renderer benchmarks, missing is fine
+benchmarkQuit = true                                    -- quit the game once the report is written
+
+local REPORT_VERSION = 1
+local RUNS = 5
+local ENTITY_COUNT = 1000
+local MACRO_FRAMES = 120
+
+local results = {}
+
+---------------------------------------------------------
+---                     MEASURING                     ---
+---------------------------------------------------------
+
+-- allocations and bytes asked for so far, allocations is nil when it is not tracked
+local function allocationCounters()
+    local used, allocations, allocated = ye_lua_memory_stats()
+    if allocated == nil then
+        -- only the collector knows anything, and with it stopped growth is what was allocated
+        return nil, used
+    end
+    return allocations, allocated
+end
+
+local function median(values)
+    local sorted = {}
+    for i = 1, #values do sorted[i] = values[i] end
+    table.sort(sorted)
+    return sorted[math.floor((#sorted + 1) / 2)]
+end
+
+local function record(name, family, iterations, times, allocations, bytes, unit)
+    local best = math.huge
+    for i = 1, #times do best = math.min(best, times[i]) end
+
+    local result = {
+        name = name,
+        family = family,
+        iterations = iterations,
+        ns_per_op = best,
+        ns_per_op_median = median(times),
+        allocations_per_op = allocations,
+        bytes_per_op = bytes,
+        unit = unit or "op",
+    }
+    results[#results + 1] = result
+
+    log("info", string.format("%-32s %12.1f ns/op %10s allocs/op %10.1f B/op\n", name, best,
+        allocations and string.format("%.2f", allocations) or "-", bytes))
+    return result
+end
+
+---**Time fn(i) for i = 1..iterations.**
+local function bench(name, family, iterations, fn)
+    -- warm up caches (and the JIT)
+    for i = 1, math.max(1, math.floor(iterations / 10)) do fn(i) end
+
+    local times = {}
+    local allocations, bytes = nil, 0
+    for run = 1, RUNS do
+        collectgarbage("collect")
+        collectgarbage("stop")
+
+        local allocs_before, bytes_before = allocationCounters()
+        local start = Timer:now()
+        for i = 1, iterations do fn(i) end
+        local elapsed = Timer:now() - start
+        local allocs_after, bytes_after = allocationCounters()
+
+        collectgarbage("restart")
+
+        times[run] = elapsed * 1e9 / iterations
+
+        -- allocation counts do not depend on timing, keep the last run's
+        if allocs_before ~= nil then
+            allocations = (allocs_after - allocs_before) / iterations
+        end
+        bytes = math.max(0, bytes_after - bytes_before) / iterations
+    end
+
+    return record(name, family, iterations, times, allocations, bytes)
+end
+
+---------------------------------------------------------
+---                       REPORT                      ---
+---------------------------------------------------------
+
+local function encodeString(s)
+    return '"' .. s:gsub('[%c"\\]', function(c)
+        if c == '"' then return '\\"' end
+        if c == '\\' then return '\\\\' end
+        if c == '\n' then return '\\n' end
+        return string.format("\\u%04x", c:byte())
+    end) .. '"'
+end
+
+local function encode(value, indent)
+    local t = type(value)
+    if value == nil then
+        return "null"
+    elseif t == "boolean" then
+        return tostring(value)
+    elseif t == "number" then
+        if value ~= value or value == math.huge or value == -math.huge then return "null" end
+        if math.type and math.type(value) == "integer" then return tostring(value) end
+        return string.format("%.6g", value)
+    elseif t == "string" then
+        return encodeString(value)
+    end
+
+    -- tables, arrays if they have a first element (or are the benchmark list)
+    local inner = indent .. "  "
+    local parts = {}
+    if value[1] ~= nil or value == results then
+        for i = 1, #value do parts[i] = inner .. encode(value[i], inner) end
+        return "[\n" .. table.concat(parts, ",\n") .. "\n" .. indent .. "]"
+    end
+
+    -- fixed order, so reports diff cleanly
+    local keys = {}
+    for k in pairs(value) do keys[#keys + 1] = k end
+    table.sort(keys)
+    for i, k in ipairs(keys) do
+        parts[i] = inner .. encodeString(k) .. ": " .. encode(value[k], inner)
+    end
+    return "{\n" .. table.concat(parts, ",\n") .. "\n" .. indent .. "}"
+end
+
+local function writeReport()
+    local _, allocations = ye_lua_memory_stats()
+    local report = {
+        version = REPORT_VERSION,
+        lua = _VERSION,
+        luajit = jit ~= nil and jit.version or false,
+        allocation_tracking = allocations ~= nil,
+        benchmarks = results,
+    }
+
+    local file, err = io.open(benchmarkOutput, "w")
+    if file == nil then
+        log("error", "benchmark suite could not write " .. tostring(benchmarkOutput) .. ": " .. tostring(err) .. "\n")
+        return false
+    end
+    file:write(encode(report, ""), "\n")
+    file:close()
+
+    log("info", "benchmark suite wrote " .. #results .. " results to " .. benchmarkOutput .. "\n")
+    return true
+end
+
+---------------------------------------------------------
+---                  MICROBENCHMARKS                  ---
+---------------------------------------------------------
+
+local sink = 0 -- keeps results alive so nothing is optimized away
+
+local function benchTransform()
+    local e = Entity:new("bench transform")
+    e:AddTransformComponent(0, 0)
+    local transform = e.Transform
+
+    bench("transform.get", "transform", 100000, function()
+        sink = sink + transform.x
+    end)
+    bench("transform.set", "transform", 100000, function(i)
+        transform.x = i
+    end)
+    bench("transform.get_through_entity", "transform", 20000, function()
+        sink = sink + e.Transform.x
+    end)
+    bench("transform.set_through_entity", "transform", 20000, function(i)
+        e.Transform.x = i
+    end)
+
+    e:destroy()
+end
+
+local function benchRenderer()
+    local e = Entity:new("bench renderer")
+    e:AddTransformComponent(0, 0)
+    e:AddImageRendererComponent(benchmarkImage, 0)
+    local renderer = e.Renderer
+    if renderer == nil then
+        log("warning", "benchmark suite could not create a renderer, skipping renderer benchmarks\n")
+        e:destroy()
+        return
+    end
+
+    bench("renderer.get", "renderer", 100000, function()
+        sink = sink + renderer.alpha
+    end)
+    bench("renderer.modify", "renderer", 100000, function(i)
+        renderer.alpha = i % 256
+    end)
+
+    e:destroy()
+end
+
+local function benchLookup(entities)
+    bench("entity.get_named", "lookup", 10000, function(i)
+        sink = sink + (Entity:getEntityNamed("bench " .. (i % ENTITY_COUNT + 1)).ID or 0)
+    end)
+
+    local ids = {}
+    for i = 1, #entities do ids[i] = entities[i].ID end
+    bench("entity.get_by_id", "lookup", 10000, function(i)
+        sink = sink + (Entity:getEntityByID(ids[i % #ids + 1]).ID or 0)
+    end)
+end
+
+local function benchTags(entities)
+    local tag = entities[ENTITY_COUNT].Tag
+
+    bench("tag.has_tag", "tag", 100000, function(i)
+        if tag:HasTag(i % 2 == 0 and "bench" or "missing") then sink = sink + 1 end
+    end)
+    bench("tag.get_entity_by_tag", "tag", 10000, function()
+        sink = sink + (Entity:getEntityByTag("bench last").ID or 0)
+    end)
+
+    local found = {}
+    bench("query.with", "tag", 1000, function()
+        sink = sink + Query:with("transform+tag", found)
+    end)
+end
+
+local function benchTimers()
+    bench("timer.get_ticks", "timer", 100000, function()
+        sink = sink + Timer:getTicks()
+    end)
+    bench("timer.now", "timer", 100000, function()
+        sink = sink + Timer:now()
+    end)
+
+    local noop = function() end
+    bench("timer.new_cancel", "timer", 10000, function()
+        cancelCoroutine(Timer:new(1000, noop, 1, 0))
+    end)
+end
+
+local function benchInput()
+    bench("input.key_pressed", "input", 100000, function()
+        if Input:keyPressed(KEY_SPACE) then sink = sink + 1 end
+    end)
+    bench("input.mouse", "input", 20000, function()
+        sink = sink + Input:mouse().x
+    end)
+end
+
+local function benchCrossState(target)
+    local script = target.LuaScript
+
+    bench("cross_state.invoke", "cross_state", 20000, function(i)
+        sink = sink + (script:Invoke("ping", i) or 0)
+    end)
+    bench("cross_state.get", "cross_state", 20000, function()
+        sink = sink + (script:Get("benchmarkValue") or 0)
+    end)
+    bench("cross_state.set", "cross_state", 20000, function(i)
+        script:Set("benchmarkValue", i)
+    end)
+end
+
+---------------------------------------------------------
+---                       MACROS                      ---
+---------------------------------------------------------
+
+--[[
+    Macros time whole frames, so they include everything the engine does each frame.
+    ns_per_op is per mover per frame, ms_per_frame is the median frame.
+]]
+
+local function recordFrames(name, family, frameTimes, movers)
+    local perMover = {}
+    for i = 1, #frameTimes do perMover[i] = frameTimes[i] * 1e9 / movers end
+    local result = record(name, family, #frameTimes * movers, perMover, nil, 0, "mover")
+    result.allocations_per_op = nil
+    result.ms_per_frame = median(frameTimes) * 1000
+    return result
+end
+
+-- 1000 movers moved from this script
+local function macroMovers()
+    local entities, movers = {}, {}
+    for i = 1, ENTITY_COUNT do
+        local e = Entity:new("bench mover " .. i)
+        e:AddTransformComponent(i, 0)
+        entities[i] = e
+        movers[i] = e.Transform
+    end
+    waitFrames(1)
+
+    local updates = {}
+    local allocs_before, bytes_before = allocationCounters()
+    for frame = 1, MACRO_FRAMES do
+        local start = Timer:now()
+        for i = 1, #movers do
+            local t = movers[i]
+            t.x = t.x + 1
+            t.y = (t.y + i) % 720
+        end
+        updates[frame] = Timer:now() - start
+        waitFrames(1)
+    end
+    local allocs_after, bytes_after = allocationCounters()
+
+    local result = recordFrames("macro.movers_single_script", "macro", updates, ENTITY_COUNT)
+    local ops = MACRO_FRAMES * ENTITY_COUNT
+    if allocs_before ~= nil then
+        result.allocations_per_op = (allocs_after - allocs_before) / ops
+    end
+    result.bytes_per_op = math.max(0, bytes_after - bytes_before) / ops
+
+    for i = 1, #entities do entities[i]:destroy() end
+end
+
+-- 1000 entities each moving themselves from their own script
+local function macroScriptedMovers()
+    local entities = {}
+    for i = 1, ENTITY_COUNT do
+        local e = Entity:new("bench scripted " .. i)
+        e:AddTransformComponent(i, 0)
+        e:AddLuaScriptComponent(benchmarkTargetScript)
+        e.LuaScript:Set("benchmarkEntityID", e.ID)
+        entities[i] = e
+    end
+    waitFrames(2) -- every target looks up its transform on its first update
+
+    local frames = {}
+    local last = Timer:now()
+    for frame = 1, MACRO_FRAMES do
+        waitFrames(1)
+        local now = Timer:now()
+        frames[frame] = now - last
+        last = now
+    end
+
+    recordFrames("macro.movers_scripted", "macro", frames, ENTITY_COUNT)
+
+    for i = 1, #entities do entities[i]:destroy() end
+end
+
+---------------------------------------------------------
+---                       SUITE                       ---
+---------------------------------------------------------
+
+local function run()
+    -- let the scene finish loading first
+    waitFrames(2)
+    local started = Timer:now()
+
+    benchTransform()
+    benchRenderer()
+    benchTimers()
+    benchInput()
+
+    local entities = {}
+    for i = 1, ENTITY_COUNT do
+        local e = Entity:new("bench " .. i)
+        e:AddTransformComponent(i, i)
+        e:AddTagComponent()
+        e.Tag:AddTag("bench")
+        entities[i] = e
+    end
+    entities[ENTITY_COUNT].Tag:AddTag("bench last")
+    waitFrames(1)
+
+    benchLookup(entities)
+    benchTags(entities)
+    for i = 1, #entities do entities[i]:destroy() end
+    entities = nil
+    waitFrames(1)
+
+    local target = Entity:new("bench target")
+    target:AddLuaScriptComponent(benchmarkTargetScript)
+    if target.LuaScript == nil or target.LuaScript:Get("benchmarkValue") == nil then
+        log("warning", "benchmark suite could not load " .. tostring(benchmarkTargetScript) .. ", skipping cross state benchmarks and macros\n")
+        target:destroy()
+    else
+        benchCrossState(target)
+        target:destroy()
+
+        macroMovers()
+        macroScriptedMovers()
+    end
+
+    log("info", string.format("benchmark suite finished in %.1fs\n", Timer:now() - started))
+    writeReport()
+
+    if benchmarkQuit then
+        exitGame()
+    end
+end
+
+function onMount()
+    startCoroutine(run)
+end
@@ -0,0 +1,32 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+--- The other side of benchmark_suite.lua: the suite calls into this script across states,
+--- and attaches it to many entities at once to time scripts moving their own entity.
+
+benchmarkValue = 0
+
+-- scripts cannot ask for their own entity, the suite sets this right after attaching us
+benchmarkEntityID = -1
+
+local transform = nil
+local step = 0
+
+function ping(x)
+    return x + 1
+end
+
+function onUpdate()
+    if transform == nil then
+        if benchmarkEntityID < 0 then return end
+        transform = Entity:getEntityByID(benchmarkEntityID).Transform
+        if transform == nil then return end
+    end
+    step = step + 1
+    transform.x = transform.x + 1
+    transform.y = step % 720
+end
@@ -6,4 +6,642 @@
 ]]
 
 --- This script attempts to exercise every part of the yoyoengine LUA API
---- Ideally, after comitting changes we can run this script to ensure that everything is working as expected
\ No newline at end of file
+--- Ideally, after comitting changes we can run this script to ensure that everything is working as expected
+---
+--- Attach it to an entity in an otherwise empty scene, and copy test_target.lua into the game's
+--- resources (see testTargetScript). Every check is logged, followed by a summary, and the game
+--- quits once it is done (see testQuit). It runs headless like benchmark_suite.lua:
+---
+---     SDL_VIDEODRIVER=dummy SDL_AUDIODRIVER=dummy ./yourgame
+
+-- settings, all of them can be set as globals on the script component
+testQuit = true                                 -- quit the game once every test has run
+testTargetScript = "scripts/test_target.lua"    -- resource handle of test_target.lua
+
+local passed = 0
+local failed = 0
+local frames = 0 -- counted by onUpdate, so tests can tell frames apart
+
+local function check(name, condition, detail)
+    if condition then
+        passed = passed + 1
+        log("debug", "PASS " .. name .. "\n")
+    else
+        failed = failed + 1
+        log("error", "FAIL " .. name .. (detail and (": " .. tostring(detail)) or "") .. "\n")
+    end
+end
+
+local function near(a, b, epsilon)
+    return a ~= nil and b ~= nil and math.abs(a - b) <= (epsilon or 0.5)
+end
+
+-- an entity with a transform and a 50x50 collider at x, y
+local function box(name, x, y, isTrigger)
+    local e = Entity:new(name)
+    e:AddTransformComponent(x, y)
+    e:AddColliderComponent(isTrigger, 0, 0, 50, 50)
+    return e
+end
+
+-- destroyed entities keep their table, but it no longer points at anything
+local function alive(e)
+    return rawget(e, "_c_entity") ~= nil
+end
+
+-- gives an entity its own test_target.lua script, false if it could not be loaded
+local function attachTarget(e)
+    e:AddLuaScriptComponent(testTargetScript)
+    if e.LuaScript == nil or e.LuaScript:Get("collisions") == nil then
+        log("warning", "test suite could not load " .. tostring(testTargetScript) .. "\n")
+        return false
+    end
+    e.LuaScript:Set("targetEntityID", e.ID)
+    return true
+end
+
+---------------------------------------------------------
+---                     COROUTINES                    ---
+---------------------------------------------------------
+
+local function testCoroutines()
+    -- runs right away up to its first wait
+    local started, resumed = false, false
+    startCoroutine(function()
+        started = true
+        waitFrames(2)
+        resumed = true
+    end)
+    check("coroutine runs until its first wait", started and not resumed)
+
+    local before = frames
+    waitFrames(3)
+    check("waitFrames resumes on a later frame", resumed and frames - before >= 2, frames - before)
+
+    -- seconds
+    local start = Timer:now()
+    wait(0.1)
+    check("wait waits at least the time asked for", Timer:now() - start >= 0.09, Timer:now() - start)
+
+    -- events
+    local woken = 0
+    for i = 1, 2 do
+        startCoroutine(function()
+            waitUntil("test suite event")
+            woken = woken + 1
+        end)
+    end
+    waitFrames(1)
+    check("waitUntil waits for its event", woken == 0, woken)
+    signal("test suite event")
+    waitFrames(1)
+    check("signal wakes every waiter", woken == 2, woken)
+
+    -- predicates
+    local ready, done = false, false
+    startCoroutine(function()
+        waitUntil(function() return ready end)
+        done = true
+    end)
+    waitFrames(2)
+    check("waitUntil polls its predicate", not done)
+    ready = true
+    waitFrames(2)
+    check("waitUntil resumes once the predicate is true", done)
+
+    -- predicates that wait on things themselves, growing the list of waits while it is polled
+    local go, outer, inner, polls = false, false, 0, 0
+    startCoroutine(function()
+        waitUntil(function()
+            polls = polls + 1
+            if polls == 1 then
+                for i = 1, 100 do
+                    startCoroutine(function()
+                        waitUntil(function() return go end)
+                        inner = inner + 1
+                    end)
+                end
+            end
+            return go
+        end)
+        outer = true
+    end)
+    waitFrames(3)
+    check("a predicate can register waits", polls >= 2 and not outer and inner == 0, polls)
+    go = true
+    waitFrames(3)
+    check("waits registered by a predicate resume", outer and inner == 100, inner)
+
+    -- cancelling
+    local ran = false
+    local id = startCoroutine(function()
+        waitFrames(1)
+        ran = true
+    end)
+    check("cancelCoroutine cancels a waiting coroutine", cancelCoroutine(id) == true)
+    waitFrames(3)
+    check("a cancelled coroutine is never resumed", not ran)
+    check("cancelCoroutine of a cancelled coroutine fails", cancelCoroutine(id) == false)
+
+    -- timers run on coroutines
+    local fired = 0
+    Timer:new(50, function() fired = fired + 1 end, 2, 0)
+    wait(0.3)
+    check("Timer:new fires once per loop", fired == 2, fired)
+end
+
+---------------------------------------------------------
+---                       TWEENS                      ---
+---------------------------------------------------------
+
+local function testTweens()
+    local e = Entity:new("test tween")
+    e:AddTransformComponent(0, 0)
+
+    local completed = 0
+    local id = Tween:to(e, "x", 100, 0.1, { easing = "outQuad", onComplete = function() completed = completed + 1 end })
+    check("Tween:to returns a handle", id ~= nil and id > 0, id)
+
+    wait(0.3)
+    check("a tween ends on its target value", near(e.Transform.x, 100), e.Transform.x)
+    check("onComplete is called once", completed == 1, completed)
+    check("Tween:cancel of a finished tween fails", Tween:cancel(id) == false)
+
+    -- cancelled midway
+    completed = 0
+    id = Tween:to(e, "y", 1000, 1, { onComplete = function() completed = completed + 1 end })
+    waitFrames(2)
+    check("Tween:cancel stops a running tween", Tween:cancel(id) == true)
+    local stopped = e.Transform.y
+    wait(0.1)
+    check("a cancelled tween stays where it was", e.Transform.y == stopped and stopped < 1000, stopped)
+    check("a cancelled tween does not complete", completed == 0)
+
+    -- from and delay
+    Tween:to(e, "x", 50, 0.05, { from = 10, delay = 0.1 })
+    waitFrames(1)
+    check("a delayed tween waits before moving", near(e.Transform.x, 100), e.Transform.x)
+    wait(0.3)
+    check("a tween with from ends on its target", near(e.Transform.x, 50), e.Transform.x)
+
+    -- cancelling by entity
+    Tween:to(e, "x", 0, 1)
+    Tween:to(e, "y", 0, 1)
+    check("Tween:cancelAll by property", Tween:cancelAll(e, "x") == 1)
+    check("Tween:cancelAll every property", Tween:cancelAll(e) == 1)
+
+    check("Tween:to without the component returns 0", Tween:to(e, "alpha", 0, 1) == 0)
+
+    e:destroy()
+
+    -- fade then destroy, from the tweened entity's own script
+    local faded = Entity:new("test tween fade")
+    faded:AddTransformComponent(0, 0)
+    if attachTarget(faded) then
+        faded.LuaScript:Invoke("fadeOut", 0.1)
+        wait(0.3)
+        check("onComplete can destroy its own entity and script", not alive(faded))
+    else
+        faded:destroy()
+    end
+end
+
+---------------------------------------------------------
+---                      OBSERVE                      ---
+---------------------------------------------------------
+
+local function testObserve()
+    local e = Entity:new("test observe")
+    e:AddTransformComponent(0, 0)
+    waitFrames(1)
+
+    -- modifications, reported once per frame
+    local calls, lastEntity, lastEvent, lastComponent = 0, nil, nil, nil
+    local id = Observe:component("transform", "modified", function(entity, event, component)
+        calls = calls + 1
+        lastEntity, lastEvent, lastComponent = entity, event, component
+    end, e)
+    check("Observe:component returns a handle", id ~= nil and id > 0, id)
+
+    e.Transform.x = 10
+    e.Transform.x = 20
+    check("observers are not called in the middle of a script", calls == 0)
+    waitFrames(2)
+    check("a component modified twice in a frame is reported once", calls == 1, calls)
+    check("observers get the entity", lastEntity == e)
+    check("observers get the event", lastEvent == "modified", lastEvent)
+    check("observers get the component", lastComponent == "transform", lastComponent)
+
+    check("Observe:cancel stops an observer", Observe:cancel(id) == true)
+    e.Transform.x = 30
+    waitFrames(2)
+    check("a cancelled observer is not called", calls == 1, calls)
+    check("Observe:cancel of a cancelled observer fails", Observe:cancel(id) == false)
+
+    -- additions and removals, for every entity
+    local added, removed, removedEntity = 0, 0, false
+    local addId = Observe:component("tag", "added", function() added = added + 1 end)
+    local removeId = Observe:component("tag", { "removed" }, function(entity)
+        removed = removed + 1
+        removedEntity = entity
+    end)
+
+    e:AddTagComponent()
+    waitFrames(2)
+    check("Observe reports added components", added == 1, added)
+
+    e:destroy()
+    waitFrames(2)
+    check("Observe reports the components of destroyed entities as removed", removed == 1, removed)
+    check("removals from destroyed entities have no entity", removedEntity == nil)
+
+    Observe:cancel(addId)
+    Observe:cancel(removeId)
+end
+
+---------------------------------------------------------
+---                       QUERY                       ---
+---------------------------------------------------------
+
+local function testQuery()
+    local wall = box("test wall", 200, 0, false)
+    wall:AddTagComponent()
+    wall.Tag:AddTag("wall")
+    local trigger = box("test trigger", 400, 0, true)
+
+    local hits = {}
+    local count = Query:raycast(0, 25, 1, 0, 1000, nil, hits)
+    check("raycast hits everything on its way", count == 2, count)
+    check("raycast returns the nearest hit first", hits[1].entity == wall)
+    check("raycast reports the distance", near(hits[1].distance, 200), hits[1].distance)
+    check("raycast reports the contact point", near(hits[1].x, 200) and near(hits[1].y, 25), hits[1].x)
+    check("raycast reports the normal", hits[1].normalX == -1 and hits[1].normalY == 0, hits[1].normalX)
+
+    count = Query:raycast(0, 25, 1, 0, 100, nil, hits)
+    check("raycast stops at its distance", count == 0, count)
+    count = Query:raycast(0, 25, 1, 0, 1000, { limit = 1 }, hits)
+    check("raycast respects limit", count == 1, count)
+    count = Query:raycast(0, 25, 1, 0, 1000, { skipTriggers = true }, hits)
+    check("raycast can skip triggers", count == 1 and hits[1].entity == wall, count)
+    count = Query:raycast(0, 25, 1, 0, 1000, { ignore = wall }, hits)
+    check("raycast can ignore an entity", count == 1 and hits[1].entity == trigger, count)
+    count = Query:raycast(0, 25, 1, 0, 1000, { tag = "wall" }, hits)
+    check("raycast can filter by tag", count == 1 and hits[1].entity == wall, count)
+
+    count = Query:sweep(0, 0, 10, 10, 1, 0, 1000, nil, hits)
+    check("sweep returns the nearest hit first", count >= 1 and hits[1].entity == wall, count)
+    check("sweep reports where the box stops", near(hits[1].distance, 190), hits[1].distance)
+
+    local found = {}
+    count = Query:overlapPoint(225, 25, nil, found)
+    check("overlapPoint finds the collider under a point", count == 1 and found[1] == wall, count)
+    count = Query:overlapPoint(300, 25, nil, found)
+    check("overlapPoint finds nothing in empty space", count == 0, count)
+    count = Query:overlapRect(190, 0, 300, 10, nil, found)
+    check("overlapRect finds every collider in a rect", count == 2, count)
+
+    -- moving a static collider is seen by the next query
+    wall.Transform.x = 600
+    count = Query:overlapPoint(225, 25, nil, found)
+    check("queries see moved static colliders", count == 0, count)
+    wall.Transform.x = 200
+
+    wall:destroy()
+    trigger:destroy()
+end
+
+---------------------------------------------------------
+---                       LAYERS                      ---
+---------------------------------------------------------
+
+local function testLayers()
+    local wall = box("test layer wall", 200, 0, false)
+    local trigger = box("test layer trigger", 400, 0, true)
+    local found = {}
+
+    wall.Collider.layer = 3
+    check("colliders can be put on a layer", wall.Collider.layer == 3, wall.Collider.layer)
+    local count = Query:overlapRect(190, 0, 300, 10, { layers = { 3 } }, found)
+    check("queries can filter by layer", count == 1 and found[1] == wall, count)
+    count = Query:overlapRect(190, 0, 300, 10, { layers = { 0 } }, found)
+    check("queries leave out other layers", count == 1 and found[1] == trigger, count)
+    count = Query:overlapRect(190, 0, 300, 10, { layers = { 3, 0 } }, found)
+    check("queries can take several layers", count == 2, count)
+    count = Query:overlapRect(190, 0, 300, 10, { asLayer = 3 }, found)
+    check("asLayer returns what the layer interacts with", count == 2, count)
+
+    -- the physics step reads the same interaction matrix, where every layer meets every other by default
+    local mover = box("test layer mover", 0, 0, false)
+    mover.Collider.layer = 5
+    mover:AddPhysicsComponent(600, 0)
+    local deadline = frames + 600
+    waitUntil(function() return mover.Physics.xVelocity == 0 or frames > deadline end)
+    check("movers collide across layers by default", mover.Physics.xVelocity == 0 and mover.Transform.x < 200, mover.Transform.x)
+
+    mover:destroy()
+    wall:destroy()
+    trigger:destroy()
+end
+
+---------------------------------------------------------
+---                 COMPONENT QUERIES                 ---
+---------------------------------------------------------
+
+local function testComponentQueries()
+    local wall = box("test query wall", 200, 0, false)
+    wall:AddTagComponent()
+    local trigger = box("test query trigger", 400, 0, true)
+
+    local found = {}
+    local count = Query:with("transform+collider+tag", found)
+    check("Query:with finds entities with every component", count == 1 and found[1] == wall, count)
+    count = Query:with("collider+!tag", found)
+    check("Query:with leaves out excluded components", count == 1 and found[1] == trigger, count)
+
+    -- destroyed entities hand their slots to the next ones, which must not inherit their membership
+    local old = {}
+    for i = 1, 20 do
+        old[i] = Entity:new("test query old " .. i)
+        old[i]:AddTransformComponent(0, 0)
+        old[i]:AddTagComponent()
+    end
+    count = Query:with("transform+tag", found)
+    check("Query:with follows added components", count == 21, count)
+    for i = 1, #old do old[i]:destroy() end
+
+    local new = {}
+    for i = 1, 20 do
+        new[i] = Entity:new("test query new " .. i)
+        new[i]:AddTransformComponent(0, 0)
+        new[i]:AddPhysicsComponent(0, 0)
+    end
+    count = Query:with("transform+tag", found)
+    check("recycled slots leave the queries of their old entity", count == 1 and found[1] == wall, count)
+    count = Query:with("physics+!tag", found)
+    local untagged = true
+    for i = 1, count do untagged = untagged and found[i].Tag == nil end
+    check("recycled slots join the queries of their new entity", count == 20 and untagged, count)
+
+    for i = 1, #new do new[i]:destroy() end
+    wall:destroy()
+    trigger:destroy()
+end
+
+---------------------------------------------------------
+---                     NAVIGATION                    ---
+---------------------------------------------------------
+
+local function testNavigation()
+    local wall = box("test nav wall", 200, 0, false)
+
+    -- 10x10 cells of 32 pixels
+    check("Navigation:build builds a grid", Navigation:build(0, 0, 320, 320, 32) == true)
+    check("static colliders block cells", Navigation:isBlocked(225, 25) == true)
+    check("empty cells are free", Navigation:isBlocked(16, 16) == false)
+    check("points outside the grid are blocked", Navigation:isBlocked(-100, -100) == true)
+
+    local points = {}
+    local count = Navigation:findPath(16, 16, 300, 16, points)
+    check("findPath finds a path around a wall", count > 0, count)
+    check("paths end at the goal", count > 0 and near(points[count].x, 300, 32) and near(points[count].y, 16, 32))
+
+    -- cut the grid in half
+    for y = 16, 320, 32 do Navigation:setBlocked(176, y, true) end
+    check("setBlocked blocks a cell", Navigation:isBlocked(176, 16) == true)
+    count = Navigation:findPath(16, 16, 300, 16, points)
+    check("findPath returns 0 for an unreachable goal", count == 0, count)
+    for y = 16, 320, 32 do Navigation:setBlocked(176, y, false) end
+
+    -- requests
+    local result = nil
+    Navigation:requestPath(16, 16, 300, 300, function(found) result = found end)
+    waitUntil(function() return result ~= nil or frames > 600 end)
+    check("requestPath calls back with a path", result ~= nil and result > 0, result)
+
+    local called = false
+    local id = Navigation:requestPath(16, 16, 300, 300, function() called = true end)
+    check("Navigation:cancel cancels a pending request", Navigation:cancel(id) == true)
+    waitFrames(5)
+    check("a cancelled request never calls back", not called)
+
+    wall:destroy()
+end
+
+---------------------------------------------------------
+---                      CONTACTS                     ---
+---------------------------------------------------------
+
+local function testContacts()
+    -- the mover's script destroys what it runs into, which has a script of its own
+    local target = box("test contact target", 300, 0, false)
+    local bullet = box("test contact bullet", 0, 0, false)
+    if not attachTarget(target) or not attachTarget(bullet) then
+        target:destroy()
+        bullet:destroy()
+        return
+    end
+    bullet.LuaScript:Set("destroyOther", true)
+    bullet:AddPhysicsComponent(600, 0)
+
+    local deadline = frames + 600
+    waitUntil(function() return not alive(target) or frames > deadline end)
+    check("onCollision can destroy the other entity", not alive(target))
+    check("the entity that destroyed it lives on", alive(bullet) and bullet.LuaScript:Get("collisions") == 1)
+    bullet:destroy()
+
+    -- the other way around, the target destroys what runs into it
+    target = box("test contact target", 300, 0, false)
+    bullet = box("test contact bullet", 0, 0, false)
+    attachTarget(target)
+    attachTarget(bullet)
+    target.LuaScript:Set("destroyOther", true)
+    bullet:AddPhysicsComponent(600, 0)
+
+    deadline = frames + 600
+    waitUntil(function() return not alive(bullet) or frames > deadline end)
+    check("onCollision can destroy the entity moving into it", not alive(bullet))
+    check("the target was told about the collision", alive(target) and target.LuaScript:Get("collisions") == 1)
+    waitFrames(2)
+    check("physics carries on without it", alive(target))
+    target:destroy()
+end
+
+---------------------------------------------------------
+---                      SLEEPING                     ---
+---------------------------------------------------------
+
+local function testSleeping()
+    local body = Entity:new("test sleeper")
+    body:AddTransformComponent(0, 0)
+    body:AddPhysicsComponent(0, 0)
+
+    -- longer than the default YE_PHYSICS_SLEEP_FRAMES
+    waitFrames(45)
+    check("a resting body falls asleep", body.Physics.isSleeping == true)
+    body.Physics.xVelocity = 100
+    waitFrames(2)
+    check("giving it velocity wakes it", body.Physics.isSleeping == false)
+    check("it moves once it is awake", body.Transform.x > 0, body.Transform.x)
+
+    -- views write straight into the component under LuaJIT, the step has to notice the velocity itself
+    body.Physics.xVelocity = 0
+    waitFrames(45)
+    check("it falls asleep again", body.Physics.isSleeping == true)
+    body:PhysicsView().yVelocity = 100
+    waitFrames(2)
+    check("velocity written through a view wakes it", body.Physics.isSleeping == false and body.Transform.y > 0, body.Transform.y)
+
+    body.Physics.isSleeping = true
+    check("isSleeping can put a body to sleep", body.Physics.isSleeping == true)
+    waitFrames(2)
+    check("a sleeping body with velocity wakes on the next step", body.Physics.isSleeping == false)
+
+    body:destroy()
+end
+
+---------------------------------------------------------
+---                       MEMORY                      ---
+---------------------------------------------------------
+
+local function testMemory()
+    check("an unknown memory tag is nil", ye_lua_engine_memory_stats("not a tag") == nil)
+
+    local startBytes, startAllocs = ye_lua_engine_memory_stats("ecs")
+    check("the ecs tag is tracked", startBytes ~= nil and startAllocs > 0, startBytes)
+
+    local entities = {}
+    for i = 1, 50 do
+        entities[i] = Entity:new("test memory " .. i)
+    end
+    local bytes, allocs, peak = ye_lua_engine_memory_stats("ecs")
+    check("creating entities is counted", bytes > startBytes and allocs >= startAllocs + 50, allocs - startAllocs)
+    check("the peak covers what is alive", peak >= bytes, peak)
+
+    for i = 1, 50 do
+        entities[i]:destroy()
+    end
+    -- slot and query arrays may have been allocated on the way, every entity and list node is freed
+    local _, after = ye_lua_engine_memory_stats("ecs")
+    check("destroying them frees what they allocated", after - startAllocs <= 2, after - startAllocs)
+end
+
+---------------------------------------------------------
+---                     INTERNING                     ---
+---------------------------------------------------------
+
+local function testInterning()
+    local _, startAllocs = ye_lua_engine_memory_stats("strings")
+
+    -- every entity holds the same name, stored once
+    local entities = {}
+    for i = 1, 20 do
+        entities[i] = Entity:new("test interned " .. "name")
+    end
+    local _, allocs = ye_lua_engine_memory_stats("strings")
+    check("a shared name is stored once", allocs - startAllocs <= 1, allocs - startAllocs)
+    check("entities keep their interned name", entities[20].name == "test interned name", entities[20].name)
+
+    -- renaming releases the old name, and lookups follow the new one
+    local renamed = entities[1]
+    renamed.name = "test renamed"
+    check("a renamed entity is found by its new name", ye_lua_ent_get_entity_named("test renamed") == rawget(renamed, "_c_entity"))
+    check("a name nothing holds finds nothing", ye_lua_ent_get_entity_named("test never named") == nil)
+
+    -- tags compare by their interned pointer, whatever string they are asked with
+    renamed:AddTagComponent()
+    renamed.Tag:AddTag("test " .. "tag")
+    check("a tag matches an equal string", renamed.Tag:HasTag(string.format("%s %s", "test", "tag")) == true)
+    check("an unknown tag does not match", renamed.Tag:HasTag("test missing tag") == false)
+    renamed.Tag:RemoveTag("test tag")
+    check("a removed tag no longer matches", renamed.Tag:HasTag("test tag") == false)
+
+    for i = 1, 20 do
+        entities[i]:destroy()
+    end
+    local _, after = ye_lua_engine_memory_stats("strings")
+    check("names and tags are freed with the last reference", after <= startAllocs, after - startAllocs)
+end
+
+---------------------------------------------------------
+---                       AUDIO                       ---
+---------------------------------------------------------
+
+local function testAudio()
+    check("the builtin buses exist", Audio:getBusVolume("master") ~= nil and Audio:getBusVolume("sfx") ~= nil)
+    check("an unknown bus has no volume", Audio:getBusVolume("test missing bus") == nil)
+
+    check("a bus can be created", Audio:createBus("test bus", "sfx") == true)
+    check("creating it again keeps the same bus", Audio:createBus("test bus") == true)
+
+    Audio:setBusVolume("test bus", 0.5)
+    check("a bus keeps its volume", near(Audio:getBusVolume("test bus"), 0.5, 0.001), Audio:getBusVolume("test bus"))
+    Audio:setBusVolume("test bus", -1)
+    check("a negative volume is clamped", Audio:getBusVolume("test bus") == 0, Audio:getBusVolume("test bus"))
+    check("the parent bus is untouched", near(Audio:getBusVolume("sfx"), 1, 0.001), Audio:getBusVolume("sfx"))
+
+    -- none of these have anything to report back, they just must not fail
+    check("the low pass can be set", pcall(Audio.setBusLowpass, Audio, "test bus", 800))
+    check("a missing sound on a custom bus is only logged", pcall(Audio.playSound, Audio, "test missing.wav", 0, 1.0, "test bus"))
+
+    Audio:setBusVolume("test bus", 1)
+    Audio:setBusLowpass("test bus", 0)
+end
+
+---------------------------------------------------------
+---                     JSON ARENA                    ---
+---------------------------------------------------------
+
+local function testJsonArena()
+    -- the scene this runs in was parsed into the arena, closing it frees all but one reusable chunk
+    local _, allocs = ye_lua_engine_memory_stats("json")
+    check("the json arena is released after the scene loads", allocs ~= nil and allocs <= 1, allocs)
+
+    -- a meta file that does not exist takes one of the early exits out of the arena scope
+    local e = Entity:new("test json arena")
+    e:AddTransformComponent(0, 0)
+    e:AddAnimationRendererComponent("test missing meta.yoyo", 0)
+    local _, after = ye_lua_engine_memory_stats("json")
+    check("a failed animation load keeps no arena memory", after <= 1, after)
+    e:destroy()
+end
+
+---------------------------------------------------------
+---                       SUITE                       ---
+---------------------------------------------------------
+
+local function run()
+    -- let the scene finish loading first
+    waitFrames(2)
+
+    testCoroutines()
+    testTweens()
+    testObserve()
+    testQuery()
+    testLayers()
+    testComponentQueries()
+    testNavigation()
+    testContacts()
+    testSleeping()
+    testMemory()
+    testInterning()
+    testAudio()
+    testJsonArena()
+
+    if failed == 0 then
+        log("info", "test suite passed all " .. passed .. " checks\n")
+    else
+        log("error", "test suite failed " .. failed .. " of " .. (passed + failed) .. " checks\n")
+    end
+
+    if testQuit then
+        exitGame()
+    end
+end
+
+function onMount()
+    startCoroutine(run)
+end
+
+function onUpdate()
+    frames = frames + 1
+end
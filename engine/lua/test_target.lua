@@ -0,0 +1,31 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+--- The other side of test_suite.lua: the suite attaches it to entities that need a script of
+--- their own, since physics callbacks only go to the scripts of the entities involved.
+
+-- scripts cannot ask for their own entity, the suite sets this right after attaching us
+targetEntityID = -1
+
+destroyOther = false -- destroy whatever we collide with
+
+collisions = 0
+
+function onCollision(a, b)
+    collisions = collisions + 1
+    if destroyOther then
+        local other = a.ID == targetEntityID and b or a
+        other:destroy()
+    end
+end
+
+-- tweens our entity away, both callbacks destroy it (and this script) and they are due on the same frame
+function fadeOut(duration)
+    local me = Entity:getEntityByID(targetEntityID)
+    Tween:to(me, "x", 100, duration, { onComplete = function() me:destroy() end })
+    Tween:to(me, "y", 100, duration, { onComplete = function() me:destroy() end })
+end
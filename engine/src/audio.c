@@ -9,6 +9,9 @@
 #include <uthash/uthash.h>
 
 #include <yoyoengine/yep.h>
+#include <yoyoengine/jobs.h>
+#include <yoyoengine/mixer.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/audio.h>
 #include <yoyoengine/engine.h>
 #include <yoyoengine/logging.h>
@@ -41,18 +44,22 @@ void ye_shutdown_mixer_cache()
 
 // free all chunks
 void ye_purge_mixer_cache(){
+    // voices read straight out of the chunks
+    ye_mixer_halt();
+
     // iterate through the cache
     struct ye_mixer_cache_item *item, *tmp;
     HASH_ITER(hh, mix_cache_table, item, tmp) {
         // remove the item from the cache
         HASH_DEL(mix_cache_table, item);
 
-        // free the chunk
+        // free the chunk (its samples were counted when it was cached)
+        ye_memory_release(YE_MEM_AUDIO, item->chunk->alen);
         Mix_FreeChunk(item->chunk);
 
         // free the item
-        free(item->handle);
-        free(item);
+        ye_free(item->handle);
+        ye_free(item);
     }
 
     // set the cache to null
@@ -65,10 +72,10 @@ void ye_purge_mixer_cache(){
 void ye_mixer_cache(const char *handle)
 {
     // create struct to cache
-    struct ye_mixer_cache_item *item = malloc(sizeof(struct ye_mixer_cache_item));
+    struct ye_mixer_cache_item *item = ye_malloc(YE_MEM_AUDIO, sizeof(struct ye_mixer_cache_item));
 
     // set the handle
-    item->handle = strdup(handle);
+    item->handle = ye_strdup(YE_MEM_AUDIO, handle);
 
     // if in editor mode, retrieve from disk, if runtime load from pack
     if(YE_STATE.editor.editor_mode){
@@ -83,10 +90,14 @@ void ye_mixer_cache(const char *handle)
     // check if the chunk is null
     if(item->chunk == NULL){
         ye_logf(error, "Failed to load audio chunk %s.\n", handle);
-        free(item);
+        ye_free(item->handle);
+        ye_free(item);
         return;
     }
 
+    // the samples live as long as the cache keeps the chunk, released in ye_purge_mixer_cache
+    ye_memory_adopt(YE_MEM_AUDIO, item->chunk->alen);
+
     // add the item to the cache
     HASH_ADD_KEYPTR(hh, mix_cache_table, item->handle, strlen(item->handle), item);
 }
@@ -96,11 +107,13 @@ void ye_mixer_cache(const char *handle)
 */
 void _ye_mixer_engine_cache(char *handle)
 {
+    ye_audio_wait_ready();
+
     // create struct to cache
-    struct ye_mixer_cache_item *item = malloc(sizeof(struct ye_mixer_cache_item));
+    struct ye_mixer_cache_item *item = ye_malloc(YE_MEM_AUDIO, sizeof(struct ye_mixer_cache_item));
 
     // set the handle
-    item->handle = strdup(handle);
+    item->handle = ye_strdup(YE_MEM_AUDIO, handle);
 
     // if in editor mode, retrieve from disk, if runtime load from pack
     if(YE_STATE.editor.editor_mode){
@@ -115,10 +128,14 @@ void _ye_mixer_engine_cache(char *handle)
     // check if the chunk is null
     if(item->chunk == NULL){
         ye_logf(error, "Failed to load engine audio chunk %s.\n", handle);
-        free(item);
+        ye_free(item->handle);
+        ye_free(item);
         return;
     }
 
+    // the samples live as long as the cache keeps the chunk, released in ye_purge_mixer_cache
+    ye_memory_adopt(YE_MEM_AUDIO, item->chunk->alen);
+
     // add the item to the cache
     HASH_ADD_KEYPTR(hh, mix_cache_table, item->handle, strlen(item->handle), item);
 }
@@ -127,6 +144,8 @@ void _ye_mixer_engine_cache(char *handle)
     Api to return a mix chunk from a handle, and load it if not existant
 */
 Mix_Chunk *ye_audio(const char *handle){
+    ye_audio_wait_ready();
+
     // check if the cache has an existing chunk by this handle
     struct ye_mixer_cache_item *item = NULL;
     HASH_FIND_STR(mix_cache_table, handle, item);
@@ -164,42 +183,60 @@ Mix_Chunk *ye_audio(const char *handle){
 */
 
 /*
-    This is the mechanism by which the engine routes audio to SDL_Mixer.
-    We will dynamically manage the number of channels open at any given time, as we
-    can have as many as we want to.
+    SDL_Mixer opens the device and streams music, everything else plays on the
+    engine mixer (see mixer.c), which mixes after SDL_Mixer is done.
 */
 
-#ifndef YE_MIXER_DEFAULT_CHANNELS
-    // do not allocate channels by default
-    #define YE_MIXER_DEFAULT_CHANNELS 0
-#endif
-
-int audio_mix_allocated_channels = 0;
-int audio_mix_busy_channels = 0;
+void ye_finished_channel(int channel);
 
 void ye_init_audio(){
-    audio_mix_allocated_channels = 0;
-    audio_mix_busy_channels = 0;
+    totalChunks = 0;
 
-    // opens mixer to stereo with default frequency and format and 2048 chunk size
-    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, 2048) < 0) 
+    /*
+        opens mixer with default frequency and format and 2048 chunk size, the device
+        may change the frequency but must stay stereo for the engine mixer
+    */
+    if (Mix_OpenAudioDevice(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, 2048, NULL, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE) < 0) 
     {
         ye_logf(error, "SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
     }
 
-    // allocate our desired max channels to the mixer
-    if(YE_MIXER_DEFAULT_CHANNELS > 0)
-        audio_mix_allocated_channels = Mix_AllocateChannels(YE_MIXER_DEFAULT_CHANNELS);
-
     ye_init_mixer_cache();
 
-    // make all channels capped at the engine volume
-    Mix_MasterVolume(YE_STATE.engine.volume);
+    ye_init_mixer();
+    ye_mixer_voice_finished(ye_finished_channel);
+
+    // the engine volume is the gain of the master bus
+    ye_mixer_set_bus_gain(YE_BUS_MASTER, YE_STATE.engine.volume / (float)MIX_MAX_VOLUME);
 
     // debug: acknowledge audio initialization
     ye_logf(info, "Initialized audio.\n");
 }
 
+/*
+    Opening the device can take a good while (some backends probe every output),
+    so at startup it happens on a worker behind the splash screen.
+*/
+static struct ye_job_counter device_open = {0};
+
+static void _ye_open_audio_job(void *data){
+    (void)data;
+    ye_init_audio();
+}
+
+void ye_init_audio_async(){
+    // subsystem init is not thread safe, only opening the device moves to the worker
+    if(SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+        ye_logf(error, "Failed to initialize SDL audio: %s\n", SDL_GetError());
+
+    ye_job_submit(_ye_open_audio_job, NULL, &device_open);
+}
+
+void ye_audio_wait_ready(){
+    if(!ye_job_done(&device_open))
+        ye_job_wait(&device_open);
+}
+
 /*
     TODO: better way to do this? we have to make sure we dont
     free chunks and let audiosource system tentatively reschedule
@@ -209,20 +246,20 @@ bool mid_audio_shutdown = false;
 
 // stop playing and clear mixer cache, shutdown mixer
 void ye_shutdown_audio(){
+    ye_audio_wait_ready();
+
     mid_audio_shutdown = true;
 
-    // Halt all playing channels
-    Mix_HaltChannel(-1);
-    // ye_logf(debug, "Halted playing all channels.\n");
+    // stop every voice and detach from SDL_mixer
+    ye_shutdown_mixer();
 
     // free all chunks
     ye_shutdown_mixer_cache();
     // free music
     Mix_FreeMusic(music);
+    music = NULL;
 
-    // reset channel counts
-    audio_mix_allocated_channels = 0;
-    audio_mix_busy_channels = 0;
+    totalChunks = 0;
 
     // Close the audio mixer
     Mix_CloseAudio();
@@ -232,10 +269,31 @@ void ye_shutdown_audio(){
 }
 
 /*
-    Callback for when a channel finishes playing
+    Stops everything and frees every chunk and the music, but keeps the device
+    and the buses, so loading a scene does not pay for reopening the device.
+*/
+void ye_reset_audio(){
+    ye_audio_wait_ready();
+
+    mid_audio_shutdown = true;
+
+    // halts every voice before freeing the chunks
+    ye_purge_mixer_cache();
+
+    Mix_HaltMusic();
+    Mix_FreeMusic(music);
+    music = NULL;
+
+    totalChunks = 0;
+
+    mid_audio_shutdown = false;
+}
+
+/*
+    Called from ye_mixer_update (on the main thread) when a voice finishes playing
 */
 void ye_finished_channel(int channel){
-    audio_mix_busy_channels--;
+    totalChunks--;
 
     /*
         if we are about to load a new scene, we actually DO NOT
@@ -247,15 +305,19 @@ void ye_finished_channel(int channel){
         // it can go through and re-request a repeat sound if it wants to
         ye_audiosource_channel_finished(channel);
     }
-
-    // SDL_Mixer will free the empty channels later as needed
 }
 
 /*
     Play a sound by its handle.
-    retrieves from cache, creates new channel for it
+    retrieves from cache, starts a voice for it
 */
 int ye_play_sound(const char *handle, int loops, float volume_scale){ // loops will be decreased and passed to the channel finished callback to replay
+    return ye_play_sound_on_bus(handle, loops, volume_scale, YE_BUS_SFX);
+}
+
+int ye_play_sound_on_bus(const char *handle, int loops, float volume_scale, int bus){
+    ye_audio_wait_ready();
+
     // retrieve the chunk from the mixer cache
     Mix_Chunk *chunk = ye_audio(handle);
 
@@ -265,28 +327,16 @@ int ye_play_sound(const char *handle, int loops, float volume_scale){ // loops w
         return -2; // nonexistant channel
     }
 
-    // allocate a new channel to play audio on if full
-    int channel;
-    if(audio_mix_allocated_channels - audio_mix_busy_channels <= 0){
-        channel = Mix_AllocateChannels(Mix_AllocateChannels(-1) + 1);
-        if(channel == 0){
-            ye_logf(error, "Failed to allocate new audio channel.\n");
-            return -2; // nonexistant channel
-        }
+    // the engine volume is applied by the master bus
+    int voice = ye_mixer_play(chunk, bus, loops, volume_scale);
+    if(voice < 0){
+        ye_logf(error, "Failed to play audio chunk %s, no free voice.\n", handle);
+        return -2; // nonexistant channel
     }
 
-    // Free audio memory when channel finishes
-    Mix_ChannelFinished(ye_finished_channel);
-
-    // play the chunk on the channel
-    channel = Mix_PlayChannel(-1, chunk, loops);
-
-    totalChunks = audio_mix_busy_channels++;
+    totalChunks++;
 
-    // adjust the channel volume
-    Mix_Volume(channel, (int)(YE_STATE.engine.volume * volume_scale));
-
-    return channel;
+    return voice;
 }
 
 /*
@@ -294,6 +344,7 @@ int ye_play_sound(const char *handle, int loops, float volume_scale){ // loops w
     uses because it caused a windows page fault. TODO: investigate
 */
 void ye_play_music(const char *handle, int loops, float volume_scale){
+    ye_audio_wait_ready();
 
     // #ifdef __linux__
 
@@ -320,8 +371,8 @@ void ye_play_music(const char *handle, int loops, float volume_scale){
     // play the music
     Mix_PlayMusic(music, loops);
 
-    // adjust the music volume
-    Mix_VolumeMusic((int)((YE_STATE.engine.volume * volume_scale)));
+    // adjust the music volume (the engine volume is applied by the master bus)
+    Mix_VolumeMusic((int)(MIX_MAX_VOLUME * volume_scale));
 }
 
 /*
@@ -329,8 +380,9 @@ void ye_play_music(const char *handle, int loops, float volume_scale){
 */
 
 void ye_set_volume(float volume){
+    ye_audio_wait_ready();
+
     YE_STATE.engine.volume = (128 * volume);
-    Mix_VolumeMusic((128 * volume));
-    Mix_Volume(-1, (128 * volume));
+    ye_mixer_set_bus_gain(YE_BUS_MASTER, volume);
     ye_logf(debug, "Set audio volume to %d.\n", (int)(128 * volume));
 }
\ No newline at end of file
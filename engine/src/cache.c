@@ -7,13 +7,17 @@
 
 #include <string.h>
 
+#include <SDL_image.h>
 #include <jansson.h>
 
 #include <yoyoengine/yep.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/json.h>
 #include <yoyoengine/cache.h>
+#include <yoyoengine/intern.h>
 #include <yoyoengine/engine.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/scene_profiler.h>
 #include <yoyoengine/ecs/renderer.h>
 
 /*
@@ -23,6 +27,12 @@ struct ye_texture_node * cached_textures_head;
 struct ye_font_node * cached_fonts_head;
 struct ye_color_node * cached_colors_head;
 
+// defined in graphics.c, never destroyed by a reload
+extern SDL_Texture *missing_texture;
+
+// lookups through the primary api
+static struct ye_cache_stats stats = {0};
+
 /*
     TODO: properly error check and validate every field
 */
@@ -109,17 +119,13 @@ void ye_pre_cache_styles(const char *styles_path){
     */
     json_t *STYLES = NULL;
     // read fonts and colors from styles and cache them
-    if(YE_STATE.editor.editor_mode){
-        STYLES = ye_json_read(ye_path_resources(styles_path));
-    }
-    else{
-        STYLES = yep_resource_json(styles_path);
-    }
+    ye_json_arena_begin();
+    STYLES = ye_json_load_transient(styles_path);
 
     // ye_json_log(STYLES);
     if(STYLES == NULL){
         ye_logf(error,"Failed to read styles file: %s\n",styles_path);
-        json_decref(STYLES);
+        ye_json_arena_end();
         return;
     }
 
@@ -129,7 +135,8 @@ void ye_pre_cache_styles(const char *styles_path){
         ye_json_object(STYLES,"fonts",&fonts);
         if(fonts == NULL){
             ye_logf(error,"%s","Failed to read fonts from styles file.\n");
-            json_decref(STYLES);
+            ye_json_release(STYLES);
+            ye_json_arena_end();
             return;
         }
 
@@ -159,7 +166,8 @@ void ye_pre_cache_styles(const char *styles_path){
         ye_json_object(STYLES,"colors",&colors);
         if(colors == NULL){
             ye_logf(error,"%s","Failed to read colors from styles file.\n");
-            json_decref(STYLES);
+            ye_json_release(STYLES);
+            ye_json_arena_end();
             return;
         }
 
@@ -193,7 +201,8 @@ void ye_pre_cache_styles(const char *styles_path){
     }
 
     // free styles json
-    json_decref(STYLES);
+    ye_json_release(STYLES);
+    ye_json_arena_end();
 }
 
 void ye_init_cache(){
@@ -208,8 +217,8 @@ void ye_clear_texture_cache(){
     HASH_ITER(hh, cached_textures_head, texture_node, texture_tmp) {
         HASH_DEL(cached_textures_head, texture_node);
         SDL_DestroyTexture(texture_node->texture);
-        free(texture_node->path);
-        free(texture_node);
+        ye_intern_release(texture_node->path);
+        ye_free(texture_node);
     }
 }
 
@@ -225,8 +234,9 @@ void ye_clear_font_cache(){
             TTF_CloseFont(font_node->font);
         }
         
-        free(font_node->name);
-        free(font_node);
+        ye_intern_release(font_node->name);
+        ye_intern_release(font_node->path);
+        ye_free(font_node);
     }
 }
 
@@ -235,8 +245,8 @@ void ye_clear_color_cache(){
     struct ye_color_node *color_node, *color_tmp;
     HASH_ITER(hh, cached_colors_head, color_node, color_tmp) {
         HASH_DEL(cached_colors_head, color_node);
-        free(color_node->name);
-        free(color_node);
+        ye_intern_release(color_node->name);
+        ye_free(color_node);
     }
 }
 
@@ -258,56 +268,89 @@ void ye_shutdown_cache(){
     This is the intended interface with the cache system, but assumes you have pre cached fonts and colors.
 */
 
+/*
+    Every cache is keyed on the interned pointer of its name, so a string nobody has interned
+    cannot be cached and the lookup after that is a pointer hash.
+*/
+static struct ye_texture_node * _find_texture(const char *path){
+    const char *key = ye_intern_find(path);
+    struct ye_texture_node *node = NULL;
+    if(key != NULL)
+        HASH_FIND_PTR(cached_textures_head, &key, node);
+    return node;
+}
+
+static struct ye_font_node * _find_font(const char *name){
+    const char *key = ye_intern_find(name);
+    struct ye_font_node *node = NULL;
+    if(key != NULL)
+        HASH_FIND_PTR(cached_fonts_head, &key, node);
+    return node;
+}
+
+static struct ye_color_node * _find_color(const char *name){
+    const char *key = ye_intern_find(name);
+    struct ye_color_node *node = NULL;
+    if(key != NULL)
+        HASH_FIND_PTR(cached_colors_head, &key, node);
+    return node;
+}
+
 SDL_Texture * ye_image(const char *path){
     // check cache for texture named by path
-    struct ye_texture_node *node = cached_textures_head;
-    HASH_FIND_STR(cached_textures_head, path, node);
+    struct ye_texture_node *node = _find_texture(path);
     if(node != NULL){
         // ye_logf(debug,"CACHE HIT: %s\n",path);
+        stats.hits++;
         return node->texture;
     }
 
     // if not found, load texture and add to cache
     // ye_logf(warning,"CACHE MISS: %s\n",path);
+    stats.misses++;
     return ye_cache_texture(path);
 }
 
 TTF_Font * ye_font(const char *name, int size){
     // check cache for font named by name and size
-    struct ye_font_node *node;
-    for(node = cached_fonts_head; node != NULL; node = node->hh.next) {
-        if(strcmp(node->name, name) == 0) {
-            // ye_logf(debug,"CACHE HIT: %s\n",name);
-
-            // we found it, so resize if necessary
-            if(node->size != size){
-                // its good to resize here even if its larger, because huge fonts take much longer to render
-                TTF_SetFontSize(node->font,size);
-                node->size = size;
-            }
+    struct ye_font_node *node = _find_font(name);
+    if(node != NULL){
+        // ye_logf(debug,"CACHE HIT: %s\n",name);
 
-            return node->font;
+        // we found it, so resize if necessary
+        if(node->size != size){
+            // its good to resize here even if its larger, because huge fonts take much longer to render
+            TTF_SetFontSize(node->font,size);
+            node->size = size;
         }
+
+        stats.hits++;
+        return node->font;
     }
 
+    stats.misses++;
     ye_logf(error,"Font cache miss: %s. Returning default.\n",name);
     return YE_STATE.engine.pEngineFont;
 }
 
 SDL_Color * ye_color(const char *name){
     // check cache for color named by name
-    struct ye_color_node *node;
-    for(node = cached_colors_head; node != NULL; node = node->hh.next) {
-        if(strcmp(node->name, name) == 0) {
-            // ye_logf(debug,"CACHE HIT: %s\n",name);
-            return &node->color;
-        }
+    struct ye_color_node *node = _find_color(name);
+    if(node != NULL){
+        // ye_logf(debug,"CACHE HIT: %s\n",name);
+        stats.hits++;
+        return &node->color;
     }
 
+    stats.misses++;
     ye_logf(error,"Color cache miss: %s. Returning default.\n",name);
     return YE_STATE.engine.pEngineFontColor;
 }
 
+struct ye_cache_stats ye_cache_stats(){
+    return stats;
+}
+
 /*
     EXTENDED API:
     This is used by the primary API but can also be used directly by the developer.
@@ -315,11 +358,10 @@ SDL_Color * ye_color(const char *name){
 
 void ye_cache_texture_manual(SDL_Texture *texture, const char *key){
     // cache the texture
-    struct ye_texture_node *new_node = malloc(sizeof(struct ye_texture_node));
+    struct ye_texture_node *new_node = ye_malloc(YE_MEM_CACHE, sizeof(struct ye_texture_node));
     new_node->texture = texture;
-    new_node->path = malloc(strlen(key) + 1);
-    strcpy(new_node->path, key);
-    HASH_ADD_KEYPTR(hh, cached_textures_head, new_node->path, strlen(new_node->path), new_node);
+    new_node->path = ye_intern(key);
+    HASH_ADD_PTR(cached_textures_head, path, new_node);
 }
 
 SDL_Texture * ye_cache_texture(const char *path){
@@ -331,12 +373,16 @@ SDL_Texture * ye_cache_texture(const char *path){
         sur = yep_resource_image(path);
 
     // if we didnt find it, load it from disk, else create texture from it
+    // (loose files are read, decoded and uploaded in one go, so they are profiled as a single decode)
+    uint64_t stage_start = ye_scene_profiler_now();
     if(sur == NULL){
         texture = ye_create_image_texture(ye_path_resources(path));
+        ye_scene_profiler_asset(path, YE_ASSET_LOAD_DECODE, stage_start, 0);
     }
     else{
         texture = SDL_CreateTextureFromSurface(YE_STATE.runtime.renderer, sur);
         SDL_FreeSurface(sur);
+        ye_scene_profiler_asset(path, YE_ASSET_LOAD_UPLOAD, stage_start, 0);
     }
 
     // cache the texture
@@ -353,12 +399,12 @@ SDL_Texture * ye_cache_texture(const char *path){
 
 TTF_Font * ye_cache_font_manual(const char *name, TTF_Font *font){
     // cache the font
-    struct ye_font_node *new_node = malloc(sizeof(struct ye_font_node));
+    struct ye_font_node *new_node = ye_malloc(YE_MEM_CACHE, sizeof(struct ye_font_node));
     new_node->font = font;
-    new_node->name = malloc(strlen(name) + 1);
-    strcpy(new_node->name, name);
+    new_node->name = ye_intern(name);
+    new_node->path = NULL; // manually cached fonts have no file we can reload from
     new_node->size = 1; // we load the fonts at size 1 for now
-    HASH_ADD_KEYPTR(hh, cached_fonts_head, new_node->name, strlen(new_node->name), new_node);
+    HASH_ADD_PTR(cached_fonts_head, name, new_node);
     // ye_logf(debug,"Cached font: %s\n",name);
     return font;
 }
@@ -372,27 +418,116 @@ TTF_Font * ye_cache_font(const char *name, /*int size,*/ const char *path){
 
     // if we didnt find it, load it from disk
     if(font == NULL){
+        uint64_t stage_start = ye_scene_profiler_now();
         font = ye_load_font(ye_path_resources(path)/*, size*/);
+        ye_scene_profiler_asset(path, YE_ASSET_LOAD_DECODE, stage_start, 0);
     }
 
     // cache the font
-    struct ye_font_node *new_node = malloc(sizeof(struct ye_font_node));
+    struct ye_font_node *new_node = ye_malloc(YE_MEM_CACHE, sizeof(struct ye_font_node));
     new_node->font = font;
-    new_node->name = malloc(strlen(name) + 1);
-    strcpy(new_node->name, name);
+    new_node->name = ye_intern(name);
+    new_node->path = ye_intern(path);
     new_node->size = 1; // we load the fonts at size 1 for now
-    HASH_ADD_KEYPTR(hh, cached_fonts_head, new_node->name, strlen(new_node->name), new_node);
+    HASH_ADD_PTR(cached_fonts_head, name, new_node);
     // ye_logf(debug,"Cached font: %s\n",name);
     return font;
 }
 
 SDL_Color * ye_cache_color(const char *name, SDL_Color color){
     // cache the color
-    struct ye_color_node *new_node = malloc(sizeof(struct ye_color_node));
+    struct ye_color_node *new_node = ye_malloc(YE_MEM_CACHE, sizeof(struct ye_color_node));
     new_node->color = color;
-    new_node->name = malloc(strlen(name) + 1);
-    strcpy(new_node->name, name);
-    HASH_ADD_KEYPTR(hh, cached_colors_head, new_node->name, strlen(new_node->name), new_node);
+    new_node->name = ye_intern(name);
+    HASH_ADD_PTR(cached_colors_head, name, new_node);
     // ye_logf(debug,"Cached color: %s\n",name);
     return &new_node->color;
-}
\ No newline at end of file
+}
+
+/*
+    HOT RELOAD:
+    Swaps the contents of existing cache nodes for freshly loaded loose files,
+    patching anything in the ECS still holding the old pointers.
+*/
+
+int ye_reload_texture(const char *path){
+    struct ye_texture_node *node = _find_texture(path);
+    if(node == NULL){
+        return -1;
+    }
+
+    // load the surface ourselves so a half written file keeps the old texture instead of the missing one
+    SDL_Surface *sur = IMG_Load(ye_path_resources(path));
+    if(sur == NULL){
+        ye_logf(warning,"Failed to reload texture %s: %s\n", path, IMG_GetError());
+        return -1;
+    }
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(YE_STATE.runtime.renderer, sur);
+    SDL_FreeSurface(sur);
+    if(texture == NULL){
+        ye_logf(warning,"Failed to reload texture %s: %s\n", path, SDL_GetError());
+        return -1;
+    }
+
+    SDL_Texture *old = node->texture;
+    node->texture = texture;
+
+    // any renderer (image, tile or animation) sharing the old texture gets the new one
+    int patched = 0;
+    struct ye_entity_node *current = renderer_list_head;
+    while(current != NULL){
+        if(current->entity->renderer->texture == old){
+            current->entity->renderer->texture = texture;
+            patched++;
+        }
+        current = current->next;
+    }
+
+    if(old != missing_texture)
+        SDL_DestroyTexture(old);
+
+    return patched;
+}
+
+int ye_reload_font_file(const char *path){
+    int patched = -1;
+
+    const char *key = ye_intern_find(path);
+    if(key == NULL)
+        return patched;
+
+    struct ye_font_node *node, *tmp;
+    HASH_ITER(hh, cached_fonts_head, node, tmp) {
+        if(node->path != key)
+            continue;
+
+        TTF_Font *font = TTF_OpenFont(ye_path_resources(path), node->size);
+        if(font == NULL){
+            ye_logf(warning,"Failed to reload font %s: %s\n", path, TTF_GetError());
+            continue;
+        }
+
+        TTF_Font *old = node->font;
+        node->font = font;
+        if(patched < 0)
+            patched = 0;
+
+        // regenerate any text that was rendered with the old font
+        struct ye_entity_node *current = renderer_list_head;
+        while(current != NULL){
+            struct ye_component_renderer *renderer = current->entity->renderer;
+            if((renderer->type == YE_RENDERER_TYPE_TEXT && renderer->renderer_impl.text->font == old) ||
+               (renderer->type == YE_RENDERER_TYPE_TEXT_OUTLINED && renderer->renderer_impl.text_outlined->font == old)){
+                ye_update_renderer_component(current->entity);
+                patched++;
+            }
+            current = current->next;
+        }
+
+        if(old != NULL && old != YE_STATE.engine.pEngineFont)
+            TTF_CloseFont(old);
+    }
+
+    return patched;
+}
@@ -0,0 +1,503 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #define NK_INCLUDE_FIXED_TYPES
+#endif
+
+#include <Nuklear/nuklear.h>
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <jansson.h>
+
+#include <yoyoengine/yep.h>
+#include <yoyoengine/json.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/capture.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/ecs/camera.h>
+
+static const char *source_names[YE_CAPTURE_SOURCE_COUNT] = {"scene", "debug", "ui"};
+
+/*
+    ==========================================
+                    RECORDING
+    ==========================================
+*/
+
+static char *armed_path = NULL;    // set by ye_capture_frame, taken by the next frame
+static char *recording_path = NULL;
+
+static struct ye_capture_op *ops = NULL;
+static int op_count = 0;
+static int op_capacity = 0;
+
+static int frame_width, frame_height;
+static int window_width, window_height;
+
+// the last capture written, for the overlay
+static char last_capture[512] = "";
+
+void ye_capture_frame(const char *path){
+    char default_path[64];
+    if(path == NULL){
+        snprintf(default_path, sizeof(default_path), "capture_%llu.json", (unsigned long long)SDL_GetTicks64());
+        path = ye_path(default_path);
+    }
+
+    ye_free(armed_path);
+    armed_path = ye_strdup(YE_MEM_GENERAL, path);
+    ye_logf(info, "Capturing the next frame to %s.\n", armed_path);
+}
+
+bool ye_capture_recording(){
+    return recording_path != NULL;
+}
+
+void ye_capture_record(const struct ye_capture_op *op){
+    if(recording_path == NULL)
+        return;
+
+    if(op_count == op_capacity){
+        op_capacity = op_capacity == 0 ? 256 : op_capacity * 2;
+        ops = ye_realloc(YE_MEM_GENERAL, ops, op_capacity * sizeof(struct ye_capture_op));
+    }
+    ops[op_count++] = *op;
+}
+
+void ye_capture_share_cost(int count, float cost_ms){
+    if(recording_path == NULL || count <= 0)
+        return;
+
+    count = SDL_min(count, op_count);
+    for(int i = op_count - count; i < op_count; i++)
+        ops[i].cost_ms += cost_ms / count;
+}
+
+void ye_capture_begin_frame(){
+    if(armed_path == NULL)
+        return;
+
+    recording_path = armed_path;
+    armed_path = NULL;
+    op_count = 0;
+
+    // the scene is drawn at the camera's logical size unless the viewport is stretched
+    SDL_GetRendererOutputSize(YE_STATE.runtime.renderer, &frame_width, &frame_height);
+    if(!YE_STATE.engine.stretch_viewport && YE_STATE.engine.target_camera != NULL && YE_STATE.engine.target_camera->camera != NULL){
+        frame_width = (int)YE_STATE.engine.target_camera->camera->view_field.w;
+        frame_height = (int)YE_STATE.engine.target_camera->camera->view_field.h;
+    }
+    SDL_GetWindowSize(YE_STATE.runtime.window, &window_width, &window_height);
+}
+
+static json_t * _rect_json(SDL_Rect rect){
+    json_t *array = json_array();
+    json_array_append_new(array, json_integer(rect.x));
+    json_array_append_new(array, json_integer(rect.y));
+    json_array_append_new(array, json_integer(rect.w));
+    json_array_append_new(array, json_integer(rect.h));
+    return array;
+}
+
+void ye_capture_end_frame(){
+    if(recording_path == NULL)
+        return;
+
+    json_t *root = json_object();
+    json_object_set_new(root, "version", json_integer(YE_CAPTURE_VERSION));
+    json_object_set_new(root, "scene", json_string(YE_STATE.runtime.scene_name != NULL ? YE_STATE.runtime.scene_name : ""));
+    json_object_set_new(root, "width", json_integer(frame_width));
+    json_object_set_new(root, "height", json_integer(frame_height));
+    json_object_set_new(root, "window_width", json_integer(window_width));
+    json_object_set_new(root, "window_height", json_integer(window_height));
+
+    // every texture is listed once, draws refer to it by index
+    json_t *textures = json_array();
+    json_t *draws = json_array();
+    for(int i = 0; i < op_count; i++){
+        struct ye_capture_op *op = &ops[i];
+
+        int texture = -1;
+        if(op->texture[0] != '\0'){
+            for(size_t t = 0; t < json_array_size(textures) && texture < 0; t++){
+                if(strcmp(json_string_value(json_array_get(textures, t)), op->texture) == 0)
+                    texture = (int)t;
+            }
+            if(texture < 0){
+                texture = (int)json_array_size(textures);
+                json_array_append_new(textures, json_string(op->texture));
+            }
+        }
+
+        json_t *color = json_array();
+        json_array_append_new(color, json_integer(op->color.r));
+        json_array_append_new(color, json_integer(op->color.g));
+        json_array_append_new(color, json_integer(op->color.b));
+        json_array_append_new(color, json_integer(op->color.a));
+
+        json_t *draw = json_object();
+        json_object_set_new(draw, "source", json_string(source_names[op->source]));
+        json_object_set_new(draw, "texture", json_integer(texture));
+        json_object_set_new(draw, "label", json_string(op->label));
+        json_object_set_new(draw, "src", _rect_json(op->src));
+        json_object_set_new(draw, "dst", _rect_json(op->dst));
+        json_object_set_new(draw, "rotation", json_real(op->rotation));
+        json_object_set_new(draw, "flip", json_integer(op->flip));
+        json_object_set_new(draw, "alpha", json_integer(op->alpha));
+        json_object_set_new(draw, "z", json_integer(op->z));
+        json_object_set_new(draw, "entity", json_integer(op->entity));
+        json_object_set_new(draw, "color", color);
+        json_object_set_new(draw, "cost_ms", json_real(op->cost_ms));
+        json_array_append_new(draws, draw);
+    }
+    json_object_set_new(root, "textures", textures);
+    json_object_set_new(root, "draws", draws);
+
+    if(ye_json_write(recording_path, root) == 0){
+        ye_logf(info, "Captured %d draws to %s.\n", op_count, recording_path);
+        snprintf(last_capture, sizeof(last_capture), "%s", recording_path);
+    }
+    else{
+        ye_logf(error, "Failed to write the capture %s.\n", recording_path);
+    }
+    json_decref(root);
+
+    ye_free(recording_path);
+    recording_path = NULL;
+    op_count = 0;
+}
+
+/*
+    ==========================================
+                    REPLAY
+    ==========================================
+*/
+
+static SDL_Rect _rect_from_json(json_t *array){
+    SDL_Rect rect = {0};
+    ye_json_arr_int(array, 0, &rect.x);
+    ye_json_arr_int(array, 1, &rect.y);
+    ye_json_arr_int(array, 2, &rect.w);
+    ye_json_arr_int(array, 3, &rect.h);
+    return rect;
+}
+
+// reads the draws of a capture into a new array (ye_free it)
+static struct ye_capture_op * _read_draws(json_t *root, json_t *textures, int *count){
+    json_t *draws = NULL;
+    if(!ye_json_array(root, "draws", &draws)){
+        *count = 0;
+        return NULL;
+    }
+
+    *count = (int)json_array_size(draws);
+    struct ye_capture_op *read = ye_calloc(YE_MEM_GENERAL, *count > 0 ? *count : 1, sizeof(struct ye_capture_op));
+
+    for(int i = 0; i < *count; i++){
+        json_t *draw = json_array_get(draws, i);
+        struct ye_capture_op *op = &read[i];
+
+        const char *source = "scene";
+        ye_json_string(draw, "source", &source);
+        for(int s = 0; s < YE_CAPTURE_SOURCE_COUNT; s++){
+            if(strcmp(source, source_names[s]) == 0)
+                op->source = s;
+        }
+
+        int texture = -1;
+        const char *handle = NULL;
+        ye_json_int(draw, "texture", &texture);
+        if(texture >= 0 && ye_json_arr_string(textures, texture, &handle))
+            snprintf(op->texture, sizeof(op->texture), "%s", handle);
+
+        const char *label = "";
+        ye_json_string(draw, "label", &label);
+        snprintf(op->label, sizeof(op->label), "%s", label);
+
+        op->src = _rect_from_json(json_object_get(draw, "src"));
+        op->dst = _rect_from_json(json_object_get(draw, "dst"));
+        ye_json_float(draw, "rotation", &op->rotation);
+        ye_json_int(draw, "flip", &op->flip);
+        ye_json_int(draw, "alpha", &op->alpha);
+        ye_json_int(draw, "z", &op->z);
+        ye_json_int(draw, "entity", &op->entity);
+        ye_json_float(draw, "cost_ms", &op->cost_ms);
+
+        json_t *color = json_object_get(draw, "color");
+        int channel[4] = {255, 255, 255, 255};
+        for(int c = 0; c < 4; c++)
+            ye_json_arr_int(color, c, &channel[c]);
+        op->color = (SDL_Color){channel[0], channel[1], channel[2], channel[3]};
+    }
+
+    return read;
+}
+
+static SDL_Texture * _load_texture(SDL_Renderer *renderer, const char *handle){
+    SDL_Surface *surface = NULL;
+    if(YE_STATE.editor.editor_mode)
+        surface = IMG_Load(ye_path_resources(handle));
+    else
+        surface = yep_resource_image(handle);
+
+    if(surface == NULL)
+        return NULL;
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+static bool _replay(const char *path, struct ye_capture_report *report,
+                    void (*step)(int index, const struct ye_capture_op *op, SDL_Surface *target, void *data), void *data,
+                    struct ye_capture_op **draws_out, int *count_out){
+    memset(report, 0, sizeof(*report));
+    report->most_expensive = -1;
+
+    json_t *root = ye_json_read(path);
+    if(root == NULL){
+        ye_logf(error, "Could not read the capture %s.\n", path);
+        return false;
+    }
+
+    int version = 0, width = 0, height = 0, ui_width = 0, ui_height = 0;
+    ye_json_int(root, "version", &version);
+    ye_json_int(root, "width", &width);
+    ye_json_int(root, "height", &height);
+    ye_json_int(root, "window_width", &ui_width);
+    ye_json_int(root, "window_height", &ui_height);
+    if(version > YE_CAPTURE_VERSION || width <= 0 || height <= 0){
+        ye_logf(error, "%s is not a capture this engine can replay.\n", path);
+        json_decref(root);
+        return false;
+    }
+
+    json_t *textures = NULL;
+    if(!ye_json_array(root, "textures", &textures))
+        textures = NULL;
+
+    int count = 0;
+    struct ye_capture_op *draws = _read_draws(root, textures, &count);
+
+    // load every texture once, up front
+    int texture_count = textures != NULL ? (int)json_array_size(textures) : 0;
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer *renderer = target != NULL ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if(renderer == NULL){
+        ye_logf(error, "Could not create a software renderer to replay %s: %s\n", path, SDL_GetError());
+        SDL_FreeSurface(target);
+        ye_free(draws);
+        json_decref(root);
+        return false;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    SDL_Texture **loaded = ye_calloc(YE_MEM_GENERAL, texture_count > 0 ? texture_count : 1, sizeof(SDL_Texture *));
+    for(int t = 0; t < texture_count; t++){
+        const char *handle = NULL;
+        ye_json_arr_string(textures, t, &handle);
+        loaded[t] = handle != NULL ? _load_texture(renderer, handle) : NULL;
+        if(loaded[t] == NULL)
+            report->missing_textures++;
+    }
+
+    // how many draws touched each pixel
+    Uint16 *coverage = ye_calloc(YE_MEM_GENERAL, (size_t)width * height, sizeof(Uint16));
+
+    // ui is recorded in window coordinates
+    float ui_scale_x = ui_width > 0 ? (float)width / ui_width : 1.0f;
+    float ui_scale_y = ui_height > 0 ? (float)height / ui_height : 1.0f;
+
+    for(int i = 0; i < count; i++){
+        struct ye_capture_op *op = &draws[i];
+
+        SDL_Rect dst = op->dst;
+        if(op->source == YE_CAPTURE_UI){
+            dst.x = (int)(dst.x * ui_scale_x);
+            dst.y = (int)(dst.y * ui_scale_y);
+            dst.w = (int)(dst.w * ui_scale_x);
+            dst.h = (int)(dst.h * ui_scale_y);
+        }
+
+        SDL_Texture *texture = NULL;
+        if(op->texture[0] != '\0'){
+            for(int t = 0; t < texture_count && texture == NULL; t++){
+                const char *handle = NULL;
+                if(ye_json_arr_string(textures, t, &handle) && strcmp(handle, op->texture) == 0)
+                    texture = loaded[t];
+            }
+        }
+
+        if(texture != NULL){
+            SDL_SetTextureAlphaMod(texture, op->alpha);
+            SDL_RenderCopyEx(renderer, texture, op->src.w > 0 ? &op->src : NULL, &dst, op->rotation, NULL, op->flip);
+        }
+        else{
+            // shapes in their own color, anything that lost its texture in magenta
+            SDL_Color color = op->color;
+            if(op->texture[0] != '\0')
+                color = (SDL_Color){255, 0, 255, op->alpha};
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            SDL_RenderFillRect(renderer, &dst);
+        }
+        SDL_RenderFlush(renderer);
+
+        // count overdraw over the clipped dst
+        SDL_Rect bounds = {0, 0, width, height}, clipped;
+        if(SDL_IntersectRect(&dst, &bounds, &clipped)){
+            for(int y = clipped.y; y < clipped.y + clipped.h; y++){
+                Uint16 *row = coverage + (size_t)y * width;
+                for(int x = clipped.x; x < clipped.x + clipped.w; x++){
+                    if(row[x] < UINT16_MAX)
+                        row[x]++;
+                }
+            }
+        }
+
+        report->draw_calls++;
+        report->draw_calls_by_source[op->source]++;
+        if(i > 0 && strcmp(op->texture, draws[i - 1].texture) != 0)
+            report->texture_switches++;
+        report->cost_ms += op->cost_ms;
+        if(report->most_expensive < 0 || op->cost_ms > draws[report->most_expensive].cost_ms)
+            report->most_expensive = i;
+
+        if(step != NULL)
+            step(i, op, target, data);
+    }
+
+    uint64_t covered = 0, fragments = 0;
+    for(size_t p = 0; p < (size_t)width * height; p++){
+        if(coverage[p] == 0)
+            continue;
+        covered++;
+        fragments += coverage[p];
+        if(coverage[p] > report->max_overdraw)
+            report->max_overdraw = coverage[p];
+    }
+    report->width = width;
+    report->height = height;
+    report->covered = (float)covered / ((float)width * height);
+    report->average_overdraw = covered > 0 ? (float)fragments / covered : 0.0f;
+
+    for(int t = 0; t < texture_count; t++){
+        if(loaded[t] != NULL)
+            SDL_DestroyTexture(loaded[t]);
+    }
+    ye_free(loaded);
+    ye_free(coverage);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    json_decref(root);
+
+    if(draws_out != NULL){
+        *draws_out = draws;
+        *count_out = count;
+    }
+    else{
+        ye_free(draws);
+    }
+    return true;
+}
+
+bool ye_capture_replay(const char *path, struct ye_capture_report *report,
+                       void (*step)(int index, const struct ye_capture_op *op, SDL_Surface *target, void *data), void *data){
+    struct ye_capture_report unused;
+    bool replayed = _replay(path, report != NULL ? report : &unused, step, data, NULL, NULL);
+    if(replayed && report != NULL){
+        ye_logf(info, "Replayed %s: %d draws, %d texture switches, %.2fx average overdraw (%d max) over %.0f%% of the frame.\n",
+            path, report->draw_calls, report->texture_switches, report->average_overdraw, report->max_overdraw, report->covered * 100.0f);
+    }
+    return replayed;
+}
+
+/*
+    ==========================================
+                    INSPECTOR
+    ==========================================
+*/
+
+// the capture the overlay replayed last
+static struct ye_capture_op *inspected = NULL;
+static int inspected_count = 0;
+static struct ye_capture_report inspected_report;
+static int inspected_step = 0;
+
+void ye_capture_overlay(struct nk_context *ctx){
+    if (nk_begin(ctx, "capture", nk_rect(380, 320, 420, 360),
+                    NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE)) {
+        char str[256];
+
+        nk_layout_row_dynamic(ctx, 25, 2);
+        if(nk_button_label(ctx, "capture next frame (F12)"))
+            ye_capture_frame(NULL);
+        if(nk_button_label(ctx, "replay last capture") && last_capture[0] != '\0'){
+            ye_free(inspected);
+            inspected = NULL;
+            inspected_count = 0;
+            inspected_step = 0;
+            if(!_replay(last_capture, &inspected_report, NULL, NULL, &inspected, &inspected_count))
+                memset(&inspected_report, 0, sizeof(inspected_report));
+        }
+
+        nk_layout_row_dynamic(ctx, 20, 1);
+        snprintf(str, sizeof(str), "last capture: %s", last_capture[0] != '\0' ? last_capture : "none");
+        nk_label(ctx, str, NK_TEXT_LEFT);
+
+        if(inspected != NULL){
+            struct ye_capture_report *r = &inspected_report;
+            snprintf(str, sizeof(str), "%d draws (scene %d, debug %d, ui %d), %d texture switches",
+                r->draw_calls, r->draw_calls_by_source[YE_CAPTURE_SCENE], r->draw_calls_by_source[YE_CAPTURE_DEBUG],
+                r->draw_calls_by_source[YE_CAPTURE_UI], r->texture_switches);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+            snprintf(str, sizeof(str), "overdraw %.2fx avg, %d max, %.0f%% covered, %d missing textures",
+                r->average_overdraw, r->max_overdraw, r->covered * 100.0f, r->missing_textures);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+            snprintf(str, sizeof(str), "%.3fms submitting, costliest draw #%d", r->cost_ms, r->most_expensive);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+
+            if(inspected_count > 0){
+                nk_layout_row_dynamic(ctx, 25, 1);
+                nk_slider_int(ctx, 0, &inspected_step, inspected_count - 1, 1);
+
+                struct ye_capture_op *op = &inspected[inspected_step];
+                nk_layout_row_dynamic(ctx, 20, 1);
+                snprintf(str, sizeof(str), "#%d %s \"%s\" entity %d z %d", inspected_step, source_names[op->source], op->label, op->entity, op->z);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+                snprintf(str, sizeof(str), "texture: %s", op->texture[0] != '\0' ? op->texture : "(none)");
+                nk_label(ctx, str, NK_TEXT_LEFT);
+                snprintf(str, sizeof(str), "src %d,%d %dx%d  dst %d,%d %dx%d", op->src.x, op->src.y, op->src.w, op->src.h,
+                    op->dst.x, op->dst.y, op->dst.w, op->dst.h);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+                snprintf(str, sizeof(str), "rotation %.1f flip %d alpha %d  %.4fms", op->rotation, op->flip, op->alpha, op->cost_ms);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+        }
+    }
+    nk_end(ctx);
+}
+
+void ye_shutdown_capture(){
+    ye_free(armed_path);
+    ye_free(recording_path);
+    ye_free(ops);
+    ye_free(inspected);
+    armed_path = recording_path = NULL;
+    ops = inspected = NULL;
+    op_count = op_capacity = inspected_count = 0;
+}
@@ -7,10 +7,12 @@
 
 #include <SDL.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include <yoyoengine/utils.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/capture.h>
 #include <yoyoengine/debug_renderer.h>
 
 struct ye_additional_render_callback_node * additional_render_head = NULL;
@@ -82,6 +84,47 @@ void ye_additional_render_fn_push(void (*fn)(void), bool persistent){
     Engine impl
 */
 
+// records an immediate node (already offset by the camera) into the frame capture, timed from start
+static void _ye_capture_immediate(struct ye_debug_render_immediate_node *node, SDL_Rect camera_rect, Uint64 start){
+    struct ye_capture_op op = {0};
+
+    op.source = YE_CAPTURE_DEBUG;
+    op.entity = -1;
+    op.alpha = node->color.a;
+    op.color = node->color;
+    op.cost_ms = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+
+    // the bounds of the shape
+    switch(node->type){
+        case YE_DEBUG_RENDER_LINE: {
+            SDL_Point a = node->data.line.start, b = node->data.line.end;
+            op.dst = (SDL_Rect){SDL_min(a.x, b.x), SDL_min(a.y, b.y), abs(a.x - b.x) + node->width, abs(a.y - b.y) + node->width};
+            snprintf(op.label, sizeof(op.label), "line");
+            break;
+        }
+        case YE_DEBUG_RENDER_RECT:
+            op.dst = node->data.rect;
+            snprintf(op.label, sizeof(op.label), "rect");
+            break;
+        case YE_DEBUG_RENDER_CIRCLE: {
+            int r = node->data.circle.radius;
+            op.dst = (SDL_Rect){node->data.circle.center.x - r, node->data.circle.center.y - r, r * 2, r * 2};
+            snprintf(op.label, sizeof(op.label), "circle");
+            break;
+        }
+        case YE_DEBUG_RENDER_POINT:
+            op.dst = (SDL_Rect){node->data.point.x, node->data.point.y, node->width, node->width};
+            snprintf(op.label, sizeof(op.label), "point");
+            break;
+        default:
+            break;
+    }
+    op.dst.x -= camera_rect.x;
+    op.dst.y -= camera_rect.y;
+
+    ye_capture_record(&op);
+}
+
 void ye_debug_renderer_render(){
 
     SDL_Renderer * renderer = YE_STATE.runtime.renderer;
@@ -93,6 +136,8 @@ void ye_debug_renderer_render(){
     */
     struct ye_debug_render_immediate_node * itr = immediate_render_head;
     while(itr != NULL){
+        Uint64 capture_start = ye_capture_recording() ? SDL_GetPerformanceCounter() : 0;
+
         // set render color
         SDL_SetRenderDrawColor(renderer, itr->color.r, itr->color.g, itr->color.b, itr->color.a);
         
@@ -120,6 +165,9 @@ void ye_debug_renderer_render(){
                 break;
         }
 
+        if(capture_start != 0)
+            _ye_capture_immediate(itr, camera_rect, capture_start);
+
         // free this node and move to the next
         struct ye_debug_render_immediate_node * temp = itr;
         itr = itr->next;
@@ -132,7 +180,17 @@ void ye_debug_renderer_render(){
     */
     struct ye_additional_render_callback_node * itr_fn = additional_render_head;
     while(itr_fn != NULL){
+        Uint64 capture_start = ye_capture_recording() ? SDL_GetPerformanceCounter() : 0;
+
         itr_fn->fn();
+
+        // whatever the callback drew is recorded as one op without bounds
+        if(capture_start != 0){
+            struct ye_capture_op op = {.source = YE_CAPTURE_DEBUG, .label = "callback", .entity = -1, .alpha = 255};
+            op.cost_ms = (float)((SDL_GetPerformanceCounter() - capture_start) * 1000.0 / SDL_GetPerformanceFrequency());
+            ye_capture_record(&op);
+        }
+
         itr_fn = itr_fn->next;
     }
 }
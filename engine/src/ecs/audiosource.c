@@ -5,19 +5,26 @@
     Licensed under the MIT license. See LICENSE file in the project root for details.
 */
 
+#include <math.h>
 #include <string.h>
 
 #include <SDL_mixer.h>
 
 #include <yoyoengine/audio.h>
+#include <yoyoengine/mixer.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/ecs/audiosource.h>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 void ye_add_audiosource_component(struct ye_entity *entity, const char *handle, float volume, bool play_on_awake, int loops, bool simulated, struct ye_rectf range){
     /*
         Add an audiosource component to the entity
     */
-    struct ye_component_audiosource *newsrc = malloc(sizeof(struct ye_component_audiosource));
+    struct ye_component_audiosource *newsrc = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_audiosource));
 
     // alloc the handle
     newsrc->handle = strdup(handle);
@@ -36,6 +43,7 @@ void ye_add_audiosource_component(struct ye_entity *entity, const char *handle,
 
     // add the entity to the audiosource list
     ye_entity_list_add(&audiosource_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_AUDIOSOURCE);
 
     if(play_on_awake && !YE_STATE.editor.editor_mode){
         // play the sound
@@ -65,10 +73,11 @@ void ye_remove_audiosource_component(struct ye_entity *entity){
         Remove an audiosource component from the entity
     */
     free(entity->audiosource->handle);
-    free(entity->audiosource);
+    ye_free(entity->audiosource);
 
     // remove the entity from the audiosource list
     ye_entity_list_remove(&audiosource_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_AUDIOSOURCE);
 
     // mixer cache takes care of removing chunk as needed
 }
@@ -78,6 +87,9 @@ void ye_remove_audiosource_component(struct ye_entity *entity){
     this math could be optimized and made better
 */
 void ye_system_audiosource(){
+    // recycle finished voices first, which may reschedule looping sources
+    ye_mixer_update();
+
     /*
         We are considering the center of the active camera to be the audio listener
     */
@@ -144,24 +156,26 @@ void ye_system_audiosource(){
                         angle += 360;
                     }
 
-                    // SDL_Mixer takes in a uint8_t for the distance, so we need to scale the distance to 0-255
-                    // scale taking into account the falloff ring
-                    int distance_from_center_scaled = (int)(distance / ((src->range.w / 2) - (src->range.h / 2)) * 255);
+                    // scale the distance to 0-1 taking into account the falloff ring
+                    float attenuation = distance / ((src->range.w / 2) - (src->range.h / 2));
 
-                    if(distance_from_center_scaled > 255){
-                        // mute the channel
-                        Mix_Volume(src->channel, 0);
+                    if(attenuation > 1){
+                        // mute the voice
+                        ye_mixer_set_voice_gain(src->channel, 0, 0);
                     }
                     else{
                         if(src->playing && src->channel == -10){
                             src->channel = ye_play_sound(src->handle, src->loops, src->volume);
                         }
 
-                        // adjust the volume of the channel
-                        Mix_Volume(src->channel, (int)(YE_STATE.engine.volume * src->volume));
-
-                        // set the position of the channel
-                        Mix_SetPosition(src->channel, (Sint16)angle, (Uint8)distance_from_center_scaled);
+                        /*
+                            constant power pan, 90 degrees is hard right and 270 hard left,
+                            in front and behind are both centered
+                        */
+                        float pan = sinf(angle * (float)(M_PI / 180.0));
+                        float theta = (pan + 1) * (float)(M_PI / 4);
+                        float gain = src->volume * (1 - attenuation);
+                        ye_mixer_set_voice_gain(src->channel, gain * cosf(theta), gain * sinf(theta));
                     }
                 }
             }
@@ -170,9 +184,8 @@ void ye_system_audiosource(){
                 if(src->playing && src->channel == -10){
                     src->channel = ye_play_sound(src->handle, src->loops, src->volume);
                 }
-                Mix_Volume(src->channel, (int)(YE_STATE.engine.volume * src->volume));
-                // remove any spatial mix
-                Mix_SetPosition(src->channel, 0, 0);
+                // no spatial mix, the engine volume is applied by the master bus
+                ye_mixer_set_voice_gain(src->channel, src->volume, src->volume);
             }
         }
     }
@@ -8,6 +8,8 @@
 #include <stdbool.h>
 
 #include <yoyoengine/utils.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/observer.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/button.h>
 
@@ -17,7 +19,7 @@
 */
 
 void ye_add_button_component(struct ye_entity *entity, struct ye_rectf rect){
-    struct ye_component_button *button = malloc(sizeof(struct ye_component_button));
+    struct ye_component_button *button = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_button));
     button->active = true;
     button->relative = false;
     button->rect = rect;
@@ -30,12 +32,14 @@ void ye_add_button_component(struct ye_entity *entity, struct ye_rectf rect){
 
     entity->button = button;
     ye_entity_list_add(&button_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_BUTTON);
 }
 
 void ye_remove_button_component(struct ye_entity *entity){
-    free(entity->button);
+    ye_free(entity->button);
     entity->button = NULL;
     ye_entity_list_remove(&button_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_BUTTON);
 }
 
 void ye_system_button(SDL_Event event){
@@ -48,8 +52,7 @@ void ye_system_button(SDL_Event event){
     ye_get_mouse_world_position(&mouseX, &mouseY);
 
     // iterate over button list
-    struct ye_entity_node *itr = button_list_head;
-    while(itr != NULL){
+    for(struct ye_entity_node *itr = button_list_head; itr != NULL; itr = itr->next){
         struct ye_entity *entity = itr->entity;
         struct ye_component_button *button = entity->button;
 
@@ -57,6 +60,9 @@ void ye_system_button(SDL_Event event){
         if(!button->active)
             continue;
 
+        bool was_hovered = button->is_hovered;
+        bool was_pressed = button->is_pressed;
+
         // get the position of the button
         struct ye_rectf pos = ye_get_position(entity, YE_COMPONENT_BUTTON);
 
@@ -77,6 +83,12 @@ void ye_system_button(SDL_Event event){
             // if the mouse is up after a press we are clicking
             if (button->_was_pressed && event.type == SDL_MOUSEBUTTONUP) {
                 button->is_clicked = true;
+                ye_observer_record(entity, YE_COMPONENT_BUTTON, YE_OBSERVE_BUTTON_CLICK);
+            }
+
+            // letting go ends the press
+            if (event.type == SDL_MOUSEBUTTONUP) {
+                button->is_pressed = false;
             }
 
             // update was_pressed for the next run
@@ -89,7 +101,11 @@ void ye_system_button(SDL_Event event){
             button->_was_pressed = false;
         }
 
-        itr = itr->next;
+        // tell observers about the transitions (see observer.h)
+        if(button->is_hovered != was_hovered)
+            ye_observer_record(entity, YE_COMPONENT_BUTTON, button->is_hovered ? YE_OBSERVE_BUTTON_HOVER : YE_OBSERVE_BUTTON_UNHOVER);
+        if(button->is_pressed != was_pressed)
+            ye_observer_record(entity, YE_COMPONENT_BUTTON, button->is_pressed ? YE_OBSERVE_BUTTON_PRESS : YE_OBSERVE_BUTTON_RELEASE);
     }
 }
 
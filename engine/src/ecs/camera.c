@@ -8,6 +8,7 @@
 #include <stdbool.h>
 
 #include <yoyoengine/engine.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/ecs/camera.h>
 
 void ye_set_camera(struct ye_entity *entity){
@@ -15,7 +16,7 @@ void ye_set_camera(struct ye_entity *entity){
 }
 
 void ye_add_camera_component(struct ye_entity *entity, int z, struct ye_rectf view_field){
-    entity->camera = malloc(sizeof(struct ye_component_camera));
+    entity->camera = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_camera));
     entity->camera->active = true;
     entity->camera->view_field = view_field; // x and y are used as an offset from the transform on the camera
     entity->camera->z = z;
@@ -26,12 +27,14 @@ void ye_add_camera_component(struct ye_entity *entity, int z, struct ye_rectf vi
 
     // add this entity to the camera component list
     ye_entity_list_add(&camera_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_CAMERA);
 }
 
 void ye_remove_camera_component(struct ye_entity *entity){
-    free(entity->camera);
+    ye_free(entity->camera);
     entity->camera = NULL;
 
     // remove the entity from the camera component list
     ye_entity_list_remove(&camera_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_CAMERA);
 }
\ No newline at end of file
@@ -6,16 +6,25 @@
 */
 
 #include <yoyoengine/utils.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/physics.h>
 #include <yoyoengine/ecs/collider.h>
 
 void ye_add_static_collider_component(struct ye_entity *entity, struct ye_rectf rect){
-    struct ye_component_collider *collider = malloc(sizeof(struct ye_component_collider));
+    struct ye_component_collider *collider = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_collider));
     collider->active = true;
     collider->rect = rect;
     collider->is_trigger = false;
+    collider->body = YE_COLLIDER_BODY_AUTO;
+    collider->layer = 0;
+    collider->_step_slot = -1;
     entity->collider = collider;
     ye_entity_list_add(&collider_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_COLLIDER);
+
+    if(ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC)
+        ye_physics_invalidate_static();
 }
 
 void ye_add_trigger_collider_component(struct ye_entity *entity, struct ye_rectf rect){
@@ -23,8 +32,31 @@ void ye_add_trigger_collider_component(struct ye_entity *entity, struct ye_rectf
     entity->collider->is_trigger = true;
 }
 
+void ye_collider_set_body(struct ye_entity *entity, enum ye_collider_body body){
+    if(entity->collider->body == body)
+        return;
+
+    bool was_static = ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC;
+    entity->collider->body = body;
+
+    // the grid needs rebuilding if a collider enters or leaves it
+    if(was_static || ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC)
+        ye_physics_invalidate_static();
+}
+
+enum ye_collider_body ye_collider_body(struct ye_entity *entity){
+    if(entity->collider->body != YE_COLLIDER_BODY_AUTO)
+        return entity->collider->body;
+    return entity->physics != NULL ? YE_COLLIDER_BODY_DYNAMIC : YE_COLLIDER_BODY_STATIC;
+}
+
 void ye_remove_collider_component(struct ye_entity *entity){
-    free(entity->collider);
+    if(ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC)
+        ye_physics_invalidate_static();
+    ye_physics_forget_contacts(entity);
+
+    ye_free(entity->collider);
     entity->collider = NULL;
     ye_entity_list_remove(&collider_list_head, entity);
-}
\ No newline at end of file
+    ye_entity_component_removed(entity, YE_COMPONENT_COLLIDER);
+}
@@ -13,7 +13,13 @@
 
 #include <yoyoengine/yep.h>
 #include <yoyoengine/cache.h>
+#include <yoyoengine/tween.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/intern.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/observer.h>
+#include <yoyoengine/utils.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/tag.h>
 #include <yoyoengine/ecs/camera.h>
@@ -28,6 +34,60 @@
 // entity id counter (used to assign unique ids to entities)
 int eid = 0;
 
+/*
+    Entity slots
+
+    Ids only ever grow within a scene, so anything indexed by entity (query membership) uses
+    a slot instead, which is handed back when the entity is destroyed. The highest slot is
+    the most entities that were alive at once.
+
+    Each slot also remembers the entity holding it, so ye_entity_alive can check a pointer
+    that might be dangling without reading through it.
+*/
+static int next_slot = 0;
+static int *free_slots = NULL;
+static int free_slot_count = 0;
+static int free_slot_capacity = 0;
+
+static struct ye_entity **slot_owners = NULL;
+static int slot_owner_capacity = 0;
+
+// set once ye_shutdown_ecs_queries freed the above, entities destroyed after that give nothing back
+static bool slots_shut_down = false;
+
+static int _acquire_slot(struct ye_entity *entity){
+    int slot = free_slot_count > 0 ? free_slots[--free_slot_count] : next_slot++;
+
+    if(slot >= slot_owner_capacity){
+        int capacity = slot_owner_capacity > 0 ? slot_owner_capacity * 2 : 64;
+        while(capacity <= slot)
+            capacity *= 2;
+        slot_owners = ye_realloc(YE_MEM_ECS, slot_owners, sizeof(struct ye_entity *) * capacity);
+        memset(slot_owners + slot_owner_capacity, 0, sizeof(struct ye_entity *) * (capacity - slot_owner_capacity));
+        slot_owner_capacity = capacity;
+    }
+    slot_owners[slot] = entity;
+    return slot;
+}
+
+static void _release_slot(int slot){
+    if(slots_shut_down)
+        return;
+
+    slot_owners[slot] = NULL;
+
+    if(free_slot_count == free_slot_capacity){
+        free_slot_capacity = free_slot_capacity > 0 ? free_slot_capacity * 2 : 64;
+        free_slots = ye_realloc(YE_MEM_ECS, free_slots, sizeof(int) * free_slot_capacity);
+    }
+    free_slots[free_slot_count++] = slot;
+}
+
+bool ye_entity_alive(struct ye_entity *entity, int slot, int id){
+    // the slot owner being this pointer means the memory is live, the id rules out a new entity reusing both
+    return entity != NULL && slot >= 0 && slot < slot_owner_capacity && slot_owners[slot] == entity && entity->id == id;
+}
+
 //////////////////////// LINKED LIST //////////////////////////
 
 struct ye_entity_node *ye_entity_list_create() {
@@ -35,7 +95,7 @@ struct ye_entity_node *ye_entity_list_create() {
 }
 
 void ye_entity_list_add(struct ye_entity_node **list, struct ye_entity *entity) {
-    struct ye_entity_node *newNode = malloc(sizeof(struct ye_entity_node));
+    struct ye_entity_node *newNode = ye_malloc(YE_MEM_ECS, sizeof(struct ye_entity_node));
     newNode->entity = entity;
     newNode->next = *list;
     *list = newNode;
@@ -47,7 +107,7 @@ void ye_entity_list_add_sorted_renderer_z(struct ye_entity_node **list, struct y
         return;
     }
     
-    struct ye_entity_node *newNode = malloc(sizeof(struct ye_entity_node));
+    struct ye_entity_node *newNode = ye_malloc(YE_MEM_ECS, sizeof(struct ye_entity_node));
     newNode->entity = entity;
     newNode->next = NULL;
 
@@ -90,7 +150,7 @@ void ye_entity_list_remove(struct ye_entity_node **list, struct ye_entity *entit
             } else {
                 prev->next = current->next;
             }
-            free(current);
+            ye_free(current);
             return;
         }
         prev = current;
@@ -103,7 +163,7 @@ void ye_entity_list_destroy(struct ye_entity_node **list) {
         struct ye_entity_node *temp = *list;
         *list = (*list)->next;
         ye_destroy_entity(temp->entity);
-        free(temp);
+        ye_free(temp);
     }
     *list = NULL;
 }
@@ -121,19 +181,232 @@ struct ye_entity_node *lua_script_list_head;
 struct ye_entity_node *audiosource_list_head;
 struct ye_entity_node *button_list_head;
 
+/*
+    Component signatures and queries
+
+    Every entity carries the set of components it has. Queries hold the entities whose set
+    matches theirs in a dense array, with a sparse array by entity slot to find an entity's
+    place in it, so adding and removing components is constant time per query.
+*/
+
+static const char *component_names[YE_COMPONENT_TYPE_COUNT] = {
+    "transform", "renderer", "physics", "collider", "lua_script", "audiosource", "camera", "tag", "button"
+};
+
+static struct ye_ecs_query *queries[YE_ECS_MAX_QUERIES];
+static int query_count = 0;
+
+const char * ye_component_name(int type){
+    return type >= 0 && type < YE_COMPONENT_TYPE_COUNT ? component_names[type] : NULL;
+}
+
+int ye_component_from_name(const char *name){
+    for(int i = 0; i < YE_COMPONENT_TYPE_COUNT; i++){
+        if(strcmp(component_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool _query_matches(struct ye_ecs_query *query, uint32_t components){
+    return (components & query->required) == query->required && (components & query->excluded) == 0;
+}
+
+static void _query_insert(struct ye_ecs_query *query, struct ye_entity *entity){
+    if(entity->_slot >= query->slot_capacity){
+        int capacity = query->slot_capacity > 0 ? query->slot_capacity : 64;
+        while(capacity <= entity->_slot)
+            capacity *= 2;
+        query->slots = ye_realloc(YE_MEM_ECS, query->slots, sizeof(int) * capacity);
+        memset(query->slots + query->slot_capacity, 0, sizeof(int) * (capacity - query->slot_capacity));
+        query->slot_capacity = capacity;
+    }
+    if(query->slots[entity->_slot] != 0)
+        return;
+
+    if(query->count == query->capacity){
+        query->capacity = query->capacity > 0 ? query->capacity * 2 : 64;
+        query->entities = ye_realloc(YE_MEM_ECS, query->entities, sizeof(struct ye_entity *) * query->capacity);
+    }
+    query->entities[query->count++] = entity;
+    query->slots[entity->_slot] = query->count;
+}
+
+static void _query_erase(struct ye_ecs_query *query, struct ye_entity *entity){
+    if(entity->_slot >= query->slot_capacity || query->slots[entity->_slot] == 0)
+        return;
+
+    int index = query->slots[entity->_slot] - 1;
+    query->slots[entity->_slot] = 0;
+
+    // someone is iterating, leave a hole rather than moving anything
+    if(query->locks > 0){
+        query->entities[index] = NULL;
+        query->holes = true;
+        return;
+    }
+
+    int last = --query->count;
+    if(index != last){
+        struct ye_entity *moved = query->entities[last];
+        query->entities[index] = moved;
+        query->slots[moved->_slot] = index + 1;
+    }
+}
+
+static void _forget_queries(struct ye_entity *entity){
+    for(int i = 0; i < query_count; i++)
+        _query_erase(queries[i], entity);
+    entity->components = 0;
+}
+
+void ye_entity_component_added(struct ye_entity *entity, int type){
+    uint32_t before = entity->components;
+    entity->components |= YE_COMPONENT_BIT(type);
+
+    for(int i = 0; i < query_count; i++){
+        bool was = _query_matches(queries[i], before), is = _query_matches(queries[i], entity->components);
+        if(was && !is)
+            _query_erase(queries[i], entity);
+        else if(is && !was)
+            _query_insert(queries[i], entity);
+    }
+
+    ye_observer_record(entity, type, YE_OBSERVE_ADDED);
+}
+
+void ye_entity_component_removed(struct ye_entity *entity, int type){
+    uint32_t before = entity->components;
+    entity->components &= ~YE_COMPONENT_BIT(type);
+
+    for(int i = 0; i < query_count; i++){
+        bool was = _query_matches(queries[i], before), is = _query_matches(queries[i], entity->components);
+        if(was && !is)
+            _query_erase(queries[i], entity);
+        else if(is && !was)
+            _query_insert(queries[i], entity);
+    }
+
+    ye_observer_record(entity, type, YE_OBSERVE_REMOVED);
+}
+
+struct ye_ecs_query * ye_ecs_query(uint32_t required, uint32_t excluded){
+    if(required == 0){
+        ye_logf(error, "An ECS query must require at least one component.\n");
+        return NULL;
+    }
+
+    for(int i = 0; i < query_count; i++){
+        if(queries[i]->required == required && queries[i]->excluded == excluded)
+            return queries[i];
+    }
+
+    if(query_count == YE_ECS_MAX_QUERIES){
+        ye_logf(error, "Too many ECS queries (the max is %d).\n", YE_ECS_MAX_QUERIES);
+        return NULL;
+    }
+
+    struct ye_ecs_query *query = ye_calloc(YE_MEM_ECS, 1, sizeof(struct ye_ecs_query));
+    query->required = required;
+    query->excluded = excluded;
+    queries[query_count++] = query;
+
+    // the only full walk a query ever does
+    for(struct ye_entity_node *node = entity_list_head; node != NULL; node = node->next){
+        if(_query_matches(query, node->entity->components))
+            _query_insert(query, node->entity);
+    }
+
+    return query;
+}
+
+struct ye_ecs_query * ye_ecs_query_parse(const char *spec){
+    uint32_t required = 0, excluded = 0;
+
+    const char *start = spec;
+    while(start != NULL && *start != '\0'){
+        const char *end = strchr(start, '+');
+        size_t length = end != NULL ? (size_t)(end - start) : strlen(start);
+
+        bool exclude = length > 0 && *start == '!';
+        if(exclude){
+            start++;
+            length--;
+        }
+
+        int type = -1;
+        for(int i = 0; i < YE_COMPONENT_TYPE_COUNT && type < 0; i++){
+            if(strlen(component_names[i]) == length && strncmp(component_names[i], start, length) == 0)
+                type = i;
+        }
+        if(type < 0){
+            ye_logf(error, "Unknown component \"%.*s\" in query \"%s\".\n", (int)length, start, spec);
+            return NULL;
+        }
+
+        if(exclude)
+            excluded |= YE_COMPONENT_BIT(type);
+        else
+            required |= YE_COMPONENT_BIT(type);
+
+        start = end != NULL ? end + 1 : NULL;
+    }
+
+    return ye_ecs_query(required, excluded);
+}
+
+void ye_ecs_query_lock(struct ye_ecs_query *query){
+    query->locks++;
+}
+
+void ye_ecs_query_unlock(struct ye_ecs_query *query){
+    if(--query->locks > 0 || !query->holes)
+        return;
+
+    // close up the holes, keeping the order
+    int kept = 0;
+    for(int i = 0; i < query->count; i++){
+        struct ye_entity *entity = query->entities[i];
+        if(entity == NULL)
+            continue;
+        query->entities[kept++] = entity;
+        query->slots[entity->_slot] = kept;
+    }
+    query->count = kept;
+    query->holes = false;
+}
+
+void ye_shutdown_ecs_queries(){
+    for(int i = 0; i < query_count; i++){
+        ye_free(queries[i]->entities);
+        ye_free(queries[i]->slots);
+        ye_free(queries[i]);
+    }
+    query_count = 0;
+
+    ye_free(free_slots);
+    free_slots = NULL;
+    free_slot_count = free_slot_capacity = 0;
+
+    ye_free(slot_owners);
+    slot_owners = NULL;
+    slot_owner_capacity = 0;
+    slots_shut_down = true;
+}
+
 struct ye_entity_node * ye_get_entity_list_head(){
     return entity_list_head;
 }
 
 struct ye_entity * ye_create_entity(){
-    struct ye_entity *entity = malloc(sizeof(struct ye_entity));
+    struct ye_entity *entity = ye_malloc(YE_MEM_ECS, sizeof(struct ye_entity));
     entity->id = eid++; // assign unique id to entity
     entity->active = true;
 
     //name the entity "entity id"
-    char *name = malloc(sizeof(char) * 100);
-    snprintf(name, 100, "entity %d", entity->id);
-    entity->name = name;
+    char name[32];
+    snprintf(name, sizeof(name), "entity %d", entity->id);
+    entity->name = ye_intern(name);
 
     // assign all copmponents to null
     entity->transform = NULL;
@@ -145,6 +418,10 @@ struct ye_entity * ye_create_entity(){
     entity->collider = NULL;
     entity->tag = NULL;
     entity->audiosource = NULL;
+    entity->components = 0;
+    entity->tween_count = 0;
+    entity->modified = 0;
+    entity->_slot = _acquire_slot(entity);
 
     // add the entity to the entity list
     ye_entity_list_add(&entity_list_head, entity);
@@ -156,13 +433,12 @@ struct ye_entity * ye_create_entity(){
 }
 
 struct ye_entity * ye_create_entity_named(const char *name){
-    struct ye_entity *entity = malloc(sizeof(struct ye_entity));
+    struct ye_entity *entity = ye_malloc(YE_MEM_ECS, sizeof(struct ye_entity));
     entity->id = eid++; // assign unique id to entity
     entity->active = true;
 
     // name the entity by its passed name
-    entity->name = malloc(strlen(name) + 1);
-    strcpy(entity->name, name);
+    entity->name = ye_intern(name);
     
     // assign all copmponents to null
     entity->transform = NULL;
@@ -174,6 +450,10 @@ struct ye_entity * ye_create_entity_named(const char *name){
     entity->collider = NULL;
     entity->tag = NULL;
     entity->audiosource = NULL;
+    entity->components = 0;
+    entity->tween_count = 0;
+    entity->modified = 0;
+    entity->_slot = _acquire_slot(entity);
 
     // add the entity to the entity list
     ye_entity_list_add(&entity_list_head, entity);
@@ -184,13 +464,11 @@ struct ye_entity * ye_create_entity_named(const char *name){
     return entity;
 }
 
-void ye_rename_entity(struct ye_entity *entity, char *new_name){
-    // free the old name
-    free(entity->name);
-
-    // name the entity by its passed name
-    entity->name = malloc(strlen(new_name) + 1);
-    strcpy(entity->name, new_name);
+void ye_rename_entity(struct ye_entity *entity, const char *new_name){
+    // take the new name before dropping the old one, they may be the same string
+    const char *old_name = entity->name;
+    entity->name = ye_intern(new_name);
+    ye_intern_release(old_name);
 }
 
 struct ye_entity * ye_duplicate_entity(struct ye_entity *entity){
@@ -296,6 +574,15 @@ void ye_destroy_entity(struct ye_entity * entity){
     // remove from the entity list (frees its node)
     ye_entity_list_remove(&entity_list_head, entity);
 
+    // stop anything animating it
+    ye_tween_forget(entity);
+
+    // scripts holding its Entity table see a nil entity from now on
+    ye_lua_forget_entity(entity);
+
+    // leave every query at once, rather than matching new ones as its components go
+    _forget_queries(entity);
+
     // check for non null components and free them
     if(entity->transform != NULL) ye_remove_transform_component(entity);
     if(entity->renderer != NULL) ye_remove_renderer_component(entity);
@@ -307,11 +594,17 @@ void ye_destroy_entity(struct ye_entity * entity){
     if(entity->collider != NULL) ye_remove_collider_component(entity);
     if(entity->audiosource != NULL) ye_remove_audiosource_component(entity);
     if(entity->lua_script != NULL) ye_remove_lua_script_component(entity);
-    // free the entity name
-    free(entity->name);
+    // the removals above are still observed, anything else waiting on it is dropped
+    ye_observer_forget_entity(entity);
+
+    // release the entity name
+    ye_intern_release(entity->name);
+
+    // it left every query above, so the slot is free to hand out again
+    _release_slot(entity->_slot);
 
     // free the entity
-    free(entity);
+    ye_free(entity);
 
     entity = NULL;
 
@@ -321,10 +614,12 @@ void ye_destroy_entity(struct ye_entity * entity){
 }
 
 struct ye_entity * ye_get_entity_by_name(const char *name){
-    struct ye_entity_node *current = entity_list_head;
+    // names are interned, so a name nothing holds cannot belong to an entity
+    const char *key = ye_intern_find(name);
+    struct ye_entity_node *current = key != NULL ? entity_list_head : NULL;
 
     while(current != NULL){
-        if(strcmp(current->entity->name, name) == 0){
+        if(current->entity->name == key){
             return current->entity;
         }
         current = current->next;
@@ -335,13 +630,12 @@ struct ye_entity * ye_get_entity_by_name(const char *name){
 }
 
 struct ye_entity * ye_get_entity_by_tag(const char *tag){
-    struct ye_entity_node *current = tag_list_head;
+    const char *key = ye_intern_find(tag);
+    struct ye_entity_node *current = key != NULL ? tag_list_head : NULL;
 
     while(current != NULL){
-        for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
-            if(strcmp(current->entity->tag->tags[i], tag) == 0){
-                return current->entity;
-            }
+        if(ye_entity_has_interned_tag(current->entity, key)){
+            return current->entity;
         }
         current = current->next;
     }
@@ -374,6 +668,8 @@ struct ye_entity *ye_get_entity_by_id(int id){
 
 
 void ye_init_ecs(){
+    slots_shut_down = false;
+
     entity_list_head = ye_entity_list_create();
     transform_list_head = ye_entity_list_create();
     renderer_list_head = ye_entity_list_create();
@@ -411,6 +707,9 @@ void ye_purge_ecs(){
 
 void ye_shutdown_ecs(){
     ye_entity_list_destroy(&entity_list_head);
+
+    // every static collider is gone
+    ye_physics_invalidate_static();
     
     /* 
         destroy the other, now empty lists (all items are null)
@@ -434,6 +733,10 @@ void ye_shutdown_ecs(){
 
     eid = 0;
 
+    // every entity is gone, start handing out slots from the bottom again
+    next_slot = 0;
+    free_slot_count = 0;
+
     ye_logf(info, "Shut down ECS\n");
 }
 
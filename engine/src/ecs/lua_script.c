@@ -15,6 +15,7 @@
 #include <yoyoengine/engine.h>
 #include <yoyoengine/logging.h>
 #include <yoyoengine/lua_api.h>
+#include <yoyoengine/utils.h>
 #include <yoyoengine/ecs/lua_script.h>
 
 // marcro for getting the state
@@ -61,22 +62,27 @@ void _extract_signature(struct ye_component_lua_script *script, const char *func
     lua_pop(L, 1); // Pop the function or nil value from the stack
 }
 
+char * _get_loose_script_buffer(const char *handle) {
+    char *full_path = ye_path_resources(handle);
+    FILE *file = fopen(full_path, "r");
+    if(file == NULL){
+        ye_logf(error,"Failed to open file %s\n", full_path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = malloc(length + 1);
+    fread(data, 1, length, file);
+    fclose(file);
+    data[length] = '\0';
+    return data;
+}
+
 char * _get_script_buffer(const char *handle, bool is_in_resources_yep) {
     char *data = NULL;
     if(YE_STATE.editor.editor_mode){
-        char *full_path = ye_path_resources(handle);
-        FILE *file = fopen(full_path, "r");
-        if(file == NULL){
-            ye_logf(error,"Failed to open file %s\n", full_path);
-            return NULL;
-        }
-        fseek(file, 0, SEEK_END);
-        long length = ftell(file);
-        fseek(file, 0, SEEK_SET);
-        data = malloc(length + 1);
-        fread(data, 1, length, file);
-        fclose(file);
-        data[length] = '\0';
+        data = _get_loose_script_buffer(handle);
     }
     else{
         struct yep_data_info d;
@@ -101,6 +107,10 @@ char * _get_script_buffer(const char *handle, bool is_in_resources_yep) {
 
 void _cleanup_script_comp(struct ye_entity *target) {
     if(target->lua_script->state != NULL){
+        ye_lua_coroutines_purge_state(target->lua_script->state);
+        ye_lua_navigation_purge_state(target->lua_script->state);
+        ye_lua_tween_purge_state(target->lua_script->state);
+        ye_lua_observer_purge_state(target->lua_script->state);
         lua_close(target->lua_script->state);
         target->lua_script->state = NULL;
     }
@@ -145,6 +155,39 @@ bool _initialize_scripting_runtime(struct ye_entity *target) {
     return true;
 }
 
+/*
+    Pushes every global we were passed through the UI onto the entity's state
+*/
+bool _apply_globals(struct ye_entity *entity) {
+    lua_State *L = entity->lua_script->state;
+
+    struct ye_lua_script_global *current = entity->lua_script->globals;
+    while(current != NULL) {
+        const char *name = current->name;
+        enum ye_lua_script_global_t type = current->type;
+        void *value = &current->value;
+
+        switch(type) {
+            case YE_LSG_STRING:
+                lua_pushstring(L, (char *)value);
+                break;
+            case YE_LSG_BOOL:
+                lua_pushboolean(L, *(bool *)value);
+                break;
+            case YE_LSG_NUMBER:
+                lua_pushnumber(L, *(lua_Number *)value);
+                break;
+            default:
+                ye_logf(error,"Tried to add global to script on entity [%s]: ERROR, invalid global type\n", entity->name);
+                return false;
+        }
+        lua_setglobal(L, name);
+
+        current = current->next;
+    }
+    return true;
+}
+
 bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, struct ye_lua_script_global *globals){
     // ye_logf(debug,"Adding lua script component to entity %s\n", entity->name);
     
@@ -164,7 +207,8 @@ bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, s
     /*
         Initialize state and load libs
     */
-    entity->lua_script->state = luaL_newstate();
+    size_t memory_limit = YE_STATE.engine.lua_memory_limit_kb > 0 ? (size_t)YE_STATE.engine.lua_memory_limit_kb * 1024 : 0;
+    entity->lua_script->state = ye_lua_new_state(&entity->lua_script->memory, memory_limit);
     luaL_openlibs(entity->lua_script->state);
     // TODO: we also need to individually register each api function here
     ye_register_lua_scripting_api(entity->lua_script->state);
@@ -216,6 +260,10 @@ bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, s
             Load our script into the lua state, which will inherently run it
         */
         if(!_run_script(entity->lua_script->state, script_data)){
+            ye_lua_coroutines_purge_state(entity->lua_script->state);
+            ye_lua_navigation_purge_state(entity->lua_script->state);
+            ye_lua_tween_purge_state(entity->lua_script->state);
+            ye_lua_observer_purge_state(entity->lua_script->state);
             lua_close(entity->lua_script->state);
             entity->lua_script->active = false;
             entity->lua_script->state = NULL;
@@ -235,34 +283,12 @@ bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, s
         _extract_signature(entity->lua_script, "onUnmount", &(entity->lua_script->has_on_unmount));
         _extract_signature(entity->lua_script, "onTriggerEnter", &(entity->lua_script->has_on_trigger_enter));
         _extract_signature(entity->lua_script, "onCollision", &(entity->lua_script->has_on_collision));
+        _extract_signature(entity->lua_script, "onCollisionExit", &(entity->lua_script->has_on_collision_exit));
+        _extract_signature(entity->lua_script, "onTriggerExit", &(entity->lua_script->has_on_trigger_exit));
 
         // set any globals we were passed through UI
-        lua_State *L = entity->lua_script->state;
-
-        struct ye_lua_script_global *current = entity->lua_script->globals;
-        while(current != NULL) {
-            const char *name = current->name;
-            enum ye_lua_script_global_t type = current->type;
-            void *value = &current->value;
-
-            switch(type) {
-                case YE_LSG_STRING:
-                    lua_pushstring(L, (char *)value);
-                    break;
-                case YE_LSG_BOOL:
-                    lua_pushboolean(L, *(bool *)value);
-                    break;
-                case YE_LSG_NUMBER:
-                    lua_pushnumber(L, *(lua_Number *)value);
-                    break;
-                default:
-                    ye_logf(error,"Tried to add global to script on entity [%s]: ERROR, invalid global type\n", entity->name);
-                    return false;
-            }
-            lua_setglobal(L, name);
-
-            current = current->next;
-        }
+        if(!_apply_globals(entity))
+            return false;
     }
 
 
@@ -280,12 +306,60 @@ bool ye_add_lua_script_component(struct ye_entity *entity, const char *handle, s
 
     // add to the lua_script list
     ye_entity_list_add(&lua_script_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_LUA_SCRIPT);
 
     // ye_logf(debug,"Successfully added lua script component to entity %s\n", entity->name);
 
     return true;
 }
 
+bool ye_reload_lua_script_component(struct ye_entity *entity){
+    if(entity == NULL || entity->lua_script == NULL || entity->lua_script->state == NULL){
+        ye_logf(error,"Attempted to reload lua script on entity without a script\n");
+        return false;
+    }
+
+    // editor states never run their script, nothing to patch
+    if(YE_STATE.editor.editor_mode)
+        return true;
+
+    // the change was seen on the loose file, the packed copy is still the old script
+    char *script_data = _get_loose_script_buffer(entity->lua_script->script_handle);
+    if(script_data == NULL)
+        return false;
+
+    /*
+        Run the new chunk in the existing state. On failure the old function
+        definitions are still bound, so the script keeps running as before.
+    */
+    bool ok = _run_script(entity->lua_script->state, script_data);
+    free(script_data);
+    if(!ok){
+        lua_pop(entity->lua_script->state, 1); // pop the error message
+        return false;
+    }
+
+    _extract_signature(entity->lua_script, "onMount", &(entity->lua_script->has_on_mount));
+    _extract_signature(entity->lua_script, "onUpdate", &(entity->lua_script->has_on_update));
+    _extract_signature(entity->lua_script, "onUnmount", &(entity->lua_script->has_on_unmount));
+    _extract_signature(entity->lua_script, "onTriggerEnter", &(entity->lua_script->has_on_trigger_enter));
+    _extract_signature(entity->lua_script, "onCollision", &(entity->lua_script->has_on_collision));
+    _extract_signature(entity->lua_script, "onCollisionExit", &(entity->lua_script->has_on_collision_exit));
+    _extract_signature(entity->lua_script, "onTriggerExit", &(entity->lua_script->has_on_trigger_exit));
+
+    // top level code may have clobbered the values we set through UI
+    return _apply_globals(entity);
+}
+
+void ye_lua_script_set_memory_limit(struct ye_entity *entity, size_t limit){
+    if(entity == NULL || entity->lua_script == NULL){
+        ye_logf(error,"Attempted to set memory limit on entity without a script\n");
+        return;
+    }
+    entity->lua_script->memory.limit = limit;
+    entity->lua_script->memory.refused = 0;
+}
+
 void ye_remove_lua_script_component(struct ye_entity *entity){
     if(entity->lua_script == NULL){
         ye_logf(warning,"Attempted to remove lua script from entity that does not have one\n");
@@ -301,7 +375,11 @@ void ye_remove_lua_script_component(struct ye_entity *entity){
     if(!YE_STATE.editor.editor_mode)
         ye_run_lua_on_unmount(entity->lua_script);
 
-    // shut down the state
+    // shut down the state (and anything it had waiting)
+    ye_lua_coroutines_purge_state(entity->lua_script->state);
+    ye_lua_navigation_purge_state(entity->lua_script->state);
+    ye_lua_tween_purge_state(entity->lua_script->state);
+    ye_lua_observer_purge_state(entity->lua_script->state);
     lua_close(entity->lua_script->state);
     entity->lua_script->state = NULL;
 
@@ -321,11 +399,15 @@ void ye_remove_lua_script_component(struct ye_entity *entity){
 
     // remove from the lua_script list
     ye_entity_list_remove(&lua_script_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_LUA_SCRIPT);
 
     // printf("Removed lua script component from entity %s\n", entity->name);
 }
 
 void ye_system_lua_scripting(){
+    // resume any coroutines that are done waiting
+    ye_update_lua_coroutines();
+
     struct ye_entity_node *current = lua_script_list_head;
     while(current != NULL){
         if(current->entity->lua_script->active){
@@ -336,24 +418,39 @@ void ye_system_lua_scripting(){
     }
 }
 
+/*
+    Physics callbacks only go to the scripts on the two entities involved
+*/
+static void _signal_pair(void (*run)(struct ye_component_lua_script *, struct ye_entity *, struct ye_entity *), struct ye_entity *entity1, struct ye_entity *entity2){
+    // the first callback might destroy either entity (a bullet and its target), so remember who they were
+    int slot1 = entity1->_slot, id1 = entity1->id;
+    int slot2 = entity2->_slot, id2 = entity2->id;
+
+    if(entity1->lua_script != NULL && entity1->lua_script->active)
+        run(entity1->lua_script, entity1, entity2);
+
+    if(entity2 == entity1 || !ye_entity_alive(entity1, slot1, id1) || !ye_entity_alive(entity2, slot2, id2))
+        return;
+
+    // it might also have removed the other script
+    if(entity2->lua_script != NULL && entity2->lua_script->active)
+        run(entity2->lua_script, entity1, entity2);
+}
+
 void ye_lua_signal_collisions(struct ye_entity *entity1, struct ye_entity *entity2){
-    struct ye_entity_node *current = lua_script_list_head;
-    while(current != NULL){
-        if(current->entity->lua_script->active){
-            ye_run_lua_on_collision(current->entity->lua_script, entity1, entity2);
-        }
-        current = current->next;
-    }
+    _signal_pair(ye_run_lua_on_collision, entity1, entity2);
+}
+
+void ye_lua_signal_collision_exit(struct ye_entity *entity1, struct ye_entity *entity2){
+    _signal_pair(ye_run_lua_on_collision_exit, entity1, entity2);
 }
 
 void ye_lua_signal_trigger_enter(struct ye_entity *entity1, struct ye_entity *entity2){
-    struct ye_entity_node *current = lua_script_list_head;
-    while(current != NULL){
-        if(current->entity->lua_script->active){
-            ye_run_lua_on_trigger_enter(current->entity->lua_script, entity1, entity2);
-        }
-        current = current->next;
-    }
+    _signal_pair(ye_run_lua_on_trigger_enter, entity1, entity2);
+}
+
+void ye_lua_signal_trigger_exit(struct ye_entity *entity1, struct ye_entity *entity2){
+    _signal_pair(ye_run_lua_on_trigger_exit, entity1, entity2);
 }
 
 /*
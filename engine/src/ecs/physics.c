@@ -5,13 +5,24 @@
     Licensed under the MIT license. See LICENSE file in the project root for details.
 */
 
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <uthash/uthash.h>
+
 #include <yoyoengine/utils.h>
+#include <yoyoengine/logging.h>
 #include <yoyoengine/event.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/intern.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/observer.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/physics.h>
 #include <yoyoengine/ecs/renderer.h>
 #include <yoyoengine/ecs/collider.h>
+#include <yoyoengine/ecs/tag.h>
 #include <yoyoengine/ecs/transform.h>
 #include <yoyoengine/ecs/lua_script.h>
 
@@ -23,29 +34,41 @@
     Velocity is in pixels per second
 */
 void ye_add_physics_component(struct ye_entity *entity, float velocity_x, float velocity_y){
-    entity->physics = malloc(sizeof(struct ye_component_physics));
+    entity->physics = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_physics));
     entity->physics->active = true;
     // entity->physics->mass = mass;
     // entity->physics->drag = drag;
     entity->physics->velocity.x = velocity_x;
     entity->physics->velocity.y = velocity_y;
     entity->physics->rotational_velocity = 0; // directly modified by pointer because not often used
+    entity->physics->sleeping = false;
+    entity->physics->rest_frames = 0;
     // entity->physics->acceleration.x = acceleration_x;
     // entity->physics->acceleration.y = acceleration_y;
 
+    // an automatic collider stops being static
+    if(entity->collider != NULL && entity->collider->body == YE_COLLIDER_BODY_AUTO)
+        ye_physics_invalidate_static();
+
     // add this entity to the physics component list
     ye_entity_list_add(&physics_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_PHYSICS);
 
     // log that we added a physics and to what ID
     // ye_logf(debug, "Added physics component to entity %d\n", entity->id);
 }
 
 void ye_remove_physics_component(struct ye_entity *entity){
-    free(entity->physics);
+    ye_free(entity->physics);
     entity->physics = NULL;
 
     // remove the entity from the physics component list
     ye_entity_list_remove(&physics_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_PHYSICS);
+
+    // an automatic collider becomes static
+    if(entity->collider != NULL && entity->collider->body == YE_COLLIDER_BODY_AUTO)
+        ye_physics_invalidate_static();
 
     // log that we removed a physics and to what ID
     // ye_logf(debug, "Removed physics component from entity %d\n", entity->id);
@@ -62,6 +85,473 @@ bool ye_rectf_collision(struct ye_rectf rect1, struct ye_rectf rect2){
     return false;
 }
 
+/*
+    Collision layers
+
+    Each collider sits on one of YE_PHYSICS_MAX_LAYERS layers. layer_masks[a] has bit b set if
+    colliders on layer a interact with colliders on layer b, and is kept symmetric. Everything
+    interacts with everything until a scene says otherwise.
+*/
+
+static uint32_t layer_masks[YE_PHYSICS_MAX_LAYERS];
+static char layer_names[YE_PHYSICS_MAX_LAYERS][YE_PHYSICS_MAX_LAYER_NAME];
+static bool layers_initialized = false;
+
+void ye_physics_reset_layers(){
+    for(int i = 0; i < YE_PHYSICS_MAX_LAYERS; i++){
+        layer_masks[i] = YE_PHYSICS_LAYERS_ALL;
+        layer_names[i][0] = '\0';
+    }
+    strncpy(layer_names[0], "default", YE_PHYSICS_MAX_LAYER_NAME - 1);
+    layers_initialized = true;
+}
+
+static inline uint32_t _layer_mask_of(struct ye_entity *entity){
+    // physics can run before any scene set the layers up
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+
+    int layer = entity->collider->layer;
+    if(layer < 0 || layer >= YE_PHYSICS_MAX_LAYERS)
+        return 0;
+    return layer_masks[layer];
+}
+
+static inline bool _in_mask(struct ye_entity *entity, uint32_t mask){
+    int layer = entity->collider->layer;
+    return layer >= 0 && layer < YE_PHYSICS_MAX_LAYERS && (mask & YE_PHYSICS_LAYER_BIT(layer));
+}
+
+void ye_physics_set_layer_name(int layer, const char *name){
+    if(layer < 0 || layer >= YE_PHYSICS_MAX_LAYERS)
+        return;
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+    strncpy(layer_names[layer], name, YE_PHYSICS_MAX_LAYER_NAME - 1);
+    layer_names[layer][YE_PHYSICS_MAX_LAYER_NAME - 1] = '\0';
+}
+
+const char * ye_physics_layer_name(int layer){
+    if(layer < 0 || layer >= YE_PHYSICS_MAX_LAYERS)
+        return NULL;
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+    return layer_names[layer];
+}
+
+int ye_physics_layer_index(const char *name){
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+    for(int i = 0; i < YE_PHYSICS_MAX_LAYERS; i++){
+        if(layer_names[i][0] != '\0' && strcmp(layer_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+void ye_physics_set_layers_interact(int a, int b, bool interact){
+    if(a < 0 || a >= YE_PHYSICS_MAX_LAYERS || b < 0 || b >= YE_PHYSICS_MAX_LAYERS)
+        return;
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+
+    if(interact){
+        layer_masks[a] |= YE_PHYSICS_LAYER_BIT(b);
+        layer_masks[b] |= YE_PHYSICS_LAYER_BIT(a);
+    }
+    else{
+        layer_masks[a] &= ~YE_PHYSICS_LAYER_BIT(b);
+        layer_masks[b] &= ~YE_PHYSICS_LAYER_BIT(a);
+    }
+}
+
+bool ye_physics_layers_interact(int a, int b){
+    if(a < 0 || a >= YE_PHYSICS_MAX_LAYERS || b < 0 || b >= YE_PHYSICS_MAX_LAYERS)
+        return false;
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+    return (layer_masks[a] & YE_PHYSICS_LAYER_BIT(b)) != 0;
+}
+
+uint32_t ye_physics_layer_mask(int layer){
+    if(layer < 0 || layer >= YE_PHYSICS_MAX_LAYERS)
+        return 0;
+    if(!layers_initialized)
+        ye_physics_reset_layers();
+    return layer_masks[layer];
+}
+
+/*
+    Static broadphase
+
+    Static colliders are bucketed into a uniform grid once (at scene load, or lazily after one
+    is added, removed or moved by hand), with their world rect cached. Movers only test the static
+    colliders in the cells their swept bounds touch.
+*/
+
+// a static collider covering more cells than this is tested against every mover instead
+#define YE_PHYSICS_MAX_CELLS_PER_STATIC 1024
+
+struct ye_static_body {
+    struct ye_entity *entity;
+    struct ye_rectf rect;
+    unsigned int stamp;     // last query that returned this body, to dedupe across cells
+};
+
+struct ye_grid_cell {
+    int64_t key;
+    int *bodies;
+    int count;
+    int capacity;
+    UT_hash_handle hh;
+};
+
+static struct ye_static_body *static_bodies = NULL;
+static int static_count = 0;
+static int static_capacity = 0;
+
+static struct ye_grid_cell *grid = NULL;
+static int *oversized = NULL;           // statics too big for the grid
+static int oversized_count = 0;
+static int oversized_capacity = 0;
+
+static bool static_dirty = true;
+static bool statics_moved = true;      // a static changed since contacts were last settled
+static unsigned int query_stamp = 0;
+
+// scratch list of static candidates for the current mover
+static int *candidates = NULL;
+static int candidate_count = 0;
+static int candidate_capacity = 0;
+
+static inline int64_t _cell_key(int cx, int cy){
+    return ((int64_t)cx << 32) | (uint32_t)cy;
+}
+
+static inline int _cell_of(float v){
+    return (int)floorf(v / YE_PHYSICS_GRID_CELL);
+}
+
+static void _push_int(int **array, int *count, int *capacity, int value){
+    if(*count == *capacity){
+        *capacity = *capacity > 0 ? *capacity * 2 : 16;
+        *array = ye_realloc(YE_MEM_PHYSICS, *array, sizeof(int) * *capacity);
+    }
+    (*array)[(*count)++] = value;
+}
+
+static void _clear_grid(){
+    struct ye_grid_cell *cell, *tmp;
+    HASH_ITER(hh, grid, cell, tmp){
+        HASH_DEL(grid, cell);
+        ye_free(cell->bodies);
+        ye_free(cell);
+    }
+    static_count = 0;
+    oversized_count = 0;
+}
+
+void ye_physics_invalidate_static(){
+    static_dirty = true;
+    statics_moved = true;
+}
+
+void ye_physics_build_broadphase(){
+    _clear_grid();
+
+    for(struct ye_entity_node *node = collider_list_head; node != NULL; node = node->next){
+        struct ye_entity *entity = node->entity;
+        if(entity->collider == NULL || ye_collider_body(entity) != YE_COLLIDER_BODY_STATIC)
+            continue;
+
+        if(static_count == static_capacity){
+            static_capacity = static_capacity > 0 ? static_capacity * 2 : 64;
+            static_bodies = ye_realloc(YE_MEM_PHYSICS, static_bodies, sizeof(struct ye_static_body) * static_capacity);
+        }
+        int index = static_count++;
+        static_bodies[index] = (struct ye_static_body){ entity, ye_get_position(entity, YE_COMPONENT_COLLIDER), 0 };
+
+        struct ye_rectf r = static_bodies[index].rect;
+        int x0 = _cell_of(r.x), x1 = _cell_of(r.x + r.w);
+        int y0 = _cell_of(r.y), y1 = _cell_of(r.y + r.h);
+        if((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > YE_PHYSICS_MAX_CELLS_PER_STATIC){
+            _push_int(&oversized, &oversized_count, &oversized_capacity, index);
+            continue;
+        }
+
+        for(int cx = x0; cx <= x1; cx++){
+            for(int cy = y0; cy <= y1; cy++){
+                int64_t key = _cell_key(cx, cy);
+                struct ye_grid_cell *cell = NULL;
+                HASH_FIND(hh, grid, &key, sizeof(int64_t), cell);
+                if(cell == NULL){
+                    cell = ye_calloc(YE_MEM_PHYSICS, 1, sizeof(struct ye_grid_cell));
+                    cell->key = key;
+                    HASH_ADD(hh, grid, key, sizeof(int64_t), cell);
+                }
+                _push_int(&cell->bodies, &cell->count, &cell->capacity, index);
+            }
+        }
+    }
+
+    static_dirty = false;
+    ye_logf(debug, "Built physics broadphase: %d static colliders in %d cells.\n", static_count, HASH_COUNT(grid));
+}
+
+// fills a list with the statics on a layer in mask whose cells overlap area
+static void _gather_static_into(struct ye_rectf area, uint32_t mask, int **out, int *count, int *capacity){
+    *count = 0;
+    query_stamp++;
+
+    for(int i = 0; i < oversized_count; i++){
+        if(_in_mask(static_bodies[oversized[i]].entity, mask))
+            _push_int(out, count, capacity, oversized[i]);
+    }
+
+    int x0 = _cell_of(area.x), x1 = _cell_of(area.x + area.w);
+    int y0 = _cell_of(area.y), y1 = _cell_of(area.y + area.h);
+    for(int cx = x0; cx <= x1; cx++){
+        for(int cy = y0; cy <= y1; cy++){
+            int64_t key = _cell_key(cx, cy);
+            struct ye_grid_cell *cell = NULL;
+            HASH_FIND(hh, grid, &key, sizeof(int64_t), cell);
+            if(cell == NULL)
+                continue;
+            for(int i = 0; i < cell->count; i++){
+                struct ye_static_body *body = &static_bodies[cell->bodies[i]];
+                if(body->stamp == query_stamp)
+                    continue;
+                body->stamp = query_stamp;
+                if(_in_mask(body->entity, mask))
+                    _push_int(out, count, capacity, cell->bodies[i]);
+            }
+        }
+    }
+}
+
+// fills candidates, the list the physics step tests the current mover against
+static void _gather_static(struct ye_rectf area, uint32_t mask){
+    _gather_static_into(area, mask, &candidates, &candidate_count, &candidate_capacity);
+}
+
+/*
+    Moving collider cache
+
+    The world rect of every kinematic and dynamic collider is computed once per step (the first
+    time a mover needs it) instead of for every mover on every substep.
+*/
+
+struct ye_moving_body {
+    struct ye_entity *entity;
+    struct ye_rectf rect;
+    uint32_t layer_bit;
+};
+
+static struct ye_moving_body *moving_bodies = NULL;
+static int moving_count = 0;
+static int moving_capacity = 0;
+static bool moving_valid = false;
+
+static void _build_moving_cache(){
+    moving_count = 0;
+    for(struct ye_entity_node *node = collider_list_head; node != NULL; node = node->next){
+        struct ye_entity *entity = node->entity;
+        if(entity->collider == NULL)
+            continue;
+        entity->collider->_step_slot = -1;
+        if(!entity->active || !entity->collider->active || ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC)
+            continue;
+
+        if(moving_count == moving_capacity){
+            moving_capacity = moving_capacity > 0 ? moving_capacity * 2 : 64;
+            moving_bodies = ye_realloc(YE_MEM_PHYSICS, moving_bodies, sizeof(struct ye_moving_body) * moving_capacity);
+        }
+        entity->collider->_step_slot = moving_count;
+        int layer = entity->collider->layer;
+        uint32_t layer_bit = layer >= 0 && layer < YE_PHYSICS_MAX_LAYERS ? YE_PHYSICS_LAYER_BIT(layer) : 0;
+        moving_bodies[moving_count++] = (struct ye_moving_body){ entity, ye_get_position(entity, YE_COMPONENT_COLLIDER), layer_bit };
+    }
+    moving_valid = true;
+}
+
+/*
+    Finds the first collider (other than self) on a layer in mask overlapping rect, statics first.
+    The candidates were already filtered by layer when they were gathered.
+*/
+static struct ye_entity * _first_overlap(struct ye_entity *self, uint32_t mask, struct ye_rectf rect){
+    for(int i = 0; i < candidate_count; i++){
+        struct ye_static_body *body = &static_bodies[candidates[i]];
+        if(body->entity->active && body->entity->collider->active && ye_rectf_collision(rect, body->rect))
+            return body->entity;
+    }
+    for(int i = 0; i < moving_count; i++){
+        if(moving_bodies[i].entity != self && (mask & moving_bodies[i].layer_bit) && ye_rectf_collision(rect, moving_bodies[i].rect))
+            return moving_bodies[i].entity;
+    }
+    return NULL;
+}
+
+/*
+    Contact cache
+
+    Every pair that touched is remembered, keyed by (mover, other). Enter events fire only when
+    a pair is first seen, and at the end of each step the pairs nobody touched are re-tested
+    against where their colliders are now: still overlapping (or for solids, still within the
+    distance the mover was stopped short by) keeps the contact alive, otherwise exit fires once.
+*/
+
+struct ye_contact_key {
+    struct ye_entity *mover;
+    struct ye_entity *other;
+};
+
+struct ye_contact {
+    struct ye_contact_key key;
+    bool trigger;
+    float skin;             // how far apart a solid pair can drift and still be touching
+    unsigned int step;      // last step the pair was touched
+    UT_hash_handle hh;
+};
+
+// an exit waiting to be dispatched, entries are nulled if an entity goes away mid dispatch
+struct ye_pending_exit {
+    struct ye_entity *mover;
+    struct ye_entity *other;
+    bool trigger;
+};
+
+static struct ye_contact *contacts = NULL;
+static unsigned int contact_step = 0;
+
+static struct ye_pending_exit *pending_exits = NULL;
+static int pending_count = 0;
+static int pending_capacity = 0;
+
+/*
+    Records that mover touched other this step, returns true if they were not already touching
+    (the caller fires the enter events).
+*/
+static bool _touch(struct ye_entity *mover, struct ye_entity *other, bool trigger, float skin){
+    struct ye_contact_key key = { mover, other };
+    struct ye_contact *contact = NULL;
+    HASH_FIND(hh, contacts, &key, sizeof(struct ye_contact_key), contact);
+    if(contact != NULL){
+        contact->step = contact_step;
+        if(skin > contact->skin)
+            contact->skin = skin;
+        return false;
+    }
+
+    contact = ye_malloc(YE_MEM_PHYSICS, sizeof(struct ye_contact));
+    contact->key = key;
+    contact->trigger = trigger;
+    contact->skin = skin;
+    contact->step = contact_step;
+    HASH_ADD(hh, contacts, key, sizeof(struct ye_contact_key), contact);
+    return true;
+}
+
+// sleeping bodies and statics only move through something that wakes them or invalidates the grid
+static bool _at_rest(struct ye_entity *entity){
+    if(entity->physics != NULL)
+        return entity->physics->sleeping;
+    return ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC;
+}
+
+static bool _still_touching(struct ye_contact *contact){
+    struct ye_entity *mover = contact->key.mover;
+    struct ye_entity *other = contact->key.other;
+    if(!mover->active || !other->active || mover->collider == NULL || other->collider == NULL
+        || !mover->collider->active || !other->collider->active || !_in_mask(other, _layer_mask_of(mover)))
+        return false;
+
+    // neither has moved since they touched
+    if(!statics_moved && _at_rest(mover) && _at_rest(other))
+        return true;
+
+    struct ye_rectf a = ye_get_position(mover, YE_COMPONENT_COLLIDER);
+    struct ye_rectf b = ye_get_position(other, YE_COMPONENT_COLLIDER);
+    if(!contact->trigger){
+        a.x -= contact->skin; a.y -= contact->skin;
+        a.w += contact->skin * 2; a.h += contact->skin * 2;
+    }
+    return ye_rectf_collision(a, b);
+}
+
+// settles the pairs not touched this step, then dispatches the exits
+static void _end_contacts(){
+    struct ye_contact *contact, *tmp;
+    HASH_ITER(hh, contacts, contact, tmp){
+        if(contact->step == contact_step)
+            continue;
+        if(_still_touching(contact)){
+            contact->step = contact_step;
+            continue;
+        }
+
+        if(pending_count == pending_capacity){
+            pending_capacity = pending_capacity > 0 ? pending_capacity * 2 : 16;
+            pending_exits = ye_realloc(YE_MEM_PHYSICS, pending_exits, sizeof(struct ye_pending_exit) * pending_capacity);
+        }
+        pending_exits[pending_count++] = (struct ye_pending_exit){ contact->key.mover, contact->key.other, contact->trigger };
+
+        HASH_DEL(contacts, contact);
+        ye_free(contact);
+    }
+    statics_moved = false;
+
+    // callbacks can destroy entities, which nulls their entries through ye_physics_forget_contacts
+    for(int i = 0; i < pending_count; i++){
+        struct ye_pending_exit *pending = &pending_exits[i];
+        if(pending->mover == NULL || pending->other == NULL)
+            continue;
+
+        union ye_event_args args = {.collision = {pending->mover, pending->other}};
+        if(pending->trigger){
+            ye_fire_event(YE_EVENT_TRIGGER_EXIT, args);
+            if(pending->mover != NULL && pending->other != NULL)
+                ye_lua_signal_trigger_exit(pending->mover, pending->other);
+        }
+        else{
+            ye_fire_event(YE_EVENT_COLLISION_EXIT, args);
+            if(pending->mover != NULL && pending->other != NULL)
+                ye_lua_signal_collision_exit(pending->mover, pending->other);
+        }
+    }
+    pending_count = 0;
+}
+
+void ye_physics_forget_contacts(struct ye_entity *entity){
+    struct ye_contact *contact, *tmp;
+    HASH_ITER(hh, contacts, contact, tmp){
+        if(contact->key.mover == entity || contact->key.other == entity){
+            HASH_DEL(contacts, contact);
+            ye_free(contact);
+        }
+    }
+
+    for(int i = 0; i < pending_count; i++){
+        if(pending_exits[i].mover == entity || pending_exits[i].other == entity)
+            pending_exits[i].mover = pending_exits[i].other = NULL;
+    }
+}
+
+static void _clear_contacts(){
+    struct ye_contact *contact, *tmp;
+    HASH_ITER(hh, contacts, contact, tmp){
+        HASH_DEL(contacts, contact);
+        ye_free(contact);
+    }
+    ye_free(pending_exits);
+    pending_exits = NULL;
+    pending_count = pending_capacity = 0;
+}
+
+void ye_physics_wake(struct ye_entity *entity){
+    entity->physics->sleeping = false;
+    entity->physics->rest_frames = 0;
+}
+
 /*
     Physics system
 
@@ -74,168 +564,444 @@ bool ye_rectf_collision(struct ye_rectf rect1, struct ye_rectf rect2){
     thresholds, or if we are below a certain framerate. We could also expose a bool for CCD on the physics
     component to allow more fine grained control, as well as an integer for specifying the number of steps.
 
+    Bodies that have not moved for YE_PHYSICS_SLEEP_FRAMES are put to sleep. Sleeping bodies are skipped
+    until something runs into them or they are woken (see ye_physics_wake), and contacts between sleeping
+    bodies and statics are kept without re-testing them. Nothing else (grid rebuild, collider positions) is
+    computed unless at least one body is actually moving, so idle scenes are nearly free.
+
+    Enter callbacks fire once per pair (see the contact cache above), so a body resting in or sliding
+    through a trigger is only announced when it arrives and when it leaves.
+
     TODO/Considerations:
     - maybe we want to check for hitting multiple overlapping triggers?
-    - trigger colliders are needed
 
     Physics entities need a transform component to work, we apply these forces to the transform not the component position.
 */
+static void _apply_rotation(struct ye_entity *entity, float delta){
+    // if we have rotational velocity apply it (if we have a renderer)
+    if(entity->physics->rotational_velocity != 0 && entity->renderer != NULL){
+        // update the entity's rotation based on its rotational velocity
+        entity->renderer->rotation += entity->physics->rotational_velocity * delta;
+        if(entity->renderer->rotation > 360) entity->renderer->rotation -= 360;
+        if(entity->renderer->rotation < 0) entity->renderer->rotation += 360;
+        ye_component_modified(entity, YE_COMPONENT_RENDERER);
+    }
+}
+
+// every entity the physics step moves
+static struct ye_ecs_query *physics_query = NULL;
+
 void ye_system_physics(){
     // current time - left for debugging
     // unsigned long start = SDL_GetTicks64();
 
     float delta = ye_delta_time();
-    // iterate over all entities with physics
-    struct ye_entity_node *current = physics_list_head;
-    while (current != NULL) {
-        // if the current entity is inactive, dont run physics on it
-        if(!current->entity->active){
-            current = current->next;
+    moving_valid = false;
+    contact_step++;
+
+    // iterate over the entities with physics and a transform, callbacks may add or destroy some
+    if(physics_query == NULL)
+        physics_query = ye_ecs_query(YE_COMPONENT_BIT(YE_COMPONENT_PHYSICS) | YE_COMPONENT_BIT(YE_COMPONENT_TRANSFORM), 0);
+
+    ye_ecs_query_lock(physics_query);
+    for(int q = 0; q < physics_query->count; q++){
+        struct ye_entity *entity = physics_query->entities[q];
+
+        // if the current entity is gone or inactive, dont run physics on it
+        if(entity == NULL || !entity->active || !entity->physics->active)
             continue;
+
+        /*
+            Asleep until something wakes it (contact, ye_physics_wake, or its transform or physics being
+            modified). Game code can also write the velocity directly, so any velocity wakes it too.
+        */
+        struct ye_component_physics *physics = entity->physics;
+        bool moving = physics->velocity.x != 0 || physics->velocity.y != 0;
+        if(physics->sleeping){
+            if(!moving && physics->rotational_velocity == 0)
+                continue;
+            ye_physics_wake(entity);
         }
 
-        // if we have a physics component and a transform component
-        if (current->entity->physics->active && current->entity->transform != NULL) {
-            // if we have velocity proceed with checks
-            if(current->entity->physics->velocity.x != 0 || current->entity->physics->velocity.y != 0){
-                
-                // printf("started looking at entity with vx:%f vy:%f\n",current->entity->physics->velocity.x, current->entity->physics->velocity.y);
-
-                /*
-                    CASE THAT ENTITY HAS NO COLLIDER (or inactive one)
-                    We just apply its velocity to its transform (also account for rotational)
-                */
-                if(current->entity->collider == NULL || !current->entity->collider->active){
-                    current->entity->transform->x += current->entity->physics->velocity.x * delta;
-                    current->entity->transform->y += current->entity->physics->velocity.y * delta;
-                    
-                    // do the rotation as well
-                    if(current->entity->physics->rotational_velocity != 0 && current->entity->renderer != NULL){
-                        // update the entity's rotation based on its rotational velocity
-                        current->entity->renderer->rotation += current->entity->physics->rotational_velocity * delta;
-                        if(current->entity->renderer->rotation > 360) current->entity->renderer->rotation -= 360;
-                        if(current->entity->renderer->rotation < 0) current->entity->renderer->rotation += 360;
-                    }
+        // resting bodies drift off to sleep
+        if(!moving && physics->rotational_velocity == 0){
+            if(++physics->rest_frames >= YE_PHYSICS_SLEEP_FRAMES)
+                physics->sleeping = true;
+            continue;
+        }
+        physics->rest_frames = 0;
+
+        if(moving){
+            ye_component_modified(entity, YE_COMPONENT_TRANSFORM);
+
+            /*
+                CASE THAT ENTITY HAS NO COLLIDER (or inactive one)
+                We just apply its velocity to its transform
+            */
+            if(entity->collider == NULL || !entity->collider->active){
+                entity->transform->x += physics->velocity.x * delta;
+                entity->transform->y += physics->velocity.y * delta;
+                _apply_rotation(entity, delta);
+                continue;
+            }
 
-                    current = current->next;
-                    continue;
-                }
+            /*
+                CASE THAT ENTITY HAS A COLLIDER
+                We need to check if we are colliding with any other colliders (CCD)
+            */
+            // get the current collider position
+            struct ye_rectf old_position = ye_get_position(entity,YE_COMPONENT_COLLIDER);
+            struct ye_rectf new_position = old_position;
+
+            // calculate the change in position based on the velocity
+            float dx = physics->velocity.x * delta;
+            float dy = physics->velocity.y * delta;
+
+            // if this entity has a static collider, we need to check if we are colliding with any other static colliders
+            if(!entity->collider->is_trigger){
+                bool world_changed = true;
+                bool gone = false;
+                uint32_t mask = _layer_mask_of(entity);
+
+                for(int i = 0; i < YE_PHYSICS_SUBSTEPS; i++){
+                    // callbacks can add, move or destroy colliders, so refresh what we test against after them
+                    if(world_changed){
+                        if(static_dirty)
+                            ye_physics_build_broadphase();
+                        if(!moving_valid)
+                            _build_moving_cache();
+
+                        struct ye_rectf swept = {
+                            fminf(old_position.x, old_position.x + dx),
+                            fminf(old_position.y, old_position.y + dy),
+                            old_position.w + fabsf(dx),
+                            old_position.h + fabsf(dy)
+                        };
+                        _gather_static(swept, mask);
+                        world_changed = false;
+                    }
 
-                /*
-                    CASE THAT ENTITY HAS A COLLIDER
-                    We need to check if we are colliding with any other colliders (CCD)
-                */
-                // get the current collider position
-                struct ye_rectf old_position = ye_get_position(current->entity,YE_COMPONENT_COLLIDER);
-
-                // // if relative, mitigate the offset bias
-                // if(current->entity->collider->relative){
-                //     old_position.x += current->entity->collider->rect.x;
-                //     old_position.y += current->entity->collider->rect.y;
-                // }
-
-                struct ye_rectf new_position = old_position;
-
-                // printf("original pos: %f,%f\n",old_position.x,old_position.y);
-
-                // calculate the change in position based on the velocity
-                float dx = current->entity->physics->velocity.x * delta;
-                float dy = current->entity->physics->velocity.y * delta;
-
-                // printf("calculated dx:%f dy:%f\n",dx,dy);
-
-                // if this entity has a static collider, we need to check if we are colliding with any other static colliders
-                if(current->entity->collider && !current->entity->collider->is_trigger && current->entity->collider->active){
-                    for(int i = 0; i < YE_PHYSICS_SUBSTEPS; i++){
-                        float substep = (i + 1) / (float)YE_PHYSICS_SUBSTEPS;  // Calculate sub-step factor
-
-                        // Calculate the interpolated position based on the sub-step
-                        new_position.x = old_position.x + substep * dx;
-                        new_position.y = old_position.y + substep * dy;
-
-                        // printf("tested substep at x:%f y:%f\n",new_position.x,new_position.y);
-                        
-                        // check for collisions by comparing this interpolated position with all other colliders
-                        struct ye_entity_node *current_collider = collider_list_head;
-                        while (current_collider != NULL) {
-                            // if a collider is on a different entity and is active
-                            if (current_collider->entity->id != current->entity->id && current_collider->entity->collider != NULL && current_collider->entity->collider->active) {
-                                // check if we collide with it
-                                if(ye_rectf_collision(new_position, ye_get_position(current_collider->entity,YE_COMPONENT_COLLIDER))){
-
-                                    /*
-                                        TODO: FIXME: PATCH
-
-                                        This should actually reset to the smallest fitting substep we took
-                                    */
-                                    if(!current_collider->entity->collider->is_trigger){
-                                        new_position.x = old_position.x;
-                                        new_position.y = old_position.y;
-                                    }
-                                    
-                                    break;
-                                }
+                    float substep = (i + 1) / (float)YE_PHYSICS_SUBSTEPS;  // Calculate sub-step factor
+
+                    // Calculate the interpolated position based on the sub-step
+                    new_position.x = old_position.x + substep * dx;
+                    new_position.y = old_position.y + substep * dy;
+
+                    // check for collisions by comparing this interpolated position with the nearby colliders
+                    struct ye_entity *hit = _first_overlap(entity, mask, new_position);
+                    if(hit == NULL)
+                        continue;
+
+                    // something ran into it
+                    if(hit->physics != NULL && hit->physics->sleeping)
+                        ye_physics_wake(hit);
+
+                    // if collider we touched is static
+                    if(!hit->collider->is_trigger){
+                        /*
+                            TODO: FIXME: PATCH
+
+                            This should actually reset to the smallest fitting substep we took
+                        */
+                        new_position.x = old_position.x;
+                        new_position.y = old_position.y;
+
+                        physics->velocity.x = 0;
+                        physics->velocity.y = 0;
+
+                        // we stopped short by up to this step's movement, stay in contact within it
+                        if(_touch(entity, hit, false, fmaxf(fabsf(dx), fabsf(dy)) + 1)){
+                            ye_fire_event(YE_EVENT_COLLISION, (union ye_event_args){.collision = {entity, hit}});
+                            
+                            ye_lua_signal_collisions(entity,hit);
+
+                            // the callbacks destroyed it (or took its physics away), its query entry is a hole now
+                            if(physics_query->entities[q] != entity){
+                                moving_valid = false;
+                                gone = true;
+                                break;
                             }
-                            current_collider = current_collider->next;
                         }
 
-                        // if we actually hit a collider this step, current_collider will not be NULL
-                        if(current_collider != NULL && current_collider->entity->active && current_collider->entity->collider->active){
-                            // ye_logf(debug, "Hit collider on entity %d\n", current_collider->entity->id);
-                            // if collider we touched is static
-                            if(!current_collider->entity->collider->is_trigger){
-                                current->entity->physics->velocity.x = 0;
-                                current->entity->physics->velocity.y = 0;
-
-                                ye_fire_event(YE_EVENT_COLLISION, (union ye_event_args){.collision = {current->entity, current_collider->entity}});
-                                
-                                ye_lua_signal_collisions(current->entity,current_collider->entity);
-
-                                /*
-                                    Saving for later as it may be relevant to the future:
-
-                                    // calculate the distance between the entity and the collider in both directions
-                                    int dx = current_collider->entity->collider->rect.x - (current->entity->transform->rect.w + current->entity->collider->rect.w) - current->entity->transform->rect.x;
-                                    int dy = current_collider->entity->collider->rect.y - (current->entity->transform->rect.h + current->entity->collider->rect.h) - current->entity->transform->rect.y;
-
-                                    // move the entity in the direction with the smaller distance, unless already overlapping
-                                    if (abs(dx) < abs(dy) && dx != 0) {
-                                        current->entity->transform->rect.x += dx + current->entity->collider->rect.w;
-                                    } else if (abs(dy) < abs(dx) && dy != 0) {
-                                        current->entity->transform->rect.y += dy;
-                                    }
-                                */
-                                
-                                break; // break out of the substep loop
-                            }
-                            else{
-                                /*
-                                    If we hit a trigger collider, broadcast the two collision entities into the
-                                    event callback
-                                */
-                                ye_fire_event(YE_EVENT_TRIGGER_ENTER, (union ye_event_args){.collision = {current->entity, current_collider->entity}});
-                                
-                                ye_lua_signal_trigger_enter(current->entity,current_collider->entity);
-                            }
-                        } // TODO: do we want to cancel rotational velocity here too?
+                        moving_valid = false;
+                        break; // break out of the substep loop
                     }
+                    else{
+                        /*
+                            If we hit a trigger collider, broadcast the two collision entities into the
+                            event callback
+                        */
+                        if(_touch(entity, hit, true, 0)){
+                            ye_fire_event(YE_EVENT_TRIGGER_ENTER, (union ye_event_args){.collision = {entity, hit}});
+                            
+                            ye_lua_signal_trigger_enter(entity,hit);
+
+                            moving_valid = false;
+                            world_changed = true;
+
+                            if(physics_query->entities[q] != entity || entity->collider == NULL){
+                                gone = physics_query->entities[q] != entity;
+                                break;
+                            }
+                        }
+                    } // TODO: do we want to cancel rotational velocity here too?
                 }
-                /*
-                    even if we havent changed our new position at all from the old, this line is still true.
-                    We are changing whatever position this entity needs to be based on whatever substep max it hit or change it needs to be.
-                */
-                current->entity->transform->x = new_position.x; // bug? relativity makes it so we need to do something diff because this is offset with relative from root transform?
-                current->entity->transform->y = new_position.y;
-            }
-            // if we have rotational velocity apply it (if we have a renderer)
-            if(current->entity->physics->rotational_velocity != 0 && current->entity->renderer != NULL){
-                // update the entity's rotation based on its rotational velocity
-                current->entity->renderer->rotation += current->entity->physics->rotational_velocity * delta;
-                if(current->entity->renderer->rotation > 360) current->entity->renderer->rotation -= 360;
-                if(current->entity->renderer->rotation < 0) current->entity->renderer->rotation += 360;
+                if(gone)
+                    continue;
             }
+            /*
+                even if we havent changed our new position at all from the old, this line is still true.
+                We are changing whatever position this entity needs to be based on whatever substep max it hit or change it needs to be.
+            */
+            entity->transform->x = new_position.x; // bug? relativity makes it so we need to do something diff because this is offset with relative from root transform?
+            entity->transform->y = new_position.y;
+
+            // keep later movers this step testing against where we ended up
+            if(moving_valid && entity->collider != NULL && entity->collider->_step_slot >= 0)
+                moving_bodies[entity->collider->_step_slot].rect = ye_get_position(entity, YE_COMPONENT_COLLIDER);
         }
-        current = current->next;
+
+        _apply_rotation(entity, delta);
     }
+    ye_ecs_query_unlock(physics_query);
+
+    _end_contacts();
     // printf("Physics system took %lu ms\n", SDL_GetTicks64() - start);
-}
\ No newline at end of file
+}
+
+/*
+    Queries
+
+    Answered from the same index the physics step uses: statics come out of the grid cells
+    the query touches, movers are few enough to test directly. Queries keep their own scratch
+    list, so they are safe to run from inside collision callbacks.
+*/
+
+static int *query_candidates = NULL;
+static int query_candidate_count = 0;
+static int query_candidate_capacity = 0;
+
+// tag is filter->tag already interned, so the per entity check is a pointer compare
+static bool _accept(struct ye_entity *entity, const struct ye_physics_filter *filter, const char *tag){
+    if(!entity->active || entity->collider == NULL || !entity->collider->active)
+        return false;
+    if(filter == NULL)
+        return true;
+    if(filter->layers != 0 && !_in_mask(entity, filter->layers))
+        return false;
+    if(entity == filter->ignore)
+        return false;
+    if(filter->skip_triggers && entity->collider->is_trigger)
+        return false;
+    if(filter->tag != NULL && !ye_entity_has_interned_tag(entity, tag))
+        return false;
+    return true;
+}
+
+/*
+    Calls visit for every accepted collider that might overlap area (statics in the cells it
+    touches, plus every mover), until visit returns false. visit does the exact test.
+*/
+static void _query(struct ye_rectf area, const struct ye_physics_filter *filter,
+                    bool (*visit)(struct ye_entity *entity, struct ye_rectf rect, void *ctx), void *ctx){
+    if(static_dirty)
+        ye_physics_build_broadphase();
+
+    // a tag nothing has interned is on no entity
+    const char *tag = NULL;
+    if(filter != NULL && filter->tag != NULL){
+        tag = ye_intern_find(filter->tag);
+        if(tag == NULL)
+            return;
+    }
+
+    uint32_t mask = filter != NULL && filter->layers != 0 ? filter->layers : YE_PHYSICS_LAYERS_ALL;
+    _gather_static_into(area, mask, &query_candidates, &query_candidate_count, &query_candidate_capacity);
+    for(int i = 0; i < query_candidate_count; i++){
+        struct ye_static_body *body = &static_bodies[query_candidates[i]];
+        if(!_accept(body->entity, filter, tag))
+            continue;
+        if(!visit(body->entity, body->rect, ctx))
+            return;
+    }
+
+    for(struct ye_entity_node *node = collider_list_head; node != NULL; node = node->next){
+        struct ye_entity *entity = node->entity;
+        if(entity->collider == NULL || ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC || !_accept(entity, filter, tag))
+            continue;
+        if(!visit(entity, ye_get_position(entity, YE_COMPONENT_COLLIDER), ctx))
+            return;
+    }
+}
+
+/*
+    Slab test of a ray against a rect, t is in the same units as max_distance.
+    A ray starting inside the rect hits at t = 0 with a zero normal.
+*/
+static bool _ray_rect(struct ye_vec2f origin, struct ye_vec2f dir, float max_distance, struct ye_rectf rect,
+                        float *t_out, struct ye_vec2f *normal_out){
+    float t_min = 0, t_max = max_distance;
+    struct ye_vec2f normal = {0, 0};
+
+    float o[2] = { origin.x, origin.y };
+    float d[2] = { dir.x, dir.y };
+    float lo[2] = { rect.x, rect.y };
+    float hi[2] = { rect.x + rect.w, rect.y + rect.h };
+
+    for(int axis = 0; axis < 2; axis++){
+        if(fabsf(d[axis]) < 1e-8f){
+            if(o[axis] < lo[axis] || o[axis] > hi[axis])
+                return false;
+            continue;
+        }
+
+        float t1 = (lo[axis] - o[axis]) / d[axis];
+        float t2 = (hi[axis] - o[axis]) / d[axis];
+        float side = d[axis] > 0 ? -1.0f : 1.0f;
+        if(t1 > t2){ float tmp = t1; t1 = t2; t2 = tmp; }
+
+        if(t1 > t_min){
+            t_min = t1;
+            normal = axis == 0 ? (struct ye_vec2f){side, 0} : (struct ye_vec2f){0, side};
+        }
+        if(t2 < t_max)
+            t_max = t2;
+        if(t_min > t_max)
+            return false;
+    }
+
+    *t_out = t_min;
+    *normal_out = normal;
+    return true;
+}
+
+struct ye_cast_ctx {
+    struct ye_rectf box;            // zero size for a ray
+    struct ye_vec2f dir;            // normalized
+    float max_distance;
+    struct ye_physics_hit *hits;
+    int max_hits;
+    int count;
+};
+
+// keeps the nearest max_hits, sorted by distance
+static bool _visit_cast(struct ye_entity *entity, struct ye_rectf rect, void *data){
+    struct ye_cast_ctx *ctx = data;
+
+    // sweeping a box against a rect is a ray against the rect grown by the box
+    struct ye_rectf grown = { rect.x - ctx->box.w, rect.y - ctx->box.h, rect.w + ctx->box.w, rect.h + ctx->box.h };
+
+    float t;
+    struct ye_vec2f normal;
+    if(!_ray_rect((struct ye_vec2f){ctx->box.x, ctx->box.y}, ctx->dir, ctx->max_distance, grown, &t, &normal))
+        return true;
+
+    if(ctx->count == ctx->max_hits && t >= ctx->hits[ctx->count - 1].distance)
+        return true;
+
+    int i = ctx->count < ctx->max_hits ? ctx->count++ : ctx->count - 1;
+    while(i > 0 && ctx->hits[i - 1].distance > t){
+        ctx->hits[i] = ctx->hits[i - 1];
+        i--;
+    }
+    ctx->hits[i] = (struct ye_physics_hit){
+        .entity = entity,
+        .point = { ctx->box.x + ctx->dir.x * t, ctx->box.y + ctx->dir.y * t },
+        .normal = normal,
+        .distance = t,
+    };
+    return true;
+}
+
+int ye_physics_sweep(struct ye_rectf box, struct ye_vec2f direction, float max_distance,
+                        const struct ye_physics_filter *filter, struct ye_physics_hit *hits, int max_hits){
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    if(length == 0 || max_distance <= 0 || max_hits <= 0 || hits == NULL)
+        return 0;
+
+    struct ye_cast_ctx ctx = {
+        .box = box,
+        .dir = { direction.x / length, direction.y / length },
+        .max_distance = max_distance,
+        .hits = hits,
+        .max_hits = max_hits,
+        .count = 0,
+    };
+
+    float end_x = box.x + ctx.dir.x * max_distance;
+    float end_y = box.y + ctx.dir.y * max_distance;
+    struct ye_rectf area = {
+        fminf(box.x, end_x),
+        fminf(box.y, end_y),
+        fabsf(end_x - box.x) + box.w,
+        fabsf(end_y - box.y) + box.h
+    };
+
+    _query(area, filter, _visit_cast, &ctx);
+    return ctx.count;
+}
+
+int ye_physics_raycast(struct ye_vec2f origin, struct ye_vec2f direction, float max_distance,
+                        const struct ye_physics_filter *filter, struct ye_physics_hit *hits, int max_hits){
+    return ye_physics_sweep((struct ye_rectf){origin.x, origin.y, 0, 0}, direction, max_distance, filter, hits, max_hits);
+}
+
+struct ye_overlap_ctx {
+    struct ye_rectf area;
+    struct ye_entity **results;
+    int max_results;
+    int count;
+};
+
+static bool _visit_overlap(struct ye_entity *entity, struct ye_rectf rect, void *data){
+    struct ye_overlap_ctx *ctx = data;
+    if(!ye_rectf_collision(ctx->area, rect))
+        return true;
+    ctx->results[ctx->count++] = entity;
+    return ctx->count < ctx->max_results;
+}
+
+int ye_physics_overlap_rect(struct ye_rectf area, const struct ye_physics_filter *filter,
+                            struct ye_entity **results, int max_results){
+    if(max_results <= 0 || results == NULL)
+        return 0;
+
+    struct ye_overlap_ctx ctx = { area, results, max_results, 0 };
+    _query(area, filter, _visit_overlap, &ctx);
+    return ctx.count;
+}
+
+static bool _visit_point(struct ye_entity *entity, struct ye_rectf rect, void *data){
+    struct ye_overlap_ctx *ctx = data;
+    float x = ctx->area.x, y = ctx->area.y;
+    if(x < rect.x || x >= rect.x + rect.w || y < rect.y || y >= rect.y + rect.h)
+        return true;
+    ctx->results[ctx->count++] = entity;
+    return ctx->count < ctx->max_results;
+}
+
+int ye_physics_overlap_point(struct ye_vec2f point, const struct ye_physics_filter *filter,
+                            struct ye_entity **results, int max_results){
+    if(max_results <= 0 || results == NULL)
+        return 0;
+
+    struct ye_overlap_ctx ctx = { {point.x, point.y, 0, 0}, results, max_results, 0 };
+    _query(ctx.area, filter, _visit_point, &ctx);
+    return ctx.count;
+}
+
+void ye_shutdown_physics(){
+    _clear_grid();
+    _clear_contacts();
+    ye_physics_reset_layers();
+    ye_free(static_bodies);
+    ye_free(oversized);
+    ye_free(candidates);
+    ye_free(moving_bodies);
+    ye_free(query_candidates);
+    static_bodies = NULL; oversized = NULL; candidates = NULL; moving_bodies = NULL; query_candidates = NULL;
+    static_capacity = candidate_capacity = moving_capacity = oversized_capacity = query_candidate_capacity = 0;
+    candidate_count = moving_count = query_candidate_count = 0;
+    static_dirty = true;
+    physics_query = NULL; // freed with the other queries
+}
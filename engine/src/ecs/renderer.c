@@ -5,6 +5,7 @@
     Licensed under the MIT license. See LICENSE file in the project root for details.
 */
 
+#include <stdio.h>
 #include <string.h>
 
 #include <SDL_ttf.h>
@@ -15,6 +16,8 @@
 #include <yoyoengine/cache.h>
 #include <yoyoengine/event.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/capture.h>
+#include <yoyoengine/intern.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/camera.h>
 #include <yoyoengine/ecs/renderer.h>
@@ -65,14 +68,12 @@ void ye_update_renderer_component(struct ye_entity *entity){
             break;
         default: ; // this semicolon fixes a mingw complaint
             // try to open new meta file and get out "src" field
-            json_t *META = NULL;
-            if(YE_STATE.editor.editor_mode)
-                META = ye_json_read(ye_path_resources(entity->renderer->renderer_impl.animation->meta_file));
-            else
-                META = yep_resource_json(entity->renderer->renderer_impl.animation->meta_file);
+            ye_json_arena_begin();
+            json_t *META = ye_json_load_transient(entity->renderer->renderer_impl.animation->meta_file);
             
             if(META == NULL){
                 ye_logf(error, "Failed to load animation meta file %s\n", entity->renderer->renderer_impl.animation->meta_file);
+                ye_json_arena_end();
                 return;
             }
 
@@ -80,7 +81,8 @@ void ye_update_renderer_component(struct ye_entity *entity){
             const char *path = NULL;
             if(!ye_json_string(META, "src", &path)){
                 ye_logf(error, "Failed to load SRC from animation meta file %s\n", entity->renderer->renderer_impl.animation->meta_file);
-                json_decref(META);
+                ye_json_release(META);
+                ye_json_arena_end();
                 return;
             }
 
@@ -89,7 +91,8 @@ void ye_update_renderer_component(struct ye_entity *entity){
 
             if(texture == NULL){
                 ye_logf(error, "Failed to load animation texture file %s\n", path);
-                json_decref(META);
+                ye_json_release(META);
+                ye_json_arena_end();
                 return;
             }
 
@@ -100,7 +103,8 @@ void ye_update_renderer_component(struct ye_entity *entity){
             ye_remove_renderer_component(entity);
             ye_add_animation_renderer_component(entity, z, meta_file);
 
-            json_decref(META);
+            ye_json_release(META);
+            ye_json_arena_end();
             free(meta_file);
             break;
     }
@@ -152,6 +156,7 @@ void ye_add_renderer_component(
 
     // add this entity to the renderer component list
     ye_entity_list_add_sorted_renderer_z(&renderer_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_RENDERER);
 
     // log that we added a renderer and to what ID
     // ye_logf(debug, "Added renderer to entity %d\n", entity->id);
@@ -159,9 +164,8 @@ void ye_add_renderer_component(
 
 void ye_add_image_renderer_component(struct ye_entity *entity, int z, const char *src){
     struct ye_component_renderer_image *image = malloc(sizeof(struct ye_component_renderer_image));
-    // copy src to image->src
-    image->src = malloc(sizeof(char) * (strlen(src) + 1));
-    strcpy(image->src, src);
+    // asset handles are interned, see intern.h
+    image->src = ye_intern(src);
 
     // create the renderer top level
     ye_add_renderer_component(entity, YE_RENDERER_TYPE_IMAGE, z, image);
@@ -196,13 +200,13 @@ void ye_add_text_renderer_component(struct ye_entity *entity, int z, const char
     text_renderer->text = strdup(text);
 
     text_renderer->font = ye_font(font, font_size);
-    text_renderer->font_name = strdup(font);
+    text_renderer->font_name = ye_intern(font);
     text_renderer->font_size = font_size;
 
     text_renderer->wrap_width = wrap_width;
 
     text_renderer->color = ye_color(color);
-    text_renderer->color_name = strdup(color);
+    text_renderer->color_name = ye_intern(color);
 
     // create the renderer top level
     ye_add_renderer_component(entity, YE_RENDERER_TYPE_TEXT, z, text_renderer);
@@ -226,16 +230,16 @@ void ye_add_text_outlined_renderer_component(struct ye_entity *entity, int z, co
     text_renderer->text = strdup(text);
 
     text_renderer->font = ye_font(font, font_size);
-    text_renderer->font_name = strdup(font);
+    text_renderer->font_name = ye_intern(font);
     text_renderer->font_size = font_size;
 
     text_renderer->wrap_width = wrap_width;
 
     text_renderer->color = ye_color(color);
-    text_renderer->color_name = strdup(color);
+    text_renderer->color_name = ye_intern(color);
 
     text_renderer->outline_color = ye_color(outline_color);
-    text_renderer->outline_color_name = strdup(outline_color);
+    text_renderer->outline_color_name = ye_intern(outline_color);
 
     text_renderer->outline_size = outline_size;
 
@@ -256,14 +260,12 @@ void ye_add_text_outlined_renderer_component(struct ye_entity *entity, int z, co
 
 void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const char *meta_file){
     // load the meta file
-    json_t *META = NULL;
-    if(YE_STATE.editor.editor_mode)
-        META = ye_json_read(ye_path_resources(meta_file));
-    else
-        META = yep_resource_json(meta_file);
+    ye_json_arena_begin();
+    json_t *META = ye_json_load_transient(meta_file);
     
     if(META == NULL){
         ye_logf(error, "Failed to load animation meta file %s\n", meta_file);
+        ye_json_arena_end();
         return;
     }
 
@@ -271,7 +273,8 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     int version; ye_json_int(META, "version", &version);
     if(version != YE_ENGINE_ANIMATION_FILE_VERSION){
         ye_logf(error, "Invalid animation meta file version %d against %d\n", version, YE_ENGINE_ANIMATION_FILE_VERSION);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -279,7 +282,8 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     const char *path = NULL; 
     if(!ye_json_string(META, "src", &path)){
         ye_logf(error, "Failed to load SRC from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -287,13 +291,15 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     int frame_width;
     if(!ye_json_int(META, "frame_width", &frame_width)){
         ye_logf(error, "Failed to load frame_width from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
     int frame_height;
     if(!ye_json_int(META, "frame_height", &frame_height)){
         ye_logf(error, "Failed to load frame_height from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -301,7 +307,8 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     int frame_count;
     if(!ye_json_int(META, "frame_count", &frame_count)){
         ye_logf(error, "Failed to load frame_count from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -309,7 +316,8 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     int frame_delay;
     if(!ye_json_int(META, "frame_delay", &frame_delay)){
         ye_logf(error, "Failed to load frame_delay from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -317,7 +325,8 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     int loops;
     if(!ye_json_int(META, "loops", &loops)){
         ye_logf(error, "Failed to load loops from animation meta file %s\n", meta_file);
-        json_decref(META);
+        ye_json_release(META);
+        ye_json_arena_end();
         return;
     }
 
@@ -346,7 +355,62 @@ void ye_add_animation_renderer_component(struct ye_entity *entity, int z, const
     animation->last_updated = SDL_GetTicks(); // set the last updated to now so we can start ticking it accurately
 
     // free the meta file
-    json_decref(META);
+    ye_json_release(META);
+    ye_json_arena_end();
+}
+
+bool ye_reload_animation_renderer_meta(struct ye_entity *entity){
+    if(entity->renderer == NULL || entity->renderer->type != YE_RENDERER_TYPE_ANIMATION){
+        ye_logf(error, "Tried to reload animation meta of entity without an animation renderer\n");
+        return false;
+    }
+
+    struct ye_component_renderer_animation *animation = entity->renderer->renderer_impl.animation;
+
+    ye_json_arena_begin();
+    json_t *META = ye_json_load_transient(animation->meta_file);
+
+    if(META == NULL){
+        ye_logf(error, "Failed to load animation meta file %s\n", animation->meta_file);
+        ye_json_arena_end();
+        return false;
+    }
+
+    int version = 0;
+    const char *path = NULL;
+    int frame_width, frame_height, frame_count, frame_delay, loops;
+    ye_json_int(META, "version", &version);
+    if(version != YE_ENGINE_ANIMATION_FILE_VERSION ||
+       !ye_json_string(META, "src", &path) ||
+       !ye_json_int(META, "frame_width", &frame_width) ||
+       !ye_json_int(META, "frame_height", &frame_height) ||
+       !ye_json_int(META, "frame_count", &frame_count) ||
+       !ye_json_int(META, "frame_delay", &frame_delay) ||
+       !ye_json_int(META, "loops", &loops)){
+        // keep playing the old clip rather than breaking the renderer on a bad save
+        ye_logf(error, "Invalid animation meta file %s, keeping previous clip\n", animation->meta_file);
+        ye_json_release(META);
+        ye_json_arena_end();
+        return false;
+    }
+
+    if(strcmp(animation->animation_handle, path) != 0){
+        free(animation->animation_handle);
+        animation->animation_handle = strdup(path);
+    }
+    entity->renderer->texture = ye_image(path);
+
+    animation->frame_width = frame_width;
+    animation->frame_height = frame_height;
+    animation->frame_count = frame_count;
+    animation->frame_delay = frame_delay;
+    animation->loops = loops;
+    if(animation->current_frame_index >= frame_count)
+        animation->current_frame_index = 0;
+
+    ye_json_release(META);
+    ye_json_arena_end();
+    return true;
 }
 
 void ye_add_tilemap_renderer_component(struct ye_entity *entity, int z, const char * handle, SDL_Rect src){
@@ -369,14 +433,14 @@ void ye_remove_renderer_component(struct ye_entity *entity){
     // free contents of renderer_impl
     switch(entity->renderer->type){
         case YE_RENDERER_TYPE_IMAGE:
-            free(entity->renderer->renderer_impl.image->src);
+            ye_intern_release(entity->renderer->renderer_impl.image->src);
             free(entity->renderer->renderer_impl.image);
             break;
         case YE_RENDERER_TYPE_TEXT:
             free(entity->renderer->renderer_impl.text->text);
-            // free the strings we strdup'd before the impl itself (duh)
-            free(entity->renderer->renderer_impl.text->font_name);
-            free(entity->renderer->renderer_impl.text->color_name);
+            // release the names before the impl itself (duh)
+            ye_intern_release(entity->renderer->renderer_impl.text->font_name);
+            ye_intern_release(entity->renderer->renderer_impl.text->color_name);
             free(entity->renderer->renderer_impl.text);
 
             // text textures are not stored in cache, manually remove them
@@ -384,10 +448,10 @@ void ye_remove_renderer_component(struct ye_entity *entity){
             break;
         case YE_RENDERER_TYPE_TEXT_OUTLINED:
             free(entity->renderer->renderer_impl.text_outlined->text);
-            // free the strings we strdup'd before the impl itself (duh)
-            free(entity->renderer->renderer_impl.text_outlined->font_name);
-            free(entity->renderer->renderer_impl.text_outlined->color_name);
-            free(entity->renderer->renderer_impl.text_outlined->outline_color_name);
+            // release the names before the impl itself (duh)
+            ye_intern_release(entity->renderer->renderer_impl.text_outlined->font_name);
+            ye_intern_release(entity->renderer->renderer_impl.text_outlined->color_name);
+            ye_intern_release(entity->renderer->renderer_impl.text_outlined->outline_color_name);
             free(entity->renderer->renderer_impl.text_outlined);
 
             // text textures are not stored in cache, manually remove them
@@ -412,6 +476,7 @@ void ye_remove_renderer_component(struct ye_entity *entity){
 
     // remove the entity from the renderer component list
     ye_entity_list_remove(&renderer_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_RENDERER);
 }
 
 void _draw_subsecting_lines(SDL_Renderer * renderer, SDL_Rect cam, int line_spacing, int thickness, SDL_Color color) {
@@ -448,6 +513,80 @@ void _draw_subsecting_lines(SDL_Renderer * renderer, SDL_Rect cam, int line_spac
     // printf("x offset: %d, y offset: %d\n", x_offset, y_offset);
 }
 
+/*
+    Ticks animation frames. Split out of the renderer so the scheduler can run it off the main thread,
+    it only ever touches animation renderers.
+*/
+void ye_system_animation(){
+    int now = SDL_GetTicks();
+
+    struct ye_entity_node *current = renderer_list_head;
+    while (current != NULL) {
+        struct ye_component_renderer *renderer = current->entity->renderer;
+        if(renderer->active && renderer->type == YE_RENDERER_TYPE_ANIMATION){
+            struct ye_component_renderer_animation *animation = renderer->renderer_impl.animation;
+            if(!animation->paused && now - animation->last_updated >= animation->frame_delay){
+                // the difference between now and last updated
+                int diff = (now - animation->last_updated);// / (animation->frame_delay); 
+
+                // the number of frames we need to advance
+                int frames_to_advance = diff / animation->frame_delay;
+
+                // advance the frame index and wrap around as needed
+                animation->current_frame_index += frames_to_advance;
+                if(animation->current_frame_index >= animation->frame_count){
+                    animation->current_frame_index = animation->current_frame_index % animation->frame_count;
+                    if(animation->loops != -1){
+                        animation->loops--;
+                        if(animation->loops <= 0){
+                            animation->paused = true; // TODO: dont just pause when it ends, but give option to destroy/ disable renderer
+                            // pause on the last frame of the animation
+                            animation->current_frame_index = animation->frame_count - 1;
+                        }
+                    }
+                }
+                animation->last_updated = now;
+            }
+        }
+        current = current->next;
+    }
+}
+
+// records a renderer draw into the frame capture, timed from start
+static void _ye_capture_renderer(struct ye_entity *entity, SDL_Rect *src, SDL_Rect dst, Uint64 start){
+    struct ye_component_renderer *rend = entity->renderer;
+    struct ye_capture_op op = {0};
+
+    op.source = YE_CAPTURE_SCENE;
+    op.entity = entity->id;
+    op.src = src != NULL ? *src : (SDL_Rect){0, 0, 0, 0};
+    op.dst = dst;
+    op.rotation = rend->rotation;
+    op.flip = (rend->flipped_x ? SDL_FLIP_HORIZONTAL : 0) | (rend->flipped_y ? SDL_FLIP_VERTICAL : 0);
+    op.alpha = rend->alpha;
+    op.z = rend->z;
+    op.color = (SDL_Color){255, 255, 255, rend->alpha};
+    op.cost_ms = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+
+    // text is drawn from a texture made at runtime, so it replays as a rect labeled with the text
+    const char *handle = NULL;
+    const char *label = entity->name;
+    switch(rend->type){
+        case YE_RENDERER_TYPE_IMAGE:            handle = rend->renderer_impl.image->src; break;
+        case YE_RENDERER_TYPE_ANIMATION:        handle = rend->renderer_impl.animation->animation_handle; break;
+        case YE_RENDERER_TYPE_TILEMAP_TILE:     handle = rend->renderer_impl.tile->handle; break;
+        case YE_RENDERER_TYPE_TEXT:             label = rend->renderer_impl.text->text; break;
+        case YE_RENDERER_TYPE_TEXT_OUTLINED:    label = rend->renderer_impl.text_outlined->text; break;
+        default: break;
+    }
+    if(handle != NULL)
+        snprintf(op.texture, sizeof(op.texture), "%s", handle);
+    if(label != NULL)
+        snprintf(op.label, sizeof(op.label), "%s", label);
+
+    ye_capture_record(&op);
+}
+
 void ye_system_renderer(SDL_Renderer *renderer) {
     if(YE_STATE.editor.editor_mode && YE_STATE.editor.editor_display_viewport_lines){
 
@@ -507,6 +646,7 @@ void ye_system_renderer(SDL_Renderer *renderer) {
     }
 
     YE_STATE.runtime.painted_entity_count = 0;
+    YE_STATE.runtime.draw_call_count = 0;
 
     /*
         Get the cameras position in world coordinates
@@ -517,40 +657,6 @@ void ye_system_renderer(SDL_Renderer *renderer) {
     struct ye_entity_node *current = renderer_list_head;
     while (current != NULL) {
         if (current->entity->renderer->active) {
-            // check if renderer is animation and attemt to tick its frame if so
-            // TODO: this should be decoupled from the renderer and become its own system
-            if(current->entity->renderer->type == YE_RENDERER_TYPE_ANIMATION){
-                // if not editor mode (we want to not run animations in editor)
-                if(!YE_STATE.editor.editor_mode){
-                    struct ye_component_renderer_animation *animation = current->entity->renderer->renderer_impl.animation;
-                    if(!animation->paused){
-                        int now = SDL_GetTicks();
-                        if(now - animation->last_updated >= animation->frame_delay){
-                            // the difference between now and last updated
-                            int diff = (now - animation->last_updated);// / (animation->frame_delay); 
-
-                            // the number of frames we need to advance
-                            int frames_to_advance = diff / animation->frame_delay;
-
-                            // advance the frame index and wrap around as needed
-                            animation->current_frame_index += frames_to_advance;
-                            if(animation->current_frame_index >= animation->frame_count){
-                                animation->current_frame_index = animation->current_frame_index % animation->frame_count;
-                                if(animation->loops != -1){
-                                    animation->loops--;
-                                    if(animation->loops <= 0){
-                                        animation->paused = true; // TODO: dont just pause when it ends, but give option to destroy/ disable renderer
-                                        // pause on the last frame of the animation
-                                        animation->current_frame_index = animation->frame_count - 1;
-                                    }
-                                }
-                            }
-                            animation->last_updated = now;
-                            // current->entity->renderer->texture = animation->frames[animation->current_frame_index]; was this the only thing to change?
-                        }
-                    }
-                }
-            }
             // paint the entity
             if (current->entity->active && // entity active
                 current->entity->renderer != NULL && // renderer is not null
@@ -649,6 +755,8 @@ void ye_system_renderer(SDL_Renderer *renderer) {
                     if(current->entity->renderer->alignment == YE_ALIGN_STRETCH)
                         ent_src_rect = NULL;
 
+                    Uint64 capture_start = ye_capture_recording() ? SDL_GetPerformanceCounter() : 0;
+
                     // if transform is flipped or rotated render it differently
                     if(current->entity->renderer->flipped_x || current->entity->renderer->flipped_y){
                         SDL_RendererFlip flip = SDL_FLIP_NONE;
@@ -670,7 +778,11 @@ void ye_system_renderer(SDL_Renderer *renderer) {
                         SDL_RenderCopy(renderer, current->entity->renderer->texture, ent_src_rect, &entity_rect);
                     }
                     
+                    if(capture_start != 0)
+                        _ye_capture_renderer(current->entity, ent_src_rect, entity_rect, capture_start);
+
                     YE_STATE.runtime.painted_entity_count++;
+                    YE_STATE.runtime.draw_call_count++;
                     
                     // paint bounds, my beloved <3
                     if (YE_STATE.editor.paintbounds_visible) {
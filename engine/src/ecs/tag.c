@@ -10,6 +10,9 @@
 #include <stdlib.h>
 
 #include <yoyoengine/logging.h>
+#include <yoyoengine/intern.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/utils.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/tag.h>
 
@@ -20,18 +23,19 @@ void ye_add_tag_component(struct ye_entity *entity){
         return;
     }
 
-    entity->tag = malloc(sizeof(struct ye_component_tag));
+    entity->tag = ye_malloc(YE_MEM_ECS, sizeof(struct ye_component_tag));
     entity->tag->active = true;
 
-    // tags are already malloced, set them to be empty
+    // start with every slot empty
     for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
-        entity->tag->tags[i][0] = '\0';
+        entity->tag->tags[i] = NULL;
     }
 
     // log that we added a tag and to what ID
     // ye_logf(debug, "Added tag component to entity %d\n", entity->id);
 
     ye_entity_list_add(&tag_list_head, entity);
+    ye_entity_component_added(entity, YE_COMPONENT_TAG);
 }
 
 void ye_add_tag(struct ye_entity *entity, const char *tag){
@@ -47,7 +51,7 @@ void ye_add_tag(struct ye_entity *entity, const char *tag){
 
     // find the first empty tag slot
     int i = 0;
-    while(entity->tag->tags[i][0] != '\0'){
+    while(entity->tag->tags[i] != NULL){
         i++;
         if(i >= YE_TAG_MAX_NUMBER){
             ye_logf(error, "Could not add tag \"%s\" to entity #%d. Tags list is full.\n", tag, entity->id);
@@ -55,8 +59,8 @@ void ye_add_tag(struct ye_entity *entity, const char *tag){
         }
     }
 
-    // copy the tag into the slot
-    strcpy(entity->tag->tags[i], tag);
+    // the slot holds a reference to the interned tag
+    entity->tag->tags[i] = ye_intern(tag);
 
     // log that we added a tag and to what ID
     // ye_logf(debug, "Added tag \"%s\" to entity %d\n", tag, entity->id);
@@ -66,6 +70,7 @@ void ye_remove_tag(struct ye_entity *entity, const char *tag){
     // check if tag component exists
     if(!entity->tag){
         ye_logf(error, "Could not remove tag \"%s\" from entity #%d. Entity has no tag component.\n", tag, entity->id);
+        return;
     }
 
     if(!entity->tag->active){
@@ -73,9 +78,10 @@ void ye_remove_tag(struct ye_entity *entity, const char *tag){
         return; // TODO: is this necessary?
     }
 
-    // find the tag
+    // find the tag, if nothing interned it then no entity can have it
+    const char *key = ye_intern_find(tag);
     int i = 0;
-    while(strcmp(entity->tag->tags[i], tag) != 0){
+    while(key == NULL || entity->tag->tags[i] != key){
         i++;
         if(i >= YE_TAG_MAX_NUMBER){
             ye_logf(error, "Could not remove tag \"%s\" from entity #%d. Tag not found.\n", tag, entity->id);
@@ -84,7 +90,8 @@ void ye_remove_tag(struct ye_entity *entity, const char *tag){
     }
 
     // remove the tag
-    entity->tag->tags[i][0] = '\0';
+    ye_intern_release(entity->tag->tags[i]);
+    entity->tag->tags[i] = NULL;
 
     // log that we removed a tag and to what ID
     // ye_logf(debug, "Removed tag from entity %d\n", entity->id);
@@ -92,7 +99,7 @@ void ye_remove_tag(struct ye_entity *entity, const char *tag){
     // if the tag component is empty, remove it
     bool empty = true;
     for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
-        if(entity->tag->tags[i][0] != '\0'){
+        if(entity->tag->tags[i] != NULL){
             empty = false;
             break;
         }
@@ -103,20 +110,28 @@ void ye_remove_tag(struct ye_entity *entity, const char *tag){
 }
 
 void ye_remove_tag_component(struct ye_entity *entity){
-    free(entity->tag);
+    for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
+        ye_intern_release(entity->tag->tags[i]);
+    }
+    ye_free(entity->tag);
     entity->tag = NULL;
 
     // log that we removed a tag and to what ID
     // ye_logf(debug, "Removed tag from entity %d\n", entity->id);
 
     ye_entity_list_remove(&tag_list_head, entity);
+    ye_entity_component_removed(entity, YE_COMPONENT_TAG);
 }
 
 bool ye_entity_has_tag(struct ye_entity *entity, const char *tag){
     // TODO: add more checks for active and such?
-    if(entity->tag != NULL){
+    return ye_entity_has_interned_tag(entity, ye_intern_find(tag));
+}
+
+bool ye_entity_has_interned_tag(struct ye_entity *entity, const char *tag){
+    if(entity->tag != NULL && tag != NULL){
         for(int i = 0; i < YE_TAG_MAX_NUMBER; i++){
-            if(strcmp(tag, entity->tag->tags[i]) == 0){
+            if(entity->tag->tags[i] == tag){
                 return true;
             }
         }
@@ -125,9 +140,15 @@ bool ye_entity_has_tag(struct ye_entity *entity, const char *tag){
 }
 
 void ye_for_matching_tag(const char * tag, void(*callback)(struct ye_entity *ent)){
+    // look the tag up once, every entity after that is a pointer compare
+    const char *key = ye_intern_find(tag);
+    if(key == NULL){
+        return;
+    }
+
     struct ye_entity_node *itr = tag_list_head;
     while(itr != NULL){
-        if(ye_entity_has_tag(itr->entity,tag)){
+        if(ye_entity_has_interned_tag(itr->entity,key)){
             callback(itr->entity);
         }
 
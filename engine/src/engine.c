@@ -19,6 +19,7 @@
 #include <yoyoengine/ui.h>
 #include <yoyoengine/yep.h>
 #include <yoyoengine/input.h>
+#include <yoyoengine/intern.h>
 #include <yoyoengine/scene.h>
 #include <yoyoengine/json.h>
 #include <yoyoengine/audio.h>
@@ -28,10 +29,21 @@
 #include <yoyoengine/config.h>
 #include <yoyoengine/engine.h>
 #include <yoyoengine/tricks.h>
+#include <yoyoengine/jobs.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/metrics.h>
+#include <yoyoengine/capture.h>
+#include <yoyoengine/observer.h>
+#include <yoyoengine/hotreload.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/lua_api.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/graphics.h>
+#include <yoyoengine/scheduler.h>
 #include <yoyoengine/networking.h>
+#include <yoyoengine/navigation.h>
+#include <yoyoengine/tween.h>
+#include <yoyoengine/scene_profiler.h>
 #include <yoyoengine/ecs/camera.h>
 #include <yoyoengine/ecs/button.h>
 #include <yoyoengine/ecs/physics.h>
@@ -58,7 +70,7 @@ char *executable_path = NULL;
 
 // TODO: temp leaving because editor knows where its copy of engine resources is through this
 char* ye_get_engine_resource_static(const char *sub_path) {
-    static char engine_reserved_buffer[256];  // Adjust the buffer size as per your requirement
+    static _Thread_local char engine_reserved_buffer[256];  // per thread, jobs build paths too
 
     if (YE_STATE.engine.engine_resources_path == NULL) {
         ye_logf(error, "Engine reserved paths not set!\n");
@@ -76,7 +88,7 @@ char* ye_get_engine_resource_static(const char *sub_path) {
 */
 
 char * ye_path(const char * path){
-    static char path_relative_buffer[512];
+    static _Thread_local char path_relative_buffer[512]; // per thread, jobs build paths too
 
     // this is set at engine init so discourage calling before then
     if (executable_path == NULL) {
@@ -89,7 +101,7 @@ char * ye_path(const char * path){
 }
 
 char * ye_path_resources(const char * path){
-    static char path_relative_buffer_resources[512];
+    static _Thread_local char path_relative_buffer_resources[512];
     
     // this is set at engine init so discourage calling before then
     if (executable_path == NULL) {
@@ -103,6 +115,38 @@ char * ye_path_resources(const char * path){
 
 /* ============== end new paths ============== */
 
+/*
+    Startup is measured from the top of ye_init_engine until the first
+    frame with the entry scene loaded has been processed.
+*/
+static uint64_t startup_counter = 0;
+static bool awaiting_first_frame = false;
+
+static float _ye_ms_since_startup(){
+    return (SDL_GetPerformanceCounter() - startup_counter) * 1000.0f / SDL_GetPerformanceFrequency();
+}
+
+// the entry scene from settings.yoyo, preloaded during init and loaded when the splash is done
+static char *entry_scene = NULL;
+
+static void _ye_load_entry_scene(){
+    // editor mode loads its own scene
+    if(!YE_STATE.editor.editor_mode){
+        if(entry_scene != NULL){
+            ye_logf(info, "Detected entry: %s.\n", entry_scene);
+            ye_load_scene(entry_scene);
+        }
+        else{
+            ye_logf(warning, "No entry_scene specified in settings.yoyo, if you do not load a custom scene the engine will crash.\n");
+        }
+    }
+
+    ye_free(entry_scene);
+    entry_scene = NULL;
+
+    awaiting_first_frame = true;
+}
+
 int last_frame_time = 0;
 void ye_process_frame(){
     // update time delta
@@ -115,53 +159,38 @@ void ye_process_frame(){
         last_frame_time = SDL_GetTicks64();
     }
 
+    // pick up any loose resources that changed on disk (does nothing unless the watcher was started)
+    ye_hotreload_poll();
+
     // update timers
     ye_update_timers();
 
     // C pre frame callback
     ye_fire_event(YE_EVENT_PRE_FRAME, (union ye_event_args){NULL});
 
-    int input_time = SDL_GetTicks64();
-    
     /*
-        Let the input system handle the following:
-        - Send events to Nuklear
-        - Handle engine input events (terminal, resizing)
-        - Send callback to game C code
-        - Lookup events in mapping table and inform C and Lua
+        Run input, physics, tricks, lua, animation, audio and rendering.
+        The scheduler orders them from what each one reads and writes, see scheduler.h
     */
-    ye_system_input();
+    ye_run_systems();
 
-    YE_STATE.runtime.input_time = SDL_GetTicks64() - input_time;
+    YE_STATE.runtime.frame_time = SDL_GetTicks64() - last_frame_time;
 
+    // C post frame callback
+    ye_fire_event(YE_EVENT_POST_FRAME, (union ye_event_args){NULL});
 
-    int physics_time = SDL_GetTicks64();
-    if(!YE_STATE.editor.editor_mode){
-        // update physics
-        ye_system_physics(); // TODO: decouple from framerate
-    }
-    YE_STATE.runtime.physics_time = SDL_GetTicks64() - physics_time;
+    // close this frame's allocation counters
+    ye_memory_end_frame();
 
-    // if we are in runtime, run callbacks
-    if(!YE_STATE.editor.editor_mode){
-        // run all trick update callbacks
-        ye_run_trick_updates();
-    
-        // run all scripting before the frame is rendered
-        ye_system_lua_scripting();
+    // the first frame of the entry scene is where startup ends for the player
+    if(awaiting_first_frame){
+        awaiting_first_frame = false;
+        YE_STATE.runtime.first_frame_ms = _ye_ms_since_startup();
+        ye_logf(info, "First interactive frame after %.1fms.\n", YE_STATE.runtime.first_frame_ms);
     }
 
-    // render frame
-    ye_render_all();
-
-    // recompute audio spatialization
-    if(!YE_STATE.editor.editor_mode)
-        ye_system_audiosource();
-
-    YE_STATE.runtime.frame_time = SDL_GetTicks64() - last_frame_time;
-
-    // C post frame callback
-    ye_fire_event(YE_EVENT_POST_FRAME, (union ye_event_args){NULL});
+    // record this frame for the metrics sink, if there is one
+    ye_metrics_frame();
 }
 
 float ye_delta_time(){
@@ -174,27 +203,20 @@ void ye_update_base_path(char *path){
     executable_path = strdup(path);
 }
 
-void teardown_splash_screen(){
-    // open SETTINGS again
-    json_t *SETTINGS = ye_json_read(ye_path("settings.yoyo"));
-    
-    // retrieve and load the entry scene (editor mode handles this itself)
-    if(!YE_STATE.editor.editor_mode){
-        const char * entry_scene;
-        if (ye_json_string(SETTINGS, "entry_scene", &entry_scene)) {
-            ye_logf(info, "Detected entry: %s.\n", entry_scene);
-            ye_load_scene(entry_scene);
-        }
-        else{
-            ye_logf(warning, "No entry_scene specified in settings.yoyo, if you do not load a custom scene the engine will crash.\n");
-        }
-    }
+static uint64_t splash_start = 0;
 
-    // no need to free timer, timer system will do it
+/*
+    Runs every frame while the splash is up, and ends it as soon as the
+    entry scene is parsed (and the splash has been up for splash_min_ms).
+*/
+void teardown_splash_screen(struct ye_timer *timer){
+    if(!ye_scene_preload_ready() || SDL_GetTicks64() - splash_start < (uint64_t)YE_STATE.engine.splash_min_ms)
+        return;
+
+    // last run, the timer system frees the timer after this
+    timer->loops = 1;
 
-    // free the settings json as needed
-    if(SETTINGS != NULL)
-        json_decref(SETTINGS);
+    _ye_load_entry_scene();
 }
 
 void setup_splash_screen(){
@@ -205,7 +227,7 @@ void setup_splash_screen(){
         default scene after 3000ms
     */
 
-    YE_STATE.runtime.scene_name = strdup("engine_splash_screen");
+    YE_STATE.runtime.scene_name = ye_strdup(YE_MEM_SCENE, "engine_splash_screen");
 
     if(!YE_STATE.editor.editor_mode){
         // because play sound looks in resources pack, we need to pre cache the engine one
@@ -261,17 +283,19 @@ void setup_splash_screen(){
     ye_update_renderer_component(splash_version);
 
     /*
-        Create a timer 3000ms from now to load the default scene
+        Check every frame whether the entry scene is ready to replace the splash
     */
+    splash_start = SDL_GetTicks64();
     struct ye_timer * splash_timer = malloc(sizeof(struct ye_timer));
     splash_timer->start_ticks = -1;
-    splash_timer->loops = 0;
-    splash_timer->length_ms = 5000;
+    splash_timer->loops = -1;
+    splash_timer->length_ms = 0;
     splash_timer->callback = teardown_splash_screen;
     ye_register_timer(splash_timer);
 }
 
 void ye_init_engine() {
+    startup_counter = SDL_GetPerformanceCounter();
 
     // pre init callback //
     ye_fire_event(YE_EVENT_PRE_INIT, (union ye_event_args){NULL});
@@ -296,15 +320,20 @@ void ye_init_engine() {
     json_t *SETTINGS = ye_json_read(ye_path("settings.yoyo"));
     if (SETTINGS == NULL) {
         ye_logf(warning, "No settings.yoyo file found, it will be created using default values.\n");
-        json_t *SETTINGS = json_object();
+        SETTINGS = json_object();
     }
 
+    // what is on disk, so the file is only rewritten if defaults were filled in
+    json_t *SETTINGS_ON_DISK = json_deep_copy(SETTINGS);
+
     // config strings all need freed later
     YE_STATE.engine.engine_resources_path   = ye_config_string(SETTINGS, "engine_resources_path", engine_default_path);
     YE_STATE.engine.game_resources_path     = ye_config_string(SETTINGS, "game_resources_path", game_default_path);
     YE_STATE.engine.log_file_path           = ye_config_string(SETTINGS, "log_file_path", log_default_path);
     YE_STATE.engine.icon_path               = ye_config_string(SETTINGS, "icon_path", "enginelogo.png");
     YE_STATE.engine.window_title            = ye_config_string(SETTINGS, "window_title", "Yoyo Engine Window");
+    YE_STATE.engine.metrics_sink            = ye_config_string(SETTINGS, "metrics_sink", "none");
+    YE_STATE.engine.metrics_target          = ye_config_string(SETTINGS, "metrics_target", "");
 
     YE_STATE.engine.window_mode             = ye_config_int(SETTINGS, "window_mode", 0);
     YE_STATE.engine.volume                  = ye_config_int(SETTINGS, "volume", 64);
@@ -313,11 +342,16 @@ void ye_init_engine() {
     YE_STATE.engine.screen_height           = ye_config_int(SETTINGS, "screen_height", 1080);
     YE_STATE.engine.framecap                = ye_config_int(SETTINGS, "framecap", -1);
     YE_STATE.engine.sdl_quality_hint        = ye_config_int(SETTINGS, "sdl_quality_hint", 1); // linear
+    YE_STATE.engine.lua_memory_limit_kb     = ye_config_int(SETTINGS, "lua_memory_limit_kb", 0); // unlimited
+    YE_STATE.engine.job_workers             = ye_config_int(SETTINGS, "job_workers", -1); // cores - 1
+    YE_STATE.engine.splash_min_ms           = ye_config_int(SETTINGS, "splash_min_ms", 0);
+    YE_STATE.engine.metrics_interval_ms     = ye_config_int(SETTINGS, "metrics_interval_ms", 10000);
 
     YE_STATE.engine.debug_mode              = ye_config_bool(SETTINGS, "debug_mode", false);
     YE_STATE.engine.skipintro               = ye_config_bool(SETTINGS, "skip_intro", false);
     YE_STATE.editor.editor_mode             = ye_config_bool(SETTINGS, "editor_mode", false);
     YE_STATE.engine.stretch_resolution      = ye_config_bool(SETTINGS, "stretch_resolution", false);
+    YE_STATE.engine.hot_reload_scripts      = ye_config_bool(SETTINGS, "hot_reload_scripts", false);
 
     // initialize some editor state
     YE_STATE.editor.scene_default_camera = NULL;
@@ -327,6 +361,21 @@ void ye_init_engine() {
     // initialize graphics systems, creating window renderer, etc
     ye_init_graphics();
 
+    /*
+        Start the worker threads early, so the audio device opens and the entry
+        scene parses while the rest of the engine starts up.
+        Fonts stay on this thread, SDL_ttf is not safe to use from several.
+    */
+    ye_init_jobs(YE_STATE.engine.job_workers);
+    ye_init_audio_async();
+
+    const char *entry;
+    if(ye_json_string(SETTINGS, "entry_scene", &entry))
+        entry_scene = ye_strdup(YE_MEM_SCENE, entry);
+
+    if(entry_scene != NULL && !YE_STATE.editor.editor_mode)
+        ye_preload_scene(entry_scene);
+
     // init timers
     ye_init_timers();
 
@@ -372,13 +421,18 @@ void ye_init_engine() {
         ye_logf(debug, "Debug mode enabled.\n");
     }
 
-    // startup audio systems
-    ye_init_audio();
+    // the editor watches its project itself, dev builds can opt in to reloading their scripts
+    if(YE_STATE.engine.hot_reload_scripts && !YE_STATE.editor.editor_mode)
+        ye_init_hotreload(ye_path_resources(""));
 
-    // the audio initialization accesses YE_STATE.engine.volume to cap each channel by default
+    // networking starts on first use (ye_init_networking)
 
-    // initialize networking
-    ye_init_networking();
+    // register the engine systems (before tricks, so they can add their own)
+    ye_init_scheduler();
+
+    // start exporting metrics, if settings.yoyo asks for it
+    ye_init_metrics();
+    ye_init_navigation();
 
     // initialize and load tricks (modules/plugins)
     ye_init_tricks();
@@ -391,31 +445,30 @@ void ye_init_engine() {
         a splash screen with the engine title and logo for 2550ms and playing a
         startup noise
     */
+    // the splash plays a sound, and tricks may have too
+    ye_audio_wait_ready();
+
     if(YE_STATE.engine.skipintro){
         ye_logf(info,"Skipping Intro.\n");
 
         // load entry scene
-        const char * entry_scene;
-        if (ye_json_string(SETTINGS, "entry_scene", &entry_scene)) {
-            ye_logf(info, "Detected entry: %s.\n", entry_scene);
-            ye_load_scene(entry_scene);
-        }
-        else{
-            ye_logf(warning, "No entry_scene specified in settings.yoyo, if you do not load a custom scene the engine will crash.\n");
-        }
+        _ye_load_entry_scene();
     }
     else{
         setup_splash_screen();
     }
 
+    YE_STATE.runtime.init_ms = _ye_ms_since_startup();
+
     // debug output
-    ye_logf(info, "Engine Fully Initialized.\n");
+    ye_logf(info, "Engine Fully Initialized in %.1fms.\n", YE_STATE.runtime.init_ms);
 
-    // dump settings in case we created defaults, then close
-    if(SETTINGS != NULL){
+    // dump settings only if we created defaults, then close
+    if(!json_equal(SETTINGS, SETTINGS_ON_DISK)){
         ye_json_write(ye_path("settings.yoyo"), SETTINGS);
-        json_decref(SETTINGS);
     }
+    json_decref(SETTINGS_ON_DISK);
+    json_decref(SETTINGS);
 
     // post init callback //
     ye_fire_event(YE_EVENT_POST_INIT, (union ye_event_args){NULL});
@@ -434,14 +487,38 @@ void ye_shutdown_engine(){
     // shut tricks down
     ye_shutdown_tricks();
 
+    // stop tweens while their targets and scripts are still alive
+    ye_shutdown_tween();
+
+    // wait out any path searches, then drop the system registry and join the workers
+    ye_shutdown_navigation();
+    ye_shutdown_scheduler();
+    ye_shutdown_jobs();
+
+    // write the metrics one last time (statsd needs the network)
+    ye_shutdown_metrics();
+
+    // drop any armed capture and the one the overlay replayed
+    ye_shutdown_capture();
+
     // shutdown networking
     ye_shutdown_networking();
 
+    // stop watching resources
+    ye_shutdown_hotreload();
+
     // purge debug renderer
     ye_debug_renderer_cleanup(true);
 
     // shutdown ECS
     ye_shutdown_ecs();
+    ye_shutdown_ecs_queries();
+    ye_shutdown_observers();
+    ye_shutdown_physics();
+
+    // free the lua coroutine scheduler and allocator pools (every script state is gone by now)
+    ye_shutdown_lua_coroutines();
+    ye_shutdown_lua_memory();
 
     // shutdown timers
     ye_shutdown_timers();
@@ -449,6 +526,9 @@ void ye_shutdown_engine(){
     // shutdown cache
     ye_shutdown_cache();
 
+    // free the last scene load report
+    ye_shutdown_scene_profiler();
+
     // free the engine font color
     free(YE_STATE.engine.pEngineFontColor);
     YE_STATE.engine.pEngineFontColor = NULL;
@@ -467,6 +547,14 @@ void ye_shutdown_engine(){
     // shutdown input
     ye_shutdown_input();
 
+    // everything tracked should be gone now, report whatever is not (the entry scene is still here if the splash never ended)
+    ye_free(entry_scene);
+    entry_scene = NULL;
+    ye_shutdown_scene_manager();
+    ye_shutdown_json_arena();
+    ye_shutdown_intern();
+    ye_shutdown_memory();
+
     // shutdown logging
     // note: must happen before SDL because it relies on SDL path to open file
     ye_log_shutdown();
@@ -474,6 +562,8 @@ void ye_shutdown_engine(){
     free(YE_STATE.engine.engine_resources_path);
     free(YE_STATE.engine.game_resources_path);
     free(YE_STATE.engine.icon_path);
+    free(YE_STATE.engine.metrics_sink);
+    free(YE_STATE.engine.metrics_target);
     // free(YE_STATE.engine.window_title); copilot added this but i havent checked if this is freed elsewhere
     SDL_free(base_path); // free base path after (used by logging)
     SDL_free(executable_path); // free base path after (used by logging)
@@ -65,9 +65,16 @@ void ye_register_event_cb(enum ye_event_type type, void *cb, int flags){
             break;
 
         case YE_EVENT_COLLISION:
+        case YE_EVENT_COLLISION_EXIT:
+        case YE_EVENT_TRIGGER_ENTER:
+        case YE_EVENT_TRIGGER_EXIT:
             event->collision_cb = (void (*)(struct ye_entity *, struct ye_entity *))cb;
             break;
 
+        case YE_EVENT_TWEEN_COMPLETE:
+            event->tween_cb = (void (*)(unsigned int, struct ye_entity *))cb;
+            break;
+
         case YE_EVENT_CUSTOM:
             event->custom_cb = (void (*)(void *))cb;
             break;
@@ -104,9 +111,16 @@ void ye_fire_event(enum ye_event_type type, union ye_event_args args){
                     break;
 
                 case YE_EVENT_COLLISION:
+                case YE_EVENT_COLLISION_EXIT:
+                case YE_EVENT_TRIGGER_ENTER:
+                case YE_EVENT_TRIGGER_EXIT:
                     current->collision_cb(args.collision.one, args.collision.two);
                     break;
 
+                case YE_EVENT_TWEEN_COMPLETE:
+                    current->tween_cb(args.tween.id, args.tween.entity);
+                    break;
+
                 case YE_EVENT_CUSTOM:
                     current->custom_cb(args.custom_data);
                     break;
@@ -16,8 +16,10 @@
 #include <yoyoengine/ui.h>
 #include <yoyoengine/yep.h>
 #include <yoyoengine/cache.h>
+#include <yoyoengine/capture.h>
 #include <yoyoengine/tricks.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/logging.h>
 #include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/camera.h>
@@ -79,6 +81,7 @@ SDL_Texture *createTextTextureWithOutline(const char *pText, int width, TTF_Font
     SDL_SetSurfaceBlendMode(fg_surface, SDL_BLENDMODE_BLEND); 
     SDL_BlitSurface(fg_surface, NULL, bg_surface, &rect); 
     SDL_FreeSurface(fg_surface); 
+    ye_memory_note(YE_MEM_TEXTURE, (size_t)bg_surface->pitch * bg_surface->h);
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, bg_surface);
     SDL_FreeSurface(bg_surface);
     
@@ -108,6 +111,7 @@ SDL_Texture *createTextTextureWithOutlineWrapped(const char *pText, int width, T
     SDL_SetSurfaceBlendMode(fg_surface, SDL_BLENDMODE_BLEND); 
     SDL_BlitSurface(fg_surface, NULL, bg_surface, &rect); 
     SDL_FreeSurface(fg_surface); 
+    ye_memory_note(YE_MEM_TEXTURE, (size_t)bg_surface->pitch * bg_surface->h);
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, bg_surface);
     SDL_FreeSurface(bg_surface);
     
@@ -133,6 +137,7 @@ SDL_Texture *createTextTexture(const char *pText, TTF_Font *pFont, SDL_Color *pC
     }
 
     // create texture from surface
+    ye_memory_note(YE_MEM_TEXTURE, (size_t)pSurface->pitch * pSurface->h);
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, pSurface);
 
     // error out if texture creation failed
@@ -159,6 +164,7 @@ SDL_Texture *createTextTextureWrapped(const char *pText, TTF_Font *pFont, SDL_Co
     }
 
     // create texture from surface
+    ye_memory_note(YE_MEM_TEXTURE, (size_t)pSurface->pitch * pSurface->h);
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, pSurface);
 
     // error out if texture creation failed
@@ -191,6 +197,7 @@ SDL_Texture * ye_create_image_texture(const char *pPath) {
     }
 
     // create texture from surface
+    ye_memory_note(YE_MEM_TEXTURE, (size_t)pImage_surface->pitch * pImage_surface->h);
     SDL_Texture *pTexture = SDL_CreateTextureFromSurface(pRenderer, pImage_surface);
     
     // error out if texture creation failed
@@ -234,6 +241,7 @@ void ye_render_all() {
         Clear the screen
     */
     // SDL_SetRenderTarget(pRenderer, NULL); Disabled, redundant since we dont change targets anymore
+    ye_capture_begin_frame();
     SDL_SetRenderDrawColor(pRenderer, 0, 0, 0, 255);
     SDL_RenderClear(pRenderer);
 
@@ -288,6 +296,9 @@ void ye_render_all() {
 
     ui_render();
 
+    // a capture of this frame is complete once the ui is submitted
+    ye_capture_end_frame();
+
     SDL_RenderPresent(pRenderer);
     SDL_UpdateWindowSurface(pWindow);
 
@@ -419,6 +430,12 @@ void ye_init_graphics(){
         pRenderer = SDL_CreateRenderer(pWindow, -1, SDL_RENDERER_ACCELERATED);
     }
 
+    // no gpu (ex: SDL_VIDEODRIVER=dummy for headless runs), draw on the cpu instead
+    if (pRenderer == NULL) {
+        ye_logf(warning, "Could not create an accelerated renderer (%s), falling back to software.\n", SDL_GetError());
+        pRenderer = SDL_CreateRenderer(pWindow, -1, SDL_RENDERER_SOFTWARE);
+    }
+
     if (pRenderer == NULL) {
         ye_logf(error, "Renderer could not be created! SDL Error: %s\n", SDL_GetError());
         exit(1);
@@ -0,0 +1,249 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <SDL.h>
+
+#ifdef __linux__
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #include <sys/inotify.h>
+#endif
+
+#include <yoyoengine/cache.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/hotreload.h>
+#include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/renderer.h>
+#include <yoyoengine/ecs/lua_script.h>
+
+int ye_hotreload_asset(const char *handle){
+    int start = SDL_GetTicks();
+    int patched = -1;
+
+    // textures (images, tiles and animation maps all route through the texture cache)
+    int result = ye_reload_texture(handle);
+    if(result >= 0)
+        patched = result;
+
+    // fonts loaded from this file
+    result = ye_reload_font_file(handle);
+    if(result >= 0)
+        patched = (patched < 0 ? 0 : patched) + result;
+
+    // animation clips using this file as their meta
+    struct ye_entity_node *current = renderer_list_head;
+    while(current != NULL){
+        struct ye_component_renderer *renderer = current->entity->renderer;
+        if(renderer->type == YE_RENDERER_TYPE_ANIMATION && strcmp(renderer->renderer_impl.animation->meta_file, handle) == 0){
+            if(ye_reload_animation_renderer_meta(current->entity))
+                patched = (patched < 0 ? 0 : patched) + 1;
+        }
+        current = current->next;
+    }
+
+    // scripts, reloaded inside the state they already live in
+    current = lua_script_list_head;
+    while(current != NULL){
+        if(strcmp(current->entity->lua_script->script_handle, handle) == 0){
+            if(ye_reload_lua_script_component(current->entity))
+                patched = (patched < 0 ? 0 : patched) + 1;
+        }
+        current = current->next;
+    }
+
+    if(patched >= 0)
+        ye_logf(info, "Hot reloaded %s (%d references) in %dms\n", handle, patched, SDL_GetTicks() - start);
+
+    return patched;
+}
+
+#ifdef __linux__
+
+struct ye_hotreload_watch {
+    int wd;         // inotify watch descriptor
+    char *dir;      // directory relative to the resources root ("" for the root itself)
+};
+
+static int inotify_fd = -1;
+static char *watch_root = NULL;
+static struct ye_hotreload_watch watches[YE_HOTRELOAD_MAX_WATCHES];
+static int watch_count = 0;
+
+/*
+    Watches a directory (relative to the root) and every directory below it
+*/
+static void _watch_recursive(const char *dir){
+    if(watch_count >= YE_HOTRELOAD_MAX_WATCHES){
+        ye_logf(warning, "Hot reload watch limit reached, %s will not be watched\n", dir);
+        return;
+    }
+
+    char full[1024];
+    snprintf(full, sizeof(full), "%s/%s", watch_root, dir);
+
+    int wd = inotify_add_watch(inotify_fd, full, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if(wd < 0){
+        ye_logf(warning, "Failed to watch %s for hot reload\n", full);
+        return;
+    }
+    watches[watch_count].wd = wd;
+    watches[watch_count].dir = strdup(dir);
+    watch_count++;
+
+    DIR *d = opendir(full);
+    if(d == NULL)
+        return;
+
+    struct dirent *entry;
+    while((entry = readdir(d)) != NULL){
+        if(entry->d_name[0] == '.')
+            continue;
+
+        char child[1024];
+        if(dir[0] == '\0')
+            snprintf(child, sizeof(child), "%s", entry->d_name);
+        else
+            snprintf(child, sizeof(child), "%s/%s", dir, entry->d_name);
+
+        char child_full[1024];
+        snprintf(child_full, sizeof(child_full), "%s/%s", watch_root, child);
+
+        struct stat st;
+        if(stat(child_full, &st) == 0 && S_ISDIR(st.st_mode))
+            _watch_recursive(child);
+    }
+    closedir(d);
+}
+
+static const char * _dir_for_wd(int wd){
+    for(int i = 0; i < watch_count; i++){
+        if(watches[i].wd == wd)
+            return watches[i].dir;
+    }
+    return NULL;
+}
+
+bool ye_init_hotreload(const char *resources_path){
+    if(inotify_fd >= 0)
+        ye_shutdown_hotreload();
+
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(inotify_fd < 0){
+        ye_logf(error, "Failed to initialize inotify, hot reload disabled\n");
+        return false;
+    }
+
+    watch_root = strdup(resources_path);
+
+    // strip trailing slashes so we can join paths consistently
+    size_t len = strlen(watch_root);
+    while(len > 1 && watch_root[len - 1] == '/')
+        watch_root[--len] = '\0';
+
+    _watch_recursive("");
+
+    ye_logf(info, "Hot reload watching %d directories under %s\n", watch_count, watch_root);
+    return true;
+}
+
+void ye_shutdown_hotreload(){
+    if(inotify_fd < 0)
+        return;
+
+    for(int i = 0; i < watch_count; i++){
+        inotify_rm_watch(inotify_fd, watches[i].wd);
+        free(watches[i].dir);
+    }
+    watch_count = 0;
+
+    close(inotify_fd);
+    inotify_fd = -1;
+
+    free(watch_root);
+    watch_root = NULL;
+
+    ye_logf(info, "Shut down hot reload.\n");
+}
+
+#define YE_HOTRELOAD_MAX_PENDING 64
+
+void ye_hotreload_poll(){
+    if(inotify_fd < 0)
+        return;
+
+    /*
+        Editors will often fire several events for a single save, so we collect
+        the unique handles that changed first and reload each of them once.
+    */
+    char pending[YE_HOTRELOAD_MAX_PENDING][512];
+    int pending_count = 0;
+
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while((len = read(inotify_fd, buf, sizeof(buf))) > 0){
+        for(char *ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len){
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            if(event->len == 0 || event->name[0] == '.')
+                continue;
+
+            const char *dir = _dir_for_wd(event->wd);
+            if(dir == NULL)
+                continue;
+
+            char handle[512];
+            if(dir[0] == '\0')
+                snprintf(handle, sizeof(handle), "%s", event->name);
+            else
+                snprintf(handle, sizeof(handle), "%s/%s", dir, event->name);
+
+            // new directories need their own watch, files only matter once written
+            if(event->mask & IN_ISDIR){
+                if(event->mask & (IN_CREATE | IN_MOVED_TO))
+                    _watch_recursive(handle);
+                continue;
+            }
+            if(!(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)))
+                continue;
+
+            bool seen = false;
+            for(int i = 0; i < pending_count; i++){
+                if(strcmp(pending[i], handle) == 0){
+                    seen = true;
+                    break;
+                }
+            }
+            if(!seen && pending_count < YE_HOTRELOAD_MAX_PENDING){
+                strcpy(pending[pending_count], handle);
+                pending_count++;
+            }
+        }
+    }
+
+    for(int i = 0; i < pending_count; i++){
+        ye_hotreload_asset(pending[i]);
+    }
+}
+
+#else
+
+bool ye_init_hotreload(const char *resources_path){
+    (void)resources_path;
+    ye_logf(warning, "Hot reload file watching is only supported on linux.\n");
+    return false;
+}
+
+void ye_shutdown_hotreload(){}
+
+void ye_hotreload_poll(){}
+
+#endif
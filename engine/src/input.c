@@ -16,6 +16,7 @@
 #include <SDL.h>
 
 #include <yoyoengine/ui.h>
+#include <yoyoengine/capture.h>
 #include <yoyoengine/input.h>
 #include <yoyoengine/event.h>
 #include <yoyoengine/engine.h>
@@ -105,6 +106,13 @@ void ye_system_input() {
                             should_reset_console_log_scroll = true;
                         }
                         break;
+
+                    // frame capture //
+
+                    case SDLK_F12:
+                        if(YE_STATE.engine.debug_mode)
+                            ye_capture_frame(NULL);
+                        break;
                 }
                 break; // breaks out of keydown
 
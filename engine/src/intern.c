@@ -0,0 +1,118 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <string.h>
+#include <stddef.h>
+
+#include <SDL.h>
+#include <uthash/uthash.h>
+
+#include <yoyoengine/intern.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/logging.h>
+
+/*
+    One allocation per string, the text is stored inline after the entry so an interned pointer
+    leads straight back to its entry without a lookup.
+*/
+struct ye_intern_entry {
+    int refs;
+    UT_hash_handle hh;
+    char str[];
+};
+
+static struct ye_intern_entry *strings = NULL;
+
+// scene loading and jobs intern too
+static SDL_SpinLock lock = 0;
+
+static inline struct ye_intern_entry * _entry_of(const char *interned){
+    return (struct ye_intern_entry *)(interned - offsetof(struct ye_intern_entry, str));
+}
+
+const char * ye_intern(const char *str){
+    if(str == NULL)
+        return NULL;
+
+    size_t length = strlen(str);
+
+    SDL_AtomicLock(&lock);
+    struct ye_intern_entry *entry = NULL;
+    HASH_FIND(hh, strings, str, length, entry);
+    if(entry == NULL){
+        entry = ye_malloc(YE_MEM_STRINGS, sizeof(struct ye_intern_entry) + length + 1);
+        entry->refs = 0;
+        memcpy(entry->str, str, length + 1);
+        HASH_ADD_KEYPTR(hh, strings, entry->str, length, entry);
+    }
+    entry->refs++;
+    SDL_AtomicUnlock(&lock);
+
+    return entry->str;
+}
+
+const char * ye_intern_retain(const char *interned){
+    if(interned == NULL)
+        return NULL;
+
+    SDL_AtomicLock(&lock);
+    _entry_of(interned)->refs++;
+    SDL_AtomicUnlock(&lock);
+
+    return interned;
+}
+
+void ye_intern_release(const char *interned){
+    if(interned == NULL)
+        return;
+
+    struct ye_intern_entry *entry = _entry_of(interned);
+
+    SDL_AtomicLock(&lock);
+    if(--entry->refs > 0){
+        SDL_AtomicUnlock(&lock);
+        return;
+    }
+    HASH_DEL(strings, entry);
+    SDL_AtomicUnlock(&lock);
+
+    ye_free(entry);
+}
+
+const char * ye_intern_find(const char *str){
+    if(str == NULL)
+        return NULL;
+
+    SDL_AtomicLock(&lock);
+    struct ye_intern_entry *entry = NULL;
+    HASH_FIND(hh, strings, str, strlen(str), entry);
+    SDL_AtomicUnlock(&lock);
+
+    return entry != NULL ? entry->str : NULL;
+}
+
+size_t ye_intern_count(){
+    SDL_AtomicLock(&lock);
+    size_t count = HASH_COUNT(strings);
+    SDL_AtomicUnlock(&lock);
+    return count;
+}
+
+void ye_shutdown_intern(){
+    size_t leaked = 0;
+
+    struct ye_intern_entry *entry, *tmp;
+    HASH_ITER(hh, strings, entry, tmp){
+        HASH_DEL(strings, entry);
+        ye_free(entry);
+        leaked++;
+    }
+
+    if(leaked > 0)
+        ye_logf(debug, "%zu interned strings were still referenced at shutdown.\n", leaked);
+    ye_logf(info, "Shut down string interner.\n");
+}
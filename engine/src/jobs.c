@@ -0,0 +1,203 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdlib.h>
+
+#include <SDL.h>
+
+#include <yoyoengine/jobs.h>
+#include <yoyoengine/logging.h>
+
+#define YE_JOBS_MAX_WORKERS 16
+#define YE_JOBS_INITIAL_CAPACITY 64
+
+struct ye_job {
+    ye_job_fn fn;
+    void *data;
+    struct ye_job_counter *counter;
+};
+
+// ring buffer of queued jobs, guarded by queue_lock
+static struct ye_job *queue = NULL;
+static int queue_capacity = 0;
+static int queue_head = 0;
+static int queue_count = 0;
+
+static SDL_mutex *queue_lock = NULL;
+static SDL_cond *queue_cond = NULL;    // signalled when a job is queued
+static SDL_cond *done_cond = NULL;     // signalled when a counter reaches zero
+
+static SDL_Thread *workers[YE_JOBS_MAX_WORKERS];
+static int worker_count = 0;
+static bool quitting = false;
+
+static void _push(struct ye_job job){
+    if(queue_count == queue_capacity){
+        int new_capacity = queue_capacity > 0 ? queue_capacity * 2 : YE_JOBS_INITIAL_CAPACITY;
+        struct ye_job *grown = malloc(sizeof(struct ye_job) * new_capacity);
+        for(int i = 0; i < queue_count; i++)
+            grown[i] = queue[(queue_head + i) % queue_capacity];
+        free(queue);
+        queue = grown;
+        queue_capacity = new_capacity;
+        queue_head = 0;
+    }
+    queue[(queue_head + queue_count) % queue_capacity] = job;
+    queue_count++;
+}
+
+static bool _pop(struct ye_job *out){
+    if(queue_count == 0)
+        return false;
+    *out = queue[queue_head];
+    queue_head = (queue_head + 1) % queue_capacity;
+    queue_count--;
+    return true;
+}
+
+// takes the oldest queued job submitted against counter, leaving the rest queued in order
+static bool _pop_for(struct ye_job_counter *counter, struct ye_job *out){
+    for(int i = 0; i < queue_count; i++){
+        if(queue[(queue_head + i) % queue_capacity].counter != counter)
+            continue;
+
+        *out = queue[(queue_head + i) % queue_capacity];
+        for(int j = i; j < queue_count - 1; j++)
+            queue[(queue_head + j) % queue_capacity] = queue[(queue_head + j + 1) % queue_capacity];
+        queue_count--;
+        return true;
+    }
+    return false;
+}
+
+static void _run(struct ye_job *job){
+    job->fn(job->data);
+
+    if(job->counter != NULL && SDL_AtomicAdd(&job->counter->pending, -1) == 1){
+        SDL_LockMutex(queue_lock);
+        SDL_CondBroadcast(done_cond);
+        SDL_UnlockMutex(queue_lock);
+    }
+}
+
+static int _worker(void *data){
+    (void)data;
+    while(true){
+        struct ye_job job;
+
+        SDL_LockMutex(queue_lock);
+        while(queue_count == 0 && !quitting)
+            SDL_CondWait(queue_cond, queue_lock);
+        bool got = _pop(&job);
+        SDL_UnlockMutex(queue_lock);
+
+        if(!got) // only happens when quitting with an empty queue
+            return 0;
+
+        _run(&job);
+    }
+}
+
+void ye_init_jobs(int count){
+#ifdef __EMSCRIPTEN__
+    count = 0;
+#else
+    if(count < 0)
+        count = SDL_GetCPUCount() - 1;
+#endif
+    if(count > YE_JOBS_MAX_WORKERS)
+        count = YE_JOBS_MAX_WORKERS;
+
+    queue_lock = SDL_CreateMutex();
+    queue_cond = SDL_CreateCond();
+    done_cond = SDL_CreateCond();
+    quitting = false;
+
+    worker_count = 0;
+    for(int i = 0; i < count; i++){
+        workers[worker_count] = SDL_CreateThread(_worker, "ye_job_worker", NULL);
+        if(workers[worker_count] == NULL){
+            ye_logf(warning, "Failed to create job worker: %s\n", SDL_GetError());
+            break;
+        }
+        worker_count++;
+    }
+
+    ye_logf(info, "Started %d job workers.\n", worker_count);
+}
+
+void ye_job_submit(ye_job_fn fn, void *data, struct ye_job_counter *counter){
+    if(counter != NULL)
+        SDL_AtomicAdd(&counter->pending, 1);
+
+    struct ye_job job = { fn, data, counter };
+
+    // nobody to hand it to
+    if(worker_count == 0){
+        _run(&job);
+        return;
+    }
+
+    SDL_LockMutex(queue_lock);
+    _push(job);
+    SDL_CondSignal(queue_cond);
+    SDL_UnlockMutex(queue_lock);
+}
+
+bool ye_job_done(struct ye_job_counter *counter){
+    return SDL_AtomicGet(&counter->pending) <= 0;
+}
+
+void ye_job_wait(struct ye_job_counter *counter){
+    while(!ye_job_done(counter)){
+        struct ye_job job;
+
+        /*
+            Only help with our own jobs. Anything else queued (a scene preload, a path search) can
+            take far longer than a frame, and is left for the workers.
+        */
+        SDL_LockMutex(queue_lock);
+        bool got = _pop_for(counter, &job);
+        if(!got && !ye_job_done(counter)){
+            // the rest are already running on workers, the timeout covers a finish racing this wait
+            SDL_CondWaitTimeout(done_cond, queue_lock, 1);
+        }
+        SDL_UnlockMutex(queue_lock);
+
+        if(got)
+            _run(&job);
+    }
+}
+
+int ye_job_worker_count(){
+    return worker_count;
+}
+
+void ye_shutdown_jobs(){
+    if(queue_lock == NULL)
+        return;
+
+    SDL_LockMutex(queue_lock);
+    quitting = true;
+    SDL_CondBroadcast(queue_cond);
+    SDL_UnlockMutex(queue_lock);
+
+    // workers drain the queue before they see quitting with nothing left
+    for(int i = 0; i < worker_count; i++)
+        SDL_WaitThread(workers[i], NULL);
+    worker_count = 0;
+
+    SDL_DestroyCond(done_cond);
+    SDL_DestroyCond(queue_cond);
+    SDL_DestroyMutex(queue_lock);
+    done_cond = queue_cond = NULL;
+    queue_lock = NULL;
+
+    free(queue);
+    queue = NULL;
+    queue_capacity = queue_head = queue_count = 0;
+}
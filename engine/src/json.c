@@ -10,9 +10,16 @@
 */
 
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include <SDL.h>
 #include <jansson.h>
 
+#include <yoyoengine/yep.h>
+#include <yoyoengine/json.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/engine.h>
 #include <yoyoengine/logging.h>
 
 #ifndef YE_JSON_WRITE_FLAGS
@@ -259,4 +266,197 @@ bool ye_json_arr_array(json_t* json, int index, json_t **out)
     }
     *out = val;
     return true;
-}
\ No newline at end of file
+}
+/*
+    Transient document arena
+*/
+
+#define YE_JSON_ARENA_CHUNK_SIZE (256 * 1024)
+
+struct ye_json_arena_chunk {
+    struct ye_json_arena_chunk *next;
+    size_t size;    // bytes of data after the header
+    size_t used;
+};
+
+// keeps every allocation 16 byte aligned
+#define YE_JSON_ARENA_HEADER ((sizeof(struct ye_json_arena_chunk) + 15) & ~(size_t)15)
+
+static struct ye_json_arena_chunk *arena_chunks = NULL; // head is the chunk being bumped
+static int arena_depth = 0;
+static bool arena_parsing = false;
+static SDL_threadID arena_thread = 0;
+
+// guards opening and closing scopes, which the main thread and the preload worker can both do
+static SDL_SpinLock arena_lock = 0;
+
+/*
+    Only the thread that opened the arena allocates from it, so only that thread can hand arena
+    memory back. Every other thread skips the chunk walk (and never touches the chunk list).
+*/
+static bool _arena_owns(void *ptr){
+    if(arena_depth == 0 || SDL_ThreadID() != arena_thread)
+        return false;
+
+    for(struct ye_json_arena_chunk *chunk = arena_chunks; chunk != NULL; chunk = chunk->next){
+        char *data = (char *)chunk + YE_JSON_ARENA_HEADER;
+        if((char *)ptr >= data && (char *)ptr < data + chunk->size)
+            return true;
+    }
+    return false;
+}
+
+static void * _arena_alloc(size_t size){
+    size = (size + 15) & ~(size_t)15;
+
+    struct ye_json_arena_chunk *chunk = arena_chunks;
+    if(chunk == NULL || chunk->used + size > chunk->size){
+        size_t chunk_size = size > YE_JSON_ARENA_CHUNK_SIZE ? size : YE_JSON_ARENA_CHUNK_SIZE;
+        chunk = ye_malloc(YE_MEM_JSON, YE_JSON_ARENA_HEADER + chunk_size);
+        if(chunk == NULL)
+            return NULL;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        chunk->next = arena_chunks;
+        arena_chunks = chunk;
+    }
+
+    void *out = (char *)chunk + YE_JSON_ARENA_HEADER + chunk->used;
+    chunk->used += size;
+    return out;
+}
+
+static void * _ye_json_malloc(size_t size){
+    if(arena_parsing && SDL_ThreadID() == arena_thread)
+        return _arena_alloc(size);
+    return malloc(size);
+}
+
+static void _ye_json_free(void *ptr){
+    // arena memory (including nodes jansson frees while growing its tables mid parse) goes away with the arena
+    if(ptr == NULL || _arena_owns(ptr))
+        return;
+    free(ptr);
+}
+
+void ye_json_arena_begin(){
+    SDL_AtomicLock(&arena_lock);
+    if(arena_depth++ == 0){
+        arena_thread = SDL_ThreadID();
+
+        // only hooked while a scope is open, so jansson everywhere else stays plain malloc/free
+        json_set_alloc_funcs(_ye_json_malloc, _ye_json_free);
+    }
+    SDL_AtomicUnlock(&arena_lock);
+}
+
+void ye_json_arena_end(){
+    SDL_AtomicLock(&arena_lock);
+    if(arena_depth <= 0){
+        SDL_AtomicUnlock(&arena_lock);
+        ye_logf(warning, "%s", "ye_json_arena_end called without a matching begin\n");
+        return;
+    }
+    if(arena_depth > 1){
+        arena_depth--;
+        SDL_AtomicUnlock(&arena_lock);
+        return;
+    }
+
+    size_t freed = 0;
+    int chunk_count = 0;
+
+    // keep one regular sized chunk around for the next load
+    struct ye_json_arena_chunk *kept = NULL;
+    struct ye_json_arena_chunk *chunk = arena_chunks;
+    while(chunk != NULL){
+        struct ye_json_arena_chunk *next = chunk->next;
+        freed += chunk->used;
+        chunk_count++;
+        if(kept == NULL && chunk->size == YE_JSON_ARENA_CHUNK_SIZE){
+            kept = chunk;
+            kept->used = 0;
+            kept->next = NULL;
+        }
+        else{
+            ye_free(chunk);
+        }
+        chunk = next;
+    }
+    arena_chunks = kept;
+
+    // the defaults are malloc and free too, so anything allocated through the hooks can still be freed after this
+    json_set_alloc_funcs(malloc, free);
+    arena_depth = 0;
+    SDL_AtomicUnlock(&arena_lock);
+
+    if(chunk_count > 0)
+        ye_logf(debug, "json arena released %zuKB from %d chunks\n", freed / 1024, chunk_count);
+}
+
+void ye_shutdown_json_arena(){
+    SDL_AtomicLock(&arena_lock);
+    while(arena_chunks != NULL){
+        struct ye_json_arena_chunk *next = arena_chunks->next;
+        ye_free(arena_chunks);
+        arena_chunks = next;
+    }
+    SDL_AtomicUnlock(&arena_lock);
+}
+
+json_t* ye_json_load_transient(const char* handle)
+{
+    bool use_arena = arena_depth > 0 && SDL_ThreadID() == arena_thread;
+    if(use_arena)
+        arena_parsing = true;
+
+    json_t *json = NULL;
+    if(YE_STATE.editor.editor_mode)
+        json = ye_json_read(ye_path_resources(handle));
+    else
+        json = yep_resource_json(handle);
+
+    if(use_arena)
+        arena_parsing = false;
+    return json;
+}
+
+void ye_json_release(json_t* json)
+{
+    if(json == NULL)
+        return;
+
+    if(_arena_owns(json))
+        return;
+    json_decref(json);
+}
+
+/*
+    Interned keys
+*/
+
+// FNV-1a, also measures the key
+static uint32_t _key_hash(const char *key, size_t *length){
+    uint32_t hash = 2166136261u;
+    const char *c = key;
+    while(*c){
+        hash ^= (unsigned char)*c++;
+        hash *= 16777619u;
+    }
+    if(length != NULL)
+        *length = c - key;
+    return hash ? hash : 1; // 0 means not computed yet
+}
+
+int ye_json_key_index(struct ye_json_key *keys, int count, const char* key)
+{
+    size_t length;
+    uint32_t hash = _key_hash(key, &length);
+    for(int i = 0; i < count; i++){
+        if(keys[i].hash == 0)
+            keys[i].hash = _key_hash(keys[i].name, NULL);
+        if(keys[i].hash == hash && keys[i].length == length && memcmp(keys[i].name, key, length) == 0)
+            return i;
+    }
+    return -1;
+}
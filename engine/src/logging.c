@@ -46,6 +46,9 @@
 FILE *logFile = NULL;
 char *logpath = NULL;
 
+// jobs and startup work on worker threads log too
+static SDL_SpinLock log_lock = 0;
+
 #ifdef _WIN32
 void ye_enable_virtual_terminal() {
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -97,7 +100,9 @@ void ye_logf(enum logLevel level, const char *format, ...){
     vsnprintf(text, sizeof(text), format, args);
 
     va_end(args);
-    
+
+    SDL_AtomicLock(&log_lock);
+
     if(level == warning){
         YE_STATE.runtime.warning_count++;
     }
@@ -107,44 +112,58 @@ void ye_logf(enum logLevel level, const char *format, ...){
 
     // if logging is disabled, or the log level is below the threshold, return (or if the file is not open yet)
     if(YE_STATE.engine.log_level > level){ // idk why i wrote null like this i just want to feel cool
+        SDL_AtomicUnlock(&log_lock);
         return;
     }
     // if logfile unititialized, put it in the buffer anyways (because it meets threshold), and if we are in debug mode then print to stdout as well
     if(logFile == 0x0){
         ye_add_to_log_buffer(level, text);
+        bool echo = YE_STATE.engine.debug_mode;
+        SDL_AtomicUnlock(&log_lock);
+
         // if we are in debug mode put it in stdout as well
-        if(YE_STATE.engine.debug_mode){
+        if(echo){
             printf("%s",text);
         }
         return;
     }
 
+    // lines are formatted under the lock (the timestamp is shared) and written after it
+    char file_line[1152];
+    char console_line[1152];
     switch (level) {
         case debug:
-            fprintf(logFile, "[%s] [DEBUG]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sDEBUG%s]: %s", RESET, ye_get_timestamp(), MAGENTA, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [DEBUG]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sDEBUG%s]: %s", RESET, ye_get_timestamp(), MAGENTA, RESET, text);
             break;
         case info:
-            fprintf(logFile, "[%s] [INFO]:  %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sINFO%s]:  %s", RESET, ye_get_timestamp(), GREEN, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [INFO]:  %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sINFO%s]:  %s", RESET, ye_get_timestamp(), GREEN, RESET, text);
             break;
         case warning:
-            fprintf(logFile, "[%s] [WARNING]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [WARNING]%s: %s", YELLOW, ye_get_timestamp(), RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [WARNING]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [WARNING]%s: %s", YELLOW, ye_get_timestamp(), RESET, text);
             break;
         case error:
-            fprintf(logFile, "[%s] [ERROR]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [ERROR]%s: %s", RED, ye_get_timestamp(), RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [ERROR]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [ERROR]%s: %s", RED, ye_get_timestamp(), RESET, text);
             break;
         default:
-            fprintf(logFile, "[%s] [ERROR]: %s", ye_get_timestamp(), "Invalid log level\n");
-            printf("%s[%s] [LOG ERROR]%s: %s", RED, ye_get_timestamp(), RESET, "Invalid log level\n");
+            snprintf(file_line, sizeof(file_line), "[%s] [ERROR]: %s", ye_get_timestamp(), "Invalid log level\n");
+            snprintf(console_line, sizeof(console_line), "%s[%s] [LOG ERROR]%s: %s", RED, ye_get_timestamp(), RESET, "Invalid log level\n");
             break;
     }
     YE_STATE.runtime.log_line_count++;
 
     // Add to the log buffer
     ye_add_to_log_buffer(level, text);
+
+    FILE *file = logFile;
+    SDL_AtomicUnlock(&log_lock);
+
+    // other threads logging only wait on the formatting above, not on this I/O
+    fputs(file_line, file);
+    fputs(console_line, stdout);
 }
 
 void _ye_lua_logf(enum logLevel level, const char *format, ...){
@@ -156,7 +175,9 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
     vsnprintf(text, sizeof(text), format, args);
 
     va_end(args);
-    
+
+    SDL_AtomicLock(&log_lock);
+
     if(level == warning){
         YE_STATE.runtime.warning_count++;
     }
@@ -166,44 +187,58 @@ void _ye_lua_logf(enum logLevel level, const char *format, ...){
 
     // if logging is disabled, or the log level is below the threshold, return (or if the file is not open yet)
     if(YE_STATE.engine.log_level > level){ // idk why i wrote null like this i just want to feel cool
+        SDL_AtomicUnlock(&log_lock);
         return;
     }
     // if logfile unititialized, put it in the buffer anyways (because it meets threshold), and if we are in debug mode then print to stdout as well
     if(logFile == 0x0){
         ye_add_to_log_buffer(level, text);
+        bool echo = YE_STATE.engine.debug_mode;
+        SDL_AtomicUnlock(&log_lock);
+
         // if we are in debug mode put it in stdout as well
-        if(YE_STATE.engine.debug_mode){
+        if(echo){
             printf("%s",text);
         }
         return;
     }
 
+    // lines are formatted under the lock (the timestamp is shared) and written after it
+    char file_line[1152];
+    char console_line[1152];
     switch (level) {
         case debug:
-            fprintf(logFile, "[%s] [LUA] [DEBUG]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sLUA%s] [%sDEBUG%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, MAGENTA, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [LUA] [DEBUG]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sLUA%s] [%sDEBUG%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, MAGENTA, RESET, text);
             break;
         case info:
-            fprintf(logFile, "[%s] [LUA] [INFO]:  %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sLUA%s] [%sINFO%s]:  %s", RESET, ye_get_timestamp(), BLUE, RESET, GREEN, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [LUA] [INFO]:  %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sLUA%s] [%sINFO%s]:  %s", RESET, ye_get_timestamp(), BLUE, RESET, GREEN, RESET, text);
             break;
         case warning:
-            fprintf(logFile, "[%s] [LUA] [WARNING]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sLUA%s] [%sWARNING%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, YELLOW, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [LUA] [WARNING]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sLUA%s] [%sWARNING%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, YELLOW, RESET, text);
             break;
         case error:
-            fprintf(logFile, "[%s] [LUA] [ERROR]: %s", ye_get_timestamp(), text);
-            printf("%s[%s] [%sLUA%s] [%sERROR%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, RED, RESET, text);
+            snprintf(file_line, sizeof(file_line), "[%s] [LUA] [ERROR]: %s", ye_get_timestamp(), text);
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sLUA%s] [%sERROR%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, RED, RESET, text);
             break;
         default:
-            fprintf(logFile, "[%s] [LUA] [ERROR]: %s", ye_get_timestamp(), "Invalid log level\n");
-            printf("%s[%s] [%sLUA%s] [%sERROR%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, RED, RESET, "Invalid log level\n");
+            snprintf(file_line, sizeof(file_line), "[%s] [LUA] [ERROR]: %s", ye_get_timestamp(), "Invalid log level\n");
+            snprintf(console_line, sizeof(console_line), "%s[%s] [%sLUA%s] [%sERROR%s]: %s", RESET, ye_get_timestamp(), BLUE, RESET, RED, RESET, "Invalid log level\n");
             break;
     }
     YE_STATE.runtime.log_line_count++;
 
     // Add to the log buffer
     ye_add_to_log_buffer(level, text);
+
+    FILE *file = logFile;
+    SDL_AtomicUnlock(&log_lock);
+
+    // other threads logging only wait on the formatting above, not on this I/O
+    fputs(file_line, file);
+    fputs(console_line, stdout);
 }
 
 void ye_log_newline(enum logLevel level){
@@ -64,6 +64,10 @@ function ye_lua_ent_get_entity_named(name) end
 ---@return lightuserdata entity The pointer to the C entity
 function ye_lua_ent_get_entity_by_id(id) end
 
+---@param entity lightuserdata The pointer to the C entity
+---@return Entity|nil entity The Entity table this script keeps for it (nil for a nil pointer)
+function ye_lua_entity_proxy(entity) end
+
 ---@param tag string The tag to search for
 ---@return lightuserdata entity The pointer to the C entity
 function ye_lua_ent_get_entity_by_tag(tag) end
@@ -461,6 +465,7 @@ function ye_lua_create_physics_component(entity, xVelocity, yVelocity) end
 ---@return number xVelocity The x velocity (in pixels per second)
 ---@return number yVelocity The y velocity (in pixels per second)
 ---@return number rotationalVelocity The rotational velocity (in degrees per second)
+---@return boolean isSleeping Whether the body is asleep
 function ye_lua_physics_query(entity) end
 
 ---**Modify a physics component on an entity**
@@ -470,7 +475,8 @@ function ye_lua_physics_query(entity) end
 ---@param xVelocity number | nil The desired x velocity (in pixels per second)
 ---@param yVelocity number | nil The desired y velocity (in pixels per second)
 ---@param rotationalVelocity number | nil The desired rotational velocity (in degrees per second)
-function ye_lua_physics_modify(entity, isActive, xVelocity, yVelocity, rotationalVelocity) end
+---@param isSleeping boolean | nil true to put the body to sleep, any modification wakes it otherwise
+function ye_lua_physics_modify(entity, isActive, xVelocity, yVelocity, rotationalVelocity, isSleeping) end
 
 
 
@@ -520,7 +526,8 @@ function ye_load_scene(handle) end
 ---@param handle string The resource handle
 ---@param loops number The number of times to loop the sound
 ---@param volume_scale number The volume scale
-function ye_audio_play_sound(handle, loops, volume_scale) end
+---@param bus? string The bus to play on
+function ye_audio_play_sound(handle, loops, volume_scale, bus) end
 
 ---**Plays a music track**
 ---
@@ -534,6 +541,31 @@ function ye_audio_play_music(handle, loops, volume_scale) end
 ---@param volume_scale number The volume scale
 function ye_audio_set_volume(volume_scale) end
 
+---**Set the volume of a bus**
+---
+---@param bus string The bus
+---@param volume_scale number The volume scale
+function ye_audio_set_bus_volume(bus, volume_scale) end
+
+---**Get the volume of a bus**
+---
+---@param bus string The bus
+---@return number|nil volume_scale The volume scale, nil if there is no such bus
+function ye_audio_get_bus_volume(bus) end
+
+---**Set the cutoff of a bus's low pass filter**
+---
+---@param bus string The bus
+---@param cutoff number The cutoff in Hz, 0 is off
+function ye_audio_set_bus_lowpass(bus, cutoff) end
+
+---**Create a bus**
+---
+---@param name string The name of the new bus
+---@param parent? string The bus it mixes into
+---@return boolean exists Whether the bus exists now
+function ye_audio_create_bus(name, parent) end
+
 
 
 ----------------
@@ -554,6 +586,11 @@ function ye_lua_timer_create_timer(duration_ms, callback_fn, loops, start_ticks,
 ---@return number ticks The current ticks of the engine
 function ye_lua_timer_get_ticks() end
 
+---**Gets a high resolution time in seconds, for timing short spans of code**
+---
+---@return number seconds
+function ye_lua_timer_get_seconds() end
+
 ----------------
 -- Input API  --
 ----------------
@@ -595,9 +632,25 @@ function ye_lua_input_number_of_controllers() end
 
 ---**Quit the game**
 ---
+---Sends the game the same quit event closing its window does.
 ---@return nil
 function exitGame() end
 
+---**Get the memory use of this script's lua state**
+---
+---@return integer used Bytes currently allocated
+---@return integer|nil allocations Allocations made since the state was created (nil on LuaJIT)
+---@return integer|nil allocated Bytes asked for by those allocations (nil on LuaJIT)
+function ye_lua_memory_stats() end
+
+---**Get the engine's own accounting for a memory tag**
+---
+---@param tag string The tag, ex: "ecs", "lua", "audio", "strings"
+---@return integer|nil live_bytes Bytes currently allocated under the tag (nil if the tag does not exist)
+---@return integer live_allocs Allocations currently alive
+---@return integer peak_bytes The most that was ever alive at once
+function ye_lua_engine_memory_stats(tag) end
+
 ---**Check if a component exists on an entity**
 ---
 ---@param entity lightuserdata The pointer to the C entity
@@ -614,6 +667,13 @@ function exitGame() end
 ---@return boolean exists Whether the component exists or not
 function ye_lua_check_component_exists(entity, comp_indx) end
 
+---**Get a raw pointer to a component on an entity**
+---
+---@param entity lightuserdata The pointer to the C entity
+---@param comp_indx number The index of the component (see ye_lua_check_component_exists)
+---@return lightuserdata|nil pointer The pointer to the C component, or nil if it does not exist
+function ye_lua_get_component_pointer(entity, comp_indx) end
+
 ---**Check if a renderer component type exists on an entity**
 ---
 ---@param entity lightuserdata The pointer to the C entity
@@ -661,4 +721,85 @@ function ye_write_cross_state_value(entity, key, value) end
 --- 6: Collider
 --- 7: Tag
 --- 8: Audiosource
-function ye_lua_remove_component(entity, comp_indx) end
\ No newline at end of file
+function ye_lua_remove_component(entity, comp_indx) end
+
+---**Start a coroutine managed by the engine scheduler**
+---
+---@param fn function The function to run
+---@vararg any Arguments to pass to the function
+---@return integer id The coroutine handle
+function ye_lua_coroutine_start(fn, ...) end
+
+---**Cancel a waiting coroutine**
+---
+---@param id integer The coroutine handle
+---@return boolean cancelled Whether the coroutine was found
+function ye_lua_coroutine_cancel(id) end
+
+---**Wake every coroutine waiting on an event**
+---
+---@param event string The event name
+function ye_lua_coroutine_signal(event) end
+
+---**Cast a ray against the colliders in the scene**
+---
+---@return integer count The number of hits written into results
+function ye_lua_query_raycast(x, y, dirX, dirY, distance, filter, results) end
+
+---**Sweep a box against the colliders in the scene**
+---
+---@return integer count The number of hits written into results
+function ye_lua_query_sweep(x, y, w, h, dirX, dirY, distance, filter, results) end
+
+---**Find the colliders overlapping a rect**
+---
+---@return integer count The number of entities written into results
+function ye_lua_query_overlap_rect(x, y, w, h, filter, results) end
+
+---**Find the colliders containing a point**
+---
+---@return integer count The number of entities written into results
+function ye_lua_query_overlap_point(x, y, filter, results) end
+
+---**Find a path on the navigation grid right away**
+---
+---@return integer count The number of points written into results
+function ye_lua_navigation_find_path(x1, y1, x2, y2, results) end
+
+---**Queue a path to be found on the worker threads**
+---
+---@return integer id The request handle
+function ye_lua_navigation_request_path(x1, y1, x2, y2, callback) end
+
+---**Cancel a path request**
+---
+---@return boolean cancelled Whether the request was still pending
+function ye_lua_navigation_cancel(id) end
+
+---**Block or free the navigation cell under a point**
+function ye_lua_navigation_set_blocked(x, y, blocked) end
+
+---**Check whether the navigation cell under a point is blocked**
+---
+---@return boolean blocked
+function ye_lua_navigation_is_blocked(x, y) end
+
+---**Rebuild the navigation grid from the static colliders**
+---
+---@return boolean built
+function ye_lua_navigation_build(x, y, w, h, cellSize, layers) end
+
+---**Start a tween on an entity property**
+---
+---@return integer id The tween handle, 0 if the entity lacks the component
+function ye_lua_tween_start(entity, property, to, duration, options) end
+
+---**Cancel a tween**
+---
+---@return boolean cancelled Whether the tween was still running
+function ye_lua_tween_cancel(id) end
+
+---**Cancel the tweens on an entity**
+---
+---@return integer count How many were cancelled
+function ye_lua_tween_cancel_entity(entity, property) end
@@ -13,6 +13,8 @@
 ---@field w number The width
 ---@field h number The height
 ---@field isTrigger boolean Whether the collider is a trigger
+---@field layer integer The collision layer, can be set by index or by name
+---@field body "auto"|"static"|"kinematic"|"dynamic" How the collider moves. "auto" is dynamic with a Physics component and static without, set "kinematic" on colliders a script moves every frame
 Collider = {
     -- no **real** fields.
     -- This exists purely for intellisense
@@ -26,6 +28,8 @@ local colliderIndexer = {
     w = 5,
     h = 6,
     isTrigger = 7,
+    layer = 8,
+    body = 9,
 }
 
 -- define the collider metatable
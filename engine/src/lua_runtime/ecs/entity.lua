@@ -30,6 +30,10 @@ local EntityMethods = {
     ["RemoveColliderComponent"] = RemoveColliderComponent,
     ["RemovePhysicsComponent"] = RemovePhysicsComponent,
     ["RemoveLuaScriptComponent"] = RemoveLuaScriptComponent,
+
+    --- COMPONENT VIEWS
+    ["TransformView"] = TransformView,
+    ["PhysicsView"] = PhysicsView,
 }
 
 ---@class Entity
@@ -182,6 +186,20 @@ Entity_mt = {
     end
 }
 
+--- Entity tables are cached per script by the engine, so asking for the same
+--- entity twice (or getting it in a callback) hands back the same table.
+--- A nil pointer still gets a table, with a nil _c_entity.
+---@param _c_entity lightuserdata|nil The pointer to the C entity
+---@return Entity entity The lua entity object
+function EntityProxy(_c_entity)
+    local entity = ye_lua_entity_proxy(_c_entity)
+    if entity == nil then
+        entity = {}
+        setmetatable(entity, Entity_mt)
+    end
+    return entity
+end
+
 ---**Create a new entity.**
 ---
 ---@param name? string The name of the entity to create (optional)
@@ -196,18 +214,15 @@ Entity_mt = {
 function Entity:new(name)
     -- name is optional TODO: clean thhis up and add behavior
 
-    -- create the entity itself
-    local entity = {}
-    setmetatable(entity, Entity_mt)
-
     -- get the _c_entity pointer
+    local _c_entity
     if name then
-        rawset(entity, "_c_entity", ye_lua_create_entity(name))
+        _c_entity = ye_lua_create_entity(name)
     else
-        rawset(entity, "_c_entity", ye_lua_create_entity())
+        _c_entity = ye_lua_create_entity()
     end
 
-    return entity
+    return EntityProxy(_c_entity)
 end
 
 ---**Get an entity by ID.**
@@ -222,17 +237,12 @@ end
 ---local player = Entity:getEntityByID(1)
 ---```
 function Entity:getEntityByID(id)
-    -- create the entity itself
-    local entity = {}
-    setmetatable(entity, Entity_mt)
-
-    -- get the _c_entity pointer
-    rawset(entity, "_c_entity", ye_lua_ent_get_entity_by_id(id))
-    if entity._c_entity == nil then
+    local _c_entity = ye_lua_ent_get_entity_by_id(id)
+    if _c_entity == nil then
         log("error", "Entity:getEntityByID failed to find entity\n")
     end
 
-    return entity
+    return EntityProxy(_c_entity)
 end
 
 ---**Get an entity by tag.**
@@ -247,17 +257,12 @@ end
 ---local player = Entity:getEntityByTag("PLAYER")
 ---```
 function Entity:getEntityByTag(tag)
-    -- create the entity itself
-    local entity = {}
-    setmetatable(entity, Entity_mt)
-
-    -- get the _c_entity pointer
-    rawset(entity, "_c_entity", ye_lua_ent_get_entity_by_tag(tag))
-    if entity._c_entity == nil then
+    local _c_entity = ye_lua_ent_get_entity_by_tag(tag)
+    if _c_entity == nil then
         log("error", "Entity:getEntityByTag failed to find entity\n")
     end
 
-    return entity
+    return EntityProxy(_c_entity)
 end
 
 ---**Get a scene entity by name.**
@@ -272,20 +277,15 @@ end
 ---local player = Entity:getEntityNamed("PLAYER")
 ---```
 function Entity:getEntityNamed(name)
-    -- create the entity itself
-    local entity = {}
-    setmetatable(entity, Entity_mt)
-
-    -- get the _c_entity pointer
-    rawset(entity, "_c_entity", ye_lua_ent_get_entity_named(name))
-    if entity._c_entity == nil then
+    local _c_entity = ye_lua_ent_get_entity_named(name)
+    if _c_entity == nil then
         log("error", "Entity:getEntityNamed failed to find entity\n")
         -- for now lets keep initializing because its better to create meta for
         -- a broken entity, than to return a nil entity, since the script has a
         -- better chance of recovery
     end
 
-    return entity
+    return EntityProxy(_c_entity)
 end
 
 --- Generic Component Addition
@@ -317,14 +317,7 @@ end
 ---@return Entity entity The new copy of the entity
 function Entity:duplicate() end -- intellisense
 function DuplicateEntity(self)
-    -- create the entity itself
-    local entity = {}
-    setmetatable(entity, Entity_mt)
-
     -- rawget the entity pointer (to avoid metatable)
     local _c_entity = rawget(self, "_c_entity")
-    local new_c_ent = ye_lua_duplicate_entity(_c_entity)
-    rawset(entity, "_c_entity", new_c_ent)
-
-    return entity
+    return EntityProxy(ye_lua_duplicate_entity(_c_entity))
 end
\ No newline at end of file
@@ -10,6 +10,7 @@
 ---@field xVelocity number The x velocity (in pixels per second)
 ---@field yVelocity number  The y velocity (in pixels per second)
 ---@field rotationalVelocity number The rotational velocity (in degrees per second)
+---@field isSleeping boolean Whether the body is asleep after resting a while. Setting it puts the body to sleep or wakes it, any velocity wakes it on the next step
 Physics = {
     -- no **real** fields.
     -- This exists purely for intellisense
@@ -20,6 +21,7 @@ local physicsIndexer = {
     xVelocity = 2,
     yVelocity = 3,
     rotationalVelocity = 4,
+    isSleeping = 5,
 }
 
 Physics_mt = {
@@ -0,0 +1,135 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+--[[
+    Component views give hot script loops direct access to component memory.
+
+    When the engine is built with YOYO_ENGINE_LUAJIT, a view is an FFI cdata pointer
+    straight into the C component, so reading and writing fields never crosses the C API.
+    On PUC Lua a view falls back to the regular component proxy, so scripts using views
+    run unchanged on either backend.
+
+    Views point directly at engine memory: do not keep one across frames, or after the
+    component or its entity has been removed.
+]]
+
+--- true when scripts are running on LuaJIT
+LUAJIT = jit ~= nil
+
+local ffi = nil
+if LUAJIT then
+    local ok, mod = pcall(require, "ffi")
+    if ok then
+        ffi = mod
+    end
+end
+
+--- true when component views are FFI cdata (rather than proxies)
+YE_FFI_VIEWS = ffi ~= nil
+
+local transformPtr = nil
+local physicsPtr = nil
+
+if ffi then
+    -- these must match the structs in yoyoengine/ecs/*.h
+    ffi.cdef[[
+        struct ye_vec2f { float x; float y; };
+
+        struct ye_component_transform {
+            float x;
+            float y;
+        };
+
+        struct ye_component_physics {
+            bool active;
+            struct ye_vec2f velocity;
+            float rotational_velocity;
+            bool sleeping;
+            int rest_frames;
+        };
+    ]]
+
+    -- let physics views be used with the same field names as the Physics proxy
+    local physicsGetters = {
+        isActive = function(c) return c.active end,
+        xVelocity = function(c) return c.velocity.x end,
+        yVelocity = function(c) return c.velocity.y end,
+        rotationalVelocity = function(c) return c.rotational_velocity end,
+        isSleeping = function(c) return c.sleeping end,
+    }
+    -- the physics step wakes sleeping bodies that have velocity, so writing it directly is enough
+    local physicsSetters = {
+        isActive = function(c, v) c.active = v end,
+        xVelocity = function(c, v) c.velocity.x = v end,
+        yVelocity = function(c, v) c.velocity.y = v end,
+        rotationalVelocity = function(c, v) c.rotational_velocity = v end,
+        isSleeping = function(c, v) c.sleeping = v; c.rest_frames = 0 end,
+    }
+
+    ffi.metatype("struct ye_component_physics", {
+        __index = function(self, key)
+            local getter = physicsGetters[key]
+            if getter then return getter(self) end
+            log("error", "Physics view accessed with invalid key\n")
+            return nil
+        end,
+
+        __newindex = function(self, key, value)
+            local setter = physicsSetters[key]
+            if setter then return setter(self, value) end
+            log("error", "Physics view modified with invalid key\n")
+        end,
+    })
+
+    transformPtr = ffi.typeof("struct ye_component_transform *")
+    physicsPtr = ffi.typeof("struct ye_component_physics *")
+end
+
+local function view(self, compIdx, ctype, mt)
+    local _c_entity = rawget(self, "_c_entity")
+    if _c_entity == nil then
+        log("error", "Component view requested on nil entity\n")
+        return nil
+    end
+
+    if ctype then
+        local ptr = ye_lua_get_component_pointer(_c_entity, compIdx)
+        if ptr == nil then return nil end
+        return ffi.cast(ctype, ptr)
+    end
+
+    if not ye_lua_check_component_exists(_c_entity, compIdx) then return nil end
+    return CreateProxyToComponent(_c_entity, mt)
+end
+
+---**Get a direct view of the Transform component.**
+---
+---Exposes `x` and `y`. Under LuaJIT this is an FFI pointer to the component.
+---Do not keep the view past the current frame.
+---
+---example:
+---```lua
+---local t = self:TransformView()
+---for i = 1, 100 do t.x = t.x + 1 end
+---```
+---@return Transform|nil view The view, or nil if there is no transform
+function Entity:TransformView() end -- fake prototype for intellisense
+function TransformView(self)
+    return view(self, TRANSFORM_COMPONENT, transformPtr, Transform_mt)
+end
+
+---**Get a direct view of the Physics component.**
+---
+---Exposes the same fields as the Physics proxy. Under LuaJIT this is an FFI pointer
+---to the component, which additionally exposes `velocity.x`, `velocity.y` and
+---`rotational_velocity` without any lookup overhead.
+---Do not keep the view past the current frame.
+---@return Physics|nil view The view, or nil if there is no physics component
+function Entity:PhysicsView() end -- fake prototype for intellisense
+function PhysicsView(self)
+    return view(self, PHYSICS_COMPONENT, physicsPtr, Physics_mt)
+end
@@ -13,13 +13,14 @@ Audio = {}
 ---@param handle string The resource handle
 ---@param loops? number The number of times to loop the sound (default 0)
 ---@param volume_scale? number The volume scale (default 1.0)
-function Audio:playSound(handle, loops, volume_scale)
+---@param bus? string The bus to play on (default "sfx")
+function Audio:playSound(handle, loops, volume_scale, bus)
     -- set optional params to defaults as needed
     loops = loops or 0
     volume_scale = volume_scale or 1.0
 
     -- call the engine function
-    ye_audio_play_sound(handle, loops, volume_scale)
+    ye_audio_play_sound(handle, loops, volume_scale, bus)
 end
 
 ---**Plays a music track**
@@ -41,4 +42,34 @@ end
 function Audio:setVolume(volume_scale)
     -- call the engine function
     ye_audio_set_volume(volume_scale)
+end
+
+---**Sets the volume of a bus**
+--- Buses are "master", "music", "sfx", "ui" and any you create, each one scales everything mixed into it
+---@param bus string The bus
+---@param volume_scale number The volume scale (1.0 is unchanged)
+function Audio:setBusVolume(bus, volume_scale)
+    ye_audio_set_bus_volume(bus, volume_scale)
+end
+
+---**Gets the volume of a bus**
+---@param bus string The bus
+---@return number|nil volume_scale The volume scale, nil if there is no such bus
+function Audio:getBusVolume(bus)
+    return ye_audio_get_bus_volume(bus)
+end
+
+---**Sets the cutoff of a bus's low pass filter**
+---@param bus string The bus
+---@param cutoff number The cutoff in Hz, 0 turns the filter off
+function Audio:setBusLowpass(bus, cutoff)
+    ye_audio_set_bus_lowpass(bus, cutoff)
+end
+
+---**Creates a bus, if one by that name does not exist yet**
+---@param name string The name of the new bus
+---@param parent? string The bus it mixes into (default "master")
+---@return boolean exists Whether the bus exists now (false if every bus is in use)
+function Audio:createBus(name, parent)
+    return ye_audio_create_bus(name, parent)
 end
\ No newline at end of file
@@ -0,0 +1,83 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+-- must match the YE_LUA_WAIT_* defines in lua_subsystem_coroutine.c
+local YE_WAIT_SECONDS = 1
+local YE_WAIT_FRAMES = 2
+local YE_WAIT_UNTIL = 3
+
+--- returns true if we are inside a coroutine (and can therefore yield)
+local function inCoroutine(fn_name)
+    local co, is_main = coroutine.running()
+    if co == nil or is_main then
+        log("error", fn_name .. "() can only be called inside a coroutine started with startCoroutine()\n")
+        return false
+    end
+    return true
+end
+
+---**Start a coroutine managed by the engine.**
+---
+---The function runs immediately until it first waits, and is resumed by the engine afterwards.
+---
+---@param fn function The function to run as a coroutine
+---@vararg any Arguments to pass to the function
+---@return integer id A handle that can be passed to cancelCoroutine
+---
+---example:
+---```lua
+---startCoroutine(function()
+---    log("info", "exploding in 3 seconds\n")
+---    wait(3)
+---    entity:destroy()
+---end)
+---```
+function startCoroutine(fn, ...)
+    return ye_lua_coroutine_start(fn, ...)
+end
+
+---**Stop a coroutine before it is resumed again.**
+---
+---@param id integer The handle returned by startCoroutine
+---@return boolean cancelled Whether a waiting coroutine was found and cancelled
+function cancelCoroutine(id)
+    return ye_lua_coroutine_cancel(id)
+end
+
+---**Suspend the current coroutine for a number of seconds.**
+---
+---@param seconds number How long to wait
+function wait(seconds)
+    if not inCoroutine("wait") then return end
+    coroutine.yield(YE_WAIT_SECONDS, seconds)
+end
+
+---**Suspend the current coroutine for a number of frames.**
+---
+---@param frames? integer How many frames to wait (defaults to 1)
+function waitFrames(frames)
+    if not inCoroutine("waitFrames") then return end
+    coroutine.yield(YE_WAIT_FRAMES, frames or 1)
+end
+
+---**Suspend the current coroutine until an event is signalled.**
+---
+---If `event` is a string, the coroutine resumes when any script (or C) calls signal(event).
+---If `event` is a function, it is called once per frame and the coroutine resumes once it returns true.
+---
+---@param event string|function The event name, or a predicate
+function waitUntil(event)
+    if not inCoroutine("waitUntil") then return end
+    coroutine.yield(YE_WAIT_UNTIL, event)
+end
+
+---**Wake every coroutine (in any script) waiting on an event.**
+---
+---@param event string The event name
+function signal(event)
+    ye_lua_coroutine_signal(event)
+end
@@ -0,0 +1,93 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+---@class Navigation
+--- Exposes pathfinding over the scene's navigation grid
+Navigation = {}
+
+---A single waypoint of a path.
+---@class NavigationPoint
+---@field x number
+---@field y number
+
+---**Find a path right away.**
+---
+---The path runs from the start to the goal, with every waypoint in between that it has to turn at.
+---Pass the same `results` table every time to avoid allocating. Only the first `count`
+---entries are valid, anything after them is left over from an earlier path.
+---
+---@param x1 number Start
+---@param y1 number Start
+---@param x2 number Goal
+---@param y2 number Goal
+---@param results table|nil Table to write NavigationPoints into
+---@return integer count 0 if the goal can not be reached
+---@return NavigationPoint[] results
+function Navigation:findPath(x1, y1, x2, y2, results)
+    results = results or {}
+    return ye_lua_navigation_find_path(x1, y1, x2, y2, results), results
+end
+
+---**Find a path on the worker threads.**
+---
+---The callback is called on a later frame with `(count, points, id)`, count being 0 if the goal
+---can not be reached. Prefer this over findPath for long paths, or many agents at once.
+---
+---@param x1 number Start
+---@param y1 number Start
+---@param x2 number Goal
+---@param y2 number Goal
+---@param callback fun(count: integer, points: NavigationPoint[], id: integer)
+---@return integer id Handle for Navigation:cancel
+---example:
+---```lua
+---Navigation:requestPath(x, y, targetX, targetY, function(count, points)
+---    if count > 0 then path = points end
+---end)
+---```
+function Navigation:requestPath(x1, y1, x2, y2, callback)
+    return ye_lua_navigation_request_path(x1, y1, x2, y2, callback)
+end
+
+---**Cancel a path request, its callback will not be called.**
+---
+---@param id integer The handle requestPath returned
+---@return boolean cancelled Whether the request was still pending
+function Navigation:cancel(id)
+    return ye_lua_navigation_cancel(id)
+end
+
+---**Block or free the cell under a point.**
+---
+---@param x number
+---@param y number
+---@param blocked boolean
+function Navigation:setBlocked(x, y, blocked)
+    ye_lua_navigation_set_blocked(x, y, blocked)
+end
+
+---**Check whether the cell under a point is blocked (points outside the grid are).**
+---
+---@param x number
+---@param y number
+---@return boolean blocked
+function Navigation:isBlocked(x, y)
+    return ye_lua_navigation_is_blocked(x, y)
+end
+
+---**Replace the grid with one blocked by the static colliders in the scene.**
+---
+---@param x number Area covered
+---@param y number Area covered
+---@param w number Area covered
+---@param h number Area covered
+---@param cellSize number Side length of a cell
+---@param layers (string|integer)[]|nil Only colliders on these layers block cells
+---@return boolean built
+function Navigation:build(x, y, w, h, cellSize, layers)
+    return ye_lua_navigation_build(x, y, w, h, cellSize, layers)
+end
@@ -0,0 +1,63 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+---@class Observe
+--- Calls functions when components change or buttons are used, instead of checking in onUpdate
+Observe = {}
+
+---@alias ObserveComponent "transform"|"renderer"|"physics"|"collider"|"lua_script"|"audiosource"|"camera"|"tag"|"button"
+
+---@alias ObserveEvent "added"|"removed"|"modified"
+
+---@alias ObserveButtonEvent "hover"|"unhover"|"press"|"release"|"click"
+
+---**Get called when a component is added to, removed from or modified on an entity.**
+---
+---Changes are collected during the frame and delivered together after scripts and tweens
+---have run, so a callback never runs in the middle of another script. A component modified
+---several times in a frame is reported once. Modifications made through component views
+---are not seen.
+---
+---The callback gets the entity (nil for removals from a destroyed entity), the event and the component.
+---
+---@param component ObserveComponent
+---@param events ObserveEvent|ObserveEvent[]
+---@param callback fun(entity: Entity|nil, event: ObserveEvent, component: ObserveComponent)
+---@param entity Entity|nil Only this entity, the observer stops when it is destroyed
+---@return integer id Handle for Observe:cancel
+---example:
+---```lua
+---Observe:component("collider", "removed", function(entity) log("info", "collider gone\n") end)
+---```
+function Observe:component(component, events, callback, entity)
+    return ye_lua_observe(component, events, entity, callback)
+end
+
+---**Get called when a button is hovered, pressed, released or clicked.**
+---
+---@param entity Entity|nil The entity with the button, nil for every button
+---@param events ObserveButtonEvent|ObserveButtonEvent[]
+---@param callback fun(entity: Entity, event: ObserveButtonEvent, component: "button")
+---@return integer id Handle for Observe:cancel
+---example:
+---```lua
+---function onMount()
+---    local play = Entity:getEntityNamed("play button")
+---    Observe:button(play, "click", function() Scene:loadScene("levels/one.yoyo") end)
+---end
+---```
+function Observe:button(entity, events, callback)
+    return ye_lua_observe("button", events, entity, callback)
+end
+
+---**Stop an observer.** Observers also stop when their script is removed.
+---
+---@param id integer The handle Observe:component or Observe:button returned
+---@return boolean cancelled Whether it was still observing
+function Observe:cancel(id)
+    return ye_lua_unobserve(id)
+end
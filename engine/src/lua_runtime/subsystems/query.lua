@@ -0,0 +1,121 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+---@class Query
+--- Exposes spatial queries against the colliders in the scene, and queries for entities by their components
+Query = {}
+
+---Narrows down what a query can return. Every field is optional.
+---@class QueryFilter
+---@field tag string|nil Only return entities with this tag
+---@field ignore Entity|nil Never return this entity (usually the one asking)
+---@field skipTriggers boolean|nil Do not return trigger colliders
+---@field limit integer|nil The most results to return (at most 64, the default)
+---@field layers (string|integer)[]|nil Only return colliders on these layers
+---@field asLayer string|integer|nil Only return colliders that a collider on this layer would interact with
+
+---A single raycast or sweep result.
+---@class QueryHit
+---@field entity Entity The entity that was hit
+---@field x number Where the ray (or the swept box's top left) was on contact
+---@field y number Where the ray (or the swept box's top left) was on contact
+---@field normalX number Normal of the face that was hit, zero if the cast started inside it
+---@field normalY number Normal of the face that was hit, zero if the cast started inside it
+---@field distance number How far along the cast the contact was
+
+---**Cast a ray and get what it hits, nearest first.**
+---
+---Pass the same `results` table every time to avoid allocating. Only the first `count`
+---entries are valid, anything after them is left over from an earlier query.
+---
+---@param x number Ray origin
+---@param y number Ray origin
+---@param dirX number Ray direction, does not need to be normalized
+---@param dirY number Ray direction, does not need to be normalized
+---@param distance number How far the ray reaches
+---@param filter QueryFilter|nil
+---@param results table|nil Table to write QueryHits into
+---@return integer count
+---@return QueryHit[] results
+---example:
+---```lua
+---local hits = {}
+---local count = Query:raycast(x, y, 1, 0, 500, { tag = "wall", limit = 1 }, hits)
+---if count > 0 then log("info", "wall at " .. hits[1].distance .. "\n") end
+---```
+function Query:raycast(x, y, dirX, dirY, distance, filter, results)
+    results = results or {}
+    return ye_lua_query_raycast(x, y, dirX, dirY, distance, filter, results), results
+end
+
+---**Move a box along a direction and get what it would run into, nearest first.**
+---
+---@param x number Box position
+---@param y number Box position
+---@param w number Box width
+---@param h number Box height
+---@param dirX number Direction to move, does not need to be normalized
+---@param dirY number Direction to move, does not need to be normalized
+---@param distance number How far to move it
+---@param filter QueryFilter|nil
+---@param results table|nil Table to write QueryHits into
+---@return integer count
+---@return QueryHit[] results
+function Query:sweep(x, y, w, h, dirX, dirY, distance, filter, results)
+    results = results or {}
+    return ye_lua_query_sweep(x, y, w, h, dirX, dirY, distance, filter, results), results
+end
+
+---**Get the entities whose colliders overlap a rect.**
+---
+---@param x number
+---@param y number
+---@param w number
+---@param h number
+---@param filter QueryFilter|nil
+---@param results table|nil Table to write Entities into
+---@return integer count
+---@return Entity[] results
+function Query:overlapRect(x, y, w, h, filter, results)
+    results = results or {}
+    return ye_lua_query_overlap_rect(x, y, w, h, filter, results), results
+end
+
+---**Get the entities whose colliders contain a point.**
+---
+---@param x number
+---@param y number
+---@param filter QueryFilter|nil
+---@param results table|nil Table to write Entities into
+---@return integer count
+---@return Entity[] results
+function Query:overlapPoint(x, y, filter, results)
+    results = results or {}
+    return ye_lua_query_overlap_point(x, y, filter, results), results
+end
+
+---**Get every entity that has a set of components.**
+---
+---`components` joins component names with `+`, a name starting with `!` excludes entities that
+---have that component. Names are `transform`, `renderer`, `physics`, `collider`, `lua_script`,
+---`audiosource`, `camera`, `tag` and `button`. The engine keeps the matching entities up to date as
+---components are added and removed, so asking again each frame does not walk the scene.
+---
+---@param components string ex: "physics+collider+!button"
+---@param results table|nil Table to write Entities into
+---@return integer count
+---@return Entity[] results
+---example:
+---```lua
+---local movers = {}
+---local count = Query:with("physics+transform", movers)
+---for i = 1, count do movers[i].Physics.xVelocity = 0 end
+---```
+function Query:with(components, results)
+    results = results or {}
+    return ye_lua_query_entities(components, results), results
+end
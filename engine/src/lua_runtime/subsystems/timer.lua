@@ -10,23 +10,51 @@
 Timer = {}
 
 ---**Creates a new timer object.**
+---
+---Timers run as engine coroutines (see startCoroutine), so a waiting timer costs nothing per frame.
 ---@param duration_ms number The duration of the timer in milliseconds.
 ---@param callback_fn function The function to call when the timer expires.
 ---@param loops number The number of times to loop the timer. -1 means loop forever.
----@param start_ticks number The number of ticks to wait before starting the timer.
+---@param start_ticks number The tick to start counting from, or 0 to start now.
 ---@vararg any Additional arguments to pass to the callback function when resolved.
----**IMPORTANT: THERE IS A MAXIMUM CAP FOR TIMER CALLBACK ARGUMENTS, DEFINED IN ENGINE AS YE_LUA_MAX_TIMER_ARGS**
+---@return integer|nil id A handle that can be passed to cancelCoroutine to stop the timer
 function Timer:new(duration_ms, callback_fn, loops, start_ticks, ...)
-    -- loops = loops or 0
-    -- start_ticks = start_ticks or -1 -- -1 makes timer system start it immediately
-    -- no more optional args, because we have the varargs
-
     -- check we have all valid args
     if not duration_ms or not callback_fn or not loops or not start_ticks then
         log("error","Called Timer:new() without all required arguments")
-    else
-        ye_lua_timer_create_timer(duration_ms, callback_fn, loops, start_ticks, ...)
+        return nil
     end
+
+    local args = {...}
+    local nargs = select("#", ...)
+
+    return startCoroutine(function()
+        local start = start_ticks
+        if start <= 0 then
+            start = ye_lua_timer_get_ticks()
+        end
+
+        local fired = 0
+        while true do
+            -- like the C timer system, fire at most once per frame
+            local delay = start + duration_ms - ye_lua_timer_get_ticks()
+            if delay > 0 then
+                wait(delay / 1000)
+            else
+                waitFrames(1)
+            end
+
+            callback_fn(Yunpack(args, 1, nargs))
+
+            if loops ~= -1 then
+                fired = fired + 1
+                if fired >= math.max(loops, 1) then
+                    return
+                end
+            end
+            start = ye_lua_timer_get_ticks()
+        end
+    end)
 end
 
 ---**Retrieves the current ticks of the engine**
@@ -35,4 +63,12 @@ end
 function Timer:getTicks(offset)
     offset = offset or 0
     return ye_lua_timer_get_ticks() + offset
-end
\ No newline at end of file
+end
+
+---**Retrieves a high resolution time in seconds**
+---
+---Only the difference between two calls means anything, use it to time short spans of code.
+---@return number seconds
+function Timer:now()
+    return ye_lua_timer_get_seconds()
+end
@@ -0,0 +1,58 @@
+--[[
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+]]
+
+---@class Tween
+--- Animates entity properties over time, run by the engine
+Tween = {}
+
+---@alias TweenProperty "x"|"y"|"alpha"|"rotation"|"width"|"height"|"cameraWidth"|"cameraHeight"
+
+---@alias TweenEasing "linear"|"inQuad"|"outQuad"|"inOutQuad"|"inCubic"|"outCubic"|"inOutCubic"|"inSine"|"outSine"|"inOutSine"|"inExpo"|"outExpo"|"inBack"|"outBack"|"outElastic"|"outBounce"
+
+---Optional settings for a tween.
+---@class TweenOptions
+---@field from number|nil Start value, defaults to the value when the tween starts moving
+---@field delay number|nil Seconds to wait before moving
+---@field easing TweenEasing|nil Defaults to "linear"
+---@field loop "restart"|"pingpong"|nil Loop forever instead of finishing
+---@field onComplete fun(id: integer)|nil Called when the tween finishes (never for looping tweens)
+
+---**Animate a property of an entity to a value.**
+---
+---The engine moves the value every frame, so there is nothing to do in `onUpdate`.
+---Starting a tween does not stop others on the same property, cancel them first if needed.
+---
+---@param entity Entity The entity to animate
+---@param property TweenProperty What to animate, x and y are the Transform, alpha, rotation, width and height the Renderer
+---@param to number The value to end at
+---@param duration number Seconds
+---@param options TweenOptions|nil
+---@return integer id Handle for Tween:cancel, 0 if the entity lacks the component
+---example:
+---```lua
+---Tween:to(entity, "alpha", 0, 0.5, { easing = "outQuad", onComplete = function() entity:destroy() end })
+---```
+function Tween:to(entity, property, to, duration, options)
+    return ye_lua_tween_start(entity, property, to, duration, options)
+end
+
+---**Stop a tween where it is. Its onComplete is not called.**
+---
+---@param id integer The handle Tween:to returned
+---@return boolean cancelled Whether the tween was still running
+function Tween:cancel(id)
+    return ye_lua_tween_cancel(id)
+end
+
+---**Stop every tween on an entity, or only the ones animating a property.**
+---
+---@param entity Entity
+---@param property TweenProperty|nil
+---@return integer count How many were stopped
+function Tween:cancelAll(entity, property)
+    return ye_lua_tween_cancel_entity(entity, property)
+end
@@ -0,0 +1,364 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <SDL.h>
+#include <jansson.h>
+#include <uthash/uthash.h>
+
+#ifdef _WIN32
+    #define NK_INCLUDE_FIXED_TYPES
+#endif
+
+#include <Nuklear/nuklear.h>
+
+#include <yoyoengine/json.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/logging.h>
+
+// how many callsites the overlay lists
+#define YE_MEMORY_OVERLAY_SITES 16
+
+static const char *tag_names[YE_MEM_TAG_COUNT] = {
+    "general", "ecs", "cache", "lua", "audio", "yep", "ui", "scene", "json", "physics", "texture", "strings"
+};
+
+#ifdef YE_MEMORY_CALLSITES
+struct ye_memory_site_key {
+    const char *file;   // __FILE__, so the pointer is stable
+    int line;
+};
+
+struct ye_memory_site {
+    struct ye_memory_site_key key;
+    enum ye_memory_tag tag;
+    size_t live_bytes;
+    size_t live_allocs;
+    size_t total_allocs;
+    UT_hash_handle hh;
+};
+
+static struct ye_memory_site *sites = NULL;
+#endif
+
+/*
+    Every block starts with this, padded so the memory handed out keeps malloc's alignment.
+*/
+struct ye_memory_header {
+    size_t size;
+    enum ye_memory_tag tag;
+#ifdef YE_MEMORY_CALLSITES
+    struct ye_memory_site *site;
+#endif
+};
+
+#define YE_MEMORY_HEADER ((sizeof(struct ye_memory_header) + 15) & ~(size_t)15)
+
+static struct ye_memory_stats stats[YE_MEM_TAG_COUNT];
+
+// counters for the frame in progress, copied into stats when it ends
+static size_t frame_allocs[YE_MEM_TAG_COUNT];
+static size_t frame_bytes[YE_MEM_TAG_COUNT];
+
+// job workers allocate too
+static SDL_SpinLock lock = 0;
+
+static inline struct ye_memory_header * _header_of(void *ptr){
+    return (struct ye_memory_header *)((char *)ptr - YE_MEMORY_HEADER);
+}
+
+// called with the lock held
+static void _account(struct ye_memory_header *header, const char *file, int line){
+    struct ye_memory_stats *s = &stats[header->tag];
+    s->live_bytes += header->size;
+    s->live_allocs++;
+    s->total_allocs++;
+    if(s->live_bytes > s->peak_bytes)
+        s->peak_bytes = s->live_bytes;
+
+    frame_allocs[header->tag]++;
+    frame_bytes[header->tag] += header->size;
+
+#ifdef YE_MEMORY_CALLSITES
+    struct ye_memory_site_key key = { file, line };
+    struct ye_memory_site *site = NULL;
+    HASH_FIND(hh, sites, &key, sizeof(struct ye_memory_site_key), site);
+    if(site == NULL){
+        site = calloc(1, sizeof(struct ye_memory_site));
+        site->key = key;
+        site->tag = header->tag;
+        HASH_ADD(hh, sites, key, sizeof(struct ye_memory_site_key), site);
+    }
+    site->live_bytes += header->size;
+    site->live_allocs++;
+    site->total_allocs++;
+    header->site = site;
+#else
+    (void)file;
+    (void)line;
+#endif
+}
+
+// called with the lock held
+static void _unaccount(struct ye_memory_header *header){
+    struct ye_memory_stats *s = &stats[header->tag];
+    s->live_bytes -= header->size;
+    s->live_allocs--;
+
+#ifdef YE_MEMORY_CALLSITES
+    header->site->live_bytes -= header->size;
+    header->site->live_allocs--;
+#endif
+}
+
+void * _ye_malloc(enum ye_memory_tag tag, size_t size, const char *file, int line){
+    struct ye_memory_header *header = malloc(YE_MEMORY_HEADER + size);
+    if(header == NULL)
+        return NULL;
+
+    header->size = size;
+    header->tag = tag;
+
+    SDL_AtomicLock(&lock);
+    _account(header, file, line);
+    SDL_AtomicUnlock(&lock);
+
+    return (char *)header + YE_MEMORY_HEADER;
+}
+
+void * _ye_calloc(enum ye_memory_tag tag, size_t count, size_t size, const char *file, int line){
+    void *out = _ye_malloc(tag, count * size, file, line);
+    if(out != NULL)
+        memset(out, 0, count * size);
+    return out;
+}
+
+void * _ye_realloc(enum ye_memory_tag tag, void *ptr, size_t size, const char *file, int line){
+    if(ptr == NULL)
+        return _ye_malloc(tag, size, file, line);
+
+    struct ye_memory_header *header = _header_of(ptr);
+
+    SDL_AtomicLock(&lock);
+    _unaccount(header);
+    SDL_AtomicUnlock(&lock);
+
+    struct ye_memory_header *grown = realloc(header, YE_MEMORY_HEADER + size);
+    if(grown == NULL){
+        // the old block is untouched, put it back
+        SDL_AtomicLock(&lock);
+        stats[header->tag].live_bytes += header->size;
+        stats[header->tag].live_allocs++;
+#ifdef YE_MEMORY_CALLSITES
+        header->site->live_bytes += header->size;
+        header->site->live_allocs++;
+#endif
+        SDL_AtomicUnlock(&lock);
+        return NULL;
+    }
+
+    grown->size = size;
+    grown->tag = tag;
+
+    SDL_AtomicLock(&lock);
+    _account(grown, file, line);
+    SDL_AtomicUnlock(&lock);
+
+    return (char *)grown + YE_MEMORY_HEADER;
+}
+
+char * _ye_strdup(enum ye_memory_tag tag, const char *str, const char *file, int line){
+    size_t length = strlen(str) + 1;
+    char *out = _ye_malloc(tag, length, file, line);
+    if(out != NULL)
+        memcpy(out, str, length);
+    return out;
+}
+
+void ye_free(void *ptr){
+    if(ptr == NULL)
+        return;
+
+    struct ye_memory_header *header = _header_of(ptr);
+
+    SDL_AtomicLock(&lock);
+    _unaccount(header);
+    SDL_AtomicUnlock(&lock);
+
+    free(header);
+}
+
+void ye_memory_note(enum ye_memory_tag tag, size_t bytes){
+    SDL_AtomicLock(&lock);
+    stats[tag].total_allocs++;
+    frame_allocs[tag]++;
+    frame_bytes[tag] += bytes;
+    SDL_AtomicUnlock(&lock);
+}
+
+void ye_memory_adopt(enum ye_memory_tag tag, size_t bytes){
+    SDL_AtomicLock(&lock);
+    struct ye_memory_stats *s = &stats[tag];
+    s->live_bytes += bytes;
+    s->live_allocs++;
+    s->total_allocs++;
+    if(s->live_bytes > s->peak_bytes)
+        s->peak_bytes = s->live_bytes;
+    frame_allocs[tag]++;
+    frame_bytes[tag] += bytes;
+    SDL_AtomicUnlock(&lock);
+}
+
+void ye_memory_release(enum ye_memory_tag tag, size_t bytes){
+    SDL_AtomicLock(&lock);
+    stats[tag].live_bytes -= bytes;
+    stats[tag].live_allocs--;
+    SDL_AtomicUnlock(&lock);
+}
+
+void ye_memory_end_frame(){
+    SDL_AtomicLock(&lock);
+    for(int i = 0; i < YE_MEM_TAG_COUNT; i++){
+        stats[i].frame_allocs = frame_allocs[i];
+        stats[i].frame_bytes = frame_bytes[i];
+        frame_allocs[i] = 0;
+        frame_bytes[i] = 0;
+    }
+    SDL_AtomicUnlock(&lock);
+}
+
+struct ye_memory_stats ye_memory_stats(enum ye_memory_tag tag){
+    SDL_AtomicLock(&lock);
+    struct ye_memory_stats out = stats[tag];
+    SDL_AtomicUnlock(&lock);
+    return out;
+}
+
+const char * ye_memory_tag_name(enum ye_memory_tag tag){
+    if(tag < 0 || tag >= YE_MEM_TAG_COUNT)
+        return "unknown";
+    return tag_names[tag];
+}
+
+#ifdef YE_MEMORY_CALLSITES
+// biggest live footprint first
+static int _site_cmp(struct ye_memory_site *a, struct ye_memory_site *b){
+    if(a->live_bytes != b->live_bytes)
+        return a->live_bytes < b->live_bytes ? 1 : -1;
+    return a->total_allocs < b->total_allocs ? 1 : a->total_allocs > b->total_allocs ? -1 : 0;
+}
+#endif
+
+json_t * ye_memory_report(){
+    json_t *report = json_object();
+
+    json_t *tags = json_object();
+    for(int i = 0; i < YE_MEM_TAG_COUNT; i++){
+        struct ye_memory_stats s = ye_memory_stats(i);
+        json_t *tag = json_object();
+        json_object_set_new(tag, "live bytes", json_integer((json_int_t)s.live_bytes));
+        json_object_set_new(tag, "peak bytes", json_integer((json_int_t)s.peak_bytes));
+        json_object_set_new(tag, "live allocations", json_integer((json_int_t)s.live_allocs));
+        json_object_set_new(tag, "total allocations", json_integer((json_int_t)s.total_allocs));
+        json_object_set_new(tag, "frame allocations", json_integer((json_int_t)s.frame_allocs));
+        json_object_set_new(tag, "frame bytes", json_integer((json_int_t)s.frame_bytes));
+        json_object_set_new(tags, tag_names[i], tag);
+    }
+    json_object_set_new(report, "tags", tags);
+
+#ifdef YE_MEMORY_CALLSITES
+    json_t *callsites = json_array();
+    SDL_AtomicLock(&lock);
+    HASH_SORT(sites, _site_cmp);
+    for(struct ye_memory_site *site = sites; site != NULL; site = site->hh.next){
+        json_t *entry = json_object();
+        json_object_set_new(entry, "file", json_string(site->key.file));
+        json_object_set_new(entry, "line", json_integer(site->key.line));
+        json_object_set_new(entry, "tag", json_string(tag_names[site->tag]));
+        json_object_set_new(entry, "live bytes", json_integer((json_int_t)site->live_bytes));
+        json_object_set_new(entry, "live allocations", json_integer((json_int_t)site->live_allocs));
+        json_object_set_new(entry, "total allocations", json_integer((json_int_t)site->total_allocs));
+        json_array_append_new(callsites, entry);
+    }
+    SDL_AtomicUnlock(&lock);
+    json_object_set_new(report, "callsites", callsites);
+#endif
+
+    return report;
+}
+
+void ye_memory_overlay(struct nk_context *ctx){
+    if (nk_begin(ctx, "memory", nk_rect(710, 10, 420, 380),
+                    NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE)) {
+        char str[256];
+
+        size_t total = 0;
+        nk_layout_row_dynamic(ctx, 20, 1);
+        for(int i = 0; i < YE_MEM_TAG_COUNT; i++){
+            struct ye_memory_stats s = ye_memory_stats(i);
+            total += s.live_bytes;
+            snprintf(str, sizeof(str), "%s: %.1fKB (peak %.1fKB) %zu live, %zu/frame",
+                tag_names[i], s.live_bytes / 1024.0, s.peak_bytes / 1024.0, s.live_allocs, s.frame_allocs);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+        }
+
+        nk_layout_row_dynamic(ctx, 25, 2);
+        snprintf(str, sizeof(str), "total: %.1fKB", total / 1024.0);
+        nk_label(ctx, str, NK_TEXT_LEFT);
+        if(nk_button_label(ctx, "dump json")){
+            json_t *report = ye_memory_report();
+            ye_json_write(ye_path("memory_report.json"), report);
+            json_decref(report);
+        }
+
+#ifdef YE_MEMORY_CALLSITES
+        if(nk_tree_push(ctx, NK_TREE_TAB, "callsites", NK_MINIMIZED)){
+            nk_layout_row_dynamic(ctx, 20, 1);
+            SDL_AtomicLock(&lock);
+            HASH_SORT(sites, _site_cmp);
+            int shown = 0;
+            for(struct ye_memory_site *site = sites; site != NULL && shown < YE_MEMORY_OVERLAY_SITES; site = site->hh.next, shown++){
+                snprintf(str, sizeof(str), "%s:%d [%s] %.1fKB, %zu live, %zu total",
+                    site->key.file, site->key.line, tag_names[site->tag], site->live_bytes / 1024.0, site->live_allocs, site->total_allocs);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+            SDL_AtomicUnlock(&lock);
+            nk_tree_pop(ctx);
+        }
+#endif
+    }
+    nk_end(ctx);
+}
+
+void ye_shutdown_memory(){
+    for(int i = 0; i < YE_MEM_TAG_COUNT; i++){
+        if(stats[i].live_allocs > 0)
+            ye_logf(warning, "%zu %s allocations (%zu bytes) were never freed.\n", stats[i].live_allocs, tag_names[i], stats[i].live_bytes);
+    }
+
+    if(YE_STATE.engine.debug_mode){
+        json_t *report = ye_memory_report();
+        ye_json_write(ye_path("memory_report.json"), report);
+        json_decref(report);
+    }
+
+#ifdef YE_MEMORY_CALLSITES
+    // live blocks still point at their sites, so only the ones with nothing left can go
+    struct ye_memory_site *site, *tmp;
+    HASH_ITER(hh, sites, site, tmp){
+        if(site->live_allocs > 0)
+            continue;
+        HASH_DEL(sites, site);
+        free(site);
+    }
+#endif
+}
@@ -0,0 +1,598 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <SDL.h>
+#include <SDL_net.h>
+
+#ifndef _WIN32
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+#include <yoyoengine/cache.h>
+#include <yoyoengine/mixer.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/metrics.h>
+#include <yoyoengine/scheduler.h>
+#include <yoyoengine/lua_memory.h>
+#include <yoyoengine/networking.h>
+
+// upper bounds in ms, the +Inf bucket comes after these
+static const double bucket_bounds[] = {0.5, 1, 2, 4, 8, 16.7, 33.3, 50, 100, 250, 1000};
+#define BOUND_COUNT (int)(sizeof(bucket_bounds) / sizeof(bucket_bounds[0]))
+
+// what fits in one datagram without fragmenting on a typical link
+#define STATSD_PACKET_SIZE 1432
+
+struct ye_metric_entry {
+    char name[48];
+    char help[96];
+    char label[24];             // empty for an unlabeled metric
+    char label_value[48];
+    enum ye_metric_type type;
+
+    double value;               // counter total, or the gauge
+    double sent;                // counter total at the last statsd send
+
+    // histograms, buckets are not cumulative here
+    uint64_t buckets[BOUND_COUNT + 1];
+    uint64_t count;
+    double sum;
+
+    // histogram samples since the last statsd send
+    uint64_t window_count;
+    double window_sum;
+    double window_max;
+};
+
+static struct ye_metric_entry metrics[YE_METRICS_MAX];
+static int metric_count = 0;
+
+enum ye_metrics_sink {
+    YE_METRICS_SINK_NONE,
+    YE_METRICS_SINK_TEXTFILE,
+    YE_METRICS_SINK_STATSD,
+    YE_METRICS_SINK_UNIX,
+};
+
+static enum ye_metrics_sink sink = YE_METRICS_SINK_NONE;
+static char target[512];
+static uint64_t last_flush = 0;
+
+// statsd over udp
+static UDPsocket udp = NULL;
+static UDPpacket *packet = NULL;
+
+#ifndef _WIN32
+// statsd over a unix datagram socket
+static int unix_socket = -1;
+static struct sockaddr_un unix_address;
+#endif
+
+// only the first failed send is logged, nobody may be listening yet
+static bool send_failed = false;
+
+// the engine's own metrics
+static struct {
+    int frames;
+    int frame_time;
+    int frame_work;
+    int fps;
+    int entities;
+    int painted;
+    int draw_calls;
+    int draw_calls_total;
+    int cache_hits;
+    int cache_misses;
+    int lua_used;
+    int lua_reserved;
+    int voices;
+    int errors;
+    int warnings;
+    int init_ms;
+    int first_frame_ms;
+    int memory_live[YE_MEM_TAG_COUNT];
+} engine_metrics;
+
+/*
+    ==========================================
+                    REGISTRY
+    ==========================================
+*/
+
+int ye_metric_labeled(const char *name, const char *help, enum ye_metric_type type, const char *label, const char *value){
+    if(sink == YE_METRICS_SINK_NONE || name == NULL)
+        return -1;
+
+    if(label == NULL || value == NULL)
+        label = value = "";
+
+    for(int i = 0; i < metric_count; i++){
+        struct ye_metric_entry *metric = &metrics[i];
+        if(strcmp(metric->name, name) != 0)
+            continue;
+
+        if(metric->type != type){
+            ye_logf(error, "Metric %s was registered with another type.\n", name);
+            return -1;
+        }
+
+        if(strcmp(metric->label, label) == 0 && strcmp(metric->label_value, value) == 0)
+            return i;
+    }
+
+    if(metric_count >= YE_METRICS_MAX){
+        ye_logf(error, "Could not register metric %s, all %d are in use.\n", name, YE_METRICS_MAX);
+        return -1;
+    }
+
+    struct ye_metric_entry *metric = &metrics[metric_count];
+    memset(metric, 0, sizeof(*metric));
+    snprintf(metric->name, sizeof(metric->name), "%s", name);
+    snprintf(metric->help, sizeof(metric->help), "%s", help != NULL ? help : "");
+    snprintf(metric->label, sizeof(metric->label), "%s", label);
+    snprintf(metric->label_value, sizeof(metric->label_value), "%s", value);
+    metric->type = type;
+
+    return metric_count++;
+}
+
+int ye_metric(const char *name, const char *help, enum ye_metric_type type){
+    return ye_metric_labeled(name, help, type, NULL, NULL);
+}
+
+void ye_metric_add(int metric, double value){
+    if(metric < 0 || metric >= metric_count)
+        return;
+    metrics[metric].value += value;
+}
+
+void ye_metric_set(int metric, double value){
+    if(metric < 0 || metric >= metric_count)
+        return;
+    metrics[metric].value = value;
+}
+
+void ye_metric_observe(int metric, double value){
+    if(metric < 0 || metric >= metric_count || metrics[metric].type != YE_METRIC_HISTOGRAM)
+        return;
+
+    struct ye_metric_entry *entry = &metrics[metric];
+
+    int bucket = 0;
+    while(bucket < BOUND_COUNT && value > bucket_bounds[bucket])
+        bucket++;
+    entry->buckets[bucket]++;
+
+    entry->count++;
+    entry->sum += value;
+
+    if(entry->window_count == 0 || value > entry->window_max)
+        entry->window_max = value;
+    entry->window_count++;
+    entry->window_sum += value;
+}
+
+bool ye_metrics_enabled(){
+    return sink != YE_METRICS_SINK_NONE;
+}
+
+/*
+    ==========================================
+                PROMETHEUS TEXTFILE
+    ==========================================
+*/
+
+// writes {label="value"} (with le if given), or nothing for an unlabeled metric without le
+static void _write_labels(FILE *file, struct ye_metric_entry *metric, const char *le){
+    bool labeled = metric->label[0] != '\0';
+    if(!labeled && le == NULL)
+        return;
+
+    fputc('{', file);
+    if(labeled){
+        fprintf(file, "%s=\"", metric->label);
+        for(const char *c = metric->label_value; *c != '\0'; c++){
+            if(*c == '\\' || *c == '"')
+                fputc('\\', file);
+            if(*c == '\n')
+                fputs("\\n", file);
+            else
+                fputc(*c, file);
+        }
+        fputc('"', file);
+    }
+    if(le != NULL)
+        fprintf(file, "%sle=\"%s\"", labeled ? "," : "", le);
+    fputc('}', file);
+}
+
+static void _write_series(FILE *file, struct ye_metric_entry *metric){
+    if(metric->type != YE_METRIC_HISTOGRAM){
+        fprintf(file, "yoyo_%s", metric->name);
+        _write_labels(file, metric, NULL);
+        fprintf(file, " %.10g\n", metric->value);
+        return;
+    }
+
+    uint64_t cumulative = 0;
+    for(int b = 0; b <= BOUND_COUNT; b++){
+        cumulative += metric->buckets[b];
+
+        char le[32];
+        if(b < BOUND_COUNT)
+            snprintf(le, sizeof(le), "%g", bucket_bounds[b]);
+        else
+            snprintf(le, sizeof(le), "+Inf");
+
+        fprintf(file, "yoyo_%s_bucket", metric->name);
+        _write_labels(file, metric, le);
+        fprintf(file, " %llu\n", (unsigned long long)cumulative);
+    }
+
+    fprintf(file, "yoyo_%s_sum", metric->name);
+    _write_labels(file, metric, NULL);
+    fprintf(file, " %.10g\n", metric->sum);
+
+    fprintf(file, "yoyo_%s_count", metric->name);
+    _write_labels(file, metric, NULL);
+    fprintf(file, " %llu\n", (unsigned long long)metric->count);
+}
+
+static const char *type_names[] = {"counter", "gauge", "histogram"};
+
+/*
+    Written to a temporary file and renamed over the target, so a collector
+    never reads half a file.
+*/
+static void _write_textfile(){
+    char temp_path[sizeof(target) + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", target);
+
+    FILE *file = fopen(temp_path, "w");
+    if(file == NULL){
+        if(!send_failed)
+            ye_logf(error, "Could not write metrics to %s.\n", temp_path);
+        send_failed = true;
+        return;
+    }
+
+    // every series of a name goes under one HELP and TYPE, in the order the names were registered
+    for(int i = 0; i < metric_count; i++){
+        bool written = false;
+        for(int j = 0; j < i && !written; j++)
+            written = strcmp(metrics[j].name, metrics[i].name) == 0;
+        if(written)
+            continue;
+
+        fprintf(file, "# HELP yoyo_%s %s\n", metrics[i].name, metrics[i].help);
+        fprintf(file, "# TYPE yoyo_%s %s\n", metrics[i].name, type_names[metrics[i].type]);
+        for(int j = i; j < metric_count; j++){
+            if(strcmp(metrics[j].name, metrics[i].name) == 0)
+                _write_series(file, &metrics[j]);
+        }
+    }
+
+    fclose(file);
+
+    #ifdef _WIN32
+        remove(target); // rename does not replace on windows
+    #endif
+    if(rename(temp_path, target) != 0){
+        if(!send_failed)
+            ye_logf(error, "Could not move metrics into %s.\n", target);
+        send_failed = true;
+    }
+}
+
+/*
+    ==========================================
+                    STATSD
+    ==========================================
+*/
+
+static char statsd_buffer[STATSD_PACKET_SIZE];
+static int statsd_length = 0;
+
+static void _statsd_send(){
+    if(statsd_length == 0)
+        return;
+
+    bool sent = false;
+    if(sink == YE_METRICS_SINK_STATSD){
+        memcpy(packet->data, statsd_buffer, statsd_length);
+        packet->len = statsd_length;
+        sent = SDLNet_UDP_Send(udp, -1, packet) != 0;
+    }
+    #ifndef _WIN32
+    else if(sink == YE_METRICS_SINK_UNIX){
+        sent = sendto(unix_socket, statsd_buffer, statsd_length, MSG_DONTWAIT,
+                        (struct sockaddr *)&unix_address, sizeof(unix_address)) == statsd_length;
+    }
+    #endif
+
+    if(!sent && !send_failed){
+        ye_logf(warning, "Could not send metrics to %s, is anything listening? (only logged once)\n", target);
+        send_failed = true;
+    }
+
+    statsd_length = 0;
+}
+
+// appends one line, sending the packet first if it would not fit
+static void _statsd_line(struct ye_metric_entry *metric, const char *suffix, double value, const char *type){
+    char name[128];
+    snprintf(name, sizeof(name), "yoyo.%s%s%s%s", metric->name,
+                metric->label[0] != '\0' ? "." : "", metric->label_value, suffix);
+
+    // label values can be anything, statsd names can not
+    for(char *c = name; *c != '\0'; c++){
+        if(!SDL_isalnum((unsigned char)*c) && *c != '.' && *c != '_' && *c != '-')
+            *c = '_';
+    }
+
+    char line[256];
+    int length = snprintf(line, sizeof(line), "%s:%.10g|%s\n", name, value, type);
+    if(length <= 0 || length >= (int)sizeof(line))
+        return;
+
+    if(statsd_length + length > STATSD_PACKET_SIZE)
+        _statsd_send();
+
+    memcpy(statsd_buffer + statsd_length, line, length);
+    statsd_length += length;
+}
+
+static void _send_statsd(){
+    for(int i = 0; i < metric_count; i++){
+        struct ye_metric_entry *metric = &metrics[i];
+        switch(metric->type){
+            case YE_METRIC_COUNTER:
+                // statsd counters are per interval
+                if(metric->value != metric->sent)
+                    _statsd_line(metric, "", metric->value - metric->sent, "c");
+                metric->sent = metric->value;
+                break;
+            case YE_METRIC_GAUGE:
+                _statsd_line(metric, "", metric->value, "g");
+                break;
+            case YE_METRIC_HISTOGRAM:
+                if(metric->window_count == 0)
+                    break;
+                _statsd_line(metric, ".avg", metric->window_sum / metric->window_count, "g");
+                _statsd_line(metric, ".max", metric->window_max, "g");
+                _statsd_line(metric, ".count", (double)metric->window_count, "c");
+                metric->window_count = 0;
+                metric->window_sum = 0;
+                metric->window_max = 0;
+                break;
+        }
+    }
+    _statsd_send();
+}
+
+static bool _open_statsd(){
+    char host[256];
+    int port = 8125;
+
+    snprintf(host, sizeof(host), "%s", target);
+    char *colon = strrchr(host, ':');
+    if(colon != NULL){
+        port = atoi(colon + 1);
+        *colon = '\0';
+    }
+
+    ye_init_networking();
+
+    IPaddress address;
+    if(SDLNet_ResolveHost(&address, host, (Uint16)port) < 0){
+        ye_logf(error, "Could not resolve the statsd host %s: %s\n", target, SDLNet_GetError());
+        return false;
+    }
+
+    udp = SDLNet_UDP_Open(0);
+    packet = SDLNet_AllocPacket(STATSD_PACKET_SIZE);
+    if(udp == NULL || packet == NULL){
+        ye_logf(error, "Could not open a statsd socket: %s\n", SDLNet_GetError());
+        if(packet != NULL)
+            SDLNet_FreePacket(packet);
+        if(udp != NULL)
+            SDLNet_UDP_Close(udp);
+        packet = NULL;
+        udp = NULL;
+        return false;
+    }
+    packet->address = address;
+    return true;
+}
+
+#ifndef _WIN32
+static bool _open_unix(){
+    if(strlen(target) >= sizeof(unix_address.sun_path)){
+        ye_logf(error, "The metrics socket path %s is too long.\n", target);
+        return false;
+    }
+
+    unix_socket = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if(unix_socket < 0){
+        ye_logf(error, "Could not open a unix socket for metrics.\n");
+        return false;
+    }
+
+    memset(&unix_address, 0, sizeof(unix_address));
+    unix_address.sun_family = AF_UNIX;
+    strcpy(unix_address.sun_path, target);
+    return true;
+}
+#endif
+
+/*
+    ==========================================
+                ENGINE METRICS
+    ==========================================
+*/
+
+static void _register_engine_metrics(){
+    engine_metrics.frames           = ye_metric("frames_total", "Frames processed.", YE_METRIC_COUNTER);
+    engine_metrics.frame_time       = ye_metric("frame_time_ms", "Time between the starts of consecutive frames.", YE_METRIC_HISTOGRAM);
+    engine_metrics.frame_work       = ye_metric("frame_work_ms", "Time spent processing a frame, without waiting on the frame cap.", YE_METRIC_HISTOGRAM);
+    engine_metrics.fps              = ye_metric("fps", "Frames per second.", YE_METRIC_GAUGE);
+    engine_metrics.entities         = ye_metric("entities", "Entities in the scene.", YE_METRIC_GAUGE);
+    engine_metrics.painted          = ye_metric("painted_entities", "Entities painted in the last frame.", YE_METRIC_GAUGE);
+    engine_metrics.draw_calls       = ye_metric("draw_calls", "Textures the renderer copied in the last frame.", YE_METRIC_GAUGE);
+    engine_metrics.draw_calls_total = ye_metric("draw_calls_total", "Textures the renderer copied.", YE_METRIC_COUNTER);
+    engine_metrics.cache_hits       = ye_metric("cache_hits_total", "Texture, font and color lookups that were cached.", YE_METRIC_COUNTER);
+    engine_metrics.cache_misses     = ye_metric("cache_misses_total", "Texture, font and color lookups that were not cached.", YE_METRIC_COUNTER);
+    engine_metrics.lua_used         = ye_metric("lua_pool_used_bytes", "Bytes of the lua allocator pools in use.", YE_METRIC_GAUGE);
+    engine_metrics.lua_reserved     = ye_metric("lua_pool_reserved_bytes", "Bytes reserved for the lua allocator pools.", YE_METRIC_GAUGE);
+    engine_metrics.voices           = ye_metric("audio_voices", "Mixer voices playing.", YE_METRIC_GAUGE);
+    engine_metrics.errors           = ye_metric("log_errors_total", "Errors logged.", YE_METRIC_COUNTER);
+    engine_metrics.warnings         = ye_metric("log_warnings_total", "Warnings logged.", YE_METRIC_COUNTER);
+    engine_metrics.init_ms          = ye_metric("startup_init_ms", "How long engine initialization took.", YE_METRIC_GAUGE);
+    engine_metrics.first_frame_ms   = ye_metric("startup_first_frame_ms", "Time from startup to the first frame of the entry scene.", YE_METRIC_GAUGE);
+
+    for(int tag = 0; tag < YE_MEM_TAG_COUNT; tag++)
+        engine_metrics.memory_live[tag] = ye_metric_labeled("memory_live_bytes", "Tracked bytes allocated, by subsystem.", YE_METRIC_GAUGE, "tag", ye_memory_tag_name(tag));
+}
+
+static void _observe_system(const char *name, const struct ye_system_timing *timing, void *data){
+    (void)data;
+    int metric = ye_metric_labeled("system_time_ms", "Time each system took, by system.", YE_METRIC_HISTOGRAM, "system", name);
+    ye_metric_observe(metric, timing->last);
+}
+
+void ye_metrics_frame(){
+    if(sink == YE_METRICS_SINK_NONE)
+        return;
+
+    ye_metric_add(engine_metrics.frames, 1);
+    ye_metric_observe(engine_metrics.frame_time, YE_STATE.runtime.delta_time * 1000.0);
+    ye_metric_observe(engine_metrics.frame_work, YE_STATE.runtime.frame_time);
+    ye_metric_set(engine_metrics.fps, YE_STATE.runtime.fps);
+    ye_metric_set(engine_metrics.entities, YE_STATE.runtime.entity_count);
+    ye_metric_set(engine_metrics.painted, YE_STATE.runtime.painted_entity_count);
+    ye_metric_set(engine_metrics.draw_calls, YE_STATE.runtime.draw_call_count);
+    ye_metric_add(engine_metrics.draw_calls_total, YE_STATE.runtime.draw_call_count);
+
+    ye_each_system_timing(_observe_system, NULL);
+
+    struct ye_cache_stats cache = ye_cache_stats();
+    ye_metric_set(engine_metrics.cache_hits, (double)cache.hits);
+    ye_metric_set(engine_metrics.cache_misses, (double)cache.misses);
+
+    size_t reserved, unused;
+    ye_lua_memory_pool_stats(&reserved, &unused);
+    ye_metric_set(engine_metrics.lua_used, (double)(reserved - unused));
+    ye_metric_set(engine_metrics.lua_reserved, (double)reserved);
+
+    for(int tag = 0; tag < YE_MEM_TAG_COUNT; tag++)
+        ye_metric_set(engine_metrics.memory_live[tag], (double)ye_memory_stats(tag).live_bytes);
+
+    ye_metric_set(engine_metrics.voices, ye_mixer_active_voices());
+    ye_metric_set(engine_metrics.errors, YE_STATE.runtime.error_count);
+    ye_metric_set(engine_metrics.warnings, YE_STATE.runtime.warning_count);
+    ye_metric_set(engine_metrics.init_ms, YE_STATE.runtime.init_ms);
+    ye_metric_set(engine_metrics.first_frame_ms, YE_STATE.runtime.first_frame_ms);
+
+    if(SDL_GetTicks64() - last_flush >= (uint64_t)YE_STATE.engine.metrics_interval_ms)
+        ye_metrics_flush();
+}
+
+/*
+    ==========================================
+                    LIFECYCLE
+    ==========================================
+*/
+
+void ye_metrics_flush(){
+    switch(sink){
+        case YE_METRICS_SINK_TEXTFILE:
+            _write_textfile();
+            break;
+        case YE_METRICS_SINK_STATSD:
+        case YE_METRICS_SINK_UNIX:
+            _send_statsd();
+            break;
+        default:
+            break;
+    }
+    last_flush = SDL_GetTicks64();
+}
+
+void ye_init_metrics(){
+    const char *name = YE_STATE.engine.metrics_sink;
+    const char *configured = YE_STATE.engine.metrics_target;
+    bool has_target = configured != NULL && configured[0] != '\0';
+
+    if(name == NULL || strcmp(name, "none") == 0)
+        return;
+
+    metric_count = 0;
+    send_failed = false;
+
+    if(strcmp(name, "textfile") == 0){
+        snprintf(target, sizeof(target), "%s", has_target ? configured : ye_path("metrics.prom"));
+        sink = YE_METRICS_SINK_TEXTFILE;
+    }
+    else if(strcmp(name, "statsd") == 0){
+        snprintf(target, sizeof(target), "%s", has_target ? configured : "127.0.0.1:8125");
+        if(!_open_statsd())
+            return;
+        sink = YE_METRICS_SINK_STATSD;
+    }
+    else if(strcmp(name, "unix") == 0){
+        #ifdef _WIN32
+            ye_logf(warning, "The unix metrics sink is not available on windows, metrics are off.\n");
+            return;
+        #else
+            snprintf(target, sizeof(target), "%s", has_target ? configured : ye_path("yoyo_metrics.sock"));
+            if(!_open_unix())
+                return;
+            sink = YE_METRICS_SINK_UNIX;
+        #endif
+    }
+    else{
+        ye_logf(warning, "Unknown metrics_sink \"%s\", metrics are off.\n", name);
+        return;
+    }
+
+    _register_engine_metrics();
+    last_flush = SDL_GetTicks64();
+    ye_logf(info, "Initialized metrics, writing to %s every %dms.\n", target, YE_STATE.engine.metrics_interval_ms);
+}
+
+void ye_shutdown_metrics(){
+    if(sink == YE_METRICS_SINK_NONE)
+        return;
+
+    ye_metrics_flush();
+
+    if(packet != NULL)
+        SDLNet_FreePacket(packet);
+    if(udp != NULL)
+        SDLNet_UDP_Close(udp);
+    packet = NULL;
+    udp = NULL;
+
+    #ifndef _WIN32
+        if(unix_socket >= 0)
+            close(unix_socket);
+        unix_socket = -1;
+    #endif
+
+    sink = YE_METRICS_SINK_NONE;
+    metric_count = 0;
+    ye_logf(info, "Shut down metrics.\n");
+}
@@ -0,0 +1,696 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define YE_MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define YE_MIXER_NEON
+#endif
+
+#include <yoyoengine/mixer.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Everything is mixed in float, stereo interleaved, this many frames at a time. The device
+    buffer is split into blocks so the bus buffers can stay static.
+*/
+#define BLOCK_FRAMES 256
+
+/*
+    A voice is handed back and forth between the threads through its state:
+
+    FREE      main thread owns it, and fills it in before queueing it
+    QUEUED    the audio thread takes it on its next block
+    PLAYING   the audio thread owns it
+    FINISHED  it ended (or was stopped), the main thread frees it in ye_mixer_update
+*/
+enum _voice_state {
+    VOICE_FREE,
+    VOICE_QUEUED,
+    VOICE_PLAYING,
+    VOICE_FINISHED,
+};
+
+struct _voice {
+    SDL_atomic_t state;
+    SDL_atomic_t stop;
+    SDL_atomic_t gain_left;     // float bits, where the gains ramp to
+    SDL_atomic_t gain_right;
+
+    // set by the main thread while the voice is free
+    Mix_Chunk *chunk;
+    int bus;
+    int loops;
+
+    // audio thread only
+    Uint32 position;            // in bytes
+    float current_left;
+    float current_right;
+
+    // main thread only
+    int generation;
+    bool stopped;               // stopped on purpose, so not reported as finished
+};
+
+struct _bus {
+    char name[32];
+    int parent;                 // always lower than the bus itself, so children mix first
+    SDL_atomic_t gain;          // float bits
+    SDL_atomic_t cutoff;        // float bits, 0 is off
+
+    // audio thread only
+    float current_gain;
+    float lowpass[2];
+    bool touched;               // has signal in the current block
+    float buffer[BLOCK_FRAMES * 2];
+};
+
+static struct _voice voices[YE_MIXER_MAX_VOICES];
+static struct _bus buses[YE_MIXER_MAX_BUSES];
+static SDL_atomic_t bus_count;
+
+// held by whoever is advancing the voices, the device callback only ever tries it
+static SDL_SpinLock mixing = 0;
+
+static bool running = false;
+static int frequency = 0;
+static Uint16 format = 0;
+static int frame_bytes = 0;
+
+static void (*finished_callback)(int voice) = NULL;
+
+static inline void _store_float(SDL_atomic_t *atomic, float value){
+    int bits;
+    memcpy(&bits, &value, sizeof(int));
+    SDL_AtomicSet(atomic, bits);
+}
+
+static inline float _load_float(SDL_atomic_t *atomic){
+    int bits = SDL_AtomicGet(atomic);
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+/*
+    ==========================================
+                    KERNELS
+    ==========================================
+*/
+
+/*
+    dst += src * gain, where the gain starts at (left, right) and moves by (step_left, step_right)
+    every frame. src is stereo S16.
+*/
+static void _mix_s16(float *dst, const Sint16 *src, int frames, float left, float right, float step_left, float step_right){
+    int i = 0;
+
+#if defined(YE_MIXER_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    __m128 gain = _mm_setr_ps(left, right, left + step_left, right + step_right);
+    const __m128 step = _mm_setr_ps(2 * step_left, 2 * step_right, 2 * step_left, 2 * step_right);
+
+    for(; i + 4 <= frames; i += 4){
+        __m128i samples = _mm_loadu_si128((const __m128i *)(src + i * 2));
+        __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+        __m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+
+        float *out = dst + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_mul_ps(low, scale), gain)));
+        gain = _mm_add_ps(gain, step);
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(_mm_mul_ps(high, scale), gain)));
+        gain = _mm_add_ps(gain, step);
+    }
+#elif defined(YE_MIXER_NEON)
+    const float start[4] = {left, right, left + step_left, right + step_right};
+    const float steps[4] = {2 * step_left, 2 * step_right, 2 * step_left, 2 * step_right};
+    float32x4_t gain = vld1q_f32(start);
+    const float32x4_t step = vld1q_f32(steps);
+
+    for(; i + 4 <= frames; i += 4){
+        int16x8_t samples = vld1q_s16(src + i * 2);
+        float32x4_t low = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), 1.0f / 32768.0f);
+        float32x4_t high = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), 1.0f / 32768.0f);
+
+        float *out = dst + i * 2;
+        vst1q_f32(out, vmlaq_f32(vld1q_f32(out), low, gain));
+        gain = vaddq_f32(gain, step);
+        vst1q_f32(out + 4, vmlaq_f32(vld1q_f32(out + 4), high, gain));
+        gain = vaddq_f32(gain, step);
+    }
+#endif
+
+    for(; i < frames; i++){
+        dst[i * 2] += src[i * 2] * (1.0f / 32768.0f) * (left + step_left * i);
+        dst[i * 2 + 1] += src[i * 2 + 1] * (1.0f / 32768.0f) * (right + step_right * i);
+    }
+}
+
+/*
+    Same as _mix_s16, for stereo F32 sources.
+*/
+static void _mix_f32(float *dst, const float *src, int frames, float left, float right, float step_left, float step_right){
+    int i = 0;
+
+#if defined(YE_MIXER_SSE2)
+    __m128 gain = _mm_setr_ps(left, right, left + step_left, right + step_right);
+    const __m128 step = _mm_setr_ps(2 * step_left, 2 * step_right, 2 * step_left, 2 * step_right);
+
+    for(; i + 2 <= frames; i += 2){
+        float *out = dst + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_loadu_ps(src + i * 2), gain)));
+        gain = _mm_add_ps(gain, step);
+    }
+#elif defined(YE_MIXER_NEON)
+    const float start[4] = {left, right, left + step_left, right + step_right};
+    const float steps[4] = {2 * step_left, 2 * step_right, 2 * step_left, 2 * step_right};
+    float32x4_t gain = vld1q_f32(start);
+    const float32x4_t step = vld1q_f32(steps);
+
+    for(; i + 2 <= frames; i += 2){
+        float *out = dst + i * 2;
+        vst1q_f32(out, vmlaq_f32(vld1q_f32(out), vld1q_f32(src + i * 2), gain));
+        gain = vaddq_f32(gain, step);
+    }
+#endif
+
+    for(; i < frames; i++){
+        dst[i * 2] += src[i * 2] * (left + step_left * i);
+        dst[i * 2 + 1] += src[i * 2 + 1] * (right + step_right * i);
+    }
+}
+
+/*
+    buffer *= gain, ramping by step every frame
+*/
+static void _scale(float *buffer, int frames, float gain, float step){
+    int i = 0;
+
+#if defined(YE_MIXER_SSE2)
+    __m128 gains = _mm_setr_ps(gain, gain, gain + step, gain + step);
+    const __m128 steps = _mm_set1_ps(2 * step);
+    for(; i + 2 <= frames; i += 2){
+        _mm_storeu_ps(buffer + i * 2, _mm_mul_ps(_mm_loadu_ps(buffer + i * 2), gains));
+        gains = _mm_add_ps(gains, steps);
+    }
+#elif defined(YE_MIXER_NEON)
+    const float start[4] = {gain, gain, gain + step, gain + step};
+    float32x4_t gains = vld1q_f32(start);
+    const float32x4_t steps = vdupq_n_f32(2 * step);
+    for(; i + 2 <= frames; i += 2){
+        vst1q_f32(buffer + i * 2, vmulq_f32(vld1q_f32(buffer + i * 2), gains));
+        gains = vaddq_f32(gains, steps);
+    }
+#endif
+
+    for(; i < frames; i++){
+        buffer[i * 2] *= gain + step * i;
+        buffer[i * 2 + 1] *= gain + step * i;
+    }
+}
+
+// dst += src
+static void _add(float *dst, const float *src, int samples){
+    int i = 0;
+
+#if defined(YE_MIXER_SSE2)
+    for(; i + 4 <= samples; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+#elif defined(YE_MIXER_NEON)
+    for(; i + 4 <= samples; i += 4)
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+#endif
+
+    for(; i < samples; i++)
+        dst[i] += src[i];
+}
+
+// clamps to [-1, 1] and converts to S16 with saturation
+static void _to_s16(Sint16 *dst, const float *src, int samples){
+    int i = 0;
+
+#if defined(YE_MIXER_SSE2)
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    for(; i + 8 <= samples; i += 8){
+        __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), low), high), scale);
+        __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), low), high), scale);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+#elif defined(YE_MIXER_NEON)
+    for(; i + 8 <= samples; i += 8){
+        float32x4_t a = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), 32767.0f);
+        float32x4_t b = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), 32767.0f);
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+    }
+#endif
+
+    for(; i < samples; i++){
+        float sample = src[i];
+        if(sample > 1.0f) sample = 1.0f;
+        if(sample < -1.0f) sample = -1.0f;
+        dst[i] = (Sint16)lrintf(sample * 32767.0f);
+    }
+}
+
+/*
+    ==========================================
+                    MIXING
+    ==========================================
+*/
+
+// the bus's buffer for this block, cleared the first time something writes to it
+static float * _bus_buffer(int bus, int frames){
+    struct _bus *b = &buses[bus];
+    if(!b->touched){
+        memset(b->buffer, 0, sizeof(float) * 2 * frames);
+        b->touched = true;
+    }
+    return b->buffer;
+}
+
+static void _mix_voice(struct _voice *voice, int frames){
+    if(voice->chunk->alen < (Uint32)frame_bytes){
+        SDL_AtomicSet(&voice->state, VOICE_FINISHED);
+        return;
+    }
+
+    float *out = _bus_buffer(voice->bus, frames);
+
+    float target_left = _load_float(&voice->gain_left);
+    float target_right = _load_float(&voice->gain_right);
+    float step_left = (target_left - voice->current_left) / frames;
+    float step_right = (target_right - voice->current_right) / frames;
+    float left = voice->current_left;
+    float right = voice->current_right;
+
+    int done = 0;
+    while(done < frames){
+        Uint32 remaining = (voice->chunk->alen - voice->position) / frame_bytes;
+        int count = (int)SDL_min((Uint32)(frames - done), remaining);
+
+        const Uint8 *src = voice->chunk->abuf + voice->position;
+        if(format == AUDIO_F32SYS)
+            _mix_f32(out + done * 2, (const float *)src, count, left, right, step_left, step_right);
+        else
+            _mix_s16(out + done * 2, (const Sint16 *)src, count, left, right, step_left, step_right);
+
+        left += step_left * count;
+        right += step_right * count;
+        voice->position += count * frame_bytes;
+        done += count;
+
+        if(voice->position + frame_bytes > voice->chunk->alen){
+            if(voice->loops == 0){
+                SDL_AtomicSet(&voice->state, VOICE_FINISHED);
+                break;
+            }
+            if(voice->loops > 0)
+                voice->loops--;
+            voice->position = 0;
+        }
+    }
+
+    voice->current_left = target_left;
+    voice->current_right = target_right;
+}
+
+static void _process_bus(struct _bus *bus, int frames){
+    float target = _load_float(&bus->gain);
+
+    if(!bus->touched){
+        bus->current_gain = target;
+        return;
+    }
+
+    // one pole low pass, it is recursive so it runs per frame
+    float cutoff = _load_float(&bus->cutoff);
+    if(cutoff > 0.0f && cutoff < frequency / 2.0f){
+        float a = 1.0f - expf(-6.2831853f * cutoff / frequency);
+        float l = bus->lowpass[0], r = bus->lowpass[1];
+        for(int i = 0; i < frames; i++){
+            l += a * (bus->buffer[i * 2] - l);
+            r += a * (bus->buffer[i * 2 + 1] - r);
+            bus->buffer[i * 2] = l;
+            bus->buffer[i * 2 + 1] = r;
+        }
+        bus->lowpass[0] = l;
+        bus->lowpass[1] = r;
+    }
+
+    _scale(bus->buffer, frames, bus->current_gain, (target - bus->current_gain) / frames);
+    bus->current_gain = target;
+}
+
+/*
+    Mixes one block into out (in the device format). If input is set, it holds what SDL_mixer
+    produced, which becomes the music bus.
+*/
+static void _mix_block(Uint8 *out, const Uint8 *input, int frames){
+    int count = SDL_AtomicGet(&bus_count);
+    for(int i = 0; i < count; i++)
+        buses[i].touched = false;
+
+    if(input != NULL){
+        float *music = _bus_buffer(YE_BUS_MUSIC, frames);
+        if(format == AUDIO_F32SYS)
+            _mix_f32(music, (const float *)input, frames, 1.0f, 1.0f, 0.0f, 0.0f);
+        else
+            _mix_s16(music, (const Sint16 *)input, frames, 1.0f, 1.0f, 0.0f, 0.0f);
+    }
+
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        struct _voice *voice = &voices[i];
+        int state = SDL_AtomicGet(&voice->state);
+        if(state != VOICE_QUEUED && state != VOICE_PLAYING)
+            continue;
+        SDL_MemoryBarrierAcquire();
+
+        if(SDL_AtomicGet(&voice->stop)){
+            SDL_AtomicSet(&voice->state, VOICE_FINISHED);
+            continue;
+        }
+        if(state == VOICE_QUEUED)
+            SDL_AtomicSet(&voice->state, VOICE_PLAYING);
+
+        _mix_voice(voice, frames);
+    }
+
+    // children always have higher ids than their parents
+    for(int i = count - 1; i > YE_BUS_MASTER; i--){
+        struct _bus *bus = &buses[i];
+        _process_bus(bus, frames);
+        if(bus->touched)
+            _add(_bus_buffer(bus->parent, frames), bus->buffer, frames * 2);
+    }
+    _process_bus(&buses[YE_BUS_MASTER], frames);
+
+    if(!buses[YE_BUS_MASTER].touched)
+        memset(out, 0, frames * frame_bytes);
+    else if(format == AUDIO_F32SYS)
+        memcpy(out, buses[YE_BUS_MASTER].buffer, frames * frame_bytes);
+    else
+        _to_s16((Sint16 *)out, buses[YE_BUS_MASTER].buffer, frames * 2);
+}
+
+// runs on the audio thread, after SDL_mixer has mixed music into the stream
+static void _postmix(void *data, Uint8 *stream, int len){
+    (void)data;
+
+    // an offline render has the voices
+    if(!SDL_AtomicTryLock(&mixing))
+        return;
+
+    int frames = len / frame_bytes;
+    for(int done = 0; done < frames; done += BLOCK_FRAMES){
+        Uint8 *block = stream + done * frame_bytes;
+        _mix_block(block, block, SDL_min(BLOCK_FRAMES, frames - done));
+    }
+
+    SDL_AtomicUnlock(&mixing);
+}
+
+/*
+    ==========================================
+                    VOICES
+    ==========================================
+*/
+
+static struct _voice * _voice_of(int voice){
+    if(voice < 0)
+        return NULL;
+    struct _voice *v = &voices[voice % YE_MIXER_MAX_VOICES];
+    return v->generation == voice / YE_MIXER_MAX_VOICES ? v : NULL;
+}
+
+int ye_mixer_play(Mix_Chunk *chunk, int bus, int loops, float gain){
+    if(!running || chunk == NULL)
+        return -1;
+
+    if(bus < 0 || bus >= SDL_AtomicGet(&bus_count)){
+        ye_logf(warning, "Mixer bus %d does not exist, playing on sfx.\n", bus);
+        bus = YE_BUS_SFX;
+    }
+
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        struct _voice *voice = &voices[i];
+        if(SDL_AtomicGet(&voice->state) != VOICE_FREE)
+            continue;
+
+        voice->generation = (voice->generation + 1) & 0xFFFFFF;
+        voice->stopped = false;
+        voice->chunk = chunk;
+        voice->bus = bus;
+        voice->loops = loops;
+        voice->position = 0;
+        voice->current_left = gain;
+        voice->current_right = gain;
+        _store_float(&voice->gain_left, gain);
+        _store_float(&voice->gain_right, gain);
+        SDL_AtomicSet(&voice->stop, 0);
+
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&voice->state, VOICE_QUEUED);
+
+        return voice->generation * YE_MIXER_MAX_VOICES + i;
+    }
+
+    ye_logf(warning, "All %d mixer voices are busy, dropping sound.\n", YE_MIXER_MAX_VOICES);
+    return -1;
+}
+
+void ye_mixer_stop(int voice){
+    struct _voice *v = _voice_of(voice);
+    if(v == NULL || SDL_AtomicGet(&v->state) == VOICE_FREE)
+        return;
+    v->stopped = true;
+    SDL_AtomicSet(&v->stop, 1);
+}
+
+void ye_mixer_set_voice_gain(int voice, float left, float right){
+    struct _voice *v = _voice_of(voice);
+    if(v == NULL)
+        return;
+    _store_float(&v->gain_left, left);
+    _store_float(&v->gain_right, right);
+}
+
+bool ye_mixer_voice_playing(int voice){
+    struct _voice *v = _voice_of(voice);
+    if(v == NULL)
+        return false;
+    int state = SDL_AtomicGet(&v->state);
+    return state == VOICE_QUEUED || state == VOICE_PLAYING;
+}
+
+int ye_mixer_active_voices(){
+    int active = 0;
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        int state = SDL_AtomicGet(&voices[i].state);
+        if(state == VOICE_QUEUED || state == VOICE_PLAYING)
+            active++;
+    }
+    return active;
+}
+
+void ye_mixer_voice_finished(void (*callback)(int voice)){
+    finished_callback = callback;
+}
+
+void ye_mixer_update(){
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        struct _voice *voice = &voices[i];
+        if(SDL_AtomicGet(&voice->state) != VOICE_FINISHED)
+            continue;
+
+        SDL_AtomicSet(&voice->state, VOICE_FREE);
+
+        // the callback may start another sound on this very voice
+        if(!voice->stopped && finished_callback != NULL)
+            finished_callback(voice->generation * YE_MIXER_MAX_VOICES + i);
+    }
+}
+
+void ye_mixer_halt(){
+    SDL_AtomicLock(&mixing);
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        voices[i].chunk = NULL;
+        SDL_AtomicSet(&voices[i].state, VOICE_FREE);
+    }
+    SDL_AtomicUnlock(&mixing);
+}
+
+/*
+    ==========================================
+                    BUSES
+    ==========================================
+*/
+
+static void _setup_bus(int id, const char *name, int parent){
+    struct _bus *bus = &buses[id];
+    memset(bus, 0, sizeof(struct _bus));
+    snprintf(bus->name, sizeof(bus->name), "%s", name);
+    bus->parent = parent;
+    bus->current_gain = 1.0f;
+    _store_float(&bus->gain, 1.0f);
+    _store_float(&bus->cutoff, 0.0f);
+}
+
+int ye_mixer_create_bus(const char *name, int parent){
+    int count = SDL_AtomicGet(&bus_count);
+    if(count >= YE_MIXER_MAX_BUSES){
+        ye_logf(error, "Could not create mixer bus %s, all %d are in use.\n", name, YE_MIXER_MAX_BUSES);
+        return -1;
+    }
+    if(parent < 0 || parent >= count){
+        ye_logf(error, "Could not create mixer bus %s, parent bus %d does not exist.\n", name, parent);
+        return -1;
+    }
+
+    _setup_bus(count, name, parent);
+
+    // the audio thread only looks at buses below the count
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&bus_count, count + 1);
+    return count;
+}
+
+int ye_mixer_find_bus(const char *name){
+    int count = SDL_AtomicGet(&bus_count);
+    for(int i = 0; i < count; i++){
+        if(strcmp(buses[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+void ye_mixer_set_bus_gain(int bus, float gain){
+    if(bus < 0 || bus >= SDL_AtomicGet(&bus_count))
+        return;
+    _store_float(&buses[bus].gain, gain < 0.0f ? 0.0f : gain);
+}
+
+float ye_mixer_get_bus_gain(int bus){
+    if(bus < 0 || bus >= SDL_AtomicGet(&bus_count))
+        return 0.0f;
+    return _load_float(&buses[bus].gain);
+}
+
+void ye_mixer_set_bus_lowpass(int bus, float cutoff){
+    if(bus < 0 || bus >= SDL_AtomicGet(&bus_count))
+        return;
+    _store_float(&buses[bus].cutoff, cutoff < 0.0f ? 0.0f : cutoff);
+}
+
+/*
+    ==========================================
+                LIFECYCLE
+    ==========================================
+*/
+
+bool ye_init_mixer(){
+    running = false;
+
+    int channels;
+    if(Mix_QuerySpec(&frequency, &format, &channels) == 0){
+        ye_logf(error, "Could not start the mixer, the audio device is not open.\n");
+        return false;
+    }
+    if(channels != 2 || (format != AUDIO_S16SYS && format != AUDIO_F32SYS)){
+        ye_logf(error, "Could not start the mixer, it needs a stereo S16 or F32 device (got %d channels, format 0x%x).\n", channels, format);
+        return false;
+    }
+    frame_bytes = 2 * SDL_AUDIO_BITSIZE(format) / 8;
+
+    for(int i = 0; i < YE_MIXER_MAX_VOICES; i++){
+        memset(&voices[i], 0, sizeof(struct _voice));
+        SDL_AtomicSet(&voices[i].state, VOICE_FREE);
+    }
+
+    _setup_bus(YE_BUS_MASTER, "master", -1);
+    _setup_bus(YE_BUS_MUSIC, "music", YE_BUS_MASTER);
+    _setup_bus(YE_BUS_SFX, "sfx", YE_BUS_MASTER);
+    _setup_bus(YE_BUS_UI, "ui", YE_BUS_MASTER);
+    SDL_AtomicSet(&bus_count, YE_BUS_BUILTIN_COUNT);
+
+    running = true;
+    Mix_SetPostMix(_postmix, NULL);
+
+#if defined(YE_MIXER_SSE2)
+    const char *kernels = "SSE2";
+#elif defined(YE_MIXER_NEON)
+    const char *kernels = "NEON";
+#else
+    const char *kernels = "scalar";
+#endif
+    ye_logf(info, "Initialized mixer (%d Hz, %s, %s kernels).\n", frequency, format == AUDIO_F32SYS ? "f32" : "s16", kernels);
+    return true;
+}
+
+void ye_shutdown_mixer(){
+    if(!running)
+        return;
+
+    // SDL_mixer locks the device to swap this, so the callback is not running once it returns
+    Mix_SetPostMix(NULL, NULL);
+    ye_mixer_halt();
+    finished_callback = NULL;
+    running = false;
+
+    ye_logf(info, "Shut down mixer.\n");
+}
+
+bool ye_mixer_render_wav(const char *path, float seconds){
+    if(!running)
+        return false;
+
+    SDL_RWops *file = SDL_RWFromFile(path, "wb");
+    if(file == NULL){
+        ye_logf(error, "Could not open %s to render audio: %s\n", path, SDL_GetError());
+        return false;
+    }
+
+    Uint32 frames = (Uint32)(seconds * frequency);
+    Uint32 data_bytes = frames * frame_bytes;
+
+    SDL_RWwrite(file, "RIFF", 1, 4);
+    SDL_WriteLE32(file, 36 + data_bytes);
+    SDL_RWwrite(file, "WAVEfmt ", 1, 8);
+    SDL_WriteLE32(file, 16);
+    SDL_WriteLE16(file, format == AUDIO_F32SYS ? 3 : 1); // IEEE float or PCM
+    SDL_WriteLE16(file, 2);
+    SDL_WriteLE32(file, frequency);
+    SDL_WriteLE32(file, frequency * frame_bytes);
+    SDL_WriteLE16(file, frame_bytes);
+    SDL_WriteLE16(file, SDL_AUDIO_BITSIZE(format));
+    SDL_RWwrite(file, "data", 1, 4);
+    SDL_WriteLE32(file, data_bytes);
+
+    Uint8 block[BLOCK_FRAMES * 2 * sizeof(float)];
+
+    SDL_AtomicLock(&mixing);
+    for(Uint32 done = 0; done < frames; done += BLOCK_FRAMES){
+        int count = (int)SDL_min((Uint32)BLOCK_FRAMES, frames - done);
+        _mix_block(block, NULL, count);
+        SDL_RWwrite(file, block, frame_bytes, count);
+    }
+    SDL_AtomicUnlock(&mixing);
+
+    SDL_RWclose(file);
+    ye_logf(info, "Rendered %.2fs of audio to %s.\n", seconds, path);
+    return true;
+}
@@ -0,0 +1,706 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <SDL.h>
+
+#include <uthash/uthash.h>
+
+#include <yoyoengine/jobs.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/navigation.h>
+#include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/physics.h>
+#include <yoyoengine/ecs/collider.h>
+
+#define YE_NAV_SQRT2 1.41421356f
+
+/*
+    Grids
+
+    Searches only ever read a published grid, and hold a reference to it while they run. Edits
+    are made to a private copy (cloned from the published grid on the first edit), which replaces
+    the published grid the next time anything asks for it.
+*/
+
+struct ye_nav_grid {
+    SDL_atomic_t refs;
+    int width, height;
+    float cell_size;
+    float origin_x, origin_y;
+    uint8_t *blocked;
+    int *region;                // connected region of each free cell, -1 for blocked ones
+};
+
+static struct ye_nav_grid *published = NULL;    // one ref is held here
+static struct ye_nav_grid *editing = NULL;      // NULL while there are no unpublished edits
+
+static struct ye_nav_grid * _grid_new(int width, int height, float cell_size, float origin_x, float origin_y){
+    struct ye_nav_grid *grid = calloc(1, sizeof(struct ye_nav_grid));
+    grid->width = width;
+    grid->height = height;
+    grid->cell_size = cell_size;
+    grid->origin_x = origin_x;
+    grid->origin_y = origin_y;
+    grid->blocked = calloc((size_t)width * height, sizeof(uint8_t));
+    grid->region = malloc(sizeof(int) * (size_t)width * height);
+    SDL_AtomicSet(&grid->refs, 1);
+    return grid;
+}
+
+static void _grid_release(struct ye_nav_grid *grid){
+    if(grid == NULL || !SDL_AtomicDecRef(&grid->refs))
+        return;
+    free(grid->blocked);
+    free(grid->region);
+    free(grid);
+}
+
+static struct ye_nav_grid * _grid_retain(struct ye_nav_grid *grid){
+    SDL_AtomicIncRef(&grid->refs);
+    return grid;
+}
+
+// the grid to write edits into, NULL if there is no grid at all
+static struct ye_nav_grid * _edit(){
+    if(editing != NULL || published == NULL)
+        return editing;
+
+    editing = _grid_new(published->width, published->height, published->cell_size, published->origin_x, published->origin_y);
+    memcpy(editing->blocked, published->blocked, (size_t)published->width * published->height);
+    return editing;
+}
+
+// flood fills the free cells, 4 connected (a diagonal step is only allowed when both sides are free, so this matches)
+static void _label_regions(struct ye_nav_grid *grid){
+    int count = grid->width * grid->height;
+    int *queue = malloc(sizeof(int) * count);
+    int next_region = 0;
+
+    for(int i = 0; i < count; i++)
+        grid->region[i] = -1;
+
+    for(int seed = 0; seed < count; seed++){
+        if(grid->blocked[seed] || grid->region[seed] >= 0)
+            continue;
+
+        int head = 0, tail = 0;
+        queue[tail++] = seed;
+        grid->region[seed] = next_region;
+
+        while(head < tail){
+            int cell = queue[head++];
+            int x = cell % grid->width, y = cell / grid->width;
+            int neighbours[4] = {
+                x > 0 ? cell - 1 : -1,
+                x < grid->width - 1 ? cell + 1 : -1,
+                y > 0 ? cell - grid->width : -1,
+                y < grid->height - 1 ? cell + grid->width : -1,
+            };
+            for(int i = 0; i < 4; i++){
+                int n = neighbours[i];
+                if(n < 0 || grid->blocked[n] || grid->region[n] >= 0)
+                    continue;
+                grid->region[n] = next_region;
+                queue[tail++] = n;
+            }
+        }
+        next_region++;
+    }
+
+    free(queue);
+}
+
+static void _cache_clear();
+
+// makes any edits visible to new searches
+static void _publish(){
+    if(editing == NULL)
+        return;
+
+    _label_regions(editing);
+
+    _grid_release(published);
+    published = editing;
+    editing = NULL;
+
+    _cache_clear();
+}
+
+static bool _cell_at(const struct ye_nav_grid *grid, struct ye_vec2f point, int *x, int *y){
+    *x = (int)floorf((point.x - grid->origin_x) / grid->cell_size);
+    *y = (int)floorf((point.y - grid->origin_y) / grid->cell_size);
+    return *x >= 0 && *y >= 0 && *x < grid->width && *y < grid->height;
+}
+
+/*
+    Search
+
+    Runs on the job workers, so it only touches the grid it was handed and its own scratch.
+*/
+
+struct ye_nav_open {
+    float f;
+    int cell;
+};
+
+struct ye_nav_heap {
+    struct ye_nav_open *items;
+    int count;
+    int capacity;
+};
+
+static void _heap_push(struct ye_nav_heap *heap, float f, int cell){
+    if(heap->count == heap->capacity){
+        heap->capacity = heap->capacity > 0 ? heap->capacity * 2 : 256;
+        heap->items = realloc(heap->items, sizeof(struct ye_nav_open) * heap->capacity);
+    }
+    int i = heap->count++;
+    while(i > 0){
+        int parent = (i - 1) / 2;
+        if(heap->items[parent].f <= f)
+            break;
+        heap->items[i] = heap->items[parent];
+        i = parent;
+    }
+    heap->items[i] = (struct ye_nav_open){ f, cell };
+}
+
+static bool _heap_pop(struct ye_nav_heap *heap, int *cell){
+    if(heap->count == 0)
+        return false;
+    *cell = heap->items[0].cell;
+
+    struct ye_nav_open last = heap->items[--heap->count];
+    int i = 0;
+    while(true){
+        int child = i * 2 + 1;
+        if(child >= heap->count)
+            break;
+        if(child + 1 < heap->count && heap->items[child + 1].f < heap->items[child].f)
+            child++;
+        if(last.f <= heap->items[child].f)
+            break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    heap->items[i] = last;
+    return true;
+}
+
+// octile distance, exact on an empty grid
+static inline float _heuristic(const struct ye_nav_grid *grid, int a, int b){
+    int dx = abs(a % grid->width - b % grid->width);
+    int dy = abs(a / grid->width - b / grid->width);
+    int lo = dx < dy ? dx : dy, hi = dx < dy ? dy : dx;
+    return (float)(hi - lo) + YE_NAV_SQRT2 * lo;
+}
+
+static inline bool _blocked_at(const struct ye_nav_grid *grid, int x, int y){
+    return x < 0 || y < 0 || x >= grid->width || y >= grid->height || grid->blocked[y * grid->width + x];
+}
+
+// walks every cell a straight line between two cell centers passes through
+static bool _line_of_sight(const struct ye_nav_grid *grid, int a, int b){
+    int x = a % grid->width, y = a / grid->width;
+    int x1 = b % grid->width, y1 = b / grid->width;
+    int dx = abs(x1 - x), dy = abs(y1 - y);
+    int sx = x1 > x ? 1 : -1, sy = y1 > y ? 1 : -1;
+
+    for(int ix = 0, iy = 0; ix < dx || iy < dy;){
+        long long across = (long long)(1 + 2 * ix) * dy;
+        long long down = (long long)(1 + 2 * iy) * dx;
+        if(across == down){
+            // exactly through a corner, dont squeeze between two blocked cells
+            if(_blocked_at(grid, x + sx, y) || _blocked_at(grid, x, y + sy))
+                return false;
+            x += sx; y += sy; ix++; iy++;
+        }
+        else if(across < down){
+            x += sx; ix++;
+        }
+        else{
+            y += sy; iy++;
+        }
+        if(_blocked_at(grid, x, y))
+            return false;
+    }
+    return true;
+}
+
+// drops every waypoint that the one before it can see past, in place
+static int _smooth(const struct ye_nav_grid *grid, int *cells, int count){
+    if(count <= 2)
+        return count;
+
+    int out = 1;
+    int anchor = cells[0];
+    for(int i = 2; i < count; i++){
+        if(!_line_of_sight(grid, anchor, cells[i])){
+            anchor = cells[i - 1];
+            cells[out++] = anchor;
+        }
+    }
+    cells[out++] = cells[count - 1];
+    return out;
+}
+
+/*
+    A* from start to goal, returns the smoothed cells of the path (malloced) or NULL.
+    Cells in different regions are rejected before any searching.
+*/
+static int * _search(const struct ye_nav_grid *grid, int start, int goal, int *out_count){
+    *out_count = 0;
+    if(grid->region[start] < 0 || grid->region[start] != grid->region[goal])
+        return NULL;
+
+    if(start == goal){
+        int *cells = malloc(sizeof(int));
+        cells[0] = start;
+        *out_count = 1;
+        return cells;
+    }
+
+    int count = grid->width * grid->height;
+    float *cost = malloc(sizeof(float) * count);
+    int *parent = malloc(sizeof(int) * count);
+    uint8_t *state = calloc(count, sizeof(uint8_t));   // 0 unseen, 1 open, 2 closed
+    struct ye_nav_heap heap = {0};
+
+    static const int dirs[8][2] = { {1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {1,-1}, {-1,1}, {-1,-1} };
+
+    cost[start] = 0;
+    parent[start] = -1;
+    state[start] = 1;
+    _heap_push(&heap, _heuristic(grid, start, goal), start);
+
+    int cell;
+    while(_heap_pop(&heap, &cell)){
+        if(state[cell] == 2)
+            continue; // stale entry, a cheaper one was already expanded
+        state[cell] = 2;
+        if(cell == goal)
+            break;
+
+        int x = cell % grid->width, y = cell / grid->width;
+        for(int i = 0; i < 8; i++){
+            int dx = dirs[i][0], dy = dirs[i][1];
+            int nx = x + dx, ny = y + dy;
+            if(_blocked_at(grid, nx, ny))
+                continue;
+            if(dx != 0 && dy != 0 && (_blocked_at(grid, nx, y) || _blocked_at(grid, x, ny)))
+                continue; // no cutting corners
+
+            int n = ny * grid->width + nx;
+            if(state[n] == 2)
+                continue;
+
+            float g = cost[cell] + (dx != 0 && dy != 0 ? YE_NAV_SQRT2 : 1.0f);
+            if(state[n] == 0 || g < cost[n]){
+                cost[n] = g;
+                parent[n] = cell;
+                state[n] = 1;
+                _heap_push(&heap, g + _heuristic(grid, n, goal), n);
+            }
+        }
+    }
+
+    int *cells = NULL;
+    if(state[goal] == 2){
+        int length = 0;
+        for(int c = goal; c != -1; c = parent[c])
+            length++;
+
+        cells = malloc(sizeof(int) * length);
+        int i = length;
+        for(int c = goal; c != -1; c = parent[c])
+            cells[--i] = c;
+
+        *out_count = _smooth(grid, cells, length);
+    }
+
+    free(heap.items);
+    free(state);
+    free(parent);
+    free(cost);
+    return cells;
+}
+
+/*
+    Path cache
+
+    Main thread only. Keyed by (start cell, goal cell), most recently used last, emptied whenever
+    a new grid is published.
+*/
+
+struct ye_nav_cached_path {
+    int64_t key;
+    int *cells;
+    int count;
+    UT_hash_handle hh;
+};
+
+static struct ye_nav_cached_path *cache = NULL;
+
+static inline int64_t _cache_key(int start, int goal){
+    return ((int64_t)start << 32) | (uint32_t)goal;
+}
+
+static struct ye_nav_cached_path * _cache_find(int start, int goal){
+    int64_t key = _cache_key(start, goal);
+    struct ye_nav_cached_path *entry = NULL;
+    HASH_FIND(hh, cache, &key, sizeof(int64_t), entry);
+    if(entry != NULL){
+        // move to the back, so the front is always the least recently used
+        HASH_DEL(cache, entry);
+        HASH_ADD(hh, cache, key, sizeof(int64_t), entry);
+    }
+    return entry;
+}
+
+// takes ownership of cells
+static void _cache_insert(int start, int goal, int *cells, int count){
+    int64_t key = _cache_key(start, goal);
+    struct ye_nav_cached_path *entry = NULL;
+    HASH_FIND(hh, cache, &key, sizeof(int64_t), entry);
+    if(entry != NULL){
+        free(cells);
+        return;
+    }
+
+    if(HASH_COUNT(cache) >= YE_NAV_CACHE_SIZE){
+        struct ye_nav_cached_path *oldest = cache;
+        HASH_DEL(cache, oldest);
+        free(oldest->cells);
+        free(oldest);
+    }
+
+    entry = malloc(sizeof(struct ye_nav_cached_path));
+    entry->key = key;
+    entry->cells = cells;
+    entry->count = count;
+    HASH_ADD(hh, cache, key, sizeof(int64_t), entry);
+}
+
+static void _cache_clear(){
+    struct ye_nav_cached_path *entry, *tmp;
+    HASH_ITER(hh, cache, entry, tmp){
+        HASH_DEL(cache, entry);
+        free(entry->cells);
+        free(entry);
+    }
+}
+
+/*
+    Turns cells into world space waypoints, with the exact start and goal at either end.
+    Returns the total number of points, writing at most max_points.
+*/
+static int _to_points(const struct ye_nav_grid *grid, const int *cells, int count,
+                        struct ye_vec2f start, struct ye_vec2f goal, struct ye_vec2f *points, int max_points){
+    int total = count < 2 ? 2 : count;
+    if(points == NULL)
+        return total;
+
+    for(int i = 0; i < total && i < max_points; i++){
+        if(i == 0)
+            points[i] = start;
+        else if(i == total - 1)
+            points[i] = goal;
+        else
+            points[i] = (struct ye_vec2f){
+                grid->origin_x + (cells[i] % grid->width + 0.5f) * grid->cell_size,
+                grid->origin_y + (cells[i] / grid->width + 0.5f) * grid->cell_size,
+            };
+    }
+    return total;
+}
+
+/*
+    Requests
+*/
+
+struct ye_nav_request {
+    unsigned int id;
+    struct ye_nav_grid *grid;       // ref held until delivery, NULL if there was nothing to search
+    int start, goal;
+    struct ye_vec2f start_point, goal_point;
+    ye_nav_callback callback;
+    void *data;
+    bool cancelled;
+
+    int *cells;                     // the result, written by the worker
+    int count;
+
+    struct ye_nav_request *next;    // in the finished list
+    UT_hash_handle hh;              // in the live table, by id
+};
+
+static struct ye_nav_request *live = NULL;          // main thread only
+static struct ye_nav_request *finished_head = NULL; // guarded by finished_lock
+static struct ye_nav_request *finished_tail = NULL;
+static SDL_mutex *finished_lock = NULL;
+static struct ye_job_counter searches = {0};
+static unsigned int next_request_id = 1;
+
+// reused for every delivery, the points handed to callbacks live here
+static struct ye_vec2f *delivery_points = NULL;
+static int delivery_capacity = 0;
+
+static void _finish(struct ye_nav_request *request){
+    request->next = NULL;
+    SDL_LockMutex(finished_lock);
+    if(finished_tail != NULL)
+        finished_tail->next = request;
+    else
+        finished_head = request;
+    finished_tail = request;
+    SDL_UnlockMutex(finished_lock);
+}
+
+static void _search_job(void *data){
+    struct ye_nav_request *request = data;
+    request->cells = _search(request->grid, request->start, request->goal, &request->count);
+    _finish(request);
+}
+
+void ye_init_navigation(){
+    finished_lock = SDL_CreateMutex();
+}
+
+bool ye_nav_build(struct ye_rectf bounds, float cell_size){
+    if(cell_size <= 0 || bounds.w <= 0 || bounds.h <= 0){
+        ye_logf(error, "Invalid navigation grid bounds or cell size.\n");
+        return false;
+    }
+
+    int width = (int)ceilf(bounds.w / cell_size);
+    int height = (int)ceilf(bounds.h / cell_size);
+    if((int64_t)width * height > YE_NAV_MAX_CELLS){
+        ye_logf(error, "Navigation grid of %dx%d cells is too large, use a bigger cell size.\n", width, height);
+        return false;
+    }
+
+    _grid_release(editing);
+    editing = _grid_new(width, height, cell_size, bounds.x, bounds.y);
+
+    ye_logf(debug, "Built %dx%d navigation grid.\n", width, height);
+    return true;
+}
+
+void ye_nav_block_colliders(uint32_t layers){
+    struct ye_nav_grid *grid = _edit();
+    if(grid == NULL)
+        return;
+
+    for(struct ye_entity_node *node = collider_list_head; node != NULL; node = node->next){
+        struct ye_entity *entity = node->entity;
+        if(!entity->active || entity->collider == NULL || !entity->collider->active || entity->collider->is_trigger)
+            continue;
+        if(ye_collider_body(entity) != YE_COLLIDER_BODY_STATIC)
+            continue;
+        if(layers != 0 && !(layers & YE_PHYSICS_LAYER_BIT(entity->collider->layer)))
+            continue;
+
+        struct ye_rectf r = ye_get_position(entity, YE_COMPONENT_COLLIDER);
+        int x0, y0, x1, y1;
+        _cell_at(grid, (struct ye_vec2f){r.x, r.y}, &x0, &y0);
+        _cell_at(grid, (struct ye_vec2f){r.x + r.w, r.y + r.h}, &x1, &y1);
+
+        // a collider ending exactly on a cell edge does not block the next cell over
+        if(x1 > x0 && grid->origin_x + x1 * grid->cell_size >= r.x + r.w) x1--;
+        if(y1 > y0 && grid->origin_y + y1 * grid->cell_size >= r.y + r.h) y1--;
+
+        if(x0 < 0) x0 = 0;
+        if(y0 < 0) y0 = 0;
+        if(x1 >= grid->width) x1 = grid->width - 1;
+        if(y1 >= grid->height) y1 = grid->height - 1;
+
+        for(int y = y0; y <= y1; y++){
+            for(int x = x0; x <= x1; x++)
+                grid->blocked[y * grid->width + x] = 1;
+        }
+    }
+}
+
+void ye_nav_set_cell(int x, int y, bool blocked){
+    struct ye_nav_grid *grid = _edit();
+    if(grid == NULL || x < 0 || y < 0 || x >= grid->width || y >= grid->height)
+        return;
+    grid->blocked[y * grid->width + x] = blocked;
+}
+
+void ye_nav_set_blocked(struct ye_vec2f point, bool blocked){
+    struct ye_nav_grid *grid = _edit();
+    int x, y;
+    if(grid == NULL || !_cell_at(grid, point, &x, &y))
+        return;
+    grid->blocked[y * grid->width + x] = blocked;
+}
+
+bool ye_nav_set_cells(const uint8_t *cells, int width, int height){
+    struct ye_nav_grid *grid = _edit();
+    if(grid == NULL || grid->width != width || grid->height != height){
+        ye_logf(error, "Navigation cell data does not match the size of the grid.\n");
+        return false;
+    }
+
+    for(int i = 0; i < width * height; i++)
+        grid->blocked[i] = cells[i] != 0;
+    return true;
+}
+
+bool ye_nav_is_blocked(struct ye_vec2f point){
+    struct ye_nav_grid *grid = editing != NULL ? editing : published;
+    int x, y;
+    if(grid == NULL || !_cell_at(grid, point, &x, &y))
+        return true;
+    return grid->blocked[y * grid->width + x];
+}
+
+void ye_nav_clear(){
+    _grid_release(editing);
+    _grid_release(published);
+    editing = published = NULL;
+    _cache_clear();
+}
+
+int ye_nav_find_path(struct ye_vec2f start, struct ye_vec2f goal, struct ye_vec2f *points, int max_points){
+    _publish();
+
+    int sx, sy, gx, gy;
+    if(published == NULL || !_cell_at(published, start, &sx, &sy) || !_cell_at(published, goal, &gx, &gy))
+        return 0;
+
+    int start_cell = sy * published->width + sx;
+    int goal_cell = gy * published->width + gx;
+
+    struct ye_nav_cached_path *cached = _cache_find(start_cell, goal_cell);
+    if(cached != NULL)
+        return _to_points(published, cached->cells, cached->count, start, goal, points, max_points);
+
+    int count;
+    int *cells = _search(published, start_cell, goal_cell, &count);
+    if(cells == NULL)
+        return 0;
+
+    int total = _to_points(published, cells, count, start, goal, points, max_points);
+    _cache_insert(start_cell, goal_cell, cells, count);
+    return total;
+}
+
+unsigned int ye_nav_request_path(struct ye_vec2f start, struct ye_vec2f goal, ye_nav_callback callback, void *data){
+    _publish();
+
+    struct ye_nav_request *request = calloc(1, sizeof(struct ye_nav_request));
+    request->id = next_request_id++;
+    if(next_request_id == 0)
+        next_request_id = 1;
+    request->start_point = start;
+    request->goal_point = goal;
+    request->callback = callback;
+    request->data = data;
+    HASH_ADD(hh, live, id, sizeof(unsigned int), request);
+
+    int sx, sy, gx, gy;
+    if(published == NULL || !_cell_at(published, start, &sx, &sy) || !_cell_at(published, goal, &gx, &gy)){
+        _finish(request); // nothing to search, it is delivered as not found
+        return request->id;
+    }
+
+    request->start = sy * published->width + sx;
+    request->goal = gy * published->width + gx;
+    request->grid = _grid_retain(published);
+
+    // answered from the cache (or unreachable), skip the workers
+    struct ye_nav_cached_path *cached = _cache_find(request->start, request->goal);
+    if(cached != NULL || published->region[request->start] < 0 || published->region[request->start] != published->region[request->goal]){
+        if(cached != NULL){
+            request->cells = malloc(sizeof(int) * cached->count);
+            memcpy(request->cells, cached->cells, sizeof(int) * cached->count);
+            request->count = cached->count;
+        }
+        _finish(request);
+        return request->id;
+    }
+
+    ye_job_submit(_search_job, request, &searches);
+    return request->id;
+}
+
+void ye_nav_cancel(unsigned int request){
+    struct ye_nav_request *found = NULL;
+    HASH_FIND(hh, live, &request, sizeof(unsigned int), found);
+    if(found != NULL)
+        found->cancelled = true;
+}
+
+void ye_system_navigation(){
+    _publish();
+
+    SDL_LockMutex(finished_lock);
+    struct ye_nav_request *request = finished_head;
+    finished_head = finished_tail = NULL;
+    SDL_UnlockMutex(finished_lock);
+
+    while(request != NULL){
+        struct ye_nav_request *next = request->next;
+        HASH_DEL(live, request);
+
+        struct ye_nav_path path = { request->cells != NULL, NULL, 0 };
+        if(path.found){
+            int total = _to_points(request->grid, request->cells, request->count, request->start_point, request->goal_point, NULL, 0);
+            if(total > delivery_capacity){
+                delivery_capacity = total * 2;
+                delivery_points = realloc(delivery_points, sizeof(struct ye_vec2f) * delivery_capacity);
+            }
+            path.count = _to_points(request->grid, request->cells, request->count, request->start_point, request->goal_point, delivery_points, delivery_capacity);
+            path.points = delivery_points;
+        }
+
+        if(!request->cancelled && request->callback != NULL)
+            request->callback(request->id, &path, request->data);
+
+        // only keep it if the grid has not changed since it was searched
+        if(path.found && published != NULL && request->grid == published)
+            _cache_insert(request->start, request->goal, request->cells, request->count);
+        else
+            free(request->cells);
+
+        _grid_release(request->grid);
+        free(request);
+        request = next;
+    }
+}
+
+void ye_shutdown_navigation(){
+    if(finished_lock == NULL)
+        return;
+
+    ye_job_wait(&searches);
+
+    struct ye_nav_request *request = finished_head;
+    while(request != NULL){
+        struct ye_nav_request *next = request->next;
+        HASH_DEL(live, request);
+        free(request->cells);
+        _grid_release(request->grid);
+        free(request);
+        request = next;
+    }
+    finished_head = finished_tail = NULL;
+
+    ye_nav_clear();
+    free(delivery_points);
+    delivery_points = NULL;
+    delivery_capacity = 0;
+
+    SDL_DestroyMutex(finished_lock);
+    finished_lock = NULL;
+}
@@ -5,20 +5,33 @@
     Licensed under the MIT license. See LICENSE file in the project root for details.
 */
 
+#include <stdbool.h>
+
 #include <SDL_net.h>
 
 #include <yoyoengine/logging.h>
 
+// most games never touch the network, so SDL_net starts on first use
+static bool initialized = false;
+
 void ye_init_networking() {
+    if (initialized)
+        return;
+
     if (SDLNet_Init() < 0) {
         ye_logf(error,"Failed to initialize networking: %s\n", SDLNet_GetError());
         exit(1);
     }
+    initialized = true;
     ye_logf(info,"Initialized networking.\n");
 }
 
 void ye_shutdown_networking() {
+    if (!initialized)
+        return;
+
     // normal shutdown
     SDLNet_Quit();
+    initialized = false;
     ye_logf(info,"Shut down networking.\n");
 }
\ No newline at end of file
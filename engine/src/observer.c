@@ -0,0 +1,240 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <yoyoengine/utils.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
+#include <yoyoengine/ecs/physics.h>
+#include <yoyoengine/ecs/collider.h>
+
+struct ye_observer {
+    unsigned int id;
+    int component;
+    int kinds;
+    int entity_id;      // -1 for every entity
+    void (*callback)(const struct ye_change *change, void *data);   // NULL once unobserved
+    void *data;
+};
+
+struct ye_change_buffer {
+    struct ye_change *changes;
+    int count;
+    int capacity;
+};
+
+static struct ye_observer *observers = NULL;
+static int observer_count = 0;
+static int observer_capacity = 0;
+static unsigned int next_id = 1;
+
+// the kinds someone observes per component type, so unobserved changes are never recorded
+static int watched[YE_COMPONENT_TYPE_COUNT];
+
+/*
+    Changes are recorded into pending. A dispatch swaps pending with delivering first,
+    so anything recorded while observers run waits for the next dispatch.
+*/
+static struct ye_change_buffer pending[YE_COMPONENT_TYPE_COUNT];
+static struct ye_change_buffer delivering[YE_COMPONENT_TYPE_COUNT];
+
+static bool dispatching = false;
+static bool observers_dirty = false; // some observers were stopped during a dispatch
+
+static void _update_watched(){
+    memset(watched, 0, sizeof(watched));
+    for(int i = 0; i < observer_count; i++){
+        if(observers[i].callback != NULL)
+            watched[observers[i].component] |= observers[i].kinds;
+    }
+}
+
+// removes stopped observers, only outside of a dispatch so indices stay valid while it runs
+static void _compact(){
+    int kept = 0;
+    for(int i = 0; i < observer_count; i++){
+        if(observers[i].callback != NULL)
+            observers[kept++] = observers[i];
+    }
+    observer_count = kept;
+    observers_dirty = false;
+}
+
+static void _stop(int index){
+    observers[index].callback = NULL;
+    observers_dirty = true;
+}
+
+unsigned int ye_observe(int component, int kinds, struct ye_entity *entity, void (*callback)(const struct ye_change *change, void *data), void *data){
+    if(component < 0 || component >= YE_COMPONENT_TYPE_COUNT || kinds == 0 || callback == NULL){
+        ye_logf(error, "Tried to register an observer without a valid component, kinds or callback.\n");
+        return 0;
+    }
+
+    if(observers_dirty && !dispatching)
+        _compact();
+
+    if(observer_count == observer_capacity){
+        observer_capacity = observer_capacity > 0 ? observer_capacity * 2 : 32;
+        observers = realloc(observers, sizeof(struct ye_observer) * observer_capacity);
+    }
+
+    unsigned int id = next_id++;
+    if(next_id == 0)
+        next_id = 1;
+
+    observers[observer_count++] = (struct ye_observer){
+        .id = id,
+        .component = component,
+        .kinds = kinds,
+        .entity_id = entity != NULL ? entity->id : -1,
+        .callback = callback,
+        .data = data,
+    };
+    watched[component] |= kinds;
+    return id;
+}
+
+bool ye_unobserve(unsigned int observer){
+    for(int i = 0; i < observer_count; i++){
+        if(observers[i].id == observer && observers[i].callback != NULL){
+            _stop(i);
+            _update_watched();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ye_observer_record(struct ye_entity *entity, int component, enum ye_observe_kind kind){
+    if(!(watched[component] & kind))
+        return;
+
+    // one modification per component per dispatch is enough
+    if(kind == YE_OBSERVE_MODIFIED){
+        if(entity->modified & YE_COMPONENT_BIT(component))
+            return;
+        entity->modified |= YE_COMPONENT_BIT(component);
+    }
+
+    struct ye_change_buffer *buffer = &pending[component];
+    if(buffer->count == buffer->capacity){
+        buffer->capacity = buffer->capacity > 0 ? buffer->capacity * 2 : 64;
+        buffer->changes = realloc(buffer->changes, sizeof(struct ye_change) * buffer->capacity);
+    }
+    buffer->changes[buffer->count++] = (struct ye_change){entity, entity->id, component, kind};
+}
+
+void ye_component_modified(struct ye_entity *entity, int component){
+    if(entity == NULL || component < 0 || component >= YE_COMPONENT_TYPE_COUNT)
+        return;
+
+    // the broadphase caches where static colliders are
+    if((component == YE_COMPONENT_TRANSFORM || component == YE_COMPONENT_COLLIDER)
+        && entity->collider != NULL && ye_collider_body(entity) == YE_COLLIDER_BODY_STATIC)
+        ye_physics_invalidate_static();
+
+    // a sleeping body that was moved or given velocity has to be simulated again
+    if((component == YE_COMPONENT_TRANSFORM || component == YE_COMPONENT_PHYSICS) && entity->physics != NULL)
+        ye_physics_wake(entity);
+    ye_observer_record(entity, component, YE_OBSERVE_MODIFIED);
+}
+
+static void _forget_in(struct ye_change_buffer *buffers, struct ye_entity *entity){
+    for(int t = 0; t < YE_COMPONENT_TYPE_COUNT; t++){
+        for(int i = 0; i < buffers[t].count; i++){
+            if(buffers[t].changes[i].entity == entity)
+                buffers[t].changes[i].entity = NULL;
+        }
+    }
+}
+
+void ye_observer_forget_entity(struct ye_entity *entity){
+    // the pointer can be handed out again, pending changes keep only the id
+    _forget_in(pending, entity);
+    if(dispatching)
+        _forget_in(delivering, entity);
+
+    bool stopped = false;
+    for(int i = 0; i < observer_count; i++){
+        if(observers[i].callback != NULL && observers[i].entity_id == entity->id){
+            _stop(i);
+            stopped = true;
+        }
+    }
+    if(stopped)
+        _update_watched();
+}
+
+void ye_system_observers(){
+    if(dispatching)
+        return;
+
+    bool any = false;
+    for(int t = 0; t < YE_COMPONENT_TYPE_COUNT; t++){
+        struct ye_change_buffer swap = delivering[t];
+        delivering[t] = pending[t];
+        pending[t] = swap;
+
+        // modifications after this point are new ones
+        for(int i = 0; i < delivering[t].count; i++){
+            struct ye_change *change = &delivering[t].changes[i];
+            if(change->kind == YE_OBSERVE_MODIFIED && change->entity != NULL)
+                change->entity->modified &= ~YE_COMPONENT_BIT(t);
+        }
+        any |= delivering[t].count > 0;
+    }
+    if(!any)
+        return;
+
+    dispatching = true;
+    for(int t = 0; t < YE_COMPONENT_TYPE_COUNT; t++){
+        // observers registered during the dispatch start with the next one
+        int count = observer_count;
+
+        for(int i = 0; i < delivering[t].count; i++){
+            // copied, a callback destroying the entity rewrites the buffer entry
+            struct ye_change change = delivering[t].changes[i];
+
+            for(int o = 0; o < count; o++){
+                struct ye_observer observer = observers[o];
+                if(observer.callback == NULL || observer.component != t || !(observer.kinds & change.kind))
+                    continue;
+                if(observer.entity_id >= 0 && observer.entity_id != change.entity_id)
+                    continue;
+
+                // an earlier callback this round may have destroyed it
+                change.entity = delivering[t].changes[i].entity;
+                if(change.entity == NULL && change.kind != YE_OBSERVE_REMOVED)
+                    break;
+
+                observer.callback(&change, observer.data);
+            }
+        }
+        delivering[t].count = 0;
+    }
+    dispatching = false;
+
+    if(observers_dirty)
+        _compact();
+}
+
+void ye_shutdown_observers(){
+    for(int t = 0; t < YE_COMPONENT_TYPE_COUNT; t++){
+        free(pending[t].changes);
+        free(delivering[t].changes);
+        pending[t] = (struct ye_change_buffer){0};
+        delivering[t] = (struct ye_change_buffer){0};
+    }
+    free(observers);
+    observers = NULL;
+    observer_count = observer_capacity = 0;
+    observers_dirty = false;
+    memset(watched, 0, sizeof(watched));
+}
@@ -12,13 +12,17 @@
 #include <jansson.h>
 
 #include <yoyoengine/yep.h>
+#include <yoyoengine/jobs.h>
 #include <yoyoengine/json.h>
 #include <yoyoengine/scene.h>
 #include <yoyoengine/event.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/cache.h>
 #include <yoyoengine/audio.h>
 #include <yoyoengine/utils.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/navigation.h>
+#include <yoyoengine/scene_profiler.h>
 #include <yoyoengine/ecs/tag.h>
 #include <yoyoengine/ecs/camera.h>
 #include <yoyoengine/ecs/button.h>
@@ -424,7 +428,29 @@ void ye_construct_collider(struct ye_entity* e, json_t* collider, const char* en
         relative = true;
     }
     e->collider->relative = relative;
+
+    // body type, older scenes dont have it and resolve it automatically
+    int body = YE_COLLIDER_BODY_AUTO;
+    if(ye_json_has_key(collider,"body") && ye_json_int(collider,"body",&body))
+        ye_collider_set_body(e,(enum ye_collider_body)body);
         
+    // layer, either its index or its name from the scene physics settings
+    json_t *layer = json_object_get(collider,"layer");
+    if(json_is_integer(layer)){
+        int index = (int)json_integer_value(layer);
+        if(index < 0 || index >= YE_PHYSICS_MAX_LAYERS)
+            ye_logf(warning,"Entity %s has a collider on out of range layer %d\n", entity_name, index);
+        else
+            e->collider->layer = index;
+    }
+    else if(json_is_string(layer)){
+        int index = ye_physics_layer_index(json_string_value(layer));
+        if(index < 0)
+            ye_logf(warning,"Entity %s has a collider on unknown layer \"%s\"\n", entity_name, json_string_value(layer));
+        else
+            e->collider->layer = index;
+    }
+
     // update active state
     if(ye_json_has_key(collider,"active")){
         bool active = true;    ye_json_bool(collider,"active",&active);
@@ -432,6 +458,104 @@ void ye_construct_collider(struct ye_entity* e, json_t* collider, const char* en
     }
 }
 
+/*
+    The optional physics settings of a scene:
+    "physics":{
+        "layers": ["default", "player", "bullet", "pickup"],
+        "collides with":{
+            "bullet": ["default", "player"],
+            "pickup": ["player"]
+        }
+    }
+    Layers are numbered in the order they are listed. A layer missing from "collides with" interacts
+    with everything, and two layers only interact if neither one's list leaves the other out.
+*/
+static void _ye_construct_physics_settings(json_t *scene){
+    ye_physics_reset_layers();
+
+    json_t *physics = NULL;
+    if(!ye_json_has_key(scene,"physics") || !ye_json_object(scene,"physics",&physics))
+        return;
+
+    json_t *layers = NULL;
+    if(ye_json_has_key(physics,"layers") && ye_json_array(physics,"layers",&layers)){
+        for(int i = 0; i < (int)json_array_size(layers) && i < YE_PHYSICS_MAX_LAYERS; i++){
+            const char *name = NULL;
+            if(ye_json_arr_string(layers,i,&name))
+                ye_physics_set_layer_name(i,name);
+        }
+    }
+
+    json_t *matrix = NULL;
+    if(!ye_json_has_key(physics,"collides with") || !ye_json_object(physics,"collides with",&matrix))
+        return;
+
+    const char *key;
+    json_t *list;
+    json_object_foreach(matrix, key, list){
+        int a = ye_physics_layer_index(key);
+        if(a < 0 || !json_is_array(list)){
+            ye_logf(warning,"Scene physics settings have an invalid \"collides with\" entry for \"%s\"\n", key);
+            continue;
+        }
+
+        uint32_t allowed = 0;
+        for(size_t i = 0; i < json_array_size(list); i++){
+            json_t *other = json_array_get(list,i);
+            int b = json_is_string(other) ? ye_physics_layer_index(json_string_value(other)) : -1;
+            if(b < 0)
+                ye_logf(warning,"Scene physics settings list an unknown layer under \"%s\"\n", key);
+            else
+                allowed |= YE_PHYSICS_LAYER_BIT(b);
+        }
+
+        for(int b = 0; b < YE_PHYSICS_MAX_LAYERS; b++){
+            if(!(allowed & YE_PHYSICS_LAYER_BIT(b)))
+                ye_physics_set_layers_interact(a,b,false);
+        }
+    }
+}
+
+/*
+    The optional navigation grid of a scene, blocked wherever there is a static collider:
+    "navigation":{
+        "cell size": 32,
+        "position": {"x": 0, "y": 0, "w": 4096, "h": 4096},
+        "layers": ["default"]
+    }
+    "layers" limits which colliders block cells, every layer does if it is left out.
+*/
+static void _ye_construct_navigation(json_t *scene){
+    json_t *navigation = NULL;
+    if(!ye_json_has_key(scene,"navigation") || !ye_json_object(scene,"navigation",&navigation)){
+        ye_nav_clear();
+        return;
+    }
+
+    float cell_size = 32;
+    if(ye_json_has_key(navigation,"cell size"))
+        ye_json_float(navigation,"cell size",&cell_size);
+
+    if(!ye_nav_build(ye_retrieve_position(navigation), cell_size)){
+        ye_nav_clear();
+        return;
+    }
+
+    uint32_t mask = 0;
+    json_t *layers = NULL;
+    if(ye_json_has_key(navigation,"layers") && ye_json_array(navigation,"layers",&layers)){
+        for(size_t i = 0; i < json_array_size(layers); i++){
+            json_t *layer = json_array_get(layers,i);
+            int index = json_is_string(layer) ? ye_physics_layer_index(json_string_value(layer)) : -1;
+            if(index < 0)
+                ye_logf(warning,"Scene navigation settings list an unknown layer\n");
+            else
+                mask |= YE_PHYSICS_LAYER_BIT(index);
+        }
+    }
+    ye_nav_block_colliders(mask);
+}
+
 void ye_construct_script(struct ye_entity* e, json_t* script, const char* entity_name){
     // validate script field
     const char *script_path = NULL;
@@ -584,6 +708,46 @@ void ye_construct_button(struct ye_entity* e, json_t* button, const char* entity
     ===================================================================
 */
 
+/*
+    Component keys in the order they are constructed, matched once per entity
+*/
+enum ye_scene_component_key {
+    YE_SCENE_COMPONENT_TRANSFORM,
+    YE_SCENE_COMPONENT_CAMERA,
+    YE_SCENE_COMPONENT_RENDERER,
+    YE_SCENE_COMPONENT_PHYSICS,
+    YE_SCENE_COMPONENT_TAG,
+    YE_SCENE_COMPONENT_COLLIDER,
+    YE_SCENE_COMPONENT_SCRIPT,
+    YE_SCENE_COMPONENT_AUDIOSOURCE,
+    YE_SCENE_COMPONENT_BUTTON,
+    YE_SCENE_COMPONENT_COUNT
+};
+
+static struct ye_json_key component_keys[YE_SCENE_COMPONENT_COUNT] = {
+    YE_JSON_KEY("transform"),
+    YE_JSON_KEY("camera"),
+    YE_JSON_KEY("renderer"),
+    YE_JSON_KEY("physics"),
+    YE_JSON_KEY("tag"),
+    YE_JSON_KEY("collider"),
+    YE_JSON_KEY("script"),
+    YE_JSON_KEY("audiosource"),
+    YE_JSON_KEY("button"),
+};
+
+static void (*const component_constructors[YE_SCENE_COMPONENT_COUNT])(struct ye_entity*, json_t*, const char*) = {
+    ye_construct_transform,
+    ye_construct_camera,
+    ye_construct_renderer,
+    ye_construct_physics,
+    ye_construct_tag,
+    ye_construct_collider,
+    ye_construct_script,
+    ye_construct_audiosource,
+    ye_construct_button,
+};
+
 void ye_construct_scene(json_t *entities){
     /*
         traverse backwards (serialization is traversing LL,
@@ -618,145 +782,136 @@ void ye_construct_scene(json_t *entities){
         // check if components exist
         json_t *components = NULL; ye_json_object(entity,"components",&components);
 
-        // if we have transform on entity
-        if(ye_json_has_key(components,"transform")){
-            json_t *transform = NULL; ye_json_object(components,"transform",&transform);
-            ye_construct_transform(e,transform,entity_name);
+        // one pass over the keys the entity actually has, instead of probing for every component type
+        json_t *found[YE_SCENE_COMPONENT_COUNT] = {0};
+        const char *key; json_t *value;
+        json_object_foreach(components, key, value){
+            int index = ye_json_key_index(component_keys, YE_SCENE_COMPONENT_COUNT, key);
+            if(index >= 0)
+                found[index] = value;
         }
 
-        // if we have camera on entity
-        if(ye_json_has_key(components,"camera")){
-            json_t *camera = NULL; ye_json_object(components,"camera",&camera);
-            if(camera == NULL){
-                ye_logf(warning,"Entity %s has a renderer field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_camera(e,camera,entity_name);
-        }
-        
-        // if we have a renderer on our entity
-        if(ye_json_has_key(components,"renderer")){
-            json_t *renderer = NULL; ye_json_object(components,"renderer",&renderer);
-            if(renderer == NULL){
-                ye_logf(warning,"Entity %s has a renderer field, but it's invalid.\n", entity_name);
+        // construct in a fixed order (ex: renderers expect the transform to exist)
+        for(int c = 0; c < YE_SCENE_COMPONENT_COUNT; c++){
+            if(found[c] == NULL)
                 continue;
-            }
-            ye_construct_renderer(e,renderer,entity_name);
-        }
 
-        // if we have a physics component on our entity
-        if(ye_json_has_key(components,"physics")){
-            json_t *physics = NULL; ye_json_object(components,"physics",&physics);
-            if(physics == NULL){
-                ye_logf(warning,"Entity %s has a physics field, but it's invalid.\n", entity_name);
-                continue;
+            if(!json_is_object(found[c])){
+                ye_logf(warning,"Entity %s has a %s field, but it's invalid.\n", entity_name, component_keys[c].name);
+                break;
             }
-            ye_construct_physics(e,physics,entity_name);
-        }
 
-        // if we have a tag component on our entity
-        if(ye_json_has_key(components,"tag")){
-            json_t *tag = NULL; ye_json_object(components,"tag",&tag);
-            if(tag == NULL){
-                ye_logf(warning,"Entity %s has a tag field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_tag(e,tag,entity_name);
+            uint64_t construct_start = ye_scene_profiler_now();
+            component_constructors[c](e,found[c],entity_name);
+            ye_scene_profiler_component(component_keys[c].name, construct_start);
         }
+    }
+}
 
-        // if we have a collider component on our entity
-        if(ye_json_has_key(components,"collider")){
-            json_t *collider = NULL; ye_json_object(components,"collider",&collider);
-            if(collider == NULL){
-                ye_logf(warning,"Entity %s has a collider field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_collider(e,collider,entity_name);
-        }
+/*
+    The entry scene is parsed on a worker while the engine finishes starting up,
+    the load that asks for the same path picks up the parsed json.
+*/
+static struct {
+    char *path;
+    json_t *json;
+    struct ye_job_counter counter;
+} preload = {0};
+
+static void _ye_preload_job(void *data){
+    (void)data;
+    preload.json = ye_json_load_transient(preload.path);
+}
 
-        // script component
-        if(ye_json_has_key(components,"script")){
-            json_t *script = NULL; ye_json_object(components,"script",&script);
-            if(script == NULL){
-                ye_logf(warning,"Entity %s has a script field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_script(e,script,entity_name);
-        }
+void ye_preload_scene(const char *scene_path){
+    if(preload.path != NULL){
+        ye_logf(warning,"Already preloading %s, not preloading %s.\n", preload.path, scene_path);
+        return;
+    }
 
-        // if we have an audiosource
-        if(ye_json_has_key(components,"audiosource")){
-            json_t *audiosource = NULL; ye_json_object(components,"audiosource",&audiosource);
-            if(audiosource == NULL){
-                ye_logf(warning,"Entity %s has a audiosource field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_audiosource(e,audiosource,entity_name);
-        }
+    preload.path = ye_strdup(YE_MEM_SCENE, scene_path);
+    preload.json = NULL;
+    ye_job_submit(_ye_preload_job, NULL, &preload.counter);
+}
 
-        // button comp
-        if(ye_json_has_key(components,"button")){
-            json_t *button = NULL; ye_json_object(components,"button",&button);
-            if(button == NULL){
-                ye_logf(warning,"Entity %s has a button field, but it's invalid.\n", entity_name);
-                continue;
-            }
-            ye_construct_button(e,button,entity_name);
-        }
+bool ye_scene_preload_ready(){
+    return preload.path == NULL || ye_job_done(&preload.counter);
+}
+
+// takes the preloaded json if it is for scene_path (NULL takes nothing), dropping the preload either way
+static json_t * _ye_take_preload(const char *scene_path){
+    if(preload.path == NULL)
+        return NULL;
+
+    if(!ye_job_done(&preload.counter))
+        ye_job_wait(&preload.counter);
+
+    json_t *json = preload.json;
+    if(scene_path == NULL || strcmp(preload.path, scene_path) != 0){
+        ye_json_release(json);
+        json = NULL;
     }
+
+    ye_free(preload.path);
+    preload.path = NULL;
+    preload.json = NULL;
+    return json;
 }
 
-void ye_load_scene(const char *scene_path){
+static void _ye_load_scene(const char *scene_path){
     // purge all non persistant events
     ye_purge_events(false);
 
-    // shutdown and restart audio subsystem TODO: do some soft reset instead
-    ye_shutdown_audio();
+    // stop all audio and free the old scene's chunks, the device stays open
+    uint64_t phase_start = ye_scene_profiler_now();
+    ye_reset_audio();
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_AUDIO, phase_start);
 
     // wipe the ecs so its ready to be populated (this will destroy and re-create editor entities, but the editor will best effort recreate and attach them)
+    phase_start = ye_scene_profiler_now();
     ye_purge_ecs();
 
     // wipe non persistant render entities (additional and debug)
     ye_debug_renderer_cleanup(false);
-
-    ye_init_audio();
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_PURGE_ECS, phase_start);
 
     /*
         If we are in editor mode, this scene file will be loaded from the loose resources dir, if runtime it will be packed
     */
     json_t *SCENE = NULL; 
-    if(YE_STATE.editor.editor_mode){
-        SCENE = ye_json_read(ye_path_resources(scene_path));
-    }
-    else{
-        SCENE = yep_resource_json(scene_path);
-    }
+    phase_start = ye_scene_profiler_now();
+    ye_json_arena_begin(); // the scene file (and styles, animation meta) only live until the load is done
+    SCENE = _ye_take_preload(scene_path);
+    if(SCENE == NULL)
+        SCENE = ye_json_load_transient(scene_path);
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_PARSE, phase_start);
 
     // try to open the scene file
     if(SCENE == NULL){
         ye_logf(error,"Failed to load scene %s\n", scene_path);
-        json_decref(SCENE);
+        ye_json_arena_end();
         return;
     }
 
     if(YE_STATE.runtime.scene_file_path != NULL)
-        free(YE_STATE.runtime.scene_file_path);
+        ye_free(YE_STATE.runtime.scene_file_path);
     
     // malloc new string for current scene file path and copy it over
-    YE_STATE.runtime.scene_file_path = malloc(strlen(scene_path)+1);
-    strcpy(YE_STATE.runtime.scene_file_path,scene_path);
+    YE_STATE.runtime.scene_file_path = ye_strdup(YE_MEM_SCENE, scene_path);
 
     // read some meta about the scene and check validity
     int scene_version;
     if(!ye_json_int(SCENE, "version", &scene_version)){
         ye_logf(error,"Scene \"%s\" has no version number\n", scene_path);
-        json_decref(SCENE);
+        ye_json_release(SCENE);
+        ye_json_arena_end();
         return;
     }
     // scene files are backwards compatible (for now) but obviously cant guarantee being forwards compatible
     if(scene_version > YE_ENGINE_SCENE_VERSION){
         ye_logf(error,"Scene \"%s\" has version %d, but the engine only supports up to version %d\n", scene_path, scene_version, YE_ENGINE_SCENE_VERSION);
-        json_decref(SCENE);
+        ye_json_release(SCENE);
+        ye_json_arena_end();
         return;
     }
 
@@ -766,34 +921,49 @@ void ye_load_scene(const char *scene_path){
     }
     else{
         if(YE_STATE.runtime.scene_name != NULL)
-            free(YE_STATE.runtime.scene_name);
-        YE_STATE.runtime.scene_name = strdup(scene_name);
+            ye_free(YE_STATE.runtime.scene_name);
+        YE_STATE.runtime.scene_name = ye_strdup(YE_MEM_SCENE, scene_name);
         ye_logf(info,"Loaded scene: %s\n", scene_name);
     }
 
     // pre cache all of its colors, fonts (TODO: thread this?)
+    phase_start = ye_scene_profiler_now();
     json_t *styles; ye_json_array(SCENE, "styles", &styles);
     // cache each styles file in array
     for(int i = 0; i < json_array_size(styles); i++){
         const char *path; ye_json_arr_string(styles, i, &path);
         ye_pre_cache_styles(path);
     }
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_STYLES, phase_start);
 
     // pre cache all of a scenes assets (TODO: thread this?)
+    phase_start = ye_scene_profiler_now();
     json_t *scene = NULL; ye_json_object(SCENE, "scene", &scene);
     ye_pre_cache_scene(scene); // lowercase scene is the actual key
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_PRE_CACHE, phase_start);
 
     // construct all entities and components
     json_t *entities = NULL;
     ye_json_array(scene,"entities",&entities);
     if(entities == NULL){
         ye_logf(error,"%s","Failed to read entities from scene.\n");
+        ye_json_release(SCENE);
+        ye_json_arena_end();
         return;
     }
 
-    // construct scene
+    // construct scene (layers first, colliders can refer to them by name)
+    phase_start = ye_scene_profiler_now();
+    _ye_construct_physics_settings(scene);
     ye_construct_scene(entities);
 
+    // bucket the static colliders now, rather than on the first physics step
+    ye_physics_build_broadphase();
+    _ye_construct_navigation(scene);
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_CONSTRUCT, phase_start);
+
+    phase_start = ye_scene_profiler_now();
+
     // check if the scene has a default camera and set it if so, if not log error
     const char* default_camera_name = NULL;
     if(!ye_json_string(scene,"default camera",&default_camera_name)){
@@ -839,11 +1009,19 @@ void ye_load_scene(const char *scene_path){
         }
     }
 
-    // deref the scene file.
-    json_decref(SCENE);
+    // deref the scene file, freeing the arena. nothing may hold onto scene json past here
+    ye_json_release(SCENE);
+    ye_json_arena_end();
 
     // send a scene loaded callback
     ye_fire_event(YE_EVENT_SCENE_LOAD, (union ye_event_args){.scene_name = YE_STATE.runtime.scene_name});
+    ye_scene_profiler_phase(YE_SCENE_LOAD_PHASE_FINALIZE, phase_start);
+}
+
+void ye_load_scene(const char *scene_path){
+    ye_scene_profiler_begin(scene_path);
+    _ye_load_scene(scene_path);
+    ye_scene_profiler_end();
 }
 
 char *ye_get_scene_name(){
@@ -851,8 +1029,13 @@ char *ye_get_scene_name(){
 }
 
 void ye_shutdown_scene_manager(){
-    if(YE_STATE.runtime.scene_name != NULL)
-        free(YE_STATE.runtime.scene_name);
+    // a preload nobody loaded
+    _ye_take_preload(NULL);
+
+    ye_free(YE_STATE.runtime.scene_name);
+    YE_STATE.runtime.scene_name = NULL;
+    ye_free(YE_STATE.runtime.scene_file_path);
+    YE_STATE.runtime.scene_file_path = NULL;
 }
 
 void ye_reload_scene(){
@@ -876,14 +1059,14 @@ char *deferred_scene_handle = NULL;
 
 void ye_load_scene_deferred(const char *scene_path){
     if(deferred_scene_handle != NULL)
-        free(deferred_scene_handle);
-    deferred_scene_handle = strdup(scene_path);
+        ye_free(deferred_scene_handle);
+    deferred_scene_handle = ye_strdup(YE_MEM_SCENE, scene_path);
 }
 
 bool ye_scene_check_deferred_load(){
     if(deferred_scene_handle != NULL){
         ye_load_scene(deferred_scene_handle);
-        free(deferred_scene_handle);
+        ye_free(deferred_scene_handle);
         deferred_scene_handle = NULL;
         return true;
     }
@@ -0,0 +1,276 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+#include <jansson.h>
+#include <uthash/uthash.h>
+
+#ifdef _WIN32
+    #define NK_INCLUDE_FIXED_TYPES
+#endif
+
+#include <Nuklear/nuklear.h>
+
+#include <yoyoengine/json.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/scene_profiler.h>
+
+#define YE_SCENE_PROFILER_MAX_COMPONENT_TYPES 16
+
+static const char *phase_names[YE_SCENE_LOAD_PHASE_COUNT] = {
+    "audio", "purge_ecs", "parse", "styles", "pre_cache", "construct", "finalize"
+};
+
+static const char *stage_names[YE_ASSET_LOAD_STAGE_COUNT] = {
+    "read", "decompress", "decode", "upload"
+};
+
+struct ye_scene_profile_asset {
+    char *handle;
+    double ms[YE_ASSET_LOAD_STAGE_COUNT];
+    size_t bytes;
+    UT_hash_handle hh;
+};
+
+struct ye_scene_profile_component {
+    const char *type;   // always a string literal from the scene constructor
+    int count;
+    double ms;
+};
+
+/*
+    The profile is only ever touched by the thread running the load. Asset reads on workers (the
+    scene preload, audio) call in too, but this flag is per thread, so they return before reading
+    anything shared and are not counted.
+*/
+static _Thread_local bool profiling = false;
+
+static struct {
+    bool has_report;
+    char *scene;
+    uint64_t start;
+    double total_ms;
+    size_t bytes_read;
+    double phases[YE_SCENE_LOAD_PHASE_COUNT];
+    struct ye_scene_profile_component components[YE_SCENE_PROFILER_MAX_COMPONENT_TYPES];
+    int component_count;
+    struct ye_scene_profile_asset *assets;
+} profile = {0};
+
+static double _ms_since(uint64_t start){
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static double _asset_total(struct ye_scene_profile_asset *asset){
+    double total = 0;
+    for(int i = 0; i < YE_ASSET_LOAD_STAGE_COUNT; i++)
+        total += asset->ms[i];
+    return total;
+}
+
+// slowest assets first
+static int _asset_cmp(struct ye_scene_profile_asset *a, struct ye_scene_profile_asset *b){
+    double ta = _asset_total(a), tb = _asset_total(b);
+    return (ta < tb) - (ta > tb);
+}
+
+static void _clear_profile(){
+    struct ye_scene_profile_asset *asset, *tmp;
+    HASH_ITER(hh, profile.assets, asset, tmp){
+        HASH_DEL(profile.assets, asset);
+        free(asset->handle);
+        free(asset);
+    }
+    free(profile.scene);
+
+    memset(&profile, 0, sizeof(profile));
+}
+
+bool ye_scene_profiler_active(){
+    return profiling;
+}
+
+uint64_t ye_scene_profiler_now(){
+    if(!profiling)
+        return 0;
+    return SDL_GetPerformanceCounter();
+}
+
+void ye_scene_profiler_begin(const char *scene_path){
+    _clear_profile();
+    profile.scene = strdup(scene_path);
+    profiling = true;
+    profile.start = SDL_GetPerformanceCounter();
+}
+
+void ye_scene_profiler_phase(enum ye_scene_load_phase phase, uint64_t start){
+    if(!profiling || phase < 0 || phase >= YE_SCENE_LOAD_PHASE_COUNT)
+        return;
+    profile.phases[phase] += _ms_since(start);
+}
+
+void ye_scene_profiler_component(const char *type, uint64_t start){
+    if(!profiling)
+        return;
+
+    double ms = _ms_since(start);
+
+    for(int i = 0; i < profile.component_count; i++){
+        if(strcmp(profile.components[i].type, type) == 0){
+            profile.components[i].count++;
+            profile.components[i].ms += ms;
+            return;
+        }
+    }
+
+    if(profile.component_count >= YE_SCENE_PROFILER_MAX_COMPONENT_TYPES)
+        return;
+
+    profile.components[profile.component_count].type = type;
+    profile.components[profile.component_count].count = 1;
+    profile.components[profile.component_count].ms = ms;
+    profile.component_count++;
+}
+
+void ye_scene_profiler_asset(const char *handle, enum ye_asset_load_stage stage, uint64_t start, size_t bytes){
+    if(!profiling || handle == NULL || stage < 0 || stage >= YE_ASSET_LOAD_STAGE_COUNT)
+        return;
+
+    double ms = _ms_since(start);
+
+    struct ye_scene_profile_asset *asset = NULL;
+    HASH_FIND_STR(profile.assets, handle, asset);
+    if(asset == NULL){
+        asset = calloc(1, sizeof(struct ye_scene_profile_asset));
+        asset->handle = strdup(handle);
+        HASH_ADD_KEYPTR(hh, profile.assets, asset->handle, strlen(asset->handle), asset);
+    }
+
+    asset->ms[stage] += ms;
+    asset->bytes += bytes;
+    profile.bytes_read += bytes;
+}
+
+json_t * ye_scene_profiler_report(){
+    if(!profile.has_report)
+        return NULL;
+
+    json_t *report = json_object();
+    json_object_set_new(report, "scene", json_string(profile.scene));
+    json_object_set_new(report, "total_ms", json_real(profile.total_ms));
+    json_object_set_new(report, "bytes_read", json_integer(profile.bytes_read));
+
+    json_t *phases = json_object();
+    for(int i = 0; i < YE_SCENE_LOAD_PHASE_COUNT; i++)
+        json_object_set_new(phases, phase_names[i], json_real(profile.phases[i]));
+    json_object_set_new(report, "phases", phases);
+
+    json_t *components = json_object();
+    for(int i = 0; i < profile.component_count; i++){
+        json_t *component = json_object();
+        json_object_set_new(component, "count", json_integer(profile.components[i].count));
+        json_object_set_new(component, "ms", json_real(profile.components[i].ms));
+        json_object_set_new(components, profile.components[i].type, component);
+    }
+    json_object_set_new(report, "components", components);
+
+    json_t *assets = json_array();
+    struct ye_scene_profile_asset *asset, *tmp;
+    HASH_ITER(hh, profile.assets, asset, tmp){
+        json_t *entry = json_object();
+        json_object_set_new(entry, "handle", json_string(asset->handle));
+        json_object_set_new(entry, "bytes", json_integer(asset->bytes));
+        for(int i = 0; i < YE_ASSET_LOAD_STAGE_COUNT; i++){
+            char key[32]; snprintf(key, sizeof(key), "%s_ms", stage_names[i]);
+            json_object_set_new(entry, key, json_real(asset->ms[i]));
+        }
+        json_array_append_new(assets, entry);
+    }
+    json_object_set_new(report, "assets", assets);
+
+    return report;
+}
+
+void ye_scene_profiler_end(){
+    if(!profiling)
+        return;
+
+    profile.total_ms = _ms_since(profile.start);
+    profiling = false;
+    profile.has_report = true;
+
+    HASH_SORT(profile.assets, _asset_cmp);
+
+    ye_logf(info, "Scene %s loaded in %.2fms (%d assets, %zu bytes read)\n",
+        profile.scene, profile.total_ms, HASH_COUNT(profile.assets), profile.bytes_read);
+
+    if(YE_STATE.engine.debug_mode){
+        json_t *report = ye_scene_profiler_report();
+        ye_json_write(ye_path("scene_load_profile.json"), report);
+        json_decref(report);
+    }
+}
+
+void ye_scene_profiler_overlay(struct nk_context *ctx){
+    if (nk_begin(ctx, "scene_load", nk_rect(10, 220, 320, 400),
+                    NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE)) {
+        nk_layout_row_dynamic(ctx, 25, 1);
+
+        if(!profile.has_report){
+            nk_label(ctx, "no scene loaded yet", NK_TEXT_LEFT);
+            nk_end(ctx);
+            return;
+        }
+
+        char str[128];
+        snprintf(str, sizeof(str), "%s: %.2fms", profile.scene, profile.total_ms);
+        nk_label(ctx, str, NK_TEXT_LEFT);
+        snprintf(str, sizeof(str), "bytes read: %zu", profile.bytes_read);
+        nk_label(ctx, str, NK_TEXT_LEFT);
+
+        if(nk_tree_push(ctx, NK_TREE_TAB, "phases", NK_MAXIMIZED)){
+            nk_layout_row_dynamic(ctx, 20, 1);
+            for(int i = 0; i < YE_SCENE_LOAD_PHASE_COUNT; i++){
+                snprintf(str, sizeof(str), "%s: %.2fms", phase_names[i], profile.phases[i]);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+            nk_tree_pop(ctx);
+        }
+
+        if(nk_tree_push(ctx, NK_TREE_TAB, "components", NK_MINIMIZED)){
+            nk_layout_row_dynamic(ctx, 20, 1);
+            for(int i = 0; i < profile.component_count; i++){
+                snprintf(str, sizeof(str), "%s x%d: %.2fms", profile.components[i].type, profile.components[i].count, profile.components[i].ms);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+            nk_tree_pop(ctx);
+        }
+
+        if(nk_tree_push(ctx, NK_TREE_TAB, "assets", NK_MINIMIZED)){
+            nk_layout_row_dynamic(ctx, 20, 1);
+            struct ye_scene_profile_asset *asset, *tmp;
+            HASH_ITER(hh, profile.assets, asset, tmp){
+                snprintf(str, sizeof(str), "%s: %.2fms (r%.1f z%.1f d%.1f u%.1f) %zuB",
+                    asset->handle, _asset_total(asset),
+                    asset->ms[YE_ASSET_LOAD_READ], asset->ms[YE_ASSET_LOAD_DECOMPRESS],
+                    asset->ms[YE_ASSET_LOAD_DECODE], asset->ms[YE_ASSET_LOAD_UPLOAD], asset->bytes);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+            nk_tree_pop(ctx);
+        }
+    }
+    nk_end(ctx);
+}
+
+void ye_shutdown_scene_profiler(){
+    _clear_profile();
+}
@@ -0,0 +1,461 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define NK_INCLUDE_FIXED_TYPES
+#endif
+
+#include <Nuklear/nuklear.h>
+
+#include <SDL.h>
+
+#include <yoyoengine/jobs.h>
+#include <yoyoengine/input.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/tricks.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/graphics.h>
+#include <yoyoengine/tween.h>
+#include <yoyoengine/observer.h>
+#include <yoyoengine/scheduler.h>
+#include <yoyoengine/navigation.h>
+#include <yoyoengine/ecs/physics.h>
+#include <yoyoengine/ecs/renderer.h>
+#include <yoyoengine/ecs/lua_script.h>
+#include <yoyoengine/ecs/audiosource.h>
+
+struct ye_system {
+    struct ye_system_desc desc;     // all strings are owned copies
+    struct ye_system_timing timing;
+    int stage;
+};
+
+static struct ye_system systems[YE_SYSTEM_MAX];
+static int system_count = 0;
+
+// system indices sorted by stage
+static int order[YE_SYSTEM_MAX];
+static int stage_starts[YE_SYSTEM_MAX + 1];
+static int stage_count = 0;
+static bool graph_dirty = true;
+static bool running = false;
+
+/*
+    Engine systems
+*/
+
+static void _input_system(void *data){
+    (void)data;
+    int input_time = SDL_GetTicks64();
+    /*
+        Let the input system handle the following:
+        - Send events to Nuklear
+        - Handle engine input events (terminal, resizing)
+        - Send callback to game C code
+        - Lookup events in mapping table and inform C and Lua
+    */
+    ye_system_input();
+    YE_STATE.runtime.input_time = SDL_GetTicks64() - input_time;
+}
+
+static void _physics_system(void *data){
+    (void)data;
+    int physics_time = SDL_GetTicks64();
+    ye_system_physics(); // TODO: decouple from framerate
+    YE_STATE.runtime.physics_time = SDL_GetTicks64() - physics_time;
+}
+
+static void _navigation_system(void *data){
+    (void)data;
+    ye_system_navigation();
+}
+
+static void _tricks_system(void *data){
+    (void)data;
+    ye_run_trick_updates();
+}
+
+static void _lua_system(void *data){
+    (void)data;
+    ye_system_lua_scripting();
+}
+
+static void _tween_system(void *data){
+    (void)data;
+    ye_system_tween();
+}
+
+static void _observers_system(void *data){
+    (void)data;
+    ye_system_observers();
+}
+
+static void _animation_system(void *data){
+    (void)data;
+    ye_system_animation();
+}
+
+static void _audiosource_system(void *data){
+    (void)data;
+    ye_system_audiosource();
+}
+
+static void _render_system(void *data){
+    (void)data;
+    ye_render_all();
+}
+
+/*
+    Registry
+*/
+
+static int _find(const char *name){
+    for(int i = 0; i < system_count; i++){
+        if(strcmp(systems[i].desc.name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void _free_system(struct ye_system *system){
+    free((char *)system->desc.name);
+    for(int i = 0; i < YE_SYSTEM_MAX_CONSTRAINTS; i++){
+        free((char *)system->desc.after[i]);
+        free((char *)system->desc.before[i]);
+    }
+}
+
+bool ye_register_system(struct ye_system_desc desc){
+    if(running){
+        ye_logf(error, "Systems can not be registered from inside a system (%s).\n", desc.name ? desc.name : "unnamed");
+        return false;
+    }
+    if(desc.name == NULL || desc.run == NULL){
+        ye_logf(error, "%s", "Tried to register a system without a name or run function.\n");
+        return false;
+    }
+
+    struct ye_system system = {0};
+    system.desc = desc;
+    system.desc.name = strdup(desc.name);
+    for(int i = 0; i < YE_SYSTEM_MAX_CONSTRAINTS; i++){
+        system.desc.after[i] = desc.after[i] ? strdup(desc.after[i]) : NULL;
+        system.desc.before[i] = desc.before[i] ? strdup(desc.before[i]) : NULL;
+    }
+
+    // replacing keeps the old registration order
+    int existing = _find(desc.name);
+    if(existing >= 0){
+        _free_system(&systems[existing]);
+        systems[existing] = system;
+    }
+    else{
+        if(system_count >= YE_SYSTEM_MAX){
+            ye_logf(error, "Could not register system %s, the limit of %d systems is reached.\n", desc.name, YE_SYSTEM_MAX);
+            _free_system(&system);
+            return false;
+        }
+        systems[system_count++] = system;
+    }
+
+    graph_dirty = true;
+    return true;
+}
+
+bool ye_unregister_system(const char *name){
+    if(running){
+        ye_logf(error, "Systems can not be unregistered from inside a system (%s).\n", name);
+        return false;
+    }
+
+    int index = _find(name);
+    if(index < 0)
+        return false;
+
+    _free_system(&systems[index]);
+    memmove(&systems[index], &systems[index + 1], sizeof(struct ye_system) * (system_count - index - 1));
+    system_count--;
+
+    graph_dirty = true;
+    return true;
+}
+
+/*
+    Graph
+*/
+
+static bool _conflicts(struct ye_system *a, struct ye_system *b){
+    return (a->desc.writes & (b->desc.reads | b->desc.writes)) || (b->desc.writes & a->desc.reads);
+}
+
+static void _serial_fallback(){
+    for(int i = 0; i < system_count; i++){
+        systems[i].stage = i;
+        order[i] = i;
+        stage_starts[i] = i;
+    }
+    stage_starts[system_count] = system_count;
+    stage_count = system_count;
+}
+
+static void _build_graph(){
+    static bool edges[YE_SYSTEM_MAX][YE_SYSTEM_MAX]; // edges[a][b]: a runs before b
+    memset(edges, 0, sizeof(edges));
+
+    for(int i = 0; i < system_count; i++){
+        for(int c = 0; c < YE_SYSTEM_MAX_CONSTRAINTS; c++){
+            const char *after = systems[i].desc.after[c];
+            const char *before = systems[i].desc.before[c];
+            if(after != NULL){
+                int j = _find(after);
+                if(j < 0) ye_logf(warning, "System %s wants to run after unknown system %s.\n", systems[i].desc.name, after);
+                else if(j != i) edges[j][i] = true;
+            }
+            if(before != NULL){
+                int j = _find(before);
+                if(j < 0) ye_logf(warning, "System %s wants to run before unknown system %s.\n", systems[i].desc.name, before);
+                else if(j != i) edges[i][j] = true;
+            }
+        }
+    }
+
+    // conflicting systems without an explicit order keep their registration order
+    for(int i = 0; i < system_count; i++){
+        for(int j = i + 1; j < system_count; j++){
+            if(!edges[i][j] && !edges[j][i] && _conflicts(&systems[i], &systems[j]))
+                edges[i][j] = true;
+        }
+    }
+
+    // kahn's algorithm, each system lands one stage after its latest dependency
+    int indegree[YE_SYSTEM_MAX] = {0};
+    for(int i = 0; i < system_count; i++){
+        systems[i].stage = 0;
+        for(int j = 0; j < system_count; j++)
+            if(edges[j][i]) indegree[i]++;
+    }
+
+    int queue[YE_SYSTEM_MAX];
+    int head = 0, tail = 0;
+    for(int i = 0; i < system_count; i++)
+        if(indegree[i] == 0) queue[tail++] = i;
+
+    while(head < tail){
+        int i = queue[head++];
+        for(int j = 0; j < system_count; j++){
+            if(!edges[i][j])
+                continue;
+            if(systems[j].stage < systems[i].stage + 1)
+                systems[j].stage = systems[i].stage + 1;
+            if(--indegree[j] == 0)
+                queue[tail++] = j;
+        }
+    }
+
+    if(tail < system_count){
+        ye_logf(error, "%s", "System ordering constraints contain a cycle, running every system in registration order.\n");
+        _serial_fallback();
+        return;
+    }
+
+    // counting sort by stage, stable so registration order is kept inside a stage
+    stage_count = 0;
+    for(int i = 0; i < system_count; i++)
+        if(systems[i].stage + 1 > stage_count) stage_count = systems[i].stage + 1;
+
+    int n = 0;
+    for(int stage = 0; stage < stage_count; stage++){
+        stage_starts[stage] = n;
+        for(int i = 0; i < system_count; i++)
+            if(systems[i].stage == stage) order[n++] = i;
+    }
+    stage_starts[stage_count] = n;
+
+    for(int i = 0; i < system_count; i++)
+        systems[i].timing.peak = 0;
+
+    ye_logf(debug, "Scheduled %d systems into %d stages.\n", system_count, stage_count);
+}
+
+/*
+    Execution
+*/
+
+static void _run_system(void *data){
+    struct ye_system *system = data;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    system->desc.run(system->desc.data);
+    float ms = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+
+    system->timing.last = ms;
+    system->timing.average = system->timing.average * 0.95f + ms * 0.05f;
+    if(ms > system->timing.peak)
+        system->timing.peak = ms;
+}
+
+static bool _should_run(struct ye_system *system){
+    return !YE_STATE.editor.editor_mode || (system->desc.flags & YE_SYSTEM_EDITOR);
+}
+
+void ye_run_systems(){
+    if(graph_dirty){
+        _build_graph();
+        graph_dirty = false;
+    }
+
+    running = true;
+    for(int stage = 0; stage < stage_count; stage++){
+        struct ye_job_counter counter = {0};
+
+        // hand off the worker safe systems first so they overlap with the main thread ones
+        for(int n = stage_starts[stage]; n < stage_starts[stage + 1]; n++){
+            struct ye_system *system = &systems[order[n]];
+            if(_should_run(system) && !(system->desc.flags & YE_SYSTEM_MAIN_THREAD))
+                ye_job_submit(_run_system, system, &counter);
+        }
+
+        for(int n = stage_starts[stage]; n < stage_starts[stage + 1]; n++){
+            struct ye_system *system = &systems[order[n]];
+            if(_should_run(system) && (system->desc.flags & YE_SYSTEM_MAIN_THREAD))
+                _run_system(system);
+        }
+
+        ye_job_wait(&counter);
+    }
+    running = false;
+}
+
+const struct ye_system_timing * ye_system_timing(const char *name){
+    int index = _find(name);
+    if(index < 0)
+        return NULL;
+    return &systems[index].timing;
+}
+
+void ye_each_system_timing(void (*fn)(const char *name, const struct ye_system_timing *timing, void *data), void *data){
+    for(int i = 0; i < system_count; i++){
+        if(_should_run(&systems[i]))
+            fn(systems[i].desc.name, &systems[i].timing, data);
+    }
+}
+
+void ye_scheduler_overlay(struct nk_context *ctx){
+    if (nk_begin(ctx, "systems", nk_rect(10, 320, 360, 300),
+                    NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE)) {
+        char str[256];
+
+        nk_layout_row_dynamic(ctx, 25, 1);
+        snprintf(str, sizeof(str), "%d systems, %d stages, %d workers", system_count, stage_count, ye_job_worker_count());
+        nk_label(ctx, str, NK_TEXT_LEFT);
+
+        nk_layout_row_dynamic(ctx, 20, 1);
+        for(int stage = 0; stage < stage_count; stage++){
+            snprintf(str, sizeof(str), "stage %d", stage);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+
+            for(int n = stage_starts[stage]; n < stage_starts[stage + 1]; n++){
+                struct ye_system *system = &systems[order[n]];
+                if(!_should_run(system))
+                    continue;
+                snprintf(str, sizeof(str), "  %s%s: %.2fms (avg %.2fms, peak %.2fms)", system->desc.name,
+                    system->desc.flags & YE_SYSTEM_MAIN_THREAD ? "" : " [worker]",
+                    system->timing.last, system->timing.average, system->timing.peak);
+                nk_label(ctx, str, NK_TEXT_LEFT);
+            }
+        }
+    }
+    nk_end(ctx);
+}
+
+void ye_init_scheduler(){
+    system_count = 0;
+    graph_dirty = true;
+
+    /*
+        The engine systems, in the order they used to be hardcoded in ye_process_frame.
+        Anything that calls out into C callbacks or lua can touch any component, so it claims all of them.
+    */
+    ye_register_system((struct ye_system_desc){
+        .name = "input", .run = _input_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD | YE_SYSTEM_EDITOR,
+    });
+
+    // physics fires trigger and collision callbacks into C and lua
+    ye_register_system((struct ye_system_desc){
+        .name = "physics", .run = _physics_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    // delivers finished path requests to C and lua callbacks
+    ye_register_system((struct ye_system_desc){
+        .name = "navigation", .run = _navigation_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    ye_register_system((struct ye_system_desc){
+        .name = "tricks", .run = _tricks_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    ye_register_system((struct ye_system_desc){
+        .name = "lua", .run = _lua_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    // after scripts, so tweens they start move on the same frame. completion fires C and lua callbacks
+    ye_register_system((struct ye_system_desc){
+        .name = "tween", .run = _tween_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    // the sync point for observers, once everything that changes components this frame has run
+    ye_register_system((struct ye_system_desc){
+        .name = "observers", .run = _observers_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD | YE_SYSTEM_EDITOR,
+    });
+
+    ye_register_system((struct ye_system_desc){
+        .name = "animation", .run = _animation_system,
+        .reads = YE_COMPONENT_BIT(YE_COMPONENT_RENDERER),
+        .writes = YE_COMPONENT_BIT(YE_COMPONENT_RENDERER),
+    });
+
+    // recycles finished mixer voices, which touches the audio cache and mixer state owned by the main thread
+    ye_register_system((struct ye_system_desc){
+        .name = "audiosource", .run = _audiosource_system,
+        .reads = YE_COMPONENT_BIT(YE_COMPONENT_TRANSFORM) | YE_COMPONENT_BIT(YE_COMPONENT_CAMERA) | YE_COMPONENT_BIT(YE_COMPONENT_AUDIOSOURCE),
+        .writes = YE_COMPONENT_BIT(YE_COMPONENT_AUDIOSOURCE),
+        .flags = YE_SYSTEM_MAIN_THREAD,
+    });
+
+    // the ui painted here (editor panels, game windows) can edit anything
+    ye_register_system((struct ye_system_desc){
+        .name = "render", .run = _render_system,
+        .reads = YE_COMPONENT_BITS_ALL, .writes = YE_COMPONENT_BITS_ALL,
+        .flags = YE_SYSTEM_MAIN_THREAD | YE_SYSTEM_EDITOR,
+    });
+}
+
+void ye_shutdown_scheduler(){
+    for(int i = 0; i < system_count; i++)
+        _free_system(&systems[i]);
+    system_count = 0;
+    stage_count = 0;
+    graph_dirty = true;
+}
@@ -8,11 +8,14 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <SDL.h>
+
 #include <lua.h>
 
 #include <yoyoengine/scene.h>
 #include <yoyoengine/logging.h>
 #include <yoyoengine/lua_api.h>
+#include <yoyoengine/lua_memory.h>
 #include <yoyoengine/ecs/renderer.h>
 
 // remove component
@@ -52,8 +55,11 @@ int lua_log(lua_State* L){
     return 0;
 }
 
-int lua_debug_quit(lua_State* L){ // TODO: removeme
-    exit(0);
+// asks the game to close the same way closing its window does
+int lua_exit_game(lua_State* L){
+    (void)L;
+    SDL_Event quit = { .type = SDL_QUIT };
+    SDL_PushEvent(&quit);
     return 0;
 }
 
@@ -89,6 +95,41 @@ int ye_lua_check_component_exists(lua_State* L){
     return 1;
 }
 
+/*
+    Returns a raw pointer to one of the entities components (or nil),
+    used by the lua runtime to create FFI views of components under LuaJIT
+*/
+int ye_lua_get_component_pointer(lua_State* L){
+    struct ye_entity * entity = lua_touserdata(L, 1);
+
+    if(entity == NULL){
+        ye_logf(error, "Tried to get component pointer on null entity.\n");
+        lua_pushnil(L);
+        return 1;
+    }
+
+    int comp_indx = lua_tointeger(L, 2);
+    void* components[] = {
+        entity->transform,
+        entity->renderer,
+        entity->camera,
+        entity->lua_script,
+        entity->button,
+        entity->physics,
+        entity->collider,
+        entity->tag,
+        entity->audiosource
+    };
+    int num_components = sizeof(components) / sizeof(components[0]);
+
+    if(comp_indx >= 0 && comp_indx < num_components && components[comp_indx] != NULL){
+        lua_pushlightuserdata(L, components[comp_indx]);
+    } else {
+        lua_pushnil(L);
+    }
+    return 1;
+}
+
 int ye_lua_check_renderer_component_type_exists(lua_State* L){
     struct ye_entity * entity = lua_touserdata(L, 1);
 
@@ -174,7 +215,9 @@ int ye_lua_remove_component(lua_State* L){
 void ye_register_lua_scripting_api(lua_State *state){
     // scattered fns
     lua_register(state, "log", lua_log);
-    // lua_register(state, "ye_debug_quit", lua_debug_quit);
+    lua_register(state, "exitGame", lua_exit_game);
+    lua_register(state, "ye_lua_memory_stats", ye_lua_memory_stats);
+    lua_register(state, "ye_lua_engine_memory_stats", ye_lua_engine_memory_stats);
 
     /*
         Entity
@@ -224,6 +267,9 @@ void ye_register_lua_scripting_api(lua_State *state){
     // check if component exists
     lua_register(state, "ye_lua_check_component_exists", ye_lua_check_component_exists);
 
+    // raw component pointer (for FFI views)
+    lua_register(state, "ye_lua_get_component_pointer", ye_lua_get_component_pointer);
+
     // check if renderer component type exists
     lua_register(state, "ye_lua_check_renderer_component_type_exists", ye_lua_check_renderer_component_type_exists);
 
@@ -244,4 +290,9 @@ void ye_register_lua_scripting_api(lua_State *state){
     ye_lua_scene_register(state);
     ye_lua_timer_register(state);
     ye_lua_input_register(state);
+    ye_lua_coroutine_register(state);
+    ye_lua_query_register(state);
+    ye_lua_navigation_register(state);
+    ye_lua_tween_register(state);
+    ye_lua_observer_register(state);
 }
\ No newline at end of file
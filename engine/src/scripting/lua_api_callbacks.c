@@ -12,6 +12,7 @@
 #include <lauxlib.h>
 
 #include <yoyoengine/logging.h>
+#include <yoyoengine/ecs/ecs.h>
 #include <yoyoengine/ecs/lua_script.h>
 
 bool ye_run_lua_callback(struct ye_component_lua_script *script, int callback_ref, const char *callback_name) {
@@ -203,17 +204,93 @@ void ye_run_lua_on_update(struct ye_component_lua_script *script) {
     }
 }
 
-// Function to create an entity table in Lua
-void create_entity_table(lua_State *L, void *entity) {
-    lua_newtable(L); // Create a new table
+/*
+    Entity proxies
+
+    Each script state keeps one Entity table per C entity in a weak valued registry table, so
+    callbacks and lookups hand back the same table instead of building a new one every time.
+    The entity pointer can be handed out again after the entity is destroyed, so destroying one
+    drops its proxy from every state (see ye_lua_forget_entity).
+*/
+
+#define YE_LUA_PROXY_CACHE "ye_entity_proxies"
+
+// pushes the proxy cache of L, creating it on first use
+static void _push_proxy_cache(lua_State *L) {
+    lua_getfield(L, LUA_REGISTRYINDEX, YE_LUA_PROXY_CACHE);
+    if(lua_istable(L, -1))
+        return;
+    lua_pop(L, 1);
 
-    // Set the _c_entity field
+    lua_newtable(L);
+
+    // proxies nothing else references can be collected, they are rebuilt on the next push
+    lua_newtable(L);
+    lua_pushstring(L, "v");
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+
+    lua_pushvalue(L, -1);
+    lua_setfield(L, LUA_REGISTRYINDEX, YE_LUA_PROXY_CACHE);
+}
+
+void ye_lua_push_entity(lua_State *L, struct ye_entity *entity) {
+    if(entity == NULL) {
+        lua_pushnil(L);
+        return;
+    }
+
+    _push_proxy_cache(L);
+    lua_pushlightuserdata(L, entity);
+    lua_rawget(L, -2);
+    if(lua_istable(L, -1)) {
+        lua_remove(L, -2); // the cache
+        return;
+    }
+    lua_pop(L, 1);
+
+    // the pointer goes in before the metatable, which would intercept it
+    lua_newtable(L);
     lua_pushlightuserdata(L, entity);
     lua_setfield(L, -2, "_c_entity");
 
-    // Set the metatable
-    luaL_getmetatable(L, "Entity_mt");
+    lua_getglobal(L, "Entity_mt");
     lua_setmetatable(L, -2);
+
+    // cache[entity] = proxy
+    lua_pushlightuserdata(L, entity);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, -4);
+
+    lua_remove(L, -2); // the cache
+}
+
+void ye_lua_forget_entity(struct ye_entity *entity) {
+    for(struct ye_entity_node *node = lua_script_list_head; node != NULL; node = node->next) {
+        lua_State *L = node->entity->lua_script->state;
+        if(L == NULL)
+            continue;
+
+        lua_getfield(L, LUA_REGISTRYINDEX, YE_LUA_PROXY_CACHE);
+        if(!lua_istable(L, -1)) {
+            lua_pop(L, 1);
+            continue;
+        }
+
+        lua_pushlightuserdata(L, entity);
+        lua_rawget(L, -2);
+        if(lua_istable(L, -1)) {
+            // a script still holding the proxy sees a nil entity instead of freed memory
+            lua_pushstring(L, "_c_entity");
+            lua_pushnil(L);
+            lua_rawset(L, -3);
+
+            lua_pushlightuserdata(L, entity);
+            lua_pushnil(L);
+            lua_rawset(L, -4);
+        }
+        lua_pop(L, 2);
+    }
 }
 
 // Function to print the Lua stack for debugging
@@ -240,54 +317,44 @@ void print_lua_stack(lua_State *L) {
     printf("\n");
 }
 
-void ye_run_lua_on_collision(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
-    if(script->has_on_collision) {
-        // get the onCollision function
-        lua_getglobal(script->state, "onCollision");
-        
-        // Check if the onCollision function exists and is callable
-        if (!lua_isfunction(script->state, -1)) {
-            ye_logf(error, "Invalid onCollision Lua function reference.\n");
-            lua_pop(script->state, 1);
-            return;
-        }
-
-        // Create and push the entity1 table
-        create_entity_table(script->state, entity1);
+// calls a global (collider, other) callback in a script, the caller checks it exists
+static void _run_lua_pair_callback(struct ye_component_lua_script *script, const char *name, struct ye_entity *entity1, struct ye_entity *entity2) {
+    lua_getglobal(script->state, name);
+    
+    // Check if the function exists and is callable
+    if (!lua_isfunction(script->state, -1)) {
+        ye_logf(error, "Invalid %s Lua function reference.\n", name);
+        lua_pop(script->state, 1);
+        return;
+    }
 
-        // Create and push the entity2 table
-        create_entity_table(script->state, entity2);
+    // Push the (cached) entity tables
+    ye_lua_push_entity(script->state, entity1);
+    ye_lua_push_entity(script->state, entity2);
 
-        // Call onCollision with the two entities
-        if (lua_pcall(script->state, 2, 0, 0) != LUA_OK) {
-            ye_logf(error, "Error calling function: %s\n", lua_tostring(script->state, -1));
-            lua_pop(script->state, 1); // Pop the error message
-        }
+    // Call it with the two entities
+    if (lua_pcall(script->state, 2, 0, 0) != LUA_OK) {
+        ye_logf(error, "Error calling function: %s\n", lua_tostring(script->state, -1));
+        lua_pop(script->state, 1); // Pop the error message
     }
 }
 
-void ye_run_lua_on_trigger_enter(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
-    if(script->has_on_trigger_enter) {
-        // get the onTriggerEnter function
-        lua_getglobal(script->state, "onTriggerEnter");
-        
-        // Check if the onTriggerEnter function exists and is callable
-        if (!lua_isfunction(script->state, -1)) {
-            ye_logf(error, "Invalid onTriggerEnter Lua function reference.\n");
-            lua_pop(script->state, 1);
-            return;
-        }
+void ye_run_lua_on_collision(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
+    if(script->has_on_collision)
+        _run_lua_pair_callback(script, "onCollision", entity1, entity2);
+}
 
-        // Create and push the entity1 table
-        create_entity_table(script->state, entity1);
+void ye_run_lua_on_collision_exit(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
+    if(script->has_on_collision_exit)
+        _run_lua_pair_callback(script, "onCollisionExit", entity1, entity2);
+}
 
-        // Create and push the entity2 table
-        create_entity_table(script->state, entity2);
+void ye_run_lua_on_trigger_enter(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
+    if(script->has_on_trigger_enter)
+        _run_lua_pair_callback(script, "onTriggerEnter", entity1, entity2);
+}
 
-        // Call onTriggerEnter with the two entities
-        if (lua_pcall(script->state, 2, 0, 0) != LUA_OK) {
-            ye_logf(error, "Error calling function: %s\n", lua_tostring(script->state, -1));
-            lua_pop(script->state, 1); // Pop the error message
-        }
-    }
-}
\ No newline at end of file
+void ye_run_lua_on_trigger_exit(struct ye_component_lua_script *script, struct ye_entity *entity1, struct ye_entity *entity2) {
+    if(script->has_on_trigger_exit)
+        _run_lua_pair_callback(script, "onTriggerExit", entity1, entity2);
+}
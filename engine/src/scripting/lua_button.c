@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/button.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -96,6 +97,8 @@ int ye_lua_button_modify(lua_State *L){
     // we are NOT allowed to modify whether or not a button is hovered, pressed, or clicked
     // TODO: any good reason to add this in the future?
 
+    ye_component_modified(ent, YE_COMPONENT_BUTTON);
+
     return 0;
 }
 
@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/camera.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -90,6 +91,8 @@ int ye_lua_camera_modify(lua_State *L){
         ent->camera->view_field.h = luaL_checknumber(L, 8);
     }
 
+    ye_component_modified(ent, YE_COMPONENT_CAMERA);
+
     return 0;
 }
 
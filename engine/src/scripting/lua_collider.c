@@ -5,12 +5,26 @@
     Licensed under the MIT license. See LICENSE file in the project root for details.
 */
 
+#include <string.h>
+
 #include <lua.h>
 
+#include <yoyoengine/ecs/physics.h>
 #include <yoyoengine/ecs/collider.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
+
+// indexed by enum ye_collider_body
+static const char *body_names[] = {"auto", "static", "kinematic", "dynamic"};
 
+static int _body_from_name(const char *name){
+    for(int i = 0; i < (int)(sizeof(body_names) / sizeof(body_names[0])); i++){
+        if(strcmp(body_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
 
 
 int ye_lua_create_static_collider(lua_State *L) {
@@ -68,8 +82,10 @@ int ye_lua_collider_query(lua_State *L){
     lua_pushnumber(L, ent->collider->rect.w);
     lua_pushnumber(L, ent->collider->rect.h);
     lua_pushboolean(L, ent->collider->is_trigger);
+    lua_pushinteger(L, ent->collider->layer);
+    lua_pushstring(L, body_names[ent->collider->body]);
 
-    return 7;
+    return 9;
 }
 
 int ye_lua_collider_modify(lua_State *L){
@@ -108,6 +124,29 @@ int ye_lua_collider_modify(lua_State *L){
         ent->collider->is_trigger = lua_toboolean(L, 8);
     }
 
+    // layer by index or by name
+    int layer = -1;
+    if(lua_type(L, 9) == LUA_TNUMBER)
+        layer = (int)lua_tointeger(L, 9);
+    else if(lua_type(L, 9) == LUA_TSTRING)
+        layer = ye_physics_layer_index(lua_tostring(L, 9));
+
+    if(layer >= 0 && layer < YE_PHYSICS_MAX_LAYERS)
+        ent->collider->layer = layer;
+    else if(!lua_isnoneornil(L, 9))
+        ye_logf(error, "could not set collider layer: unknown layer\n");
+
+    // body by name
+    if(lua_type(L, 10) == LUA_TSTRING){
+        int body = _body_from_name(lua_tostring(L, 10));
+        if(body >= 0)
+            ye_collider_set_body(ent, (enum ye_collider_body)body);
+        else
+            ye_logf(error, "could not set collider body: expected auto, static, kinematic or dynamic\n");
+    }
+
+    ye_component_modified(ent, YE_COMPONENT_COLLIDER);
+
     return 0;
 }
 
@@ -28,6 +28,12 @@ int ye_lua_ent_get_entity_named(lua_State *L) {
     return 1;
 }
 
+// (entity pointer) -> the Entity table this state keeps for it, or nil
+int ye_lua_entity_proxy(lua_State *L) {
+    ye_lua_push_entity(L, lua_islightuserdata(L, 1) ? lua_touserdata(L, 1) : NULL);
+    return 1;
+}
+
 int ye_lua_create_entity(lua_State *L) {
     int nargs = lua_gettop(L);
 
@@ -194,6 +200,7 @@ void ye_lua_entity_register(lua_State *L) {
     lua_register(L, "ye_lua_ent_get_entity_by_id", ye_lua_get_entity_by_id);
     lua_register(L, "ye_lua_ent_get_entity_by_tag", ye_lua_get_entity_by_tag);
     lua_register(L, "ye_lua_create_entity", ye_lua_create_entity);
+    lua_register(L, "ye_lua_entity_proxy", ye_lua_entity_proxy);
 
     // active
     lua_register(L, "ye_lua_ent_get_active", ye_lua_ent_get_active);
@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/lua_script.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -67,6 +68,8 @@ int ye_lua_lua_script_modify(lua_State *L){
         ye_add_lua_script_component(ent, lua_tostring(L, 3), NULL);
     }
 
+    ye_component_modified(ent, YE_COMPONENT_LUA_SCRIPT);
+
     return 0;
 }
 
@@ -0,0 +1,323 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #define NK_INCLUDE_FIXED_TYPES
+#endif
+
+#include <Nuklear/nuklear.h>
+
+#include <lua.h>
+
+#include <yoyoengine/memory.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/lua_memory.h>
+#include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/lua_script.h>
+
+/*
+    NOTE: lua states only ever run on the main thread, so the pools are not locked.
+*/
+
+static const size_t class_sizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, YE_LUA_POOL_MAX_BLOCK };
+#define YE_LUA_POOL_CLASSES ((int)(sizeof(class_sizes) / sizeof(class_sizes[0])))
+
+// maps (size + 15) / 16 to the smallest class that fits
+static int class_lookup[YE_LUA_POOL_MAX_BLOCK / 16 + 1];
+static bool class_lookup_built = false;
+
+struct ye_lua_free_block {
+    struct ye_lua_free_block *next;
+};
+
+struct ye_lua_slab {
+    struct ye_lua_slab *next;
+};
+
+struct ye_lua_pool {
+    struct ye_lua_free_block *free_list;
+    size_t free_count;
+    char *bump;         // next never used block in the current slab
+    char *bump_end;
+};
+
+static struct ye_lua_pool pools[YE_LUA_POOL_CLASSES];
+static struct ye_lua_slab *slabs = NULL;
+static size_t slab_count = 0;
+
+// keeps the block area of a slab aligned for any lua value
+#define YE_LUA_SLAB_HEADER ((sizeof(struct ye_lua_slab) + 15) & ~(size_t)15)
+
+static void _build_class_lookup(){
+    int cls = 0;
+    for(int i = 0; i <= YE_LUA_POOL_MAX_BLOCK / 16; i++){
+        while(class_sizes[cls] < (size_t)i * 16)
+            cls++;
+        class_lookup[i] = cls;
+    }
+    class_lookup_built = true;
+}
+
+static inline int _class_for(size_t size){
+    if(size > YE_LUA_POOL_MAX_BLOCK)
+        return -1;
+    return class_lookup[(size + 15) / 16];
+}
+
+static void * _pool_alloc(int cls){
+    struct ye_lua_pool *pool = &pools[cls];
+
+    if(pool->free_list != NULL){
+        struct ye_lua_free_block *block = pool->free_list;
+        pool->free_list = block->next;
+        pool->free_count--;
+        return block;
+    }
+
+    if(pool->bump == NULL || pool->bump + class_sizes[cls] > pool->bump_end){
+        struct ye_lua_slab *slab = ye_malloc(YE_MEM_LUA, YE_LUA_POOL_SLAB_SIZE);
+        if(slab == NULL)
+            return NULL;
+        slab->next = slabs;
+        slabs = slab;
+        slab_count++;
+
+        // whatever was left in the old slab is lost to this class, its never more than one block
+        pool->bump = (char *)slab + YE_LUA_SLAB_HEADER;
+        pool->bump_end = (char *)slab + YE_LUA_POOL_SLAB_SIZE;
+    }
+
+    void *block = pool->bump;
+    pool->bump += class_sizes[cls];
+    return block;
+}
+
+static void _pool_free(void *ptr, int cls){
+    struct ye_lua_free_block *block = ptr;
+    block->next = pools[cls].free_list;
+    pools[cls].free_list = block;
+    pools[cls].free_count++;
+}
+
+static void _free_block(void *ptr, size_t size){
+    int cls = _class_for(size);
+    if(cls < 0)
+        ye_free(ptr);
+    else
+        _pool_free(ptr, cls);
+}
+
+static void * _ye_lua_alloc(void *ud, void *ptr, size_t osize, size_t nsize){
+    struct ye_lua_memory *memory = ud;
+
+    // when ptr is NULL osize encodes the type of object being created, not a size
+    if(ptr == NULL)
+        osize = 0;
+
+    if(nsize == 0){
+        if(ptr != NULL){
+            _free_block(ptr, osize);
+            memory->used -= osize;
+            memory->blocks--;
+        }
+        return NULL;
+    }
+
+    // refuse to grow past the limit, lua raises a memory error in the script for us
+    if(nsize > osize && memory->limit > 0 && memory->used + (nsize - osize) > memory->limit){
+        if(memory->refused++ == 0)
+            ye_logf(warning, "A lua script hit its memory limit of %zu bytes.\n", memory->limit);
+        return NULL;
+    }
+
+    int old_cls = ptr != NULL ? _class_for(osize) : -1;
+    int new_cls = _class_for(nsize);
+    void *out = NULL;
+
+    if(ptr != NULL && old_cls >= 0 && old_cls == new_cls){
+        // still fits the same block
+        out = ptr;
+    }
+    else if(ptr != NULL && old_cls < 0 && new_cls < 0){
+        out = ye_realloc(YE_MEM_LUA, ptr, nsize);
+    }
+    else{
+        out = new_cls >= 0 ? _pool_alloc(new_cls) : ye_malloc(YE_MEM_LUA, nsize);
+        if(out != NULL && ptr != NULL){
+            memcpy(out, ptr, osize < nsize ? osize : nsize);
+            _free_block(ptr, osize);
+        }
+    }
+
+    if(out == NULL){
+        /*
+            Lua does not allow shrinking to fail. The old block is at least as big as
+            what was asked for, so hand it back (it will be freed into the smaller class later, which is safe).
+        */
+        if(ptr != NULL && nsize <= osize)
+            out = ptr;
+        else
+            return NULL;
+    }
+
+    if(ptr == NULL)
+        memory->blocks++;
+    if(nsize > osize){
+        memory->allocations++;
+        memory->allocated += nsize - osize;
+    }
+    memory->used = memory->used - osize + nsize;
+    if(memory->used > memory->peak)
+        memory->peak = memory->used;
+
+    return out;
+}
+
+// luaL_newstate installs the same thing, we lose it by creating the state ourselves
+static int _ye_lua_panic(lua_State *L){
+    ye_logf(error, "PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(L, -1));
+    return 0; // return to lua to abort
+}
+
+lua_State * ye_lua_new_state(struct ye_lua_memory *memory, size_t limit){
+    memset(memory, 0, sizeof(struct ye_lua_memory));
+    memory->limit = limit;
+
+#ifdef YE_LUAJIT
+    // LuaJIT on 64 bit refuses custom allocators
+    return luaL_newstate();
+#else
+    if(!class_lookup_built)
+        _build_class_lookup();
+
+    lua_State *L = lua_newstate(_ye_lua_alloc, memory);
+    if(L != NULL)
+        lua_atpanic(L, _ye_lua_panic);
+    return L;
+#endif
+}
+
+size_t ye_lua_memory_used(lua_State *L, struct ye_lua_memory *memory){
+#ifdef YE_LUAJIT
+    (void)memory;
+    if(L == NULL)
+        return 0;
+    return (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + (size_t)lua_gc(L, LUA_GCCOUNTB, 0);
+#else
+    (void)L;
+    return memory->used;
+#endif
+}
+
+int ye_lua_memory_stats(lua_State *L){
+    void *ud = NULL;
+    lua_Alloc alloc = lua_getallocf(L, &ud);
+
+#ifndef YE_LUAJIT
+    if(alloc == _ye_lua_alloc){
+        struct ye_lua_memory *memory = ud;
+        lua_pushinteger(L, (lua_Integer)memory->used);
+        lua_pushinteger(L, (lua_Integer)memory->allocations);
+        lua_pushinteger(L, (lua_Integer)memory->allocated);
+        return 3;
+    }
+#else
+    (void)alloc;
+#endif
+
+    // not one of our allocators, only the garbage collector knows anything
+    lua_pushinteger(L, (lua_Integer)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0));
+    lua_pushnil(L);
+    lua_pushnil(L);
+    return 3;
+}
+
+int ye_lua_engine_memory_stats(lua_State *L){
+    const char *name = lua_tostring(L, 1);
+    for(int i = 0; name != NULL && i < YE_MEM_TAG_COUNT; i++){
+        if(strcmp(ye_memory_tag_name(i), name) != 0)
+            continue;
+
+        struct ye_memory_stats stats = ye_memory_stats(i);
+        lua_pushinteger(L, (lua_Integer)stats.live_bytes);
+        lua_pushinteger(L, (lua_Integer)stats.live_allocs);
+        lua_pushinteger(L, (lua_Integer)stats.peak_bytes);
+        return 3;
+    }
+
+    lua_pushnil(L);
+    return 1;
+}
+
+void ye_lua_memory_pool_stats(size_t *reserved, size_t *unused){
+    size_t free_bytes = 0;
+    for(int i = 0; i < YE_LUA_POOL_CLASSES; i++){
+        free_bytes += pools[i].free_count * class_sizes[i];
+        if(pools[i].bump != NULL)
+            free_bytes += pools[i].bump_end - pools[i].bump;
+    }
+
+    if(reserved != NULL)
+        *reserved = slab_count * YE_LUA_POOL_SLAB_SIZE;
+    if(unused != NULL)
+        *unused = free_bytes;
+}
+
+void ye_lua_memory_overlay(struct nk_context *ctx){
+    if (nk_begin(ctx, "lua_memory", nk_rect(340, 10, 360, 300),
+                    NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE)) {
+        char str[256];
+
+        size_t reserved, unused;
+        ye_lua_memory_pool_stats(&reserved, &unused);
+
+        nk_layout_row_dynamic(ctx, 25, 1);
+        snprintf(str, sizeof(str), "pools: %zuKB reserved, %zuKB free", reserved / 1024, unused / 1024);
+        nk_label(ctx, str, NK_TEXT_LEFT);
+
+        size_t total = 0;
+        nk_layout_row_dynamic(ctx, 20, 1);
+        struct ye_entity_node *current = lua_script_list_head;
+        while(current != NULL){
+            struct ye_component_lua_script *script = current->entity->lua_script;
+            size_t used = ye_lua_memory_used(script->state, &script->memory);
+            total += used;
+
+            if(script->memory.limit > 0)
+                snprintf(str, sizeof(str), "%s (%s): %.1fKB / %.1fKB, peak %.1fKB%s", current->entity->name, script->script_handle,
+                    used / 1024.0, script->memory.limit / 1024.0, script->memory.peak / 1024.0, script->memory.refused > 0 ? " [LIMITED]" : "");
+            else
+                snprintf(str, sizeof(str), "%s (%s): %.1fKB, peak %.1fKB", current->entity->name, script->script_handle,
+                    used / 1024.0, script->memory.peak / 1024.0);
+            nk_label(ctx, str, NK_TEXT_LEFT);
+
+            current = current->next;
+        }
+
+        nk_layout_row_dynamic(ctx, 25, 1);
+        snprintf(str, sizeof(str), "total: %.1fKB", total / 1024.0);
+        nk_label(ctx, str, NK_TEXT_LEFT);
+    }
+    nk_end(ctx);
+}
+
+void ye_shutdown_lua_memory(){
+    struct ye_lua_slab *slab = slabs;
+    while(slab != NULL){
+        struct ye_lua_slab *next = slab->next;
+        ye_free(slab);
+        slab = next;
+    }
+    slabs = NULL;
+    slab_count = 0;
+    memset(pools, 0, sizeof(pools));
+}
@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/physics.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -41,8 +42,9 @@ int ye_lua_physics_query(lua_State *L){
     lua_pushnumber(L, ent->physics->velocity.x);
     lua_pushnumber(L, ent->physics->velocity.y);
     lua_pushnumber(L, ent->physics->rotational_velocity);
+    lua_pushboolean(L, ent->physics->sleeping);
 
-    return 4;
+    return 5;
 }
 
 int ye_lua_physics_modify(lua_State *L){
@@ -69,6 +71,13 @@ int ye_lua_physics_modify(lua_State *L){
         ent->physics->rotational_velocity = luaL_checknumber(L, 5);
     }
 
+    ye_component_modified(ent, YE_COMPONENT_PHYSICS);
+
+    // after the modification above, which wakes it
+    if(lua_isboolean(L, 6) && lua_toboolean(L, 6)){
+        ent->physics->sleeping = true;
+    }
+
     return 0;
 }
 
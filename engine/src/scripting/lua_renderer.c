@@ -9,9 +9,11 @@
 
 #include <lua.h>
 
+#include <yoyoengine/intern.h>
 #include <yoyoengine/ecs/renderer.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -108,9 +110,8 @@ int ye_lua_text_renderer_modify(lua_State *L){
     // font name
     if(lua_isstring(L, 3)){
         const char * font_name = luaL_checkstring(L, 3);
-        free(ent->renderer->renderer_impl.text->font_name);
-        ent->renderer->renderer_impl.text->font_name = malloc(strlen(font_name) + 1);
-        strcpy(ent->renderer->renderer_impl.text->font_name, font_name);
+        ye_intern_release(ent->renderer->renderer_impl.text->font_name);
+        ent->renderer->renderer_impl.text->font_name = ye_intern(font_name);
     }
 
     // font size
@@ -121,9 +122,8 @@ int ye_lua_text_renderer_modify(lua_State *L){
     // color name
     if(lua_isstring(L, 5)){
         const char * color_name = luaL_checkstring(L, 5);
-        free(ent->renderer->renderer_impl.text->color_name);
-        ent->renderer->renderer_impl.text->color_name = malloc(strlen(color_name) + 1);
-        strcpy(ent->renderer->renderer_impl.text->color_name, color_name);
+        ye_intern_release(ent->renderer->renderer_impl.text->color_name);
+        ent->renderer->renderer_impl.text->color_name = ye_intern(color_name);
     }
 
     // wrap width
@@ -134,6 +134,8 @@ int ye_lua_text_renderer_modify(lua_State *L){
     // reflect any changes made
     ye_update_renderer_component(ent);
 
+    ye_component_modified(ent, YE_COMPONENT_RENDERER);
+
     return 0;
 }
 
@@ -248,6 +250,8 @@ int ye_lua_tile_renderer_modify(lua_State *L){
     // reflect any changes made
     ye_update_renderer_component(ent);
 
+    ye_component_modified(ent, YE_COMPONENT_RENDERER);
+
     return 0;
 }
 
@@ -353,6 +357,8 @@ int ye_lua_animation_renderer_modify(lua_State *L){
     // reflect any changes made
     ye_update_renderer_component(ent);
 
+    ye_component_modified(ent, YE_COMPONENT_RENDERER);
+
     return 0;
 }
 
@@ -490,6 +496,8 @@ int ye_lua_renderer_modify(lua_State *L){
 
     // ye_update_renderer_component(ent);
 
+    ye_component_modified(ent, YE_COMPONENT_RENDERER);
+
     return 0;
 }
 
@@ -504,14 +512,15 @@ int ye_lua_image_renderer_modify(lua_State *L){
     // get the src
     if(lua_isstring(L, 2)){
         const char * path = luaL_checkstring(L, 2);
-        free(ent->renderer->renderer_impl.image->src);
-        ent->renderer->renderer_impl.image->src = malloc(strlen(path) + 1);
-        strcpy(ent->renderer->renderer_impl.image->src, path);
+        ye_intern_release(ent->renderer->renderer_impl.image->src);
+        ent->renderer->renderer_impl.image->src = ye_intern(path);
 
         // reload the image
         ye_update_renderer_component(ent);
     }
 
+    ye_component_modified(ent, YE_COMPONENT_RENDERER);
+
     return 0;
 }
 
@@ -8,8 +8,10 @@
 #include <stdbool.h>
 
 #include <lua.h>
+#include <lauxlib.h>
 
 #include <yoyoengine/audio.h>
+#include <yoyoengine/mixer.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
 
@@ -23,12 +25,27 @@
     info on number of channels playing, etc.
 */
 
+// looks up the bus named at idx, nil means the default
+static int _bus_arg(lua_State *L, int idx, int fallback) {
+    if(lua_isnoneornil(L, idx))
+        return fallback;
+
+    const char *name = lua_tostring(L, idx);
+    int bus = name != NULL ? ye_mixer_find_bus(name) : -1;
+    if(bus < 0){
+        ye_logf(warning, "Unknown audio bus \"%s\".\n", name ? name : "(not a string)");
+        return fallback;
+    }
+    return bus;
+}
+
 int ye_lua_audio_play_sound(lua_State *L) {
     const char *handle = lua_tostring(L, 1);
     int loops = lua_tointeger(L, 2);
     float volume_scale = lua_tonumber(L, 3);
+    int bus = _bus_arg(L, 4, YE_BUS_SFX);
 
-    ye_play_sound(handle, loops, volume_scale);
+    ye_play_sound_on_bus(handle, loops, volume_scale, bus);
 
     // ye_play_sound returns the channel assigned, but im going to drop it for now.
 
@@ -52,10 +69,52 @@ int ye_lua_audio_set_volume(lua_State *L) {
     return 0;
 }
 
+int ye_lua_audio_set_bus_volume(lua_State *L) {
+    int bus = _bus_arg(L, 1, -1);
+    float volume = lua_tonumber(L, 2);
+    ye_mixer_set_bus_gain(bus, volume);
+
+    return 0;
+}
+
+int ye_lua_audio_get_bus_volume(lua_State *L) {
+    int bus = _bus_arg(L, 1, -1);
+    if(bus < 0)
+        lua_pushnil(L);
+    else
+        lua_pushnumber(L, ye_mixer_get_bus_gain(bus));
+
+    return 1;
+}
+
+int ye_lua_audio_set_bus_lowpass(lua_State *L) {
+    int bus = _bus_arg(L, 1, -1);
+    float cutoff = lua_tonumber(L, 2);
+    ye_mixer_set_bus_lowpass(bus, cutoff);
+
+    return 0;
+}
+
+int ye_lua_audio_create_bus(lua_State *L) {
+    const char *name = luaL_checkstring(L, 1);
+    int parent = _bus_arg(L, 2, YE_BUS_MASTER);
+
+    int bus = ye_mixer_find_bus(name);
+    if(bus < 0)
+        bus = ye_mixer_create_bus(name, parent);
+
+    lua_pushboolean(L, bus >= 0);
+    return 1;
+}
+
 int ye_lua_audio_register(lua_State *L) {
     lua_register(L, "ye_audio_play_sound", ye_lua_audio_play_sound);
     lua_register(L, "ye_audio_play_music", ye_lua_audio_play_music);
     lua_register(L, "ye_audio_set_volume", ye_lua_audio_set_volume);
+    lua_register(L, "ye_audio_set_bus_volume", ye_lua_audio_set_bus_volume);
+    lua_register(L, "ye_audio_get_bus_volume", ye_lua_audio_get_bus_volume);
+    lua_register(L, "ye_audio_set_bus_lowpass", ye_lua_audio_set_bus_lowpass);
+    lua_register(L, "ye_audio_create_bus", ye_lua_audio_create_bus);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,506 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+
+#include <lua.h>
+
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Coroutine scheduler for lua scripts.
+
+    A coroutine is started from lua with startCoroutine(fn, ...). Whenever it calls
+    wait(seconds), waitFrames(n) or waitUntil(event) it yields a request back to us,
+    and we park it in one of three places:
+    - a min heap keyed on the tick it should wake at
+    - a min heap keyed on the frame it should wake at
+    - a flat list of coroutines waiting on a named signal or a predicate function
+
+    Each frame we only pop what is due off of the heaps, so sleeping coroutines cost nothing.
+    The coroutine thread is anchored in the registry once when it is started, and the
+    same ref is reused for every wait, so waiting never allocates on the C side (the
+    arrays below only grow, by doubling).
+*/
+
+// must match the YE_WAIT_* constants in lua_runtime/subsystems/coroutine.lua
+#define YE_LUA_WAIT_SECONDS 1
+#define YE_LUA_WAIT_FRAMES  2
+#define YE_LUA_WAIT_UNTIL   3
+
+#define YE_LUA_COROUTINE_MAX_EVENT_NAME 64
+#define YE_LUA_COROUTINE_MAX_DEPTH 32
+
+// registry key holding the main state a thread belongs to
+#define YE_LUA_COROUTINE_OWNER_KEY "ye_coroutine_owner"
+
+struct ye_lua_coroutine {
+    lua_State *owner;   // the scripts main state, NULL once the script is gone
+    lua_State *thread;
+    int ref;            // registry ref anchoring the thread
+    unsigned int id;    // handle given to lua, used for cancelling
+};
+
+struct ye_lua_wait {
+    int64_t key;        // tick or frame to resume at
+    unsigned int seq;   // keeps equal keys in FIFO order
+    struct ye_lua_coroutine co;
+};
+
+struct ye_lua_event_wait {
+    char event[YE_LUA_COROUTINE_MAX_EVENT_NAME];
+    int predicate_ref;  // LUA_NOREF when waiting on a named signal
+    int64_t frame;      // frame it started waiting on, predicates are first polled the frame after
+    struct ye_lua_coroutine co;
+};
+
+struct ye_lua_wait_heap {
+    struct ye_lua_wait *items;
+    int count;
+    int capacity;
+};
+
+static struct ye_lua_wait_heap time_heap = {0};
+static struct ye_lua_wait_heap frame_heap = {0};
+
+static struct ye_lua_event_wait *event_waits = NULL;
+static int event_wait_count = 0;
+static int event_wait_capacity = 0;
+
+// coroutines that are about to be resumed (used as a stack, so signals can nest)
+static struct ye_lua_coroutine *ready = NULL;
+static int ready_count = 0;
+static int ready_capacity = 0;
+
+// owners of the coroutines currently being resumed, so we notice if one is closed mid resume
+static struct {
+    lua_State *owner;
+    bool closed;
+} stepping[YE_LUA_COROUTINE_MAX_DEPTH];
+static int stepping_depth = 0;
+
+static int64_t current_frame = 0;
+static unsigned int next_seq = 0;
+static unsigned int next_id = 1;
+
+/*
+    Growable arrays
+*/
+
+static void _reserve(void **array, int *capacity, int needed, size_t item_size){
+    if(needed <= *capacity)
+        return;
+    int new_capacity = *capacity == 0 ? 64 : *capacity;
+    while(new_capacity < needed)
+        new_capacity *= 2;
+    *array = realloc(*array, new_capacity * item_size);
+    *capacity = new_capacity;
+}
+
+/*
+    Heap operations
+*/
+
+static bool _wait_before(struct ye_lua_wait *a, struct ye_lua_wait *b){
+    if(a->key != b->key)
+        return a->key < b->key;
+    return (int)(a->seq - b->seq) < 0;
+}
+
+static void _sift_down(struct ye_lua_wait_heap *heap, int i){
+    while(true){
+        int l = i * 2 + 1, r = l + 1, smallest = i;
+        if(l < heap->count && _wait_before(&heap->items[l], &heap->items[smallest]))
+            smallest = l;
+        if(r < heap->count && _wait_before(&heap->items[r], &heap->items[smallest]))
+            smallest = r;
+        if(smallest == i)
+            return;
+        struct ye_lua_wait tmp = heap->items[i];
+        heap->items[i] = heap->items[smallest];
+        heap->items[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void _heap_push(struct ye_lua_wait_heap *heap, int64_t key, struct ye_lua_coroutine co){
+    _reserve((void **)&heap->items, &heap->capacity, heap->count + 1, sizeof(struct ye_lua_wait));
+
+    int i = heap->count++;
+    heap->items[i] = (struct ye_lua_wait){ .key = key, .seq = next_seq++, .co = co };
+
+    while(i > 0){
+        int parent = (i - 1) / 2;
+        if(!_wait_before(&heap->items[i], &heap->items[parent]))
+            break;
+        struct ye_lua_wait tmp = heap->items[i];
+        heap->items[i] = heap->items[parent];
+        heap->items[parent] = tmp;
+        i = parent;
+    }
+}
+
+static struct ye_lua_wait _heap_pop(struct ye_lua_wait_heap *heap){
+    struct ye_lua_wait top = heap->items[0];
+    heap->items[0] = heap->items[--heap->count];
+    _sift_down(heap, 0);
+    return top;
+}
+
+// removes every entry matching owner (or id if owner is NULL), returns how many were removed
+static int _heap_remove(struct ye_lua_wait_heap *heap, lua_State *owner, unsigned int id){
+    int kept = 0;
+    for(int i = 0; i < heap->count; i++){
+        bool match = owner != NULL ? heap->items[i].co.owner == owner : heap->items[i].co.id == id;
+        if(!match)
+            heap->items[kept++] = heap->items[i];
+        else if(owner == NULL)
+            luaL_unref(heap->items[i].co.owner, LUA_REGISTRYINDEX, heap->items[i].co.ref);
+    }
+    int removed = heap->count - kept;
+    heap->count = kept;
+    for(int i = heap->count / 2 - 1; i >= 0; i--)
+        _sift_down(heap, i);
+    return removed;
+}
+
+/*
+    Resuming
+*/
+
+static int _resume(lua_State *co, int nargs, int *nres){
+#ifdef YE_LUAJIT
+    int status = lua_resume(co, nargs);
+    *nres = lua_gettop(co);
+    return status;
+#else
+    return lua_resume(co, NULL, nargs, nres);
+#endif
+}
+
+static void _ready_push(struct ye_lua_coroutine co){
+    _reserve((void **)&ready, &ready_capacity, ready_count + 1, sizeof(struct ye_lua_coroutine));
+    ready[ready_count++] = co;
+}
+
+static void _schedule(struct ye_lua_coroutine co, int nres);
+
+/*
+    Resumes a coroutine until it yields or finishes, and parks it again if it yielded
+*/
+static void _step(struct ye_lua_coroutine co, int nargs){
+    if(co.owner == NULL)
+        return; // its script was removed while it was waiting to be resumed
+
+    if(stepping_depth >= YE_LUA_COROUTINE_MAX_DEPTH){
+        ye_logf(error, "Lua coroutines nested too deeply, dropping coroutine %u\n", co.id);
+        luaL_unref(co.owner, LUA_REGISTRYINDEX, co.ref);
+        return;
+    }
+
+    int depth = stepping_depth++;
+    stepping[depth].owner = co.owner;
+    stepping[depth].closed = false;
+
+    int nres = 0;
+    int status = _resume(co.thread, nargs, &nres);
+
+    bool closed = stepping[depth].closed;
+    stepping_depth--;
+
+    // the script destroyed itself from inside the coroutine, its state is gone
+    if(closed)
+        return;
+
+    if(status == LUA_YIELD){
+        _schedule(co, nres);
+        return;
+    }
+
+    if(status != LUA_OK)
+        ye_logf(error, "Error in lua coroutine: %s\n", lua_tostring(co.thread, -1));
+
+    luaL_unref(co.owner, LUA_REGISTRYINDEX, co.ref);
+}
+
+/*
+    Reads the request a coroutine yielded with and parks it accordingly.
+    A bare coroutine.yield() resumes on the next frame.
+*/
+static void _schedule(struct ye_lua_coroutine co, int nres){
+    lua_State *T = co.thread;
+    int base = lua_gettop(T) - nres + 1;
+
+    int kind = nres >= 1 && lua_type(T, base) == LUA_TNUMBER ? (int)lua_tointeger(T, base) : YE_LUA_WAIT_FRAMES;
+    int arg = base + 1;
+
+    switch(kind){
+        case YE_LUA_WAIT_SECONDS: {
+            int64_t ms = (int64_t)(lua_tonumber(T, arg) * 1000.0 + 0.5);
+            if(ms <= 0)
+                _heap_push(&frame_heap, current_frame + 1, co);
+            else
+                _heap_push(&time_heap, (int64_t)SDL_GetTicks64() + ms, co);
+            break;
+        }
+        case YE_LUA_WAIT_UNTIL: {
+            _reserve((void **)&event_waits, &event_wait_capacity, event_wait_count + 1, sizeof(struct ye_lua_event_wait));
+            struct ye_lua_event_wait *wait = &event_waits[event_wait_count];
+            wait->co = co;
+            wait->event[0] = '\0';
+            wait->predicate_ref = LUA_NOREF;
+            wait->frame = current_frame;
+
+            if(lua_type(T, arg) == LUA_TFUNCTION){
+                lua_pushvalue(T, arg);
+                wait->predicate_ref = luaL_ref(T, LUA_REGISTRYINDEX);
+            }
+            else if(lua_type(T, arg) == LUA_TSTRING){
+                const char *event = lua_tostring(T, arg);
+                if(strlen(event) >= YE_LUA_COROUTINE_MAX_EVENT_NAME)
+                    ye_logf(warning, "waitUntil event \"%s\" is longer than %d characters and will be truncated\n", event, YE_LUA_COROUTINE_MAX_EVENT_NAME - 1);
+                strncpy(wait->event, event, YE_LUA_COROUTINE_MAX_EVENT_NAME - 1);
+                wait->event[YE_LUA_COROUTINE_MAX_EVENT_NAME - 1] = '\0';
+            }
+            else{
+                ye_logf(error, "waitUntil expects an event name or a function, resuming next frame\n");
+                _heap_push(&frame_heap, current_frame + 1, co);
+                break;
+            }
+            event_wait_count++;
+            break;
+        }
+        case YE_LUA_WAIT_FRAMES:
+        default: {
+            int64_t frames = nres >= 2 ? (int64_t)lua_tointeger(T, arg) : 1;
+            if(frames < 1)
+                frames = 1;
+            _heap_push(&frame_heap, current_frame + frames, co);
+            break;
+        }
+    }
+
+    lua_pop(T, nres);
+}
+
+/*
+    Public API
+*/
+
+void ye_update_lua_coroutines(){
+    current_frame++;
+
+    int64_t now = (int64_t)SDL_GetTicks64();
+    while(time_heap.count > 0 && time_heap.items[0].key <= now){
+        struct ye_lua_wait wait = _heap_pop(&time_heap);
+        _step(wait.co, 0);
+    }
+
+    while(frame_heap.count > 0 && frame_heap.items[0].key <= current_frame){
+        struct ye_lua_wait wait = _heap_pop(&frame_heap);
+        _step(wait.co, 0);
+    }
+
+    // poll predicates, moving the satisfied ones aside before resuming anything
+    int base = ready_count;
+    for(int i = 0; i < event_wait_count;){
+        // waits added while polling (by a predicate) are left for the next frame
+        if(event_waits[i].predicate_ref == LUA_NOREF || event_waits[i].frame == current_frame){
+            i++;
+            continue;
+        }
+
+        /*
+            The predicate is lua code, it can start coroutines or wait on things itself (growing
+            event_waits), cancel waits or destroy its own script. So copy out what we need, and
+            find our entry again once it returns.
+        */
+        struct ye_lua_coroutine co = event_waits[i].co;
+        int predicate_ref = event_waits[i].predicate_ref;
+        lua_State *L = co.owner;
+
+        if(stepping_depth >= YE_LUA_COROUTINE_MAX_DEPTH){
+            i++;
+            continue;
+        }
+        int depth = stepping_depth++;
+        stepping[depth].owner = L;
+        stepping[depth].closed = false;
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, predicate_ref);
+        bool satisfied = false;
+        int status = lua_pcall(L, 0, 1, 0);
+
+        bool closed = stepping[depth].closed;
+        stepping_depth--;
+
+        // the predicate destroyed its own script, which also dropped its waits
+        if(closed)
+            continue;
+
+        if(status != LUA_OK){
+            ye_logf(error, "Error in waitUntil predicate: %s\n", lua_tostring(L, -1));
+        }
+        else{
+            satisfied = lua_toboolean(L, -1);
+        }
+        lua_pop(L, 1);
+
+        if(i >= event_wait_count || event_waits[i].co.id != co.id){
+            int j = 0;
+            while(j < event_wait_count && event_waits[j].co.id != co.id)
+                j++;
+            if(j == event_wait_count)
+                continue; // cancelled from inside the predicate
+            i = j;
+        }
+
+        if(satisfied){
+            luaL_unref(L, LUA_REGISTRYINDEX, predicate_ref);
+            _ready_push(co);
+            event_waits[i] = event_waits[--event_wait_count];
+        }
+        else{
+            i++;
+        }
+    }
+
+    int end = ready_count;
+    for(int i = base; i < end; i++)
+        _step(ready[i], 0);
+    ready_count = base;
+}
+
+void ye_lua_coroutine_signal(const char *event){
+    int base = ready_count;
+    for(int i = 0; i < event_wait_count;){
+        if(event_waits[i].predicate_ref == LUA_NOREF && strncmp(event_waits[i].event, event, YE_LUA_COROUTINE_MAX_EVENT_NAME - 1) == 0){
+            _ready_push(event_waits[i].co);
+            event_waits[i] = event_waits[--event_wait_count];
+        }
+        else{
+            i++;
+        }
+    }
+
+    int end = ready_count;
+    for(int i = base; i < end; i++)
+        _step(ready[i], 0);
+    ready_count = base;
+}
+
+void ye_lua_coroutines_purge_state(lua_State *L){
+    // the state is about to be closed, so there is no need to release any refs
+    _heap_remove(&time_heap, L, 0);
+    _heap_remove(&frame_heap, L, 0);
+
+    for(int i = 0; i < event_wait_count;){
+        if(event_waits[i].co.owner == L)
+            event_waits[i] = event_waits[--event_wait_count];
+        else
+            i++;
+    }
+
+    for(int i = 0; i < ready_count; i++){
+        if(ready[i].owner == L)
+            ready[i].owner = NULL;
+    }
+
+    for(int i = 0; i < stepping_depth; i++){
+        if(stepping[i].owner == L)
+            stepping[i].closed = true;
+    }
+}
+
+void ye_shutdown_lua_coroutines(){
+    free(time_heap.items);
+    free(frame_heap.items);
+    free(event_waits);
+    free(ready);
+
+    time_heap = (struct ye_lua_wait_heap){0};
+    frame_heap = (struct ye_lua_wait_heap){0};
+    event_waits = NULL; event_wait_count = 0; event_wait_capacity = 0;
+    ready = NULL; ready_count = 0; ready_capacity = 0;
+}
+
+/*
+    Lua bindings
+*/
+
+lua_State * ye_lua_main_state(lua_State *L){
+    lua_getfield(L, LUA_REGISTRYINDEX, YE_LUA_COROUTINE_OWNER_KEY);
+    lua_State *owner = lua_touserdata(L, -1);
+    lua_pop(L, 1);
+    return owner != NULL ? owner : L;
+}
+
+int ye_lua_coroutine_start(lua_State *L){
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    int nargs = lua_gettop(L) - 1;
+
+    // resolve the main state, since we might be called from inside another coroutine
+    lua_State *owner = ye_lua_main_state(L);
+
+    lua_State *thread = lua_newthread(L);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    // move the function and its arguments onto the new thread
+    lua_xmove(L, thread, nargs + 1);
+
+    struct ye_lua_coroutine co = { .owner = owner, .thread = thread, .ref = ref, .id = next_id++ };
+    _step(co, nargs);
+
+    lua_pushinteger(L, co.id);
+    return 1;
+}
+
+int ye_lua_coroutine_cancel(lua_State *L){
+    unsigned int id = (unsigned int)luaL_checkinteger(L, 1);
+
+    if(_heap_remove(&time_heap, NULL, id) > 0 || _heap_remove(&frame_heap, NULL, id) > 0){
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    for(int i = 0; i < event_wait_count; i++){
+        if(event_waits[i].co.id == id){
+            if(event_waits[i].predicate_ref != LUA_NOREF)
+                luaL_unref(L, LUA_REGISTRYINDEX, event_waits[i].predicate_ref);
+            luaL_unref(L, LUA_REGISTRYINDEX, event_waits[i].co.ref);
+            event_waits[i] = event_waits[--event_wait_count];
+            lua_pushboolean(L, 1);
+            return 1;
+        }
+    }
+
+    lua_pushboolean(L, 0);
+    return 1;
+}
+
+int ye_lua_coroutine_signal_event(lua_State *L){
+    const char *event = luaL_checkstring(L, 1);
+    ye_lua_coroutine_signal(event);
+    return 0;
+}
+
+int ye_lua_coroutine_register(lua_State *L){
+    lua_pushlightuserdata(L, L);
+    lua_setfield(L, LUA_REGISTRYINDEX, YE_LUA_COROUTINE_OWNER_KEY);
+
+    lua_register(L, "ye_lua_coroutine_start", ye_lua_coroutine_start);
+    lua_register(L, "ye_lua_coroutine_cancel", ye_lua_coroutine_cancel);
+    lua_register(L, "ye_lua_coroutine_signal", ye_lua_coroutine_signal_event);
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include <uthash/uthash.h>
+
+#include <yoyoengine/navigation.h>
+#include <yoyoengine/ecs/physics.h>
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Pathfinding for lua, see the Navigation table in lua_runtime/subsystems/navigation.lua
+
+    Paths are written into a table of {x, y} points passed in by the caller, reusing the point
+    tables already in it. Requests keep their callback in the registry of the script that made
+    them until it is called, or until the script goes away.
+*/
+
+// the most waypoints handed to lua for one path
+#define YE_LUA_NAV_MAX_POINTS 1024
+
+struct ye_lua_nav_request {
+    unsigned int id;
+    lua_State *owner;   // the main state of the script
+    int ref;            // the callback
+    UT_hash_handle hh;
+};
+
+static struct ye_lua_nav_request *requests = NULL;
+
+// writes points into the table at results, returns how many were written
+static int _push_points(lua_State *L, int results, const struct ye_vec2f *points, int count){
+    if(count > YE_LUA_NAV_MAX_POINTS)
+        count = YE_LUA_NAV_MAX_POINTS;
+
+    for(int i = 0; i < count; i++){
+        lua_rawgeti(L, results, i + 1);
+        if(!lua_istable(L, -1)){
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, results, i + 1);
+        }
+        lua_pushnumber(L, points[i].x);     lua_setfield(L, -2, "x");
+        lua_pushnumber(L, points[i].y);     lua_setfield(L, -2, "y");
+        lua_pop(L, 1);
+    }
+    return count;
+}
+
+static void _deliver(unsigned int id, const struct ye_nav_path *path, void *data){
+    struct ye_lua_nav_request *request = data;
+    lua_State *L = request->owner;
+    HASH_DEL(requests, request);
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, request->ref);
+    luaL_unref(L, LUA_REGISTRYINDEX, request->ref);
+    free(request);
+
+    lua_newtable(L);
+    int count = _push_points(L, lua_gettop(L), path->points, path->count);
+    lua_pushinteger(L, count);
+    lua_insert(L, -2);
+    lua_pushinteger(L, id);
+
+    // (count, points, id)
+    if(lua_pcall(L, 3, 0, 0) != LUA_OK){
+        ye_logf(error, "Error calling path request callback: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+}
+
+void ye_lua_navigation_purge_state(lua_State *L){
+    // the state is about to be closed, so there is no need to release any refs
+    struct ye_lua_nav_request *request, *tmp;
+    HASH_ITER(hh, requests, request, tmp){
+        if(request->owner != L)
+            continue;
+        ye_nav_cancel(request->id);
+        HASH_DEL(requests, request);
+        free(request);
+    }
+}
+
+// (x1, y1, x2, y2, results)
+int ye_lua_navigation_find_path(lua_State *L){
+    struct ye_vec2f start = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+    struct ye_vec2f goal = { luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+    luaL_checktype(L, 5, LUA_TTABLE);
+
+    static struct ye_vec2f points[YE_LUA_NAV_MAX_POINTS];
+    int count = ye_nav_find_path(start, goal, points, YE_LUA_NAV_MAX_POINTS);
+    lua_pushinteger(L, _push_points(L, 5, points, count));
+    return 1;
+}
+
+// (x1, y1, x2, y2, callback)
+int ye_lua_navigation_request_path(lua_State *L){
+    struct ye_vec2f start = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+    struct ye_vec2f goal = { luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+    luaL_checktype(L, 5, LUA_TFUNCTION);
+
+    // callbacks run on the main state, even if this was asked from inside a coroutine
+    struct ye_lua_nav_request *request = malloc(sizeof(struct ye_lua_nav_request));
+    request->owner = ye_lua_main_state(L);
+    lua_pushvalue(L, 5);
+    request->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    request->id = ye_nav_request_path(start, goal, _deliver, request);
+    HASH_ADD(hh, requests, id, sizeof(unsigned int), request);
+
+    lua_pushinteger(L, request->id);
+    return 1;
+}
+
+int ye_lua_navigation_cancel(lua_State *L){
+    unsigned int id = (unsigned int)luaL_checkinteger(L, 1);
+
+    struct ye_lua_nav_request *request = NULL;
+    HASH_FIND(hh, requests, &id, sizeof(unsigned int), request);
+    if(request == NULL){
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    ye_nav_cancel(id);
+    HASH_DEL(requests, request);
+    luaL_unref(request->owner, LUA_REGISTRYINDEX, request->ref);
+    free(request);
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+// (x, y, blocked)
+int ye_lua_navigation_set_blocked(lua_State *L){
+    struct ye_vec2f point = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+    ye_nav_set_blocked(point, lua_toboolean(L, 3));
+    return 0;
+}
+
+// (x, y)
+int ye_lua_navigation_is_blocked(lua_State *L){
+    struct ye_vec2f point = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+    lua_pushboolean(L, ye_nav_is_blocked(point));
+    return 1;
+}
+
+// (x, y, w, h, cellSize, layers)
+int ye_lua_navigation_build(lua_State *L){
+    struct ye_rectf bounds = { luaL_checknumber(L, 1), luaL_checknumber(L, 2), luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+    float cell_size = luaL_checknumber(L, 5);
+
+    if(!ye_nav_build(bounds, cell_size)){
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    // blocked by the static colliders on these layers, any if there is no list
+    uint32_t layers = 0;
+    if(lua_istable(L, 6)){
+        for(lua_Integer i = 1; i <= (lua_Integer)lua_rawlen(L, 6); i++){
+            lua_rawgeti(L, 6, i);
+            int layer = lua_type(L, -1) == LUA_TSTRING ? ye_physics_layer_index(lua_tostring(L, -1)) : (int)lua_tointeger(L, -1);
+            if(layer >= 0 && layer < YE_PHYSICS_MAX_LAYERS)
+                layers |= YE_PHYSICS_LAYER_BIT(layer);
+            lua_pop(L, 1);
+        }
+    }
+    ye_nav_block_colliders(layers);
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+int ye_lua_navigation_register(lua_State *L) {
+    lua_register(L, "ye_lua_navigation_find_path", ye_lua_navigation_find_path);
+    lua_register(L, "ye_lua_navigation_request_path", ye_lua_navigation_request_path);
+    lua_register(L, "ye_lua_navigation_cancel", ye_lua_navigation_cancel);
+    lua_register(L, "ye_lua_navigation_set_blocked", ye_lua_navigation_set_blocked);
+    lua_register(L, "ye_lua_navigation_is_blocked", ye_lua_navigation_is_blocked);
+    lua_register(L, "ye_lua_navigation_build", ye_lua_navigation_build);
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include <uthash/uthash.h>
+
+#include <yoyoengine/observer.h>
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Observers for lua, see the Observe table in lua_runtime/subsystems/observe.lua
+
+    Each lua observer is a C observer whose data is the function to call, so changes nobody
+    observes from lua never reach a script.
+*/
+
+struct ye_lua_observer {
+    unsigned int id;
+    lua_State *owner;   // the main state of the script
+    int ref;            // the callback
+    UT_hash_handle hh;
+};
+
+static struct ye_lua_observer *lua_observers = NULL;
+
+// indexed by the bit of each enum ye_observe_kind
+static const char *kind_names[YE_OBSERVE_KIND_COUNT] = {
+    "added", "removed", "modified", "hover", "unhover", "press", "release", "click"
+};
+
+static const char * _kind_name(enum ye_observe_kind kind){
+    for(int i = 0; i < YE_OBSERVE_KIND_COUNT; i++){
+        if(kind == (unsigned)(1u << i))
+            return kind_names[i];
+    }
+    return NULL;
+}
+
+static int _kind_from_name(const char *name){
+    for(int i = 0; i < YE_OBSERVE_KIND_COUNT; i++){
+        if(strcmp(kind_names[i], name) == 0)
+            return 1 << i;
+    }
+    return 0;
+}
+
+static void _notify(const struct ye_change *change, void *data){
+    struct ye_lua_observer *observer = data;
+    lua_State *L = observer->owner;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, observer->ref);
+    ye_lua_push_entity(L, change->entity);
+    lua_pushstring(L, _kind_name(change->kind));
+    lua_pushstring(L, ye_component_name(change->component));
+    if(lua_pcall(L, 3, 0, 0) != LUA_OK){
+        ye_logf(error, "Error calling observer: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+}
+
+static void _release(struct ye_lua_observer *observer){
+    ye_unobserve(observer->id);
+    HASH_DEL(lua_observers, observer);
+    luaL_unref(observer->owner, LUA_REGISTRYINDEX, observer->ref);
+    free(observer);
+}
+
+void ye_lua_observer_purge_state(lua_State *L){
+    // the state is about to be closed, so there is no need to release any refs
+    struct ye_lua_observer *observer, *tmp;
+    HASH_ITER(hh, lua_observers, observer, tmp){
+        if(observer->owner != L)
+            continue;
+        ye_unobserve(observer->id);
+        HASH_DEL(lua_observers, observer);
+        free(observer);
+    }
+}
+
+// a single name, or a list of them
+static int _check_kinds(lua_State *L, int idx){
+    int kinds = 0;
+    if(lua_type(L, idx) == LUA_TSTRING){
+        kinds = _kind_from_name(lua_tostring(L, idx));
+    }
+    else if(lua_istable(L, idx)){
+        for(lua_Integer i = 1; i <= (lua_Integer)lua_rawlen(L, idx); i++){
+            lua_rawgeti(L, idx, i);
+            int kind = lua_type(L, -1) == LUA_TSTRING ? _kind_from_name(lua_tostring(L, -1)) : 0;
+            lua_pop(L, 1);
+            if(kind == 0){
+                kinds = 0;
+                break;
+            }
+            kinds |= kind;
+        }
+    }
+
+    if(kinds == 0)
+        luaL_argerror(L, idx, "expected an event name or a list of them");
+    return kinds;
+}
+
+// (component, events, entity, callback)
+int ye_lua_observe(lua_State *L){
+    int component = ye_component_from_name(luaL_checkstring(L, 1));
+    if(component < 0)
+        luaL_argerror(L, 1, "unknown component");
+
+    int kinds = _check_kinds(L, 2);
+
+    struct ye_entity *entity = NULL;
+    if(!lua_isnoneornil(L, 3)){
+        luaL_checktype(L, 3, LUA_TTABLE);
+        lua_getfield(L, 3, "_c_entity");
+        entity = lua_touserdata(L, -1);
+        lua_pop(L, 1);
+        if(entity == NULL)
+            luaL_argerror(L, 3, "expected an Entity");
+    }
+
+    luaL_checktype(L, 4, LUA_TFUNCTION);
+
+    struct ye_lua_observer *observer = malloc(sizeof(struct ye_lua_observer));
+    observer->owner = ye_lua_main_state(L);
+    lua_pushvalue(L, 4);
+    observer->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    observer->id = ye_observe(component, kinds, entity, _notify, observer);
+    if(observer->id == 0){
+        luaL_unref(L, LUA_REGISTRYINDEX, observer->ref);
+        free(observer);
+        lua_pushinteger(L, 0);
+        return 1;
+    }
+    HASH_ADD(hh, lua_observers, id, sizeof(unsigned int), observer);
+
+    lua_pushinteger(L, observer->id);
+    return 1;
+}
+
+int ye_lua_unobserve(lua_State *L){
+    unsigned int id = (unsigned int)luaL_checkinteger(L, 1);
+
+    struct ye_lua_observer *observer = NULL;
+    HASH_FIND(hh, lua_observers, &id, sizeof(unsigned int), observer);
+    if(observer != NULL)
+        _release(observer);
+
+    lua_pushboolean(L, observer != NULL);
+    return 1;
+}
+
+int ye_lua_observer_register(lua_State *L) {
+    lua_register(L, "ye_lua_observe", ye_lua_observe);
+    lua_register(L, "ye_lua_unobserve", ye_lua_unobserve);
+
+    return 0;
+}
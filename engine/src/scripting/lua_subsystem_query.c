@@ -0,0 +1,225 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include <yoyoengine/ecs/ecs.h>
+#include <yoyoengine/ecs/physics.h>
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Spatial and component queries for lua, see the Query table in lua_runtime/subsystems/query.lua
+
+    Results are written into a table passed in by the caller. Hit tables already in it are
+    reused rather than replaced and entities are the script's cached Entity tables, so a script
+    that keeps one results table around does not allocate anything per query once it has grown
+    to size.
+*/
+
+// the most results a single query can return to lua
+#define YE_LUA_QUERY_MAX_RESULTS 64
+
+// reads an optional filter table {tag, ignore, skipTriggers, limit, layers, asLayer} at idx
+static int _check_filter(lua_State *L, int idx, struct ye_physics_filter *filter){
+    memset(filter, 0, sizeof(struct ye_physics_filter));
+    int limit = YE_LUA_QUERY_MAX_RESULTS;
+
+    if(lua_istable(L, idx)){
+        lua_getfield(L, idx, "tag");
+        filter->tag = lua_isstring(L, -1) ? lua_tostring(L, -1) : NULL; // the filter table keeps it alive
+        lua_pop(L, 1);
+
+        lua_getfield(L, idx, "ignore");
+        if(lua_istable(L, -1))
+            lua_getfield(L, -1, "_c_entity");
+        else
+            lua_pushnil(L);
+        filter->ignore = lua_islightuserdata(L, -1) ? lua_touserdata(L, -1) : NULL;
+        lua_pop(L, 2);
+
+        lua_getfield(L, idx, "skipTriggers");
+        filter->skip_triggers = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, idx, "limit");
+        if(lua_isnumber(L, -1))
+            limit = (int)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        // only these layers
+        lua_getfield(L, idx, "layers");
+        if(lua_istable(L, -1)){
+            for(lua_Integer i = 1; i <= (lua_Integer)lua_rawlen(L, -1); i++){
+                lua_rawgeti(L, -1, i);
+                int layer = lua_type(L, -1) == LUA_TSTRING ? ye_physics_layer_index(lua_tostring(L, -1)) : (int)lua_tointeger(L, -1);
+                if(layer >= 0 && layer < YE_PHYSICS_MAX_LAYERS)
+                    filter->layers |= YE_PHYSICS_LAYER_BIT(layer);
+                lua_pop(L, 1);
+            }
+        }
+        lua_pop(L, 1);
+
+        // whatever a collider on this layer would interact with
+        lua_getfield(L, idx, "asLayer");
+        if(!lua_isnil(L, -1)){
+            int layer = lua_type(L, -1) == LUA_TSTRING ? ye_physics_layer_index(lua_tostring(L, -1)) : (int)lua_tointeger(L, -1);
+            uint32_t mask = ye_physics_layer_mask(layer);
+            filter->layers = filter->layers != 0 ? filter->layers & mask : mask;
+
+            // nothing left to hit, but 0 means any
+            if(filter->layers == 0)
+                limit = 0;
+        }
+        lua_pop(L, 1);
+    }
+
+    if(limit < 0)
+        limit = 0;
+    if(limit > YE_LUA_QUERY_MAX_RESULTS)
+        limit = YE_LUA_QUERY_MAX_RESULTS;
+    return limit;
+}
+
+// sets t[key] (or t[index]) to the Entity table of entity, t at the top of the stack
+static void _set_entity(lua_State *L, const char *key, lua_Integer index, struct ye_entity *entity){
+    ye_lua_push_entity(L, entity);
+    if(key != NULL)
+        lua_setfield(L, -2, key);
+    else
+        lua_rawseti(L, -2, index);
+}
+
+static void _push_hits(lua_State *L, int results, struct ye_physics_hit *hits, int count){
+    for(int i = 0; i < count; i++){
+        lua_rawgeti(L, results, i + 1);
+        if(!lua_istable(L, -1)){
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, results, i + 1);
+        }
+
+        _set_entity(L, "entity", 0, hits[i].entity);
+        lua_pushnumber(L, hits[i].point.x);         lua_setfield(L, -2, "x");
+        lua_pushnumber(L, hits[i].point.y);         lua_setfield(L, -2, "y");
+        lua_pushnumber(L, hits[i].normal.x);        lua_setfield(L, -2, "normalX");
+        lua_pushnumber(L, hits[i].normal.y);        lua_setfield(L, -2, "normalY");
+        lua_pushnumber(L, hits[i].distance);        lua_setfield(L, -2, "distance");
+        lua_pop(L, 1);
+    }
+    lua_pushinteger(L, count);
+}
+
+static void _push_entities(lua_State *L, int results, struct ye_entity **entities, int count){
+    lua_pushvalue(L, results);
+    for(int i = 0; i < count; i++)
+        _set_entity(L, NULL, i + 1, entities[i]);
+    lua_pop(L, 1);
+    lua_pushinteger(L, count);
+}
+
+// (x, y, dirX, dirY, distance, filter, results)
+int ye_lua_query_raycast(lua_State *L){
+    struct ye_vec2f origin = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+    struct ye_vec2f dir = { luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+    float distance = luaL_checknumber(L, 5);
+
+    struct ye_physics_filter filter;
+    int limit = _check_filter(L, 6, &filter);
+    luaL_checktype(L, 7, LUA_TTABLE);
+
+    struct ye_physics_hit hits[YE_LUA_QUERY_MAX_RESULTS];
+    int count = ye_physics_raycast(origin, dir, distance, &filter, hits, limit);
+    _push_hits(L, 7, hits, count);
+    return 1;
+}
+
+// (x, y, w, h, dirX, dirY, distance, filter, results)
+int ye_lua_query_sweep(lua_State *L){
+    struct ye_rectf box = { luaL_checknumber(L, 1), luaL_checknumber(L, 2), luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+    struct ye_vec2f dir = { luaL_checknumber(L, 5), luaL_checknumber(L, 6) };
+    float distance = luaL_checknumber(L, 7);
+
+    struct ye_physics_filter filter;
+    int limit = _check_filter(L, 8, &filter);
+    luaL_checktype(L, 9, LUA_TTABLE);
+
+    struct ye_physics_hit hits[YE_LUA_QUERY_MAX_RESULTS];
+    int count = ye_physics_sweep(box, dir, distance, &filter, hits, limit);
+    _push_hits(L, 9, hits, count);
+    return 1;
+}
+
+// (x, y, w, h, filter, results)
+int ye_lua_query_overlap_rect(lua_State *L){
+    struct ye_rectf area = { luaL_checknumber(L, 1), luaL_checknumber(L, 2), luaL_checknumber(L, 3), luaL_checknumber(L, 4) };
+
+    struct ye_physics_filter filter;
+    int limit = _check_filter(L, 5, &filter);
+    luaL_checktype(L, 6, LUA_TTABLE);
+
+    struct ye_entity *entities[YE_LUA_QUERY_MAX_RESULTS];
+    int count = ye_physics_overlap_rect(area, &filter, entities, limit);
+    _push_entities(L, 6, entities, count);
+    return 1;
+}
+
+// (x, y, filter, results)
+int ye_lua_query_overlap_point(lua_State *L){
+    struct ye_vec2f point = { luaL_checknumber(L, 1), luaL_checknumber(L, 2) };
+
+    struct ye_physics_filter filter;
+    int limit = _check_filter(L, 3, &filter);
+    luaL_checktype(L, 4, LUA_TTABLE);
+
+    struct ye_entity *entities[YE_LUA_QUERY_MAX_RESULTS];
+    int count = ye_physics_overlap_point(point, &filter, entities, limit);
+    _push_entities(L, 4, entities, count);
+    return 1;
+}
+
+// (spec, results)
+int ye_lua_query_entities(lua_State *L){
+    const char *spec = luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    // queries are cached by their masks, parsing the same spec again returns the same one
+    struct ye_ecs_query *query = ye_ecs_query_parse(spec);
+    if(query == NULL){
+        lua_pushinteger(L, 0);
+        return 1;
+    }
+
+    int count = 0;
+    lua_pushvalue(L, 2);
+    ye_ecs_query_lock(query);
+    for(int i = 0; i < query->count; i++){
+        if(query->entities[i] != NULL)
+            _set_entity(L, NULL, ++count, query->entities[i]);
+    }
+    ye_ecs_query_unlock(query);
+    lua_pop(L, 1);
+
+    lua_pushinteger(L, count);
+    return 1;
+}
+
+int ye_lua_query_register(lua_State *L) {
+    lua_register(L, "ye_lua_query_raycast", ye_lua_query_raycast);
+    lua_register(L, "ye_lua_query_sweep", ye_lua_query_sweep);
+    lua_register(L, "ye_lua_query_overlap_rect", ye_lua_query_overlap_rect);
+    lua_register(L, "ye_lua_query_overlap_point", ye_lua_query_overlap_point);
+    lua_register(L, "ye_lua_query_entities", ye_lua_query_entities);
+
+    return 0;
+}
@@ -85,10 +85,17 @@ int ye_lua_timer_get_ticks(lua_State *L) {
     return 1;
 }
 
+// high resolution, for measuring short spans of time
+int ye_lua_timer_get_seconds(lua_State *L) {
+    lua_pushnumber(L, (lua_Number)SDL_GetPerformanceCounter() / (lua_Number)SDL_GetPerformanceFrequency());
+    return 1;
+}
+
 int ye_lua_timer_register(lua_State *L) {
     lua_register(L, "ye_lua_timer_create_timer", ye_lua_create_timer);
 
     lua_register(L, "ye_lua_timer_get_ticks", ye_lua_timer_get_ticks);
+    lua_register(L, "ye_lua_timer_get_seconds", ye_lua_timer_get_seconds);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include <uthash/uthash.h>
+
+#include <yoyoengine/tween.h>
+#include <yoyoengine/lua_api.h>
+#include <yoyoengine/logging.h>
+
+/*
+    Tweens for lua, see the Tween table in lua_runtime/subsystems/tween.lua
+
+    Lua only starts and cancels tweens, the engine advances them. Only tweens with an onComplete
+    callback are tracked here, so fire and forget tweens cost lua nothing after they start.
+*/
+
+struct ye_lua_tween {
+    unsigned int id;
+    struct ye_entity *entity;
+    enum ye_tween_property property;
+    lua_State *owner;   // the main state of the script
+    int ref;            // onComplete
+    UT_hash_handle hh;
+};
+
+static struct ye_lua_tween *callbacks = NULL;
+
+static void _complete(unsigned int id, struct ye_entity *entity, bool finished, void *data){
+    (void)entity;
+    struct ye_lua_tween *tween = data;
+    lua_State *L = tween->owner;
+    HASH_DEL(callbacks, tween);
+
+    // release everything before calling back, onComplete might destroy its own script
+    lua_rawgeti(L, LUA_REGISTRYINDEX, tween->ref);
+    luaL_unref(L, LUA_REGISTRYINDEX, tween->ref);
+    free(tween);
+
+    if(!finished){
+        lua_pop(L, 1);
+        return;
+    }
+
+    lua_pushinteger(L, id);
+    if(lua_pcall(L, 1, 0, 0) != LUA_OK){
+        ye_logf(error, "Error calling tween onComplete: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+}
+
+void ye_lua_tween_purge_state(lua_State *L){
+    // the state is about to be closed, so there is no need to release any refs
+    struct ye_lua_tween *tween, *tmp;
+    HASH_ITER(hh, callbacks, tween, tmp){
+        if(tween->owner != L)
+            continue;
+        ye_tween_cancel(tween->id); // also drops its callback if it already ended this frame
+        HASH_DEL(callbacks, tween);
+        free(tween);
+    }
+}
+
+static struct ye_entity * _check_entity(lua_State *L, int idx){
+    luaL_checktype(L, idx, LUA_TTABLE);
+    lua_getfield(L, idx, "_c_entity");
+    struct ye_entity *entity = lua_touserdata(L, -1);
+    lua_pop(L, 1);
+    if(entity == NULL)
+        luaL_argerror(L, idx, "expected an Entity");
+    return entity;
+}
+
+static enum ye_tween_property _check_property(lua_State *L, int idx){
+    enum ye_tween_property property = ye_tween_property_from_name(luaL_checkstring(L, idx));
+    if(property == YE_TWEEN_PROPERTY_COUNT)
+        luaL_argerror(L, idx, "unknown tween property");
+    return property;
+}
+
+// (entity, property, to, duration, options)
+int ye_lua_tween_start(lua_State *L){
+    struct ye_tween_desc desc = {0};
+    desc.entity = _check_entity(L, 1);
+    desc.property = _check_property(L, 2);
+    desc.to = luaL_checknumber(L, 3);
+    desc.duration = luaL_checknumber(L, 4);
+    desc.from_current = true;
+
+    if(lua_istable(L, 5)){
+        lua_getfield(L, 5, "from");
+        if(lua_isnumber(L, -1)){
+            desc.from = lua_tonumber(L, -1);
+            desc.from_current = false;
+        }
+        lua_pop(L, 1);
+
+        lua_getfield(L, 5, "delay");
+        desc.delay = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, 5, "easing");
+        if(lua_isstring(L, -1)){
+            desc.easing = ye_tween_easing_from_name(lua_tostring(L, -1));
+            if(desc.easing == YE_EASE_COUNT){
+                ye_logf(warning, "Unknown tween easing \"%s\", using linear.\n", lua_tostring(L, -1));
+                desc.easing = YE_EASE_LINEAR;
+            }
+        }
+        lua_pop(L, 1);
+
+        lua_getfield(L, 5, "loop");
+        if(lua_isstring(L, -1)){
+            const char *loop = lua_tostring(L, -1);
+            if(strcmp(loop, "restart") == 0)
+                desc.loop = YE_TWEEN_RESTART;
+            else if(strcmp(loop, "pingpong") == 0)
+                desc.loop = YE_TWEEN_PINGPONG;
+        }
+        lua_pop(L, 1);
+
+        lua_getfield(L, 5, "onComplete");
+        if(lua_isfunction(L, -1)){
+            struct ye_lua_tween *tween = malloc(sizeof(struct ye_lua_tween));
+            tween->entity = desc.entity;
+            tween->property = desc.property;
+            tween->owner = ye_lua_main_state(L);
+            tween->ref = luaL_ref(L, LUA_REGISTRYINDEX); // pops it
+            desc.on_complete = _complete;
+            desc.data = tween;
+        }
+        else
+            lua_pop(L, 1);
+    }
+
+    unsigned int id = ye_tween_start(desc);
+
+    struct ye_lua_tween *tween = desc.data;
+    if(tween != NULL){
+        if(id == 0){
+            luaL_unref(tween->owner, LUA_REGISTRYINDEX, tween->ref);
+            free(tween);
+        }
+        else{
+            tween->id = id;
+            HASH_ADD(hh, callbacks, id, sizeof(unsigned int), tween);
+        }
+    }
+
+    lua_pushinteger(L, id);
+    return 1;
+}
+
+int ye_lua_tween_cancel(lua_State *L){
+    unsigned int id = (unsigned int)luaL_checkinteger(L, 1);
+    bool cancelled = ye_tween_cancel(id);
+
+    struct ye_lua_tween *tween = NULL;
+    HASH_FIND(hh, callbacks, &id, sizeof(unsigned int), tween);
+    if(tween != NULL){
+        HASH_DEL(callbacks, tween);
+        luaL_unref(tween->owner, LUA_REGISTRYINDEX, tween->ref);
+        free(tween);
+    }
+
+    lua_pushboolean(L, cancelled);
+    return 1;
+}
+
+// (entity, property)
+int ye_lua_tween_cancel_entity(lua_State *L){
+    struct ye_entity *entity = _check_entity(L, 1);
+    enum ye_tween_property property = lua_isnoneornil(L, 2) ? YE_TWEEN_PROPERTY_COUNT : _check_property(L, 2);
+
+    // cancelling does not call _complete, so release the callbacks here
+    struct ye_lua_tween *tween, *tmp;
+    HASH_ITER(hh, callbacks, tween, tmp){
+        if(tween->entity != entity || (property != YE_TWEEN_PROPERTY_COUNT && tween->property != property))
+            continue;
+        HASH_DEL(callbacks, tween);
+        luaL_unref(tween->owner, LUA_REGISTRYINDEX, tween->ref);
+        free(tween);
+    }
+
+    lua_pushinteger(L, ye_tween_cancel_entity(entity, property));
+    return 1;
+}
+
+int ye_lua_tween_register(lua_State *L) {
+    lua_register(L, "ye_lua_tween_start", ye_lua_tween_start);
+    lua_register(L, "ye_lua_tween_cancel", ye_lua_tween_cancel);
+    lua_register(L, "ye_lua_tween_cancel_entity", ye_lua_tween_cancel_entity);
+
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/tag.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 
 
@@ -53,6 +54,8 @@ int ye_lua_tag_modify(lua_State *L){
         ent->tag->active = lua_toboolean(L, 2);
     }
 
+    ye_component_modified(ent, YE_COMPONENT_TAG);
+
     return 0;
 }
 
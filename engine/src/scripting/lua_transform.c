@@ -10,6 +10,7 @@
 #include <yoyoengine/ecs/transform.h>
 #include <yoyoengine/lua_api.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
 
 /*
     CONSTRUCT
@@ -89,6 +90,7 @@ int ye_lua_transform_set_position_x(lua_State *L) {
     int x = luaL_checknumber(L, 2);
 
     ent->transform->x = x;
+    ye_component_modified(ent, YE_COMPONENT_TRANSFORM);
 
     return 0;
 }
@@ -108,6 +110,7 @@ int ye_lua_transform_set_position_y(lua_State *L) {
     int y = luaL_checknumber(L, 2);
 
     ent->transform->y = y;
+    ye_component_modified(ent, YE_COMPONENT_TRANSFORM);
 
     return 0;
 }
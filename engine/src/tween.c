@@ -0,0 +1,400 @@
+/*
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <yoyoengine/event.h>
+#include <yoyoengine/tween.h>
+#include <yoyoengine/engine.h>
+#include <yoyoengine/logging.h>
+#include <yoyoengine/observer.h>
+#include <yoyoengine/ecs/camera.h>
+#include <yoyoengine/ecs/renderer.h>
+#include <yoyoengine/ecs/transform.h>
+
+#define YE_TWEEN_PI 3.14159265f
+
+struct ye_tween {
+    unsigned int id;
+    struct ye_entity *entity;
+    enum ye_tween_property property;
+    float from, to;
+    float duration;
+    float elapsed;          // negative while delayed
+    enum ye_tween_easing easing;
+    enum ye_tween_loop loop;
+    bool from_current;
+    bool reversed;          // on the way back of a pingpong
+    ye_tween_callback on_complete;
+    void *data;
+};
+
+// ended tweens waiting for their callbacks, which run after the pass so they can start new tweens
+struct ye_tween_ended {
+    unsigned int id;
+    struct ye_entity *entity;
+    enum ye_tween_property property;
+    bool finished;
+    ye_tween_callback on_complete;
+    void *data;
+};
+
+// packed, order does not matter
+static struct ye_tween *tweens = NULL;
+static int tween_count = 0;
+static int tween_capacity = 0;
+
+static struct ye_tween_ended *ended = NULL;
+static int ended_count = 0;
+static int ended_capacity = 0;
+
+static unsigned int next_id = 1;
+static bool flushing = false;
+
+static const char *easing_names[YE_EASE_COUNT] = {
+    "linear",
+    "inQuad", "outQuad", "inOutQuad",
+    "inCubic", "outCubic", "inOutCubic",
+    "inSine", "outSine", "inOutSine",
+    "inExpo", "outExpo",
+    "inBack", "outBack",
+    "outElastic",
+    "outBounce",
+};
+
+static const char *property_names[YE_TWEEN_PROPERTY_COUNT] = {
+    "x", "y", "alpha", "rotation", "width", "height", "cameraWidth", "cameraHeight",
+};
+
+enum ye_tween_easing ye_tween_easing_from_name(const char *name){
+    for(int i = 0; i < YE_EASE_COUNT; i++){
+        if(strcmp(easing_names[i], name) == 0)
+            return (enum ye_tween_easing)i;
+    }
+    return YE_EASE_COUNT;
+}
+
+enum ye_tween_property ye_tween_property_from_name(const char *name){
+    for(int i = 0; i < YE_TWEEN_PROPERTY_COUNT; i++){
+        if(strcmp(property_names[i], name) == 0)
+            return (enum ye_tween_property)i;
+    }
+    return YE_TWEEN_PROPERTY_COUNT;
+}
+
+static float _bounce_out(float t){
+    const float n = 7.5625f, d = 2.75f;
+    if(t < 1 / d)
+        return n * t * t;
+    if(t < 2 / d){
+        t -= 1.5f / d;
+        return n * t * t + 0.75f;
+    }
+    if(t < 2.5f / d){
+        t -= 2.25f / d;
+        return n * t * t + 0.9375f;
+    }
+    t -= 2.625f / d;
+    return n * t * t + 0.984375f;
+}
+
+float ye_ease(enum ye_tween_easing easing, float t){
+    const float back = 1.70158f;
+    switch(easing){
+        case YE_EASE_IN_QUAD:       return t * t;
+        case YE_EASE_OUT_QUAD:      return 1 - (1 - t) * (1 - t);
+        case YE_EASE_IN_OUT_QUAD:   return t < 0.5f ? 2 * t * t : 1 - powf(-2 * t + 2, 2) / 2;
+        case YE_EASE_IN_CUBIC:      return t * t * t;
+        case YE_EASE_OUT_CUBIC:     return 1 - powf(1 - t, 3);
+        case YE_EASE_IN_OUT_CUBIC:  return t < 0.5f ? 4 * t * t * t : 1 - powf(-2 * t + 2, 3) / 2;
+        case YE_EASE_IN_SINE:       return 1 - cosf(t * YE_TWEEN_PI / 2);
+        case YE_EASE_OUT_SINE:      return sinf(t * YE_TWEEN_PI / 2);
+        case YE_EASE_IN_OUT_SINE:   return -(cosf(YE_TWEEN_PI * t) - 1) / 2;
+        case YE_EASE_IN_EXPO:       return t <= 0 ? 0 : powf(2, 10 * t - 10);
+        case YE_EASE_OUT_EXPO:      return t >= 1 ? 1 : 1 - powf(2, -10 * t);
+        case YE_EASE_IN_BACK:       return (back + 1) * t * t * t - back * t * t;
+        case YE_EASE_OUT_BACK:      return 1 + (back + 1) * powf(t - 1, 3) + back * powf(t - 1, 2);
+        case YE_EASE_OUT_ELASTIC:
+            if(t <= 0 || t >= 1)
+                return t <= 0 ? 0 : 1;
+            return powf(2, -10 * t) * sinf((t * 10 - 0.75f) * (2 * YE_TWEEN_PI / 3)) + 1;
+        case YE_EASE_OUT_BOUNCE:    return _bounce_out(t);
+        default:                    return t;
+    }
+}
+
+// the value a property lives in, NULL if the entity lacks that component
+static float * _value_of(struct ye_entity *entity, enum ye_tween_property property){
+    switch(property){
+        case YE_TWEEN_TRANSFORM_X:          return entity->transform ? &entity->transform->x : NULL;
+        case YE_TWEEN_TRANSFORM_Y:          return entity->transform ? &entity->transform->y : NULL;
+        case YE_TWEEN_RENDERER_ROTATION:    return entity->renderer ? &entity->renderer->rotation : NULL;
+        case YE_TWEEN_RENDERER_WIDTH:       return entity->renderer ? &entity->renderer->rect.w : NULL;
+        case YE_TWEEN_RENDERER_HEIGHT:      return entity->renderer ? &entity->renderer->rect.h : NULL;
+        case YE_TWEEN_CAMERA_WIDTH:         return entity->camera ? &entity->camera->view_field.w : NULL;
+        case YE_TWEEN_CAMERA_HEIGHT:        return entity->camera ? &entity->camera->view_field.h : NULL;
+        default:                            return NULL;
+    }
+}
+
+// alpha is the only int property
+static bool _has_target(struct ye_entity *entity, enum ye_tween_property property){
+    if(property == YE_TWEEN_RENDERER_ALPHA)
+        return entity->renderer != NULL;
+    return _value_of(entity, property) != NULL;
+}
+
+static float _read(struct ye_entity *entity, enum ye_tween_property property){
+    if(property == YE_TWEEN_RENDERER_ALPHA)
+        return (float)entity->renderer->alpha;
+    return *_value_of(entity, property);
+}
+
+// the component a property belongs to
+static int _component_of(enum ye_tween_property property){
+    switch(property){
+        case YE_TWEEN_TRANSFORM_X:
+        case YE_TWEEN_TRANSFORM_Y:          return YE_COMPONENT_TRANSFORM;
+        case YE_TWEEN_CAMERA_WIDTH:
+        case YE_TWEEN_CAMERA_HEIGHT:        return YE_COMPONENT_CAMERA;
+        default:                            return YE_COMPONENT_RENDERER;
+    }
+}
+
+static void _write(struct ye_entity *entity, enum ye_tween_property property, float value){
+    ye_component_modified(entity, _component_of(property));
+
+    if(property == YE_TWEEN_RENDERER_ALPHA){
+        int alpha = (int)lroundf(value);
+        entity->renderer->alpha = alpha < 0 ? 0 : alpha > 255 ? 255 : alpha;
+        return;
+    }
+    *_value_of(entity, property) = value;
+}
+
+static void _end(int index, bool finished){
+    struct ye_tween *tween = &tweens[index];
+    tween->entity->tween_count--;
+
+    if(tween->on_complete != NULL || finished){
+        if(ended_count == ended_capacity){
+            ended_capacity = ended_capacity > 0 ? ended_capacity * 2 : 64;
+            ended = realloc(ended, sizeof(struct ye_tween_ended) * ended_capacity);
+        }
+        ended[ended_count++] = (struct ye_tween_ended){
+            .id = tween->id,
+            .entity = tween->entity,
+            .property = tween->property,
+            .finished = finished,
+            .on_complete = tween->on_complete,
+            .data = tween->data,
+        };
+    }
+
+    tweens[index] = tweens[--tween_count];
+}
+
+static void _drop(int index){
+    tweens[index].entity->tween_count--;
+    tweens[index] = tweens[--tween_count];
+}
+
+// runs the callbacks (and events) for everything that ended since the last flush
+static void _flush_ended(){
+    if(flushing)
+        return;
+    flushing = true;
+
+    // a callback can end more tweens, which land after i
+    for(int i = 0; i < ended_count; i++){
+        struct ye_tween_ended end = ended[i];
+
+        if(end.finished && end.entity != NULL){
+            union ye_event_args args;
+            args.tween.id = end.id;
+            args.tween.entity = end.entity;
+            ye_fire_event(YE_EVENT_TWEEN_COMPLETE, args);
+        }
+
+        if(end.on_complete != NULL)
+            end.on_complete(end.id, end.entity, end.finished, end.data);
+    }
+    ended_count = 0;
+    flushing = false;
+}
+
+unsigned int ye_tween_start(struct ye_tween_desc desc){
+    if(desc.entity == NULL || desc.property < 0 || desc.property >= YE_TWEEN_PROPERTY_COUNT){
+        ye_logf(error, "Invalid tween target.\n");
+        return 0;
+    }
+    if(!_has_target(desc.entity, desc.property)){
+        ye_logf(warning, "Entity %s lacks the component for tweened property \"%s\".\n", desc.entity->name, property_names[desc.property]);
+        return 0;
+    }
+
+    if(tween_count == tween_capacity){
+        tween_capacity = tween_capacity > 0 ? tween_capacity * 2 : 256;
+        tweens = realloc(tweens, sizeof(struct ye_tween) * tween_capacity);
+    }
+
+    struct ye_tween *tween = &tweens[tween_count++];
+    *tween = (struct ye_tween){
+        .id = next_id++,
+        .entity = desc.entity,
+        .property = desc.property,
+        .from = desc.from,
+        .to = desc.to,
+        .duration = desc.duration > 0 ? desc.duration : 0,
+        .elapsed = desc.delay > 0 ? -desc.delay : 0,
+        .easing = desc.easing >= 0 && desc.easing < YE_EASE_COUNT ? desc.easing : YE_EASE_LINEAR,
+        .loop = desc.loop,
+        .from_current = desc.from_current,
+        .on_complete = desc.on_complete,
+        .data = desc.data,
+    };
+    if(next_id == 0)
+        next_id = 1;
+
+    // without a delay, the current value is known now
+    if(tween->from_current && tween->elapsed >= 0){
+        tween->from = _read(tween->entity, tween->property);
+        tween->from_current = false;
+    }
+
+    desc.entity->tween_count++;
+    return tween->id;
+}
+
+bool ye_tween_cancel(unsigned int tween){
+    for(int i = 0; i < tween_count; i++){
+        if(tweens[i].id == tween){
+            _drop(i);
+            return true;
+        }
+    }
+
+    // it may have ended with its callback still waiting for the flush, whose data the caller is about to free
+    for(int i = 0; i < ended_count; i++){
+        if(ended[i].id == tween && ended[i].on_complete != NULL){
+            ended[i].on_complete = NULL;
+            return true;
+        }
+    }
+    return false;
+}
+
+int ye_tween_cancel_entity(struct ye_entity *entity, enum ye_tween_property property){
+    int cancelled = 0;
+    for(int i = 0; i < tween_count && entity->tween_count > 0;){
+        if(tweens[i].entity == entity && (property == YE_TWEEN_PROPERTY_COUNT || tweens[i].property == property)){
+            _drop(i);
+            cancelled++;
+        }
+        else
+            i++;
+    }
+
+    // callbacks of tweens that ended this frame are dropped too, but they do not count
+    for(int i = 0; i < ended_count; i++){
+        if(ended[i].entity == entity && (property == YE_TWEEN_PROPERTY_COUNT || ended[i].property == property))
+            ended[i].on_complete = NULL;
+    }
+    return cancelled;
+}
+
+void ye_tween_forget(struct ye_entity *entity){
+    for(int i = 0; i < tween_count && entity->tween_count > 0;){
+        if(tweens[i].entity == entity)
+            _end(i, false);
+        else
+            i++;
+    }
+
+    // callbacks still waiting to run should not see the freed entity
+    for(int i = 0; i < ended_count; i++){
+        if(ended[i].entity == entity)
+            ended[i].entity = NULL;
+    }
+
+    // does nothing if this is already inside a callback, the running flush picks these up
+    _flush_ended();
+}
+
+int ye_tween_count(){
+    return tween_count;
+}
+
+void ye_system_tween(){
+    float dt = YE_STATE.runtime.delta_time;
+
+    for(int i = 0; i < tween_count;){
+        struct ye_tween *tween = &tweens[i];
+
+        if(!_has_target(tween->entity, tween->property)){
+            _end(i, false); // the component was removed
+            continue;
+        }
+
+        tween->elapsed += dt;
+        if(tween->elapsed < 0){
+            i++;
+            continue;
+        }
+
+        if(tween->from_current){
+            tween->from = _read(tween->entity, tween->property);
+            tween->from_current = false;
+        }
+
+        float t = tween->duration > 0 ? tween->elapsed / tween->duration : 1;
+        bool done = false;
+        if(t >= 1){
+            switch(tween->loop){
+                case YE_TWEEN_RESTART:
+                    tween->elapsed = tween->duration > 0 ? fmodf(tween->elapsed, tween->duration) : 0;
+                    t = tween->duration > 0 ? tween->elapsed / tween->duration : 1;
+                    break;
+                case YE_TWEEN_PINGPONG:
+                    // each pass that wraps flips the direction
+                    tween->reversed ^= ((int)t & 1);
+                    tween->elapsed = tween->duration > 0 ? fmodf(tween->elapsed, tween->duration) : 0;
+                    t = tween->duration > 0 ? tween->elapsed / tween->duration : 1;
+                    break;
+                default:
+                    t = 1;
+                    done = true;
+                    break;
+            }
+        }
+
+        float eased = ye_ease(tween->easing, tween->reversed ? 1 - t : t);
+        _write(tween->entity, tween->property, tween->from + (tween->to - tween->from) * eased);
+
+        if(done)
+            _end(i, true);
+        else
+            i++;
+    }
+
+    _flush_ended();
+}
+
+void ye_shutdown_tween(){
+    while(tween_count > 0)
+        _end(tween_count - 1, false);
+    _flush_ended();
+
+    free(tweens);
+    free(ended);
+    tweens = NULL;
+    ended = NULL;
+    tween_count = tween_capacity = 0;
+    ended_count = ended_capacity = 0;
+}
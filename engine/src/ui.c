@@ -51,7 +51,12 @@
 
 #include <yoyoengine/yep.h>
 #include <yoyoengine/engine.h>
+#include <yoyoengine/memory.h>
+#include <yoyoengine/capture.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/lua_memory.h>
+#include <yoyoengine/scheduler.h>
+#include <yoyoengine/scene_profiler.h>
 #include <yoyoengine/ecs/camera.h>
 #include <yoyoengine/ecs/transform.h>
 
@@ -297,6 +302,95 @@ void ui_paint_cam_info(struct nk_context *ctx){
     }
 }
 
+/*
+    Records every nuklear command into the frame capture. Nuklear submits the whole ui
+    as one batch of geometry, so the time of that submit is split evenly across them.
+*/
+static void _ui_capture_render(){
+    int count = 0;
+    const struct nk_command *cmd;
+    nk_foreach(cmd, ctx){
+        struct ye_capture_op op = {.source = YE_CAPTURE_UI, .entity = -1, .alpha = 255};
+        struct nk_color color = {255, 255, 255, 255};
+
+        switch(cmd->type){
+            case NK_COMMAND_RECT: {
+                const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+                op.dst = (SDL_Rect){r->x, r->y, r->w, r->h};
+                color = r->color;
+                snprintf(op.label, sizeof(op.label), "rect");
+                break;
+            }
+            case NK_COMMAND_RECT_FILLED: {
+                const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+                op.dst = (SDL_Rect){r->x, r->y, r->w, r->h};
+                color = r->color;
+                snprintf(op.label, sizeof(op.label), "rect_filled");
+                break;
+            }
+            case NK_COMMAND_LINE: {
+                const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+                op.dst = (SDL_Rect){SDL_min(l->begin.x, l->end.x), SDL_min(l->begin.y, l->end.y),
+                                    abs(l->begin.x - l->end.x) + l->line_thickness, abs(l->begin.y - l->end.y) + l->line_thickness};
+                color = l->color;
+                snprintf(op.label, sizeof(op.label), "line");
+                break;
+            }
+            case NK_COMMAND_CIRCLE: {
+                const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+                op.dst = (SDL_Rect){c->x, c->y, c->w, c->h};
+                color = c->color;
+                snprintf(op.label, sizeof(op.label), "circle");
+                break;
+            }
+            case NK_COMMAND_CIRCLE_FILLED: {
+                const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+                op.dst = (SDL_Rect){c->x, c->y, c->w, c->h};
+                color = c->color;
+                snprintf(op.label, sizeof(op.label), "circle_filled");
+                break;
+            }
+            case NK_COMMAND_TRIANGLE_FILLED: {
+                const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+                int min_x = SDL_min(t->a.x, SDL_min(t->b.x, t->c.x)), min_y = SDL_min(t->a.y, SDL_min(t->b.y, t->c.y));
+                int max_x = SDL_max(t->a.x, SDL_max(t->b.x, t->c.x)), max_y = SDL_max(t->a.y, SDL_max(t->b.y, t->c.y));
+                op.dst = (SDL_Rect){min_x, min_y, max_x - min_x, max_y - min_y};
+                color = t->color;
+                snprintf(op.label, sizeof(op.label), "triangle");
+                break;
+            }
+            case NK_COMMAND_TEXT: {
+                const struct nk_command_text *t = (const struct nk_command_text *)cmd;
+                op.dst = (SDL_Rect){t->x, t->y, t->w, t->h};
+                color = t->foreground;
+                snprintf(op.label, sizeof(op.label), "%.*s", t->length, t->string);
+                break;
+            }
+            case NK_COMMAND_IMAGE: {
+                const struct nk_command_image *i = (const struct nk_command_image *)cmd;
+                op.dst = (SDL_Rect){i->x, i->y, i->w, i->h};
+                color = i->col;
+                snprintf(op.label, sizeof(op.label), "image");
+                break;
+            }
+            default:
+                // scissors and the rest do not draw
+                continue;
+        }
+
+        op.color = (SDL_Color){color.r, color.g, color.b, color.a};
+        op.alpha = color.a;
+        ye_capture_record(&op);
+        count++;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    nk_sdl_render(NK_ANTI_ALIASING_ON);
+    float cost = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+
+    ye_capture_share_cost(count, cost);
+}
+
 void ui_render(){
     // render all tracked ui components
     for (int i = 0; i < num_ui_components; i++) {
@@ -306,6 +400,11 @@ void ui_render(){
         }
     }
 
+    if(ye_capture_recording()){
+        _ui_capture_render();
+        return;
+    }
+
     // paint everything
     nk_sdl_render(NK_ANTI_ALIASING_ON);
 }
@@ -371,6 +470,11 @@ void init_ui(SDL_Window *win, SDL_Renderer *renderer){
     if(YE_STATE.engine.debug_mode){
         ui_register_component("debug_overlay",ui_paint_debug_overlay);
         ui_register_component("cam_info",ui_paint_cam_info);
+        ui_register_component("scene_load",ye_scene_profiler_overlay);
+        ui_register_component("lua_memory",ye_lua_memory_overlay);
+        ui_register_component("systems",ye_scheduler_overlay);
+        ui_register_component("memory",ye_memory_overlay);
+        ui_register_component("capture",ye_capture_overlay);
     }
 
     YE_STATE.engine.ctx = ctx;
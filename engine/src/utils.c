@@ -344,28 +344,7 @@ void ye_get_mouse_world_position(int *x, int *y){
 }
 
 bool ye_component_exists(struct ye_entity *entity, enum ye_component_type type){
-    switch(type){
-        case YE_COMPONENT_TRANSFORM:
-            return entity->transform != NULL;
-        case YE_COMPONENT_RENDERER:
-            return entity->renderer != NULL;
-        case YE_COMPONENT_CAMERA:
-            return entity->camera != NULL;
-        case YE_COMPONENT_PHYSICS:
-            return entity->physics != NULL;
-        case YE_COMPONENT_TAG:
-            return entity->tag != NULL;
-        case YE_COMPONENT_COLLIDER:
-            return entity->collider != NULL;
-        case YE_COMPONENT_LUA_SCRIPT:
-            return entity->lua_script != NULL;
-        case YE_COMPONENT_AUDIOSOURCE:
-            return entity->audiosource != NULL;
-        case YE_COMPONENT_BUTTON:
-            return entity->button != NULL;
-        default:
-            return false;
-    }
+    return (entity->components & YE_COMPONENT_BIT(type)) != 0;
 }
 
 bool ye_draw_thick_line(SDL_Renderer *renderer, float x1, float y1, float x2, float y2, int thickness, SDL_Color color) {
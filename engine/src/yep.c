@@ -13,16 +13,29 @@
 #include <jansson.h> // jansson
 
 #include <yoyoengine/yep.h>
+#include <yoyoengine/memory.h>
 #include <yoyoengine/engine.h>
 #include <yoyoengine/logging.h>
+#include <yoyoengine/scene_profiler.h>
 
 #include <zlib.h>   // zlib compression
 
-// holds the reference to the currently open yep file
-char* yep_file_path = NULL;
-FILE *yep_file = NULL;
-uint16_t file_entry_count = 0;
-uint16_t file_version_number = 0;
+/*
+    Every pack we read from stays open, since the engine and game packs are read back and
+    forth all the time. Each has its own lock so different packs can be read from different
+    threads at once (startup reads both while the window comes up).
+*/
+#define YEP_MAX_OPEN_FILES 4
+
+struct yep_open_file {
+    char *path;
+    FILE *file;
+    uint16_t entry_count;
+    SDL_mutex *lock;
+};
+
+static struct yep_open_file open_files[YEP_MAX_OPEN_FILES];
+static SDL_SpinLock open_files_lock = 0;
 
 struct yep_pack_list yep_pack_list;
 
@@ -169,55 +182,88 @@ void displayProgressBar(int current, int max) {
 
 ///////////////////////////////////////////
 
-bool _yep_open_file(const char *file){
-    // if we already have this file open, don't open it again
-    if(yep_file_path != NULL && strcmp(yep_file_path, file) == 0){
-        return true;
+/*
+    Returns the open pack for a path, opening it if needed. It comes back locked, the caller
+    unlocks it once it is done reading.
+*/
+struct yep_open_file * _yep_open_file(const char *file){
+    // find the slot for this path, or claim an empty one
+    SDL_AtomicLock(&open_files_lock);
+    struct yep_open_file *pack = NULL;
+    struct yep_open_file *empty = NULL;
+    for(int i = 0; i < YEP_MAX_OPEN_FILES; i++){
+        if(open_files[i].path == NULL){
+            if(empty == NULL)
+                empty = &open_files[i];
+            continue;
+        }
+        if(strcmp(open_files[i].path, file) == 0){
+            pack = &open_files[i];
+            break;
+        }
+    }
+    if(pack == NULL && empty != NULL){
+        pack = empty;
+        pack->path = ye_strdup(YE_MEM_YEP, file);
+        if(pack->lock == NULL)
+            pack->lock = SDL_CreateMutex();
     }
+    SDL_AtomicUnlock(&open_files_lock);
 
-    yep_file = fopen(file, "rb");
-    if (yep_file == NULL) {
-        ye_logf(error,"Error opening yep file\n");
-        return false;
+    if(pack == NULL){
+        ye_logf(error,"Error: cannot open %s, %d yep files are already open\n", file, YEP_MAX_OPEN_FILES);
+        return NULL;
     }
 
-    // set the file path
-    if(yep_file_path != NULL)
-        free(yep_file_path);
+    SDL_LockMutex(pack->lock);
+    if(pack->file != NULL)
+        return pack;
 
-    yep_file_path = strdup(file);
+    pack->file = fopen(file, "rb");
+    if (pack->file == NULL) {
+        ye_logf(error,"Error opening yep file\n");
+        SDL_UnlockMutex(pack->lock);
+        return NULL;
+    }
 
     // read the version number (byte 0-1)
-    fread(&file_version_number, sizeof(uint8_t), 1, yep_file);
+    uint8_t version_number = 0;
+    fread(&version_number, sizeof(uint8_t), 1, pack->file);
 
     // read the entry count (byte 2-3)
-    fread(&file_entry_count, sizeof(uint16_t), 1, yep_file);
+    fread(&pack->entry_count, sizeof(uint16_t), 1, pack->file);
 
-    if(file_version_number != YEP_CURRENT_FORMAT_VERSION){
-        ye_logf(error,"Error: file version number (%d) does not match current version number (%d)\n", file_version_number, YEP_CURRENT_FORMAT_VERSION);
-        return false;
+    if(version_number != YEP_CURRENT_FORMAT_VERSION){
+        ye_logf(error,"Error: file version number (%d) does not match current version number (%d)\n", version_number, YEP_CURRENT_FORMAT_VERSION);
+        fclose(pack->file);
+        pack->file = NULL;
+        SDL_UnlockMutex(pack->lock);
+        return NULL;
     }
 
-    return true;
+    return pack;
 }
 
-void _yep_close_file(){
-    if(yep_file != NULL){
-        fclose(yep_file);
-        yep_file = NULL;
-
-        if(yep_file_path != NULL)
-            free(yep_file_path);
-
-        file_entry_count = 0;
-        file_version_number = 0;
+void _yep_close_files(){
+    SDL_AtomicLock(&open_files_lock);
+    for(int i = 0; i < YEP_MAX_OPEN_FILES; i++){
+        struct yep_open_file *pack = &open_files[i];
+        if(pack->file != NULL)
+            fclose(pack->file);
+        if(pack->lock != NULL)
+            SDL_DestroyMutex(pack->lock);
+        ye_free(pack->path);
+        memset(pack, 0, sizeof(struct yep_open_file));
     }
+    SDL_AtomicUnlock(&open_files_lock);
 }
 
 /*
     Takes in references to where to output the data if found, and returns true if found, false if not found
 */
-bool _yep_seek_header(const char *handle, char *name, uint32_t *offset, uint32_t *size, uint8_t *compression_type, uint32_t *uncompressed_size, uint8_t *data_type){
+bool _yep_seek_header(struct yep_open_file *pack, const char *handle, char *name, uint32_t *offset, uint32_t *size, uint8_t *compression_type, uint32_t *uncompressed_size, uint8_t *data_type){
+    FILE *yep_file = pack->file;
+
     // go to the beginning of the header section (3 byte) offset from beginning
     fseek(yep_file, 3, SEEK_SET);
 
@@ -225,7 +271,7 @@ bool _yep_seek_header(const char *handle, char *name, uint32_t *offset, uint32_t
         Its simplist to just read the whole header into memory (the name is most of it) to
         keep ourselves aligned with the headers list
     */
-    for(size_t i = 0; i < file_entry_count; i++){
+    for(size_t i = 0; i < pack->entry_count; i++){
         // printf("Searching for %s\n", handle);
 
         // 64 bytes - name of the resource
@@ -257,15 +303,14 @@ bool _yep_seek_header(const char *handle, char *name, uint32_t *offset, uint32_t
 }
 
 struct yep_data_info yep_extract_data(const char *file, const char *handle){
-    if(!_yep_open_file(file)){
+    uint64_t stage_start = ye_scene_profiler_now();
+
+    struct yep_open_file *pack = _yep_open_file(file);
+    if(pack == NULL){
         ye_logf(error,"Error opening yep file %s\n", file);
         exit(1);
     }
 
-    // printf("File: %s\n", yep_file_path);
-    // printf("    Version number: %d\n", file_version_number);
-    // printf("    Entry count: %d\n", file_entry_count);
-
     // setup the data we will seek out of the yep file
     char name[64];
     uint32_t offset;
@@ -275,7 +320,7 @@ struct yep_data_info yep_extract_data(const char *file, const char *handle){
     uint8_t data_type;
 
     // try to get our header
-    if(!_yep_seek_header(handle, name, &offset, &size, &compression_type, &uncompressed_size, &data_type)){
+    if(!_yep_seek_header(pack, handle, name, &offset, &size, &compression_type, &uncompressed_size, &data_type)){
         ye_logf(error,"Error: could not find resource \"%s\" in file %s\n", handle, file);
         exit(1);
     }
@@ -290,11 +335,15 @@ struct yep_data_info yep_extract_data(const char *file, const char *handle){
     // printf("    Data type: %d\n", data_type);
 
     // seek to the offset
-    fseek(yep_file, offset, SEEK_SET);
+    fseek(pack->file, offset, SEEK_SET);
 
     // read the data
     char *data = malloc(size + 1); // null terminator
-    fread(data, sizeof(char), size, yep_file);
+    fread(data, sizeof(char), size, pack->file);
+
+    // done with the file, decompression does not need it
+    SDL_UnlockMutex(pack->lock);
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_READ, stage_start, size);
 
     // null terminate the data
     if(compression_type == YEP_COMPRESSION_NONE)
@@ -304,6 +353,7 @@ struct yep_data_info yep_extract_data(const char *file, const char *handle){
 
     // if the data is compressed, decompress it
     if(compression_type == YEP_COMPRESSION_ZLIB){
+        stage_start = ye_scene_profiler_now();
         char *decompressed_data;
         if(decompress_data(data, size, &decompressed_data, uncompressed_size) != 0){
             ye_logf(error,"!!!Error decompressing data!!!\n");
@@ -322,12 +372,14 @@ struct yep_data_info yep_extract_data(const char *file, const char *handle){
         // set the data to the decompressed data
         data = decompressed_data;
         size = uncompressed_size;
+        ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECOMPRESS, stage_start, 0);
     }
 
     // create return data
     struct yep_data_info info;
     info.data = data;
     info.size = size;
+    info.data_type = data_type;
 
     // return the data
     return info;
@@ -339,14 +391,14 @@ void yep_initialize(){
 }
 
 void yep_shutdown(){
-    _yep_close_file();
+    _yep_close_files();
 
     if(yep_pack_list.head != NULL){
         struct yep_header_node *itr = yep_pack_list.head;
         while(itr != NULL){
             struct yep_header_node *next = itr->next;
-            free(itr->fullpath);
-            free(itr);
+            ye_free(itr->fullpath);
+            ye_free(itr);
             itr = next;
         }
     }
@@ -399,13 +451,13 @@ void _ye_walk_directory(char *root_path, char *directory_path){
             // printf("%s\n", relative_path);
 
             // add a yep header node with the relative path
-            struct yep_header_node *node = malloc(sizeof(struct yep_header_node));
+            struct yep_header_node *node = ye_malloc(YE_MEM_YEP, sizeof(struct yep_header_node));
 
             // set the name field to zeros so I dont lose my mind reading hex output
             memset(node->name, 0, 64);
 
             // set the full path
-            node->fullpath = strdup(full_path);
+            node->fullpath = ye_strdup(YE_MEM_YEP, full_path);
 
             // set the name
             sprintf(node->name, "%s", relative_path);
@@ -477,6 +529,56 @@ void update_header(FILE *pack_file, int entry_index, uint32_t offset, uint32_t s
     fwrite(&data_type, sizeof(uint8_t), 1, pack_file);
 }
 
+/*
+    Whether a file is audio the mixer can decode into a chunk
+*/
+bool _yep_is_audio(const char *path){
+    const char *extension = strrchr(path, '.');
+    if(extension == NULL)
+        return false;
+
+    return SDL_strcasecmp(extension, ".wav") == 0 || SDL_strcasecmp(extension, ".ogg") == 0 ||
+           SDL_strcasecmp(extension, ".mp3") == 0 || SDL_strcasecmp(extension, ".flac") == 0 ||
+           SDL_strcasecmp(extension, ".opus") == 0;
+}
+
+/*
+    Decodes an audio file into the mixer's device format, replacing data with a PCM payload
+    (see struct yep_pcm_header). Leaves data alone and returns false if the mixer is not
+    open, the file does not decode, or it is too long to be worth shipping raw.
+*/
+bool _yep_transcode_pcm(char **data, uint32_t *size){
+    int frequency, channels;
+    Uint16 format;
+    if(Mix_QuerySpec(&frequency, &format, &channels) == 0)
+        return false;
+
+    Mix_Chunk *chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(*data, *size), 1);
+    if(chunk == NULL)
+        return false;
+
+    if(chunk->alen > YEP_PCM_MAX_BYTES){
+        Mix_FreeChunk(chunk);
+        return false;
+    }
+
+    struct yep_pcm_header header = {0};
+    header.frequency = (uint32_t)frequency;
+    header.format = format;
+    header.channels = (uint8_t)channels;
+
+    uint32_t pcm_size = sizeof(struct yep_pcm_header) + chunk->alen;
+    char *pcm = malloc(pcm_size);
+    memcpy(pcm, &header, sizeof(struct yep_pcm_header));
+    memcpy(pcm + sizeof(struct yep_pcm_header), chunk->abuf, chunk->alen);
+    Mix_FreeChunk(chunk);
+
+    free(*data);
+    *data = pcm;
+    *size = pcm_size;
+    return true;
+}
+
 void write_pack_file(FILE *pack_file) {
     // holds the start of the header for our current entry
     uint32_t data_start = 3 + (yep_pack_list.entry_count * YEP_HEADER_SIZE_BYTES);
@@ -499,7 +601,6 @@ void write_pack_file(FILE *pack_file) {
         }
 
         uint32_t data_size = get_file_size(file_to_write);
-        uint32_t uncompressed_size = data_size;
         char *data = read_file_data(file_to_write, data_size);
         fclose(file_to_write);
 
@@ -508,9 +609,16 @@ void write_pack_file(FILE *pack_file) {
         uint8_t compression_type = (uint8_t)YEP_COMPRESSION_NONE;
         uint8_t data_type = (uint8_t)YEP_DATATYPE_MISC;
 
+        // short sounds are decoded now so loading them is just a copy
+        if(_yep_is_audio(itr->fullpath) && _yep_transcode_pcm(&data, &data_size))
+            data_type = (uint8_t)YEP_DATATYPE_PCM;
+
+        uint32_t uncompressed_size = data_size;
+
         if(
             data_size > 256
             // here is where we can && exclusion conditions, like bytecode
+            && data_type != YEP_DATATYPE_PCM
         ){
             compression_type = (uint8_t)YEP_COMPRESSION_ZLIB;
         }
@@ -560,8 +668,8 @@ void write_pack_file(FILE *pack_file) {
     struct yep_header_node *itr2 = yep_pack_list.head;
     while(itr2 != NULL){
         struct yep_header_node *next = itr2->next;
-        free(itr2->fullpath);
-        free(itr2);
+        ye_free(itr2->fullpath);
+        ye_free(itr2);
         itr2 = next;
     }
     yep_pack_list.head = NULL;
@@ -698,7 +806,9 @@ SDL_Surface * _yep_image(const char *handle, const char *path){
     struct yep_data_info data = _yep_misc(handle, path);
 
     // create the surface
+    uint64_t decode_start = ye_scene_profiler_now();
     SDL_Surface *surface = IMG_Load_RW(SDL_RWFromMem(data.data, data.size), 1);
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECODE, decode_start, 0);
     if(surface == NULL){
         ye_logf(error,"Error: could not create surface for %s\n", handle);
         return NULL;
@@ -716,7 +826,9 @@ json_t * _yep_json(const char *handle, const char *path){
     struct yep_data_info data = _yep_misc(handle, path);
 
     // create the json
+    uint64_t decode_start = ye_scene_profiler_now();
     json_t *json = json_loadb(data.data, data.size, 0, NULL);
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECODE, decode_start, 0);
     if(json == NULL){
         ye_logf(error,"Error: could not create json for %s\n", handle);
         return NULL;
@@ -730,14 +842,137 @@ json_t * _yep_json(const char *handle, const char *path){
     return json;
 }
 
+/*
+    Builds a chunk straight from a PCM payload. If the pack was built for a different device
+    format than the one we got, the samples are converted once here instead.
+*/
+Mix_Chunk * _yep_pcm_chunk(const char *handle, struct yep_data_info data){
+    if(data.size < sizeof(struct yep_pcm_header)){
+        ye_logf(error,"Error: PCM data for %s is truncated\n", handle);
+        return NULL;
+    }
+
+    struct yep_pcm_header header;
+    memcpy(&header, data.data, sizeof(struct yep_pcm_header));
+    Uint8 *samples = (Uint8 *)data.data + sizeof(struct yep_pcm_header);
+    Uint32 length = (Uint32)(data.size - sizeof(struct yep_pcm_header));
+
+    int frequency, channels;
+    Uint16 format;
+    if(Mix_QuerySpec(&frequency, &format, &channels) == 0){
+        ye_logf(error,"Error: cannot load %s, the mixer is not open\n", handle);
+        return NULL;
+    }
+
+    // the mixer frees abuf with the chunk once allocated is set, so it must come from SDL_malloc
+    Uint8 *buffer = NULL;
+    if((int)header.frequency == frequency && header.format == format && header.channels == channels){
+        buffer = SDL_malloc(length);
+        memcpy(buffer, samples, length);
+    }
+    else{
+        ye_logf(warning,"%s was packed for a different audio device format, converting it\n", handle);
+
+        SDL_AudioCVT cvt;
+        int needed = SDL_BuildAudioCVT(&cvt, header.format, header.channels, (int)header.frequency, format, (Uint8)channels, frequency);
+        if(needed < 0){
+            ye_logf(error,"Error: cannot convert %s: %s\n", handle, SDL_GetError());
+            return NULL;
+        }
+
+        cvt.len = (int)length;
+        cvt.buf = SDL_malloc((size_t)length * cvt.len_mult);
+        memcpy(cvt.buf, samples, length);
+        if(needed > 0){
+            if(SDL_ConvertAudio(&cvt) < 0){
+                ye_logf(error,"Error: cannot convert %s: %s\n", handle, SDL_GetError());
+                SDL_free(cvt.buf);
+                return NULL;
+            }
+            length = (Uint32)cvt.len_cvt;
+        }
+        buffer = cvt.buf;
+    }
+
+    Mix_Chunk *chunk = Mix_QuickLoad_RAW(buffer, length);
+    if(chunk == NULL){
+        SDL_free(buffer);
+        return NULL;
+    }
+    chunk->allocated = 1;
+    return chunk;
+}
+
+/*
+    Mix_Music streams its source, so PCM has to be handed to it as a wav
+*/
+SDL_RWops * _yep_pcm_to_wav(const char *handle, struct yep_data_info *data){
+    struct yep_pcm_header header;
+    memcpy(&header, data->data, sizeof(struct yep_pcm_header));
+
+    // wav stores 8 bit samples unsigned and everything wider signed
+    uint16_t wav_format = 0;
+    if(SDL_AUDIO_ISFLOAT(header.format))
+        wav_format = 3; // WAVE_FORMAT_IEEE_FLOAT
+    else if((SDL_AUDIO_BITSIZE(header.format) == 8) != (SDL_AUDIO_ISSIGNED(header.format) != 0))
+        wav_format = 1; // WAVE_FORMAT_PCM
+
+    if(wav_format == 0 || SDL_AUDIO_ISBIGENDIAN(header.format)){
+        ye_logf(error,"Error: %s was packed as PCM in a format wav cannot hold, it cannot be streamed as music\n", handle);
+        return NULL;
+    }
+
+    uint32_t length = (uint32_t)(data->size - sizeof(struct yep_pcm_header));
+    uint16_t block_align = (uint16_t)(header.channels * (SDL_AUDIO_BITSIZE(header.format) / 8));
+
+    // canonical 44 byte header in front of the samples
+    uint8_t *wav = malloc(44 + length);
+    memcpy(wav, "RIFF", 4);
+    memcpy(wav + 8, "WAVEfmt ", 8);
+    Uint32 riff_size = SDL_SwapLE32(36 + length);
+    Uint32 fmt_size = SDL_SwapLE32(16);
+    Uint16 format_tag = SDL_SwapLE16(wav_format);
+    Uint16 channel_count = SDL_SwapLE16(header.channels);
+    Uint32 rate = SDL_SwapLE32(header.frequency);
+    Uint32 byte_rate = SDL_SwapLE32(header.frequency * block_align);
+    Uint16 align = SDL_SwapLE16(block_align);
+    Uint16 bits = SDL_SwapLE16(SDL_AUDIO_BITSIZE(header.format));
+    Uint32 data_size = SDL_SwapLE32(length);
+    memcpy(wav + 4, &riff_size, 4);
+    memcpy(wav + 16, &fmt_size, 4);
+    memcpy(wav + 20, &format_tag, 2);
+    memcpy(wav + 22, &channel_count, 2);
+    memcpy(wav + 24, &rate, 4);
+    memcpy(wav + 28, &byte_rate, 4);
+    memcpy(wav + 32, &align, 2);
+    memcpy(wav + 34, &bits, 2);
+    memcpy(wav + 36, "data", 4);
+    memcpy(wav + 40, &data_size, 4);
+    memcpy(wav + 44, (uint8_t *)data->data + sizeof(struct yep_pcm_header), length);
+
+    free(data->data);
+    data->data = wav;
+    data->size = 44 + length;
+    return SDL_RWFromMem(data->data, (int)data->size);
+}
+
 Mix_Chunk * _yep_audio(const char *handle, const char *path){
     // load the data
     struct yep_data_info data = _yep_misc(handle, path);
+    if(data.data == NULL)
+        return NULL;
 
     // create the chunk
-    Mix_Chunk *chunk = Mix_LoadWAV_RW(SDL_RWFromMem(data.data, data.size), 1);
+    uint64_t decode_start = ye_scene_profiler_now();
+    Mix_Chunk *chunk = NULL;
+    if(data.data_type == YEP_DATATYPE_PCM)
+        chunk = _yep_pcm_chunk(handle, data);
+    else
+        chunk = Mix_LoadWAV_RW(SDL_RWFromMem(data.data, data.size), 1);
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECODE, decode_start, 0);
     if(chunk == NULL){
         ye_logf(error,"Error: could not create chunk for %s\n", handle);
+        free(data.data);
         return NULL;
     }
 
@@ -753,7 +988,14 @@ Mix_Music * _yep_music(const char *handle, const char *path){
     struct yep_data_info data = _yep_misc(handle, path);
 
     // create the music
-    Mix_Music *music = Mix_LoadMUS_RW(SDL_RWFromMem(data.data, data.size), 1);
+    uint64_t decode_start = ye_scene_profiler_now();
+    SDL_RWops *source = NULL;
+    if(data.data_type == YEP_DATATYPE_PCM && data.size >= sizeof(struct yep_pcm_header))
+        source = _yep_pcm_to_wav(handle, &data);
+    else
+        source = SDL_RWFromMem(data.data, data.size);
+    Mix_Music *music = source != NULL ? Mix_LoadMUS_RW(source, 1) : NULL;
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECODE, decode_start, 0);
     if(music == NULL){
         ye_logf(error,"Error: could not create music for %s\n", handle);
         return NULL;
@@ -771,7 +1013,9 @@ TTF_Font * _yep_font(const char *handle, const char *path){
     struct yep_data_info data = _yep_misc(handle, path);
 
     // create the font
+    uint64_t decode_start = ye_scene_profiler_now();
     TTF_Font *font = TTF_OpenFontRW(SDL_RWFromMem(data.data, data.size), 1, 1);
+    ye_scene_profiler_asset(handle, YE_ASSET_LOAD_DECODE, decode_start, 0);
     if(font == NULL){
         ye_logf(error,"Error: could not create font for %s\n", handle);
         return YE_STATE.engine.pEngineFont;
@@ -0,0 +1,75 @@
+"""
+    This file is a part of yoyoengine. (https://github.com/zoogies/yoyoengine)
+    Copyright (C) 2024  Ryan Zmuda
+
+    Licensed under the MIT license. See LICENSE file in the project root for details.
+
+    Compares two reports written by engine/lua/benchmark_suite.lua and exits with 1 if the
+    current one is slower than the baseline by more than the threshold, or allocates more.
+
+    usage: python compare_lua_benchmarks.py baseline.json current.json [--threshold 0.15]
+"""
+
+import sys
+import json
+import argparse
+
+def load_report(path):
+    with open(path, 'r') as f:
+        report = json.load(f)
+    return {bench['name']: bench for bench in report.get('benchmarks', [])}, report
+
+def compare(baseline_path, current_path, threshold):
+    baseline, baseline_report = load_report(baseline_path)
+    current, current_report = load_report(current_path)
+
+    if baseline_report.get('lua') != current_report.get('lua') or baseline_report.get('luajit') != current_report.get('luajit'):
+        print(f"warning: reports are from different lua versions ({baseline_report.get('lua')} vs {current_report.get('lua')})")
+
+    regressions = []
+
+    print(f"{'benchmark':<32} {'base ns/op':>12} {'ns/op':>12} {'change':>8} {'base allocs':>12} {'allocs':>8}")
+    for name, bench in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print(f"{name:<32} {'-':>12} {bench['ns_per_op']:>12.1f} {'new':>8}")
+            continue
+
+        change = bench['ns_per_op'] / base['ns_per_op'] - 1 if base['ns_per_op'] > 0 else 0
+        base_allocs = base.get('allocations_per_op')
+        allocs = bench.get('allocations_per_op')
+
+        flags = []
+        if change > threshold:
+            flags.append('slower')
+        # allocation counts are exact, anything above the baseline is a new allocation
+        if base_allocs is not None and allocs is not None and allocs > base_allocs + 1e-3:
+            flags.append('allocates')
+        if flags:
+            regressions.append((name, flags))
+
+        fmt_allocs = lambda a: f"{a:.2f}" if a is not None else '-'
+        print(f"{name:<32} {base['ns_per_op']:>12.1f} {bench['ns_per_op']:>12.1f} {change * 100:>+7.1f}% "
+              f"{fmt_allocs(base_allocs):>12} {fmt_allocs(allocs):>8} {' '.join(flags)}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<32} missing from {current_path}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) beyond {threshold * 100:.0f}%:")
+        for name, flags in regressions:
+            print(f"  {name}: {', '.join(flags)}")
+        return 1
+
+    print("\nno regressions")
+    return 0
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Compare two yoyoengine lua benchmark reports.")
+    parser.add_argument('baseline', help="report to compare against")
+    parser.add_argument('current', help="report to check")
+    parser.add_argument('--threshold', type=float, default=0.15, help="allowed slowdown, 0.15 is 15%% (default)")
+    args = parser.parse_args()
+
+    sys.exit(compare(args.baseline, args.current, args.threshold))